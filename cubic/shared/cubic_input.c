@@ -6,6 +6,7 @@
  */
 
 #include "cubic_input.h"
+#include "../../shared/code_reader.h"
 #include<string.h>
 
 void decodeCubicMultiCode(unsigned short* code, int length, GRAPH graph, int *vertexCount) {
@@ -36,6 +37,8 @@ void decodeCubicMultiCode(unsigned short* code, int length, GRAPH graph, int *ve
 }
 
 /**
+ * Reads the next code with a reader that is bound to file. The reader is
+ * created at the first call and replaced when a different file is passed.
  * 
  * @param code
  * @param length
@@ -43,117 +46,31 @@ void decodeCubicMultiCode(unsigned short* code, int length, GRAPH graph, int *ve
  * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
  */
 int readCubicMultiCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
+    static CODE_READER *reader = NULL;
+    static FILE *readerFile = NULL;
+    CODE_VIEW view;
 
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 12, file) != 12) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[12] = 0;
-        if (strcmp(testheader, ">>multi_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No multicode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
+    if (reader == NULL || readerFile != file) {
+        if (reader != NULL) {
+            freeCodeReader(reader);
         }
+        reader = newMultiCodeReader(file);
+        readerFile = file;
     }
 
-    /* possibly removing interior headers -- only done for multicode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
+    if (!nextCode(reader, &view)) {
         return (0);
     }
 
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
+    if (view.order > MAXN) {
+        fprintf(stderr, "Constant N too small %d > %d \n", view.order, MAXN);
+        exit(1);
     }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]-1) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]-1) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
+    if (view.entryCount >= MAXCODELENGTH) {
+        fprintf(stderr, "Code too long (%d entries) -- exiting!\n", view.entryCount);
+        exit(1);
     }
 
-    *length = bufferSize;
+    *length = codeViewToArray(&view, code);
     return (1);
-
-
 }
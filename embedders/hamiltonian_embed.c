@@ -14,7 +14,10 @@
  *     
  *     cc -o hamiltonian_embed -O4  hamiltonian_embed.c \
  *     ../multicode/shared/multicode_base.c \
- *     ../multicode/shared/multicode_input.c
+ *     ../multicode/shared/multicode_input.c \
+ *     ../invariants/shared/invariant_context.c \
+ *     ../invariants/shared/invariant_graph_data.c \
+ *     ../invariants/shared/hamiltonian_search.c
  * 
  */
 
@@ -25,85 +28,12 @@
 
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
-
-boolean currentCycle[MAXN+1];
-int cycleOrder[MAXN];
-
-/**
-  * 
-  */
-boolean continueCycle(GRAPH graph, ADJACENCY adj, int target, int next, int remaining) {
-    int i;
-    
-    if(target==next){
-        if(remaining==0){
-            return TRUE;
-        }
-        return FALSE;
-    }
-    
-    cycleOrder[graph[0][0] - remaining] = next;
-    
-    for(i = 0; i < adj[next]; i++){
-        if(!currentCycle[graph[next][i]]){
-            currentCycle[graph[next][i]]=TRUE;
-            if(continueCycle(graph, adj, target, graph[next][i], remaining - 1)){
-                return TRUE;
-            }
-            currentCycle[graph[next][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean findHamiltonianCycle(GRAPH graph, ADJACENCY adj){
-    int i, j;
-    int order = graph[0][0];
-    int minDegree;
-    int minDegreeVertex;
-    
-    if(order<3){
-        return FALSE;
-    }
-    
-    minDegree = order;
-    for(i = 1; i <= order; i++){
-        if(adj[i] < minDegree){
-            minDegree = adj[i];
-            minDegreeVertex = i;
-        }
-    }
-    
-    if(minDegree == 1){
-        return FALSE;
-    }
-    
-    //just look for a hamiltonian cycle
-    for(i=0; i<=MAXN; i++){
-        currentCycle[i] = FALSE;
-    }
-    
-    currentCycle[minDegreeVertex] = TRUE;
-    cycleOrder[1] = minDegreeVertex;
-    for(i = 1; i < adj[minDegreeVertex]; i++){
-        currentCycle[graph[minDegreeVertex][i]] = TRUE;
-        for(j = 0; j < i; j++){
-            cycleOrder[0] = graph[minDegreeVertex][j];
-            //search for cycle containing graph[minDegreeVertex][i], minDegreeVertex,  graph[minDegreeVertex][j]
-            if(continueCycle(graph, adj, graph[minDegreeVertex][j], graph[minDegreeVertex][i], order - 2)){
-                return TRUE;
-            }
-        }
-        currentCycle[graph[minDegreeVertex][i]]=FALSE;
-    }
-    
-    return FALSE;
-}
+#include "../invariants/shared/invariant_context.h"
+#include "../invariants/shared/hamiltonian_search.h"
 
 //////////////////////////////////////////////////////////////////////////////
 
-void writeWritegraph2d_fixedCycle(GRAPH graph, ADJACENCY adj, FILE *f){
+void writeWritegraph2d_fixedCycle(GRAPH graph, ADJACENCY adj, int *cycleOrder, FILE *f){
     static int first = TRUE;
     int i, j, pos;
     int nv = graph[0][0];
@@ -116,7 +46,7 @@ void writeWritegraph2d_fixedCycle(GRAPH graph, ADJACENCY adj, FILE *f){
     
     int cyclePosition[nv+1];
     
-    for(i = 0; i <= nv; i++){
+    for(i = 0; i < nv; i++){
         cyclePosition[cycleOrder[i]] = i;
     }
     
@@ -127,7 +57,7 @@ void writeWritegraph2d_fixedCycle(GRAPH graph, ADJACENCY adj, FILE *f){
         pos = cyclePosition[i];
         
         //coordinates
-        fprintf(f, "%.4f %.4f ", cos(2*(pos-1)*M_PI/nv), sin(2*(pos-1)*M_PI/nv));
+        fprintf(f, "%.4f %.4f ", cos(2*pos*M_PI/nv), sin(2*pos*M_PI/nv));
         
         //neighbours
         for(j = 0; j<adj[i]; j++){
@@ -197,11 +127,14 @@ int main(int argc, char** argv) {
     int length;
     if (readMultiCode(code, &length, stdin)) {
         decodeMultiCode(code, length, graph, adj);
-        if(findHamiltonianCycle(graph, adj)){
-            writeWritegraph2d_fixedCycle(graph, adj, stdout);
+        INVARIANT_CONTEXT *context = newInvariantContext();
+        HAMILTONIAN_SEARCH *search = prepareHamiltonianSearch(graph, adj, context);
+        if(searchHamiltonianCycle(search)){
+            writeWritegraph2d_fixedCycle(graph, adj, search->path, stdout);
         } else {
             fprintf(stderr, "Error! Graph is not hamiltonian.\n");
         }
+        freeInvariantContext(context);
     } else {
         fprintf(stderr, "Error! Could not read graph.\n");
         return (EXIT_FAILURE);
@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o tutte -O4 tutte.c
+ *     cc -o tutte -O4 tutte.c ../planar/shared/planar_base.c \
+ *         ../planar/shared/planar_input.c ../shared/code_reader.c -lm
  * 
  */
 
@@ -21,66 +22,20 @@
 #include <string.h>
 #include <math.h>
 
+#include "../planar/shared/planar_base.h"
+#include "../planar/shared/planar_input.h"
+#include "../shared/code_reader.h"
 
-#ifndef MAXN
-#define MAXN 64            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
+PLANE_GRAPH *pg = NULL;
 
-#define INFI (MAXN + 1)
+typedef double COORDINATES[2];
 
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
+COORDINATES *coord = NULL;
+COORDINATES *coord2 = NULL; //used as a temporary variable
 
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
+boolean *fixed = NULL;
 
-    int left_facesize; /* size of the face in prev-direction of the edge.
-        		  Only used for -p option. */
-    double x;
-    double y;
-} EDGE;
-
-typedef double COORDINATES[MAXN][2];
-
-typedef int boolean;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-COORDINATES coord;
-COORDINATES coord2; //used as a temporary variable
-
-int fixed[MAXN];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
+int coordinatesSize = 0; //the number of vertices for which there is room
 
 int iterations = 1000;
 int outerface = -1;
@@ -92,17 +47,12 @@ boolean verbose = FALSE;
 int iterationCount;
 double precision = 1e-15;
 
-int nv;
-int ne;
-int nf;
-
-
 //////////////////////////////////////////////////////////////////////////////
 
 void writeWritegraph2d(FILE *f){
     static int first = TRUE;
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     if(first){
         first = FALSE;
@@ -110,7 +60,7 @@ void writeWritegraph2d(FILE *f){
         fprintf(f, ">>writegraph2d<<\n");
     }
     
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < pg->nv; i++){
         //current vertex
         fprintf(f, "%3d ", i+1);
         
@@ -118,7 +68,7 @@ void writeWritegraph2d(FILE *f){
         fprintf(f, "%.4f %.4f ", coord[i][0], coord[i][1]);
         
         //neighbours
-        e = elast = firstedge[i];
+        e = elast = pg->firstedge[i];
         do {
             fprintf(f, "%3d ", e->end+1);
             e = e->next;
@@ -133,11 +83,10 @@ void writeWritegraph2d(FILE *f){
 
 //////////////////////////////////////////////////////////////////////////////
 
-
 int findFaceOnRightSide(int from, int to){
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
-    e = elast = firstedge[from];
+    e = elast = pg->firstedge[from];
     
     if(e->end == to){
         return e->rightface;
@@ -158,9 +107,9 @@ int determineBestOuterface(){
     //just look for the largest face
     int i, maxFace, maxFaceSize = 0;
     
-    for(i = 0; i < nf; i++){
-        if(faceSize[i] > maxFaceSize){
-            maxFaceSize = faceSize[i];
+    for(i = 0; i < pg->nf; i++){
+        if(pg->faceSize[i] > maxFaceSize){
+            maxFaceSize = pg->faceSize[i];
             maxFace = i;
         }
     }
@@ -169,8 +118,8 @@ int determineBestOuterface(){
 }
 
 void embedFace(int face){
-    EDGE *e, *elast;
-    int size = faceSize[face];
+    PG_EDGE *e, *elast;
+    int size = pg->faceSize[face];
     int i = 0;
     int vertex;
     
@@ -178,7 +127,7 @@ void embedFace(int face){
     //make sure that bottom edge of outer face is horizontal
     double startingAngle = (.5*(2.0-size)/size)*M_PI;
     
-    e = elast = facestart[face];
+    e = elast = pg->facestart[face];
     do {
         vertex = e->start;
         coord[vertex][0] = radius*cos(2*i*M_PI/size + startingAngle);
@@ -191,27 +140,27 @@ void embedFace(int face){
 
 void doTutteEmbeddingIterations(){
     int i, j;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     double x, y;
     
     boolean noChanges = FALSE;
     
     for(i = 0; (i < iterations) && (!converge || !noChanges); i++){
         noChanges = TRUE;
-        for(j = 0; j < nv; j++){
+        for(j = 0; j < pg->nv; j++){
             if(!fixed[j]){
                 x = y = 0.0;
-                e = elast = firstedge[j];
+                e = elast = pg->firstedge[j];
                 do {
                     x += coord[e->end][0];
                     y += coord[e->end][1];
                     e = e->next;
                 } while (e != elast);
-                coord2[j][0] = x/degree[j];
-                coord2[j][1] = y/degree[j];
+                coord2[j][0] = x/pg->degree[j];
+                coord2[j][1] = y/pg->degree[j];
             }
         }
-        for(j = 0; j < nv; j++){
+        for(j = 0; j < pg->nv; j++){
             if(!fixed[j]){
                 double distance = hypot(coord[j][0]-coord2[j][0], coord[j][1]-coord2[j][1]);
                 if(distance > precision){
@@ -225,8 +174,23 @@ void doTutteEmbeddingIterations(){
     iterationCount = i;
 }
 
+void growCoordinates(){
+    if(pg->nv <= coordinatesSize){
+        return;
+    }
+    coordinatesSize = pg->nv;
+    coord = (COORDINATES *)realloc(coord, coordinatesSize*sizeof(COORDINATES));
+    coord2 = (COORDINATES *)realloc(coord2, coordinatesSize*sizeof(COORDINATES));
+    fixed = (boolean *)realloc(fixed, coordinatesSize*sizeof(boolean));
+    if(coord == NULL || coord2 == NULL || fixed == NULL){
+        fprintf(stderr, "Insufficient memory for coordinates -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
 void embedGraph(){
     int i;
+    growCoordinates();
     if(outerfaceEdgeFrom!=-1 && outerfaceEdgeTo!=-1){
         outerface = findFaceOnRightSide(outerfaceEdgeFrom, outerfaceEdgeTo);
     } else {
@@ -234,13 +198,13 @@ void embedGraph(){
     }
     
     //embed and fix the vertices of the outerface
-    for(i=0; i<MAXN; i++){
+    for(i=0; i<pg->nv; i++){
         fixed[i] = FALSE;
     }
     embedFace(outerface);
     
     //place remaining vertices at the origin
-    for(i=0; i<nv; i++){
+    for(i=0; i<pg->nv; i++){
         if(!fixed[i]){
             coord[i][0] = coord[i][1] = 0.0;
         }
@@ -253,243 +217,12 @@ void embedGraph(){
     writeWritegraph2d(stdout);
 }
 
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS;
-
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
-
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
-}
-
-/**
- * 
- * @param code
- * @param length
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
     fprintf(stderr, "The program %s generates a tutte embedding for planar graphs.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
-    fprintf(stderr, "graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -i, --iterations #\n");
     fprintf(stderr, "       Specify the number of iterations. Defaults to 1000.\n");
@@ -574,10 +307,12 @@ int main(int argc, char *argv[]) {
     
     int numberOfGraphs = 0;
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    if(readPlanarCode(code, &length, stdin)){
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    if(nextCode(reader, &view)){
+        pg = decodePlanarCodeView(&view, pg, &options);
         embedGraph();
         numberOfGraphs++;
         if(verbose){
@@ -586,8 +321,8 @@ int main(int argc, char *argv[]) {
         }
     }
     if(!onlyOne){
-        while (readPlanarCode(code, &length, stdin)) {
-            decodePlanarCode(code);
+        while (nextCode(reader, &view)) {
+            pg = decodePlanarCodeView(&view, pg, &options);
             embedGraph();
             numberOfGraphs++;
             if(verbose){
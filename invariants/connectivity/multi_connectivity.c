@@ -9,64 +9,47 @@
  * 
  */
 
-#include <string.h>
+#include "multi_connectivity.h"
 
-#include "../../multicode/shared/multicode_base.h"
-    
-//try to find a path from the current vertex to the target
-boolean findPath(GRAPH graph, ADJACENCY adj, int currentVertex, int target, int *paths, int order, boolean* currentPath, int *capacity) {
-    int i;
-    if(currentVertex==target)
-        return TRUE;
-    currentPath[currentVertex]=TRUE;
-    for(i=0; i < adj[currentVertex]; i++){
-        int nextVertex = graph[currentVertex][i];
-        if(paths[currentVertex*(order+1) + nextVertex]-paths[nextVertex*(order+1) + currentVertex]<=capacity[currentVertex*(order+1) + nextVertex]-1 && !currentPath[nextVertex]){
-            paths[currentVertex*(order+1) + nextVertex]++;
-            if(findPath(graph, adj, nextVertex, target, paths, order, currentPath, capacity))
-                return TRUE;
-            else
-                paths[currentVertex*(order+1) + nextVertex]--;
-        }
-    }
-    currentPath[currentVertex]=FALSE;
-    return FALSE;
+#define NEIGHBOUR_MARKS 0
+
+int findMaxFlowInSTNetwork(FLOW_NETWORK *network, int source, int target, int maxValue){
+    resetFlowNetwork(network);
+    setFlowTerminal(network, source, FLOW_SOURCE);
+    setFlowTerminal(network, target, FLOW_TARGET);
+    return computeMaximumFlow(network, maxValue);
 }
 
-//returns the minimum of the maxflow of the st-network and maxValue
-int findMaxFlowInSTNetwork(GRAPH graph, ADJACENCY adj, int source, int target, int maxValue){
+//returns TRUE if the graph has no loops and no multi-edges
+static boolean isSimpleGraph(GRAPH graph, ADJACENCY adj, boolean *isNeighbour){
     int i, j;
-
-    int order = graph[0][0];
-    int paths[(order+1)*(order+1)];
-    int capacity[(order+1)*(order+1)];
-    for(i=0; i<(order+1)*(order+1); i++){
-        paths[i] = 0;
-        capacity[i] = 0;
+    boolean simple = TRUE;
+    
+    for(i = 1; i <= graph[0][0]; i++){
+        isNeighbour[i] = FALSE;
     }
-    for(i = 1; i <= order; i++){
+    for(i = 1; i <= graph[0][0] && simple; i++){
+        isNeighbour[i] = TRUE;
         for(j = 0; j < adj[i]; j++){
-            capacity[i*(order+1) + graph[i][j]]++;
+            if(isNeighbour[graph[i][j]]){
+                simple = FALSE;
+            }
+            isNeighbour[graph[i][j]] = TRUE;
         }
-    }
-    
-    int pathCount = 0;
-    boolean currentPath[order+1];
-    for(i=0; i<(order+1); i++){
-        currentPath[i] = FALSE;
-    }
-    while(findPath(graph, adj, source, target, paths, order, currentPath, capacity) && pathCount < maxValue){
-        pathCount++;
-        for(i=0; i<(order+1); i++){
-            currentPath[i] = FALSE;
+        isNeighbour[i] = FALSE;
+        for(j = 0; j < adj[i]; j++){
+            isNeighbour[graph[i][j]] = FALSE;
         }
     }
-    return pathCount;
+    return simple;
 }
 
-int findEdgeConnectivity(GRAPH graph, ADJACENCY adj){
+int findEdgeConnectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int i;
     int minDegree, vertexMinDegree, minimumCutSize;
+    boolean simple;
+    boolean *isNeighbour;
+    FLOW_NETWORK *network;
     
     minDegree = adj[1];
     vertexMinDegree = 1;
@@ -78,12 +61,24 @@ int findEdgeConnectivity(GRAPH graph, ADJACENCY adj){
         }
     }
     
+    isNeighbour = getInvariantWorkspace(context, NEIGHBOUR_MARKS, sizeof(boolean)*(graph[0][0] + 1));
+    simple = isSimpleGraph(graph, adj, isNeighbour);
+    isNeighbour[vertexMinDegree] = TRUE;
+    for (i = 0; i < adj[vertexMinDegree]; i++){
+        isNeighbour[graph[vertexMinDegree][i]] = TRUE;
+    }
+    
+    /* In a simple graph with edge connectivity less than the minimum degree
+     * both sides of a minimum cut contain more than minDegree vertices, so the
+     * side without vertexMinDegree contains a vertex that is not adjacent to
+     * vertexMinDegree (Esfahanian and Hakimi).
+     */
+    network = prepareEdgeFlowNetwork(graph, adj, context);
     minimumCutSize = minDegree;
     for (i = 1; i <= graph[0][0]; i++){
-        if(i!=vertexMinDegree){
-            minimumCutSize = findMaxFlowInSTNetwork(graph, adj, vertexMinDegree, i, minimumCutSize);
+        if(!isNeighbour[i] || (!simple && i!=vertexMinDegree)){
+            minimumCutSize = findMaxFlowInSTNetwork(network, vertexMinDegree, i, minimumCutSize);
         }
-        //TODO: add optimalisations
     }
     
     return minimumCutSize;
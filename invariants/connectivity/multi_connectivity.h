@@ -8,11 +8,13 @@
 #ifndef MULTI_CONNECTIVITY_H
 #define	MULTI_CONNECTIVITY_H
 
-boolean findPath(GRAPH graph, ADJACENCY adj, int currentVertex, int target, int *paths, int order, boolean* currentPath);
+#include "../../multicode/shared/multicode_base.h"
+#include "../shared/invariant_context.h"
+#include "../shared/flow_network.h"
 
-int findMaxFlowInSTNetwork(GRAPH graph, ADJACENCY adj, int source, int target, int maxValue);
+//returns the minimum of the maxflow of the st-network and maxValue
+int findMaxFlowInSTNetwork(FLOW_NETWORK *network, int source, int target, int maxValue);
 
-int findEdgeConnectivity(GRAPH graph, ADJACENCY adj);
+int findEdgeConnectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
 
 #endif	/* MULTI_CONNECTIVITY_H */
-
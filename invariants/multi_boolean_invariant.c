@@ -17,8 +17,9 @@
  *     multi_boolean_invariant.c \
  *     ../multicode/shared/multicode_base.c \
  *     ../multicode/shared/multicode_input.c \
- *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_invariantname.c
+ *     ../shared/code_reader.c \
+ *     shared/invariant_driver.c shared/invariant_context.c \
+ *     multi_invariant_invariantname.c -pthread
  * 
  * or:
  *     
@@ -28,8 +29,9 @@
  *     multi_boolean_invariant.c \
  *     ../multicode/shared/multicode_base.c \
  *     ../multicode/shared/multicode_input.c \
- *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_invariantname.c
+ *     ../shared/code_reader.c \
+ *     shared/invariant_driver.c shared/invariant_context.c \
+ *     multi_invariant_invariantname.c -pthread
  * 
  */
 
@@ -47,16 +49,50 @@
 
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
-#include "../multicode/shared/multicode_output.h"
+#include "shared/invariant_driver.h"
 
 #define XSTR(s) STR(s)
 #define STR(s) #s
 
-boolean INVARIANT(GRAPH graph, ADJACENCY adj);
+boolean INVARIANT(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
 
 int graphCount = 0;
 int graphsFiltered = 0;
 
+boolean doFiltering = FALSE;
+boolean invert = FALSE;
+
+void computeInvariant(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context, void *result){
+    *((boolean *)result) = INVARIANT(graph, adj, context);
+}
+
+/* Writes the code of the graph to stdout as it was read, so the graph does not
+ * have to be decoded again.
+ */
+void writeGraph(CODE_VIEW *view){
+    writeCodeView(view, graphsFiltered ? NULL : MULTICODE_HEADER, stdout);
+    graphsFiltered++;
+}
+
+void handleResult(unsigned long long graphNumber, CODE_VIEW *view, void *result, void *data){
+    boolean value = *((boolean *)result);
+    graphCount = graphNumber;
+    
+    if(doFiltering){
+        if(invert && !value){
+            writeGraph(view);
+        } else if(!invert && value){
+            writeGraph(view);
+        }
+    } else {
+        if(value){
+            fprintf(stdout, "Graph %d has the property " XSTR(INVARIANTNAME) ".\n", graphCount);
+        } else {
+            fprintf(stdout, "Graph %d does not have the property " XSTR(INVARIANTNAME) ".\n", graphCount);
+        }
+    }
+}
+
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -70,6 +106,8 @@ void help(char *name) {
     fprintf(stderr, "       Filter graphs that have the property.\n");
     fprintf(stderr, "    -i, --invert\n");
     fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -j #, --threads #\n");
+    fprintf(stderr, "       Compute the invariant with the specified number of threads.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -84,11 +122,7 @@ void usage(char *name) {
  */
 int main(int argc, char** argv) {
     
-    GRAPH graph;
-    ADJACENCY adj;
-    
-    boolean doFiltering = FALSE;
-    boolean invert = FALSE;
+    int threads = 1;
 
     /*=========== commandline parsing ===========*/
 
@@ -97,11 +131,12 @@ int main(int argc, char** argv) {
     static struct option long_options[] = {
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
+        {"threads", required_argument, NULL, 'j'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hfi", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hfij:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'i':
                 invert = TRUE;
@@ -109,6 +144,9 @@ int main(int argc, char** argv) {
             case 'f':
                 doFiltering = TRUE;
                 break;
+            case 'j':
+                threads = atoi(optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -122,29 +160,9 @@ int main(int argc, char** argv) {
         }
     }
     
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
-        graphCount++;
-        
-        boolean value = INVARIANT(graph, adj);
-        if(doFiltering){
-            if(invert && !value){
-                graphsFiltered++;
-                writeMultiCode(graph, adj, stdout);
-            } else if(!invert && value){
-                graphsFiltered++;
-                writeMultiCode(graph, adj, stdout);
-            }
-        } else {
-            if(value){
-                fprintf(stdout, "Graph %d has the property " XSTR(INVARIANTNAME) ".\n", graphCount);
-            } else {
-                fprintf(stdout, "Graph %d does not have the property " XSTR(INVARIANTNAME) ".\n", graphCount);
-            }
-        }
-    }
+    CODE_READER *reader = newMultiCodeReader(stdin);
+    runInvariant(reader, threads, computeInvariant, sizeof(boolean), handleResult, NULL);
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", graphCount, graphCount==1 ? "" : "s");
     if(doFiltering){
@@ -18,7 +18,9 @@
  *     ../multicode/shared/multicode_base.c \
  *     ../multicode/shared/multicode_input.c \
  *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_invariantname.c
+ *     ../shared/code_reader.c \
+ *     shared/invariant_driver.c shared/invariant_context.c \
+ *     multi_invariant_invariantname.c -pthread
  * 
  * or:
  *     
@@ -29,7 +31,9 @@
  *     ../multicode/shared/multicode_base.c \
  *     ../multicode/shared/multicode_input.c \
  *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_invariantname.c
+ *     ../shared/code_reader.c \
+ *     shared/invariant_driver.c shared/invariant_context.c \
+ *     multi_invariant_invariantname.c -pthread
  * 
  */
 
@@ -48,15 +52,70 @@
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
 #include "../multicode/shared/multicode_output.h"
+#include "shared/invariant_driver.h"
 
 #define XSTR(s) STR(s)
 #define STR(s) #s
 
-int INVARIANT(GRAPH graph, ADJACENCY adj);
+int INVARIANT(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
 
 int graphCount = 0;
 int graphsFiltered = 0;
 
+int filterValue;
+boolean doFiltering = FALSE;
+boolean findMinimum = FALSE;
+boolean findMaximum = FALSE;
+
+boolean allowEqual = TRUE;
+boolean allowLess = FALSE;
+boolean allowGreater = FALSE;
+
+int maximum = INT_MIN;
+int minimum = INT_MAX;
+int extremumGraph = -1;
+
+//used to decode the graphs that are written to the output
+GRAPH outputGraph;
+ADJACENCY outputAdj;
+
+void computeInvariant(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context, void *result){
+    *((int *)result) = INVARIANT(graph, adj, context);
+}
+
+void writeGraph(CODE_VIEW *view){
+    graphsFiltered++;
+    decodeMultiCodeView(view, outputGraph, outputAdj, MULTICODE_DECODE_NO_SENTINELS);
+    writeMultiCode(outputGraph, outputAdj, stdout);
+}
+
+void handleResult(unsigned long long graphNumber, CODE_VIEW *view, void *result, void *data){
+    int value = *((int *)result);
+    graphCount = graphNumber;
+    
+    if(doFiltering){
+        if(allowEqual && filterValue == value){
+            writeGraph(view);
+        } else if(allowLess && filterValue > value){
+            writeGraph(view);
+        } else if(allowGreater && filterValue < value){
+            writeGraph(view);
+        }
+    } else if(findMaximum) {
+        if(value>maximum){
+            maximum = value;
+            extremumGraph = graphCount;
+        }
+    } else if(findMinimum) {
+        if(value<minimum){
+            minimum = value;
+            extremumGraph = graphCount;
+        }
+    } else {
+        fprintf(stdout, "Graph %d has " XSTR(INVARIANTNAME) " equal to %d.\n", graphCount, value);
+    }
+}
+
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -78,6 +137,8 @@ void help(char *name) {
     fprintf(stderr, "       Find the graph with the smallest value.\n");
     fprintf(stderr, "    -M, --maximum\n");
     fprintf(stderr, "       Find the graph with the largest value.\n");
+    fprintf(stderr, "    -j #, --threads #\n");
+    fprintf(stderr, "       Compute the invariant with the specified number of threads.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -92,17 +153,7 @@ void usage(char *name) {
  */
 int main(int argc, char** argv) {
     
-    GRAPH graph;
-    ADJACENCY adj;
-    
-    int filterValue;
-    boolean doFiltering = FALSE;
-    boolean findMinimum = FALSE;
-    boolean findMaximum = FALSE;
-    
-    boolean allowEqual = TRUE;
-    boolean allowLess = FALSE;
-    boolean allowGreater = FALSE;
+    int threads = 1;
 
     /*=========== commandline parsing ===========*/
 
@@ -115,11 +166,12 @@ int main(int argc, char** argv) {
         {"minimum", no_argument, NULL, 'm'},
         {"maximum", no_argument, NULL, 'M'},
         {"filter", required_argument, NULL, 'f'},
+        {"threads", required_argument, NULL, 'j'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hf:lgnmM", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hf:lgnmMj:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'n':
                 allowEqual = FALSE;
@@ -137,6 +189,9 @@ int main(int argc, char** argv) {
             case 'm':
                 findMinimum = TRUE;
                 break;
+            case 'j':
+                threads = atoi(optarg);
+                break;
             case 'M':
                 findMaximum = TRUE;
                 break;
@@ -153,41 +208,9 @@ int main(int argc, char** argv) {
         }
     }
     
-    int maximum = INT_MIN;
-    int minimum = INT_MAX;
-    int extremumGraph = -1;
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
-        graphCount++;
-        
-        int value = INVARIANT(graph, adj);
-        if(doFiltering){
-            if(allowEqual && filterValue == value){
-                graphsFiltered++;
-                writeMultiCode(graph, adj, stdout);
-            } else if(allowLess && filterValue > value){
-                graphsFiltered++;
-                writeMultiCode(graph, adj, stdout);
-            } else if(allowGreater && filterValue < value){
-                graphsFiltered++;
-                writeMultiCode(graph, adj, stdout);
-            }
-        } else if(findMaximum) {
-            if(value>maximum){
-                maximum = value;
-                extremumGraph = graphCount;
-            }
-        } else if(findMinimum) {
-            if(value<minimum){
-                minimum = value;
-                extremumGraph = graphCount;
-            }
-        } else {
-            fprintf(stdout, "Graph %d has " XSTR(INVARIANTNAME) " equal to %d.\n", graphCount, value);
-        }
-    }
+    CODE_READER *reader = newMultiCodeReader(stdin);
+    runInvariant(reader, threads, computeInvariant, sizeof(int), handleResult, NULL);
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", graphCount, graphCount==1 ? "" : "s");
     if(doFiltering){
@@ -19,56 +19,199 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 
-int colourGraph(GRAPH graph, ADJACENCY adj, int* graphPartition, int currentVertex, int maximumColours){
-    int i, j, partitionCount;
-    //first see how many partitions we have
-    partitionCount = 0;
-    for(i = 1; i < currentVertex; i++){
-        if(graphPartition[i]==i){
-            partitionCount++;
+#define SEARCH 0
+#define NEIGHBOURHOODS 1
+#define COLOUR_CLASSES 2
+#define COLOUR 3
+#define SATURATION 4
+#define DEGREE 5
+#define CANDIDATES 6
+
+typedef unsigned long long int bitset;
+
+//vertex v is stored in bit v-1
+#define WORD(v) (((v) - 1) >> 6)
+#define SINGLETON(v) (1ULL << (((v) - 1) & 63))
+#define CONTAINS(s, v) ((s)[WORD(v)] & SINGLETON(v))
+#define ADD(s, v) ((s)[WORD(v)] |= SINGLETON(v))
+#define REMOVE(s, v) ((s)[WORD(v)] &= ~SINGLETON(v))
+
+//the vertex that corresponds to the lowest bit of the non-empty word w
+#define FIRST_VERTEX(word, w) (64*(w) + __builtin_ctzll(word) + 1)
+
+#define NEIGHBOURS(search, v) ((search)->neighbourhoods + (v)*(search)->words)
+#define COLOUR_CLASS(search, c) ((search)->colourClasses + (c)*(search)->words)
+
+/* A branch and bound search for a colouring with fewer colours than the best
+ * colouring found so far. The next vertex to colour is always an uncoloured
+ * vertex with the most different colours among its neighbours (DSATUR). A
+ * vertex can only receive one new colour, namely the smallest unused one, so
+ * colourings that only differ by a permutation of the colours are only
+ * generated once.
+ */
+typedef struct __colouring_search {
+    int order;
+    int words;
+
+    bitset *neighbourhoods;
+    //the vertices with colour c, for c in 1..order
+    bitset *colourClasses;
+
+    //the colour of each vertex or 0 if the vertex is not yet coloured
+    int *colour;
+    //the number of different colours among the neighbours of each vertex
+    int *saturation;
+    //the number of different neighbours of each vertex
+    int *degree;
+
+    int colouredCount;
+    int usedColours;
+
+    int bestColourCount;
+    int lowerBound;
+} COLOURING_SEARCH;
+
+static boolean isEmptyIntersection(bitset *set1, bitset *set2, int words){
+    int w;
+    for(w = 0; w < words; w++){
+        if(set1[w] & set2[w]){
+            return FALSE;
         }
     }
-    
-    if(partitionCount >= maximumColours){
-        //we won't find anything better with this partition
-        return maximumColours;
+    return TRUE;
+}
+
+/* Adds v to colour class c and updates the saturation of the uncoloured
+ * neighbours for which c is a new colour.
+ */
+static void assignColour(COLOURING_SEARCH *search, int v, int c){
+    int w;
+    bitset *neighbours = NEIGHBOURS(search, v);
+    bitset *colourClass = COLOUR_CLASS(search, c);
+
+    for(w = 0; w < search->words; w++){
+        bitset word = neighbours[w];
+        while(word){
+            int u = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            if(!search->colour[u] && isEmptyIntersection(NEIGHBOURS(search, u), colourClass, search->words)){
+                search->saturation[u]++;
+            }
+        }
     }
-    if(currentVertex > graph[0][0]){
-        //all vertices have been coloured, and partitionCount is less than maximumColours
-        return partitionCount;
+    ADD(colourClass, v);
+    search->colour[v] = c;
+    search->colouredCount++;
+}
+
+static void removeColour(COLOURING_SEARCH *search, int v){
+    int w;
+    bitset *neighbours = NEIGHBOURS(search, v);
+    bitset *colourClass = COLOUR_CLASS(search, search->colour[v]);
+
+    REMOVE(colourClass, v);
+    search->colour[v] = 0;
+    search->colouredCount--;
+    for(w = 0; w < search->words; w++){
+        bitset word = neighbours[w];
+        while(word){
+            int u = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            if(!search->colour[u] && isEmptyIntersection(NEIGHBOURS(search, u), colourClass, search->words)){
+                search->saturation[u]--;
+            }
+        }
     }
-    
-    //colour the current vertex
-    
-    //first try all existing colour classes
-    for(i = 1; i < currentVertex; i++){
-        if(graphPartition[i]==i){
-            boolean canGoInThisPartition = TRUE;
-            j = 0;
-            while(canGoInThisPartition && j < adj[currentVertex]){
-                //the vertex can go in this partition if all of its neighbours
-                //are either not in a colour class or in a different colour class
-                canGoInThisPartition = (graph[currentVertex][j] > currentVertex) ||
-                        (graphPartition[graph[currentVertex][j]] != i);
-                j++;
+}
+
+static void colourGraph(COLOURING_SEARCH *search){
+    int v, c, next = 0;
+
+    if(search->colouredCount == search->order){
+        //only colourings with less colours than the best one are generated
+        search->bestColourCount = search->usedColours;
+        return;
+    }
+
+    for(v = 1; v <= search->order; v++){
+        if(!search->colour[v] && (!next ||
+                search->saturation[v] > search->saturation[next] ||
+                (search->saturation[v] == search->saturation[next] &&
+                search->degree[v] > search->degree[next]))){
+            next = v;
+        }
+    }
+
+    if(search->saturation[next] + 1 >= search->bestColourCount){
+        //this vertex needs a colour that is not better than the best colouring
+        return;
+    }
+
+    for(c = 1; c <= search->usedColours; c++){
+        if(isEmptyIntersection(NEIGHBOURS(search, next), COLOUR_CLASS(search, c), search->words)){
+            assignColour(search, next, c);
+            colourGraph(search);
+            removeColour(search, next);
+            if(search->bestColourCount == search->lowerBound ||
+                    search->usedColours >= search->bestColourCount){
+                return;
             }
-            if(canGoInThisPartition){
-                graphPartition[currentVertex] = i;
-                maximumColours = colourGraph(graph, adj, graphPartition, currentVertex + 1, maximumColours);
+        }
+    }
+
+    if(search->usedColours + 1 < search->bestColourCount){
+        search->usedColours++;
+        assignColour(search, next, search->usedColours);
+        colourGraph(search);
+        removeColour(search, next);
+        search->usedColours--;
+    }
+}
+
+/* Greedily grows a clique from start by repeatedly adding the candidate with
+ * the largest degree and returns its size. If colour is TRUE, each vertex of
+ * the clique receives a new colour.
+ */
+static int growClique(COLOURING_SEARCH *search, int start, bitset *candidates, boolean colour){
+    int u, w, size = 1;
+    int words = search->words;
+
+    for(w = 0; w < words; w++){
+        candidates[w] = NEIGHBOURS(search, start)[w];
+    }
+    if(colour){
+        assignColour(search, start, ++search->usedColours);
+    }
+    while(!isEmptyIntersection(candidates, candidates, words)){
+        int best = 0;
+        for(w = 0; w < words; w++){
+            bitset word = candidates[w];
+            while(word){
+                u = FIRST_VERTEX(word, w);
+                word &= word - 1;
+                if(!best || search->degree[u] > search->degree[best]){
+                    best = u;
+                }
             }
         }
+        for(w = 0; w < words; w++){
+            candidates[w] &= NEIGHBOURS(search, best)[w];
+        }
+        if(colour){
+            assignColour(search, best, ++search->usedColours);
+        }
+        size++;
     }
-    
-    //finally try to put the vertex in a new colour class
-    graphPartition[currentVertex] = currentVertex;
-    maximumColours = colourGraph(graph, adj, graphPartition, currentVertex + 1, maximumColours);
-    
-    return maximumColours;
+    return size;
 }
 
-int chromaticNumber(GRAPH graph, ADJACENCY adj){
-    int i, minDeg, maxDeg, n;
+int chromaticNumber(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int i, v, minDeg, maxDeg, n, words, cliqueStart = 1;
+    COLOURING_SEARCH *search;
+    bitset *candidates;
     
     n = graph[0][0];
     
@@ -76,15 +219,9 @@ int chromaticNumber(GRAPH graph, ADJACENCY adj){
         return 0;
     }
     
-    minDeg = maxDeg = adj[1];
-    
-    for(i=2; i<=n; i++){
-        if(adj[i] < minDeg){
-            minDeg = adj[i];
-        } else if(adj[i] > maxDeg){
-            maxDeg = adj[i];
-        }
-    }
+    INVARIANT_GRAPH_DATA *degrees = getDegreeData(graph, adj, context);
+    minDeg = degrees->minimumDegree;
+    maxDeg = degrees->maximumDegree;
     
     if((maxDeg == n - 1) && (minDeg == n - 1)){
         return n; //complete graph
@@ -94,12 +231,51 @@ int chromaticNumber(GRAPH graph, ADJACENCY adj){
         return 1; //no edges
     }
     
-    int graphPartition[MAXN + 1];
+    words = (n + 63)/64;
+    search = getInvariantWorkspace(context, SEARCH, sizeof(COLOURING_SEARCH));
+    search->order = n;
+    search->words = words;
+    search->neighbourhoods = getInvariantWorkspace(context, NEIGHBOURHOODS, sizeof(bitset)*words*(n + 1));
+    search->colourClasses = getInvariantWorkspace(context, COLOUR_CLASSES, sizeof(bitset)*words*(n + 1));
+    search->colour = getInvariantWorkspace(context, COLOUR, sizeof(int)*(n + 1));
+    search->saturation = getInvariantWorkspace(context, SATURATION, sizeof(int)*(n + 1));
+    search->degree = getInvariantWorkspace(context, DEGREE, sizeof(int)*(n + 1));
+    candidates = getInvariantWorkspace(context, CANDIDATES, sizeof(bitset)*words);
     
-    //initially all vertices are in the same partition
-    for(i = 1; i <= MAXN; i++){
-        graphPartition[i] = 1;
+    for(i = 0; i < words*(n + 1); i++){
+        search->neighbourhoods[i] = search->colourClasses[i] = 0ULL;
     }
+    for(v = 1; v <= n; v++){
+        //loops are ignored and multi-edges are only stored once
+        for(i = 0; i < adj[v]; i++){
+            if(graph[v][i] != v){
+                ADD(NEIGHBOURS(search, v), graph[v][i]);
+            }
+        }
+        search->colour[v] = search->saturation[v] = search->degree[v] = 0;
+        for(i = 0; i < words; i++){
+            search->degree[v] += __builtin_popcountll(NEIGHBOURS(search, v)[i]);
+        }
+    }
+    search->colouredCount = search->usedColours = 0;
+    
+    //greedy colouring never needs more than maxDeg + 1 colours
+    search->bestColourCount = maxDeg + 1;
+    search->lowerBound = 0;
+    for(v = 1; v <= n; v++){
+        int size = growClique(search, v, candidates, FALSE);
+        if(size > search->lowerBound){
+            search->lowerBound = size;
+            cliqueStart = v;
+        }
+    }
+    if(search->lowerBound >= search->bestColourCount){
+        return search->bestColourCount;
+    }
+    
+    //the vertices of the clique can be given the first colours
+    growClique(search, cliqueStart, candidates, TRUE);
+    colourGraph(search);
     
-    return colourGraph(graph, adj, graphPartition, 2, maxDeg + 1);
+    return search->bestColourCount;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
 #include <stdio.h>
 
 typedef unsigned long long int bitset;
@@ -47,12 +48,12 @@ typedef unsigned long long int bitset;
 #define SAFE_REMOVE_ALL(s, elements) ADD_ALL(s, elements); REMOVE_ALL(s, elements)
 
 
-boolean handleSimpleCycle(bitset verticesInCycle, bitset universalNeighbours){
+static boolean handleSimpleCycle(bitset verticesInCycle, bitset universalNeighbours){
     //if there is a universal neighbour then we have a wheel
     return universalNeighbours ? TRUE : FALSE;
 }
 
-boolean checkSimpleCycles_impl(
+static boolean checkSimpleCycles_impl(
             GRAPH graph, ADJACENCY adj, int firstVertex,
             int secondVertex, int currentVertex, bitset *verticesInCycle,
             bitset universalNeighbours, bitset neighbourhoods[]){
@@ -94,7 +95,7 @@ boolean checkSimpleCycles_impl(
 /* Returns TRUE if the graph contains a wheel. Check all cycles and check whether
  * there is a central vertex adjacent to each vertex of the cycle.
  */
-boolean containsWheel(GRAPH graph, ADJACENCY adj){
+boolean containsWheel(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int v, i;
     int order = graph[0][0];
     bitset neighbourhoods[order+1];
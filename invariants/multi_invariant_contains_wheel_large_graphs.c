@@ -12,7 +12,7 @@
  * Compile like this:
  *     
  *     cc -o multi_invariant_contains_wheel_large_graphs -O4
- *     -DINVARIANT=containsWheel \
+ *     -DINVARIANT=containsWheelLargeGraphs \
  *     multi_boolean_invariant.c \
  *     ../multicode/shared/multicode_base.c\
  *     ../multicode/shared/multicode_input.c \
@@ -21,22 +21,38 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
 #include <stdio.h>
 
-boolean verticesInCycle[MAXN+1];
-boolean neighbourhoods[MAXN+1][MAXN+1];
-boolean universalNeighbours[MAXN+1][MAXN+1];
+#define VERTICES_IN_CYCLE 0
+#define NEIGHBOURHOODS 1
+#define UNIVERSAL_NEIGHBOURS 2
 
-boolean handleSimpleCycle(int universalNeighbourCount){
+/* The matrices have order+1 rows of order+1 entries. Row i of
+ * universalNeighbours contains the common neighbours of the first i vertices
+ * of the current cycle.
+ */
+typedef struct __wheel_search {
+    boolean *verticesInCycle;
+    boolean *neighbourhoods;
+    boolean *universalNeighbours;
+    int rowSize;
+} WHEEL_SEARCH;
+
+#define neighbourhoods(search, v, w) ((search)->neighbourhoods[(v)*(search)->rowSize + (w)])
+#define universalNeighbours(search, size, w) ((search)->universalNeighbours[(size)*(search)->rowSize + (w)])
+
+static boolean handleSimpleCycle(int universalNeighbourCount){
     //if there is a universal neighbour then we have a wheel
     return universalNeighbourCount > 0 ? TRUE : FALSE;
 }
 
-boolean checkSimpleCycles_impl(
-            GRAPH graph, ADJACENCY adj, int firstVertex,
+static boolean checkSimpleCycles_impl(
+            GRAPH graph, ADJACENCY adj, WHEEL_SEARCH *search, int firstVertex,
             int secondVertex, int currentVertex, int size,
             int universalNeighbourCount){
     int i, w;
+    boolean *verticesInCycle = search->verticesInCycle;
     for(i=0; i<adj[currentVertex]; i++){
         int neighbour = graph[currentVertex][i];
         if((neighbour != firstVertex) && verticesInCycle[neighbour]){
@@ -61,15 +77,15 @@ boolean checkSimpleCycles_impl(
             //compute the new universal neighbours
             int universalNeighbourCount = 0;
             for(w = 1; w <= graph[0][0]; w++){
-                universalNeighbours[size + 1][w] = universalNeighbours[size][w] &&
-                        neighbourhoods[neighbour][w];
-                if(universalNeighbours[size + 1][w]){
+                universalNeighbours(search, size + 1, w) = universalNeighbours(search, size, w) &&
+                        neighbourhoods(search, neighbour, w);
+                if(universalNeighbours(search, size + 1, w)){
                     universalNeighbourCount++;
                 }
             }
                 
             if(universalNeighbourCount && 
-                    checkSimpleCycles_impl(graph, adj, firstVertex, secondVertex,
+                    checkSimpleCycles_impl(graph, adj, search, firstVertex, secondVertex,
                     neighbour, size+1, universalNeighbourCount)){
                 return TRUE;
             }
@@ -82,16 +98,27 @@ boolean checkSimpleCycles_impl(
 /* Returns TRUE if the graph contains a wheel. Check all cycles and check whether
  * there is a central vertex adjacent to each vertex of the cycle.
  */
-boolean containsWheel(GRAPH graph, ADJACENCY adj){
+boolean containsWheelLargeGraphs(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int v, w, i;
     int order = graph[0][0];
+    WHEEL_SEARCH search;
+    boolean *verticesInCycle;
+    
+    search.rowSize = order + 1;
+    search.verticesInCycle = verticesInCycle =
+            getInvariantWorkspace(context, VERTICES_IN_CYCLE, sizeof(boolean)*(order + 1));
+    search.neighbourhoods = getInvariantWorkspace(context, NEIGHBOURHOODS,
+            sizeof(boolean)*(order + 1)*(order + 1));
+    search.universalNeighbours = getInvariantWorkspace(context, UNIVERSAL_NEIGHBOURS,
+            sizeof(boolean)*(order + 1)*(order + 1));
     
     for(v = 1; v <= order; v++){
+        verticesInCycle[v] = FALSE;
         for(w=1; w <= order; w++){
-            neighbourhoods[v][w] = FALSE;
+            neighbourhoods(&search, v, w) = FALSE;
         }
         for(i=0; i<adj[v]; i++){
-            neighbourhoods[v][graph[v][i]] = TRUE;
+            neighbourhoods(&search, v, graph[v][i]) = TRUE;
         }
     }
     
@@ -108,14 +135,14 @@ boolean containsWheel(GRAPH graph, ADJACENCY adj){
                 
                 int universalNeighbourCount = 0;
                 for(w = 1; w <= order; w++){
-                    universalNeighbours[2][w] = neighbourhoods[v][w] &&
-                            neighbourhoods[neighbour][w];
-                    if(universalNeighbours[2][w]){
+                    universalNeighbours(&search, 2, w) = neighbourhoods(&search, v, w) &&
+                            neighbourhoods(&search, neighbour, w);
+                    if(universalNeighbours(&search, 2, w)){
                         universalNeighbourCount++;
                     }
                 }
                 if(universalNeighbourCount && 
-                        checkSimpleCycles_impl(graph, adj, v, neighbour, neighbour,
+                        checkSimpleCycles_impl(graph, adj, &search, v, neighbour, neighbour,
                         2, universalNeighbourCount)){
                     return TRUE;
                 }
@@ -20,8 +20,13 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 #include "connectivity/multi_connectivity.h"
 
-int edge_connectivity(GRAPH graph, ADJACENCY adj){
-    return findEdgeConnectivity(graph, adj);
+int edge_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    if(!isConnectedGraph(graph, adj, context)){
+        return 0;
+    }
+    return findEdgeConnectivity(graph, adj, context);
 }
\ No newline at end of file
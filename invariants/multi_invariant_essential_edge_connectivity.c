@@ -20,51 +20,28 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
-#include "connectivity/multi_connectivity.h"
-
-#include <stdio.h>
+#include "shared/invariant_context.h"
+#include "shared/flow_network.h"
 
 /*
- * Contract the edges (from1, to1) and (from2, to2). This function assumes that the edges
- * are disjoint. The result is stored in the new graph. The newly formed vertices
- * have number 1 and 2.
+ * Returns the minimum of maxValue and the maximum flow from the edge
+ * (from1, to1) to the edge (from2, to2), i.e., the maximum flow in the graph
+ * in which both edges are contracted. This function assumes that the edges
+ * are disjoint.
  */
-void contractEdges(GRAPH oldGraph, ADJACENCY oldAdj, GRAPH newGraph, ADJACENCY newAdj, int from1, int to1, int from2, int to2){
-    int i, j;
-    int order = oldGraph[0][0];
-    int old2new[order+1];
-    for(i=1; i<=order; i++){
-        old2new[i]=-1;
-    }
-    
-    int newVertexCounter = 1;
-    old2new[from1] = old2new[to1] = newVertexCounter++;
-    old2new[from2] = old2new[to2] = newVertexCounter++;
-    for(i=1; i<=order; i++){
-        if(old2new[i]==-1){
-            old2new[i] = newVertexCounter++;
-        }
-    }
-    
-    prepareGraph(newGraph, newAdj, order-2);
-    
-    for(i=1; i<=order; i++){
-        for(j=0; j<oldAdj[i]; j++){
-            int neighbour = oldGraph[i][j];
-            if((i==from1 && neighbour==to1) || (i==to1 && neighbour==from1)) continue;
-            if((i==from2 && neighbour==to2) || (i==to2 && neighbour==from2)) continue;
-            if(i < neighbour){
-                addEdge(newGraph, newAdj, old2new[i], old2new[neighbour]);
-            }
-        }
-    }
+static int findMaxFlowBetweenEdges(FLOW_NETWORK *network, int from1, int to1, int from2, int to2, int maxValue){
+    resetFlowNetwork(network);
+    setFlowTerminal(network, from1, FLOW_SOURCE);
+    setFlowTerminal(network, to1, FLOW_SOURCE);
+    setFlowTerminal(network, from2, FLOW_TARGET);
+    setFlowTerminal(network, to2, FLOW_TARGET);
+    return computeMaximumFlow(network, maxValue);
 }
 
-int findEssentialEdgeConnectivity(GRAPH graph, ADJACENCY adj){
+static int findEssentialEdgeConnectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int i, j, i2, j2;
-    GRAPH modifiedGraph;
-    ADJACENCY modifiedAdj;
     int minimumCutSize;
+    FLOW_NETWORK *network;
     
     minimumCutSize = graph[0][0]*(graph[0][0]-1)/2;
     
@@ -76,14 +53,14 @@ int findEssentialEdgeConnectivity(GRAPH graph, ADJACENCY adj){
         }
     }
     
+    network = prepareEdgeFlowNetwork(graph, adj, context);
     for (i = 1; i <= graph[0][0]; i++){
         for(j = 0; j < adj[i]; j++){
             if(i<graph[i][j]){
                 for (i2 = i+1; i2 <= graph[0][0]; i2++){
                     for(j2 = 0; j2 < adj[i2]; j2++){
                         if(i2<graph[i2][j2] && i < i2 && graph[i][j]!=i2 && graph[i][j]!=graph[i2][j2]){
-                            contractEdges(graph, adj, modifiedGraph, modifiedAdj, i, graph[i][j], i2, graph[i2][j2]);
-                            minimumCutSize = findMaxFlowInSTNetwork(modifiedGraph, modifiedAdj, 1, 2, minimumCutSize);
+                            minimumCutSize = findMaxFlowBetweenEdges(network, i, graph[i][j], i2, graph[i2][j2], minimumCutSize);
                         }
                     }
                 }
@@ -94,6 +71,6 @@ int findEssentialEdgeConnectivity(GRAPH graph, ADJACENCY adj){
     return minimumCutSize;
 }
 
-int essential_edge_connectivity(GRAPH graph, ADJACENCY adj){
-    return findEssentialEdgeConnectivity(graph, adj);
+int essential_edge_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return findEssentialEdgeConnectivity(graph, adj, context);
 }
\ No newline at end of file
@@ -19,67 +19,10 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/girth.h"
 
-/**
-  * Return the minimum of the given girth and the length of the shortest
-  * cycle through the given vertex.
-  */
-int pseudoGirth(GRAPH graph, ADJACENCY adj, int v, int girth) {
-    int i;
-    
-    int n = graph[0][0];
-        
-    int queue[n];
-    int head = 0;
-    int tail = 0;
-
-    int levels[n+1];
-    for(i=1; i<=n; i++){
-        levels[i]=-1;
-    }
-    queue[head] = v;
-
-    int lim = girth / 2;
-
-    head ++;
-    levels[v] = 0;
-    while (head > tail) {
-        int vertex = queue[tail];
-        int d = levels[vertex];
-        if (d >= lim)
-            return girth; // can never improve current girth
-        tail ++;
-        for (i=0; i<adj[vertex]; i++) {
-            int nb = graph[vertex][i];
-            int e = levels[nb];
-            if (e < 0) {
-                // not yet encountered
-                levels[nb] = d+1;
-                queue[head] = nb;
-                head ++;
-            } else if (e == d) {
-                // odd cycle
-                return 2*d + 1;
-            } else if (e > d) {
-                // even cycle
-                if (girth > 2*e) {
-                    girth = 2*e; // == 2*d+2
-                }
-            } //else {
-                // returns towards v, ignore
-            //}
-        }
-    }
-    return girth;
-}
-
-int girth(GRAPH graph, ADJACENCY adj){
-    int i;
-    int girth = graph[0][0];
-    
-    for(i=1; i<=graph[0][0]; i++){
-        girth = pseudoGirth(graph, adj, i, girth);
-    }
-    
-    return girth;
+int girth(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    //an acyclic graph gets its order as girth
+    return computeGirth(graph, adj, graph[0][0], context);
 }
\ No newline at end of file
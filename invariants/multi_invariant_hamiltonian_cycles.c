@@ -19,62 +19,72 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-#if INVARIANT == hamiltonianCyclesEdgeIncidence
-#define CONSTRUCT_CYCLE
-#define HANDLE_CYCLE countCycleEdgeIncidence
-#endif
+#define CURRENT_CYCLE 0
+#define CURRENT_CYCLE_VERTEX_ORDER 1
+#define CYCLE_EDGE_INCIDENCE 2
+#define WALKS 3
+#define NEXT_WALKS 4
 
-#if INVARIANT == hamiltonianCyclesUniversalEdges
-#define CONSTRUCT_CYCLE
-#define HANDLE_CYCLE countCycleEdgeIncidence
-#endif
+//the subsets of the vertices other than vertex 1 are stored in a 64-bit word
+#define INCLUSION_EXCLUSION_MAXIMUM_ORDER 64
+//vertex 1 is in every subset and vertex v > 1 is in the subset if bit v-2 is set
+#define IN_SUBSET(subset, v) ((v) == 1 || (((subset) >> ((v) - 2)) & 1ULL))
 
-#if INVARIANT == hamiltonianCyclesUncoveredEdges
-#define CONSTRUCT_CYCLE
-#define HANDLE_CYCLE countCycleEdgeIncidence
-#endif
+#define BACKEND_ENUMERATION 0
+#define BACKEND_INCLUSION_EXCLUSION 1
 
-#ifndef HANDLE_CYCLE
-#define HANDLE_CYCLE countCycle
-#endif
-
-unsigned int cycleCount;
-boolean currentCycle[MAXN+1];
-
-//this array will only be filled if the macro CONSTRUCT_CYCLE is defined
-int currentCycleVertexOrder[MAXN];
+typedef struct __cycle_search {
+    unsigned int cycleCount;
+    boolean *currentCycle;
+    
+    /* If constructCycle is TRUE, the order of the vertices in the cycle is
+     * stored and the edge incidences are counted for each cycle.
+     */
+    boolean constructCycle;
+    
+    //these arrays will only be used if constructCycle is TRUE
+    int *currentCycleVertexOrder;
+    //the number of cycles that contain the edge (i,j) is stored at position i*(order+1) + j
+    int *cycleEdgeIncidenceMatrix;
+    int cycleEdgeIncidenceRow;
+} CYCLE_SEARCH;
 
-int cycleEdgeIncidence[MAXN][MAXN];
+#define cycleEdgeIncidence(search, i, j) (search)->cycleEdgeIncidenceMatrix[(i)*(search)->cycleEdgeIncidenceRow + (j)]
 
-void countCycle(GRAPH graph, ADJACENCY adj){
-    cycleCount++;
+static void countCycle(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search){
+    search->cycleCount++;
 }
 
-void countCycleEdgeIncidence(GRAPH graph, ADJACENCY adj){
+static void countCycleEdgeIncidence(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search){
     int i;
+    int *currentCycleVertexOrder = search->currentCycleVertexOrder;
     
-    cycleCount++;
+    search->cycleCount++;
     
     for(i = 1; i < graph[0][0]; i++){
-        cycleEdgeIncidence[currentCycleVertexOrder[i-1]][currentCycleVertexOrder[i]]++;
-        cycleEdgeIncidence[currentCycleVertexOrder[i]][currentCycleVertexOrder[i-1]]++;
+        cycleEdgeIncidence(search, currentCycleVertexOrder[i-1], currentCycleVertexOrder[i])++;
+        cycleEdgeIncidence(search, currentCycleVertexOrder[i], currentCycleVertexOrder[i-1])++;
     }
-    cycleEdgeIncidence[currentCycleVertexOrder[0]][currentCycleVertexOrder[graph[0][0]-1]]++;
-    cycleEdgeIncidence[currentCycleVertexOrder[graph[0][0]-1]][currentCycleVertexOrder[0]]++;
+    cycleEdgeIncidence(search, currentCycleVertexOrder[0], currentCycleVertexOrder[graph[0][0]-1])++;
+    cycleEdgeIncidence(search, currentCycleVertexOrder[graph[0][0]-1], currentCycleVertexOrder[0])++;
     
 }
 
-double processCycleEdgeIncidence(GRAPH graph, ADJACENCY adj){
+static double processCycleEdgeIncidence(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search){
     int i, j;
     int a = 0, b = 0;
     
     for(i = 1; i <= graph[0][0]; i++){
         for(j = 0; j < adj[i]; j++){
-            if(cycleEdgeIncidence[i][graph[i][j]] == cycleCount){
+            if(cycleEdgeIncidence(search, i, graph[i][j]) == search->cycleCount){
                 a++;
-            } else if(cycleEdgeIncidence[i][graph[i][j]] == 0){
+            } else if(cycleEdgeIncidence(search, i, graph[i][j]) == 0){
                 b++;
             }
         }
@@ -83,13 +93,13 @@ double processCycleEdgeIncidence(GRAPH graph, ADJACENCY adj){
     return 1.0*b/a;
 }
 
-int processCycleUniversalEdges(GRAPH graph, ADJACENCY adj){
+static int processCycleUniversalEdges(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search){
     int i, j;
     int a = 0;
     
     for(i = 1; i <= graph[0][0]; i++){
         for(j = 0; j < adj[i]; j++){
-            if(cycleEdgeIncidence[i][graph[i][j]] == cycleCount){
+            if(cycleEdgeIncidence(search, i, graph[i][j]) == search->cycleCount){
                 a++;
             }
         }
@@ -98,13 +108,13 @@ int processCycleUniversalEdges(GRAPH graph, ADJACENCY adj){
     return a/2;
 }
 
-int processCycleUncoveredEdges(GRAPH graph, ADJACENCY adj){
+static int processCycleUncoveredEdges(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search){
     int i, j;
     int b = 0;
     
     for(i = 1; i <= graph[0][0]; i++){
         for(j = 0; j < adj[i]; j++){
-            if(cycleEdgeIncidence[i][graph[i][j]] == 0){
+            if(cycleEdgeIncidence(search, i, graph[i][j]) == 0){
                 b++;
             }
         }
@@ -116,150 +126,259 @@ int processCycleUncoveredEdges(GRAPH graph, ADJACENCY adj){
 /**
   * 
   */
-void continueCycle(GRAPH graph, ADJACENCY adj, int target, int next, int remaining) {
+static void continueCycle(GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search, int target, int next, int remaining) {
     int i;
+    boolean *currentCycle = search->currentCycle;
     
     if(target==next){
         if(remaining==0){
-            HANDLE_CYCLE(graph, adj);
+            if(search->constructCycle){
+                countCycleEdgeIncidence(graph, adj, search);
+            } else {
+                countCycle(graph, adj, search);
+            }
         }
         return;
     }
     
-#ifdef CONSTRUCT_CYCLE
-    currentCycleVertexOrder[graph[0][0]-remaining] = next;
-#endif
+    if(search->constructCycle){
+        search->currentCycleVertexOrder[graph[0][0]-remaining] = next;
+    }
     
     for(i = 0; i < adj[next]; i++){
         if(!currentCycle[graph[next][i]]){
             currentCycle[graph[next][i]]=TRUE;
-            continueCycle(graph, adj, target, graph[next][i], remaining - 1);
+            continueCycle(graph, adj, search, target, graph[next][i], remaining - 1);
             currentCycle[graph[next][i]]=FALSE;
         }
     }
     
 }
 
-int hamiltonianCycles(GRAPH graph, ADJACENCY adj){
+/* Visits all hamiltonian cycles of the graph and stores the number of cycles
+ * in search->cycleCount. If constructCycle is TRUE, also the number of cycles
+ * through each edge is counted.
+ */
+static void findHamiltonianCycles(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context,
+        CYCLE_SEARCH *search, boolean constructCycle){
     int i, j;
     int order = graph[0][0];
-    cycleCount = 0;
+    int matrixSize = (order + 1)*(order + 1);
+    boolean *currentCycle;
     
-    for(i=0; i<=MAXN; i++){
+    search->cycleCount = 0;
+    search->constructCycle = constructCycle;
+    search->currentCycle = currentCycle =
+            getInvariantWorkspace(context, CURRENT_CYCLE, sizeof(boolean)*(order + 1));
+    for(i=0; i<=order; i++){
         currentCycle[i] = FALSE;
     }
     
-#ifdef CONSTRUCT_CYCLE
-    currentCycleVertexOrder[1] = 1;
-#endif
+    if(constructCycle){
+        search->currentCycleVertexOrder = getInvariantWorkspace(context,
+                CURRENT_CYCLE_VERTEX_ORDER, sizeof(int)*(order + 1));
+        search->cycleEdgeIncidenceMatrix = getInvariantWorkspace(context,
+                CYCLE_EDGE_INCIDENCE, sizeof(int)*matrixSize);
+        search->cycleEdgeIncidenceRow = order + 1;
+        memset(search->cycleEdgeIncidenceMatrix, 0, sizeof(int)*matrixSize);
+        
+        search->currentCycleVertexOrder[1] = 1;
+    }
     
     currentCycle[1] = TRUE;
     for(i = 1; i < adj[1]; i++){
         currentCycle[graph[1][i]]=TRUE;
         for(j = 0; j < i; j++){
-#ifdef CONSTRUCT_CYCLE
-            currentCycleVertexOrder[0] = graph[1][j];
-#endif
+            if(constructCycle){
+                search->currentCycleVertexOrder[0] = graph[1][j];
+            }
             //search for cycle containing graph[1][i], 1,  graph[1][j]
-            continueCycle(graph, adj, graph[1][j], graph[1][i], order - 2);
+            continueCycle(graph, adj, search, graph[1][j], graph[1][i], order - 2);
         }
         currentCycle[graph[1][i]]=FALSE;
     }
-    
-    return cycleCount;
 }
 
-double hamiltonianCyclesEdgeIncidence(GRAPH graph, ADJACENCY adj){
-    int i, j;
+/* Counts the hamiltonian cycles by inclusion-exclusion: the number of closed
+ * walks of length n through vertex 1 that visit all vertices is the alternating
+ * sum over all vertex subsets S containing 1 of the number of closed walks of
+ * length n through 1 in the subgraph induced by S. The walks in a subgraph are
+ * counted in O(n.m) time with two arrays, so the whole computation takes
+ * O(2^n.n.m) time and O(n) memory. The intermediate numbers may overflow, but
+ * since all arithmetic is modulo 2^64 the final result is still exact as long
+ * as it fits in 64 bits.
+ */
+static unsigned long long countCyclesByInclusionExclusion(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int i, step, v;
     int order = graph[0][0];
-    cycleCount = 0;
+    unsigned long long subset, subsetCount;
+    unsigned long long directedCycles = 0;
+    unsigned long long *walks, *nextWalks, *swap;
     
-    for(i=0; i<=MAXN; i++){
-        currentCycle[i] = FALSE;
-        for(j = 0; j <= MAXN; j++){
-            cycleEdgeIncidence[i][j] = 0;
-        }
+    if(order < 3){
+        return 0;
     }
     
-    currentCycleVertexOrder[1] = 1;
+    walks = getInvariantWorkspace(context, WALKS, sizeof(unsigned long long)*(order + 1));
+    nextWalks = getInvariantWorkspace(context, NEXT_WALKS, sizeof(unsigned long long)*(order + 1));
     
-    currentCycle[1] = TRUE;
-    for(i = 1; i < adj[1]; i++){
-        currentCycle[graph[1][i]]=TRUE;
-        for(j = 0; j < i; j++){
-            currentCycleVertexOrder[0] = graph[1][j];
-            //search for cycle containing graph[1][i], 1,  graph[1][j]
-            continueCycle(graph, adj, graph[1][j], graph[1][i], order - 2);
+    subsetCount = 1ULL << (order - 1);
+    for(subset = 0; subset < subsetCount; subset++){
+        int excluded = order - 1;
+        unsigned long long closedWalks = 0;
+        
+        for(v = 1; v <= order; v++){
+            walks[v] = 0;
+            if(v > 1 && IN_SUBSET(subset, v)){
+                excluded--;
+            }
+        }
+        walks[1] = 1;
+        
+        for(step = 1; step < order; step++){
+            for(v = 1; v <= order; v++){
+                nextWalks[v] = 0;
+                if(IN_SUBSET(subset, v)){
+                    for(i = 0; i < adj[v]; i++){
+                        if(IN_SUBSET(subset, graph[v][i])){
+                            nextWalks[v] += walks[graph[v][i]];
+                        }
+                    }
+                }
+            }
+            swap = walks;
+            walks = nextWalks;
+            nextWalks = swap;
+        }
+        for(i = 0; i < adj[1]; i++){
+            if(IN_SUBSET(subset, graph[1][i])){
+                closedWalks += walks[graph[1][i]];
+            }
+        }
+        
+        if(excluded % 2){
+            directedCycles -= closedWalks;
+        } else {
+            directedCycles += closedWalks;
         }
-        currentCycle[graph[1][i]]=FALSE;
     }
     
-    if(cycleCount>0){
-        return processCycleEdgeIncidence(graph, adj);
-    } else {
-        return 0;
-    }
+    //each cycle is found in both directions
+    return directedCycles/2;
 }
 
-int hamiltonianCyclesUniversalEdges(GRAPH graph, ADJACENCY adj){
-    int i, j;
+/* Returns the backend that is expected to be the fastest for this graph. The
+ * enumeration visits at most the product of (degree - 1) over all vertices
+ * partial cycles, while inclusion-exclusion always takes about 2^n.n.m steps.
+ * Multigraphs are always handled by the enumeration, which counts cycles that
+ * use different parallel edges separately.
+ */
+static int chooseBackend(GRAPH graph, ADJACENCY adj){
+    int i, j, v;
     int order = graph[0][0];
-    cycleCount = 0;
+    double enumerationSteps = 1.0;
+    double inclusionExclusionSteps;
+    int degreeSum = 0;
     
-    for(i=0; i<=MAXN; i++){
-        currentCycle[i] = FALSE;
-        for(j = 0; j <= MAXN; j++){
-            cycleEdgeIncidence[i][j] = 0;
-        }
+    if(order < 3 || order > INCLUSION_EXCLUSION_MAXIMUM_ORDER){
+        return BACKEND_ENUMERATION;
     }
     
-    currentCycleVertexOrder[1] = 1;
-    
-    currentCycle[1] = TRUE;
-    for(i = 1; i < adj[1]; i++){
-        currentCycle[graph[1][i]]=TRUE;
-        for(j = 0; j < i; j++){
-            currentCycleVertexOrder[0] = graph[1][j];
-            //search for cycle containing graph[1][i], 1,  graph[1][j]
-            continueCycle(graph, adj, graph[1][j], graph[1][i], order - 2);
+    for(v = 1; v <= order; v++){
+        for(i = 1; i < adj[v]; i++){
+            for(j = 0; j < i; j++){
+                if(graph[v][i] == graph[v][j]){
+                    return BACKEND_ENUMERATION;
+                }
+            }
         }
-        currentCycle[graph[1][i]]=FALSE;
+        if(adj[v] > 2){
+            enumerationSteps *= adj[v] - 1;
+        }
+        degreeSum += adj[v];
     }
     
-    if(cycleCount>0){
-        return processCycleUniversalEdges(graph, adj);
-    } else {
+    inclusionExclusionSteps = (double)(1ULL << (order - 1)) * order * degreeSum;
+    
+    return enumerationSteps > inclusionExclusionSteps ?
+        BACKEND_INCLUSION_EXCLUSION : BACKEND_ENUMERATION;
+}
+
+static int countCycles(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context, int backend){
+    CYCLE_SEARCH search;
+    
+    if(graph[0][0] >= 3 && !isBiconnectedGraph(graph, adj, context)){
+        //a graph with a cut vertex has no hamiltonian cycles
         return 0;
     }
+    
+    //a graph with fewer than 3 vertices can only have a cycle on a double edge,
+    //which the inclusion-exclusion does not count
+    if(backend == BACKEND_INCLUSION_EXCLUSION && graph[0][0] >= 3 &&
+            graph[0][0] <= INCLUSION_EXCLUSION_MAXIMUM_ORDER){
+        return (int)countCyclesByInclusionExclusion(graph, adj, context);
+    }
+    
+    findHamiltonianCycles(graph, adj, context, &search, FALSE);
+    
+    return search.cycleCount;
 }
 
-int hamiltonianCyclesUncoveredEdges(GRAPH graph, ADJACENCY adj){
-    int i, j;
-    int order = graph[0][0];
-    cycleCount = 0;
+int hamiltonianCycles(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return countCycles(graph, adj, context, chooseBackend(graph, adj));
+}
+
+int hamiltonianCyclesEnumeration(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return countCycles(graph, adj, context, BACKEND_ENUMERATION);
+}
+
+/* Graphs with fewer than 3 or more than 64 vertices are handled by the
+ * enumeration.
+ */
+int hamiltonianCyclesInclusionExclusion(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return countCycles(graph, adj, context, BACKEND_INCLUSION_EXCLUSION);
+}
+
+/* Returns the backend that hamiltonianCycles uses for this graph: 0 for the
+ * enumeration and 1 for inclusion-exclusion.
+ */
+int hamiltonianCyclesBackend(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return chooseBackend(graph, adj);
+}
+
+double hamiltonianCyclesEdgeIncidence(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    CYCLE_SEARCH search;
     
-    for(i=0; i<=MAXN; i++){
-        currentCycle[i] = FALSE;
-        for(j = 0; j <= MAXN; j++){
-            cycleEdgeIncidence[i][j] = 0;
-        }
+    findHamiltonianCycles(graph, adj, context, &search, TRUE);
+    
+    if(search.cycleCount>0){
+        return processCycleEdgeIncidence(graph, adj, &search);
+    } else {
+        return 0;
     }
+}
+
+int hamiltonianCyclesUniversalEdges(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    CYCLE_SEARCH search;
     
-    currentCycleVertexOrder[1] = 1;
+    findHamiltonianCycles(graph, adj, context, &search, TRUE);
     
-    currentCycle[1] = TRUE;
-    for(i = 1; i < adj[1]; i++){
-        currentCycle[graph[1][i]]=TRUE;
-        for(j = 0; j < i; j++){
-            currentCycleVertexOrder[0] = graph[1][j];
-            //search for cycle containing graph[1][i], 1,  graph[1][j]
-            continueCycle(graph, adj, graph[1][j], graph[1][i], order - 2);
-        }
-        currentCycle[graph[1][i]]=FALSE;
+    if(search.cycleCount>0){
+        return processCycleUniversalEdges(graph, adj, &search);
+    } else {
+        return 0;
     }
+}
+
+int hamiltonianCyclesUncoveredEdges(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int i;
+    int order = graph[0][0];
+    CYCLE_SEARCH search;
+    
+    findHamiltonianCycles(graph, adj, context, &search, TRUE);
     
-    if(cycleCount>0){
-        return processCycleUncoveredEdges(graph, adj);
+    if(search.cycleCount>0){
+        return processCycleUncoveredEdges(graph, adj, &search);
     } else {
         int edgeCount = 0;
         for(i = 1; i < order; i++){
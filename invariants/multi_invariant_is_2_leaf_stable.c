@@ -20,14 +20,17 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 #include <stdio.h>
 
-boolean currentPath[MAXN+1];
+#define CURRENT_PATH 0
+#define DEGREE_MODIFICATION 1
 
 /**
   * 
   */
-boolean continuePathIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj, int last, int remaining, int startVertex, boolean *foundHamiltonianCycle) {
+static boolean continuePathIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj, boolean *currentPath, int last, int remaining, int startVertex, boolean *foundHamiltonianCycle) {
     int i;
     
     if(remaining==0){
@@ -44,7 +47,7 @@ boolean continuePathIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj
     for(i = 0; i < adj[last]; i++){
         if(!currentPath[graph[last][i]]){
             currentPath[graph[last][i]]=TRUE;
-            if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, graph[last][i], remaining - 1, startVertex, foundHamiltonianCycle)){
+            if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, currentPath, graph[last][i], remaining - 1, startVertex, foundHamiltonianCycle)){
                 if(*foundHamiltonianCycle){
                     return TRUE;
                 } else {
@@ -61,7 +64,7 @@ boolean continuePathIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj
 /**
   * 
   */
-boolean continuePath(GRAPH graph, ADJACENCY adj, int last, int remaining) {
+static boolean continuePath(GRAPH graph, ADJACENCY adj, boolean *currentPath, int last, int remaining) {
     int i;
     
     if(remaining==0){
@@ -71,7 +74,7 @@ boolean continuePath(GRAPH graph, ADJACENCY adj, int last, int remaining) {
     for(i = 0; i < adj[last]; i++){
         if(!currentPath[graph[last][i]]){
             currentPath[graph[last][i]]=TRUE;
-            if(continuePath(graph, adj, graph[last][i], remaining - 1)){
+            if(continuePath(graph, adj, currentPath, graph[last][i], remaining - 1)){
                 return TRUE;
             }
             currentPath[graph[last][i]]=FALSE;
@@ -81,10 +84,10 @@ boolean continuePath(GRAPH graph, ADJACENCY adj, int last, int remaining) {
     return FALSE;
 }
 
-boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(GRAPH graph, ADJACENCY adj, int startVertex, boolean *foundHamiltonianCycle, int deletedVertex){
+static boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(GRAPH graph, ADJACENCY adj, boolean *currentPath, int startVertex, boolean *foundHamiltonianCycle, int deletedVertex){
     int i;
     
-    for(i=0; i<=MAXN; i++){
+    for(i=0; i<=graph[0][0]; i++){
         currentPath[i] = FALSE;
     }
     currentPath[deletedVertex] = TRUE;
@@ -95,7 +98,7 @@ boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(GRA
         if(graph[startVertex][i]!=deletedVertex){
             currentPath[graph[startVertex][i]]=TRUE;
             //search for path containing the edge (startVertex, graph[startVertex][i])
-            if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, graph[startVertex][i], graph[0][0] - 3, startVertex, foundHamiltonianCycle)){
+            if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, currentPath, graph[startVertex][i], graph[0][0] - 3, startVertex, foundHamiltonianCycle)){
                 if(*foundHamiltonianCycle){
                     return TRUE;
                 } else {
@@ -111,10 +114,10 @@ boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(GRA
 }
 
 
-boolean isTraceableFromVertex_vertexDeleted(GRAPH graph, ADJACENCY adj, int startVertex, int deletedVertex){
+static boolean isTraceableFromVertex_vertexDeleted(GRAPH graph, ADJACENCY adj, boolean *currentPath, int startVertex, int deletedVertex){
     int i;
     
-    for(i=0; i<=MAXN; i++){
+    for(i=0; i<=graph[0][0]; i++){
         currentPath[i] = FALSE;
     }
     currentPath[deletedVertex] = TRUE;
@@ -124,7 +127,7 @@ boolean isTraceableFromVertex_vertexDeleted(GRAPH graph, ADJACENCY adj, int star
         if(graph[startVertex][i]!=deletedVertex){
             currentPath[graph[startVertex][i]]=TRUE;
             //search for path containing the edge (startVertex, graph[startVertex][i])
-            if(continuePath(graph, adj, graph[startVertex][i], graph[0][0] - 3)){
+            if(continuePath(graph, adj, currentPath, graph[startVertex][i], graph[0][0] - 3)){
                 return TRUE;
             }
             currentPath[graph[startVertex][i]]=FALSE;
@@ -135,12 +138,11 @@ boolean isTraceableFromVertex_vertexDeleted(GRAPH graph, ADJACENCY adj, int star
     return FALSE;
 }
 
-boolean removingVertexLeavesTraceableNotHamiltonian(GRAPH graph, ADJACENCY adj, int vertexToRemove){
+static boolean removingVertexLeavesTraceableNotHamiltonian(GRAPH graph, ADJACENCY adj, boolean *currentPath, int *degreeModification, int vertexToRemove){
     int i;
     int order = graph[0][0];
     
-    int degreeModification[MAXN + 1];
-    for(i = 1; i <= MAXN; i++){
+    for(i = 1; i <= order; i++){
         degreeModification[i] = 0;
     }
     for(i = 0; i < adj[vertexToRemove]; i++){
@@ -176,12 +178,12 @@ boolean removingVertexLeavesTraceableNotHamiltonian(GRAPH graph, ADJACENCY adj,
     if(minDegree == 1){
         //graph is certainly not hamiltonian and hamiltonian path will start
         //from vertex of degree 1
-        return isTraceableFromVertex_vertexDeleted(graph, adj, minDegreeVertex, vertexToRemove);
+        return isTraceableFromVertex_vertexDeleted(graph, adj, currentPath, minDegreeVertex, vertexToRemove);
     } else {
         //graph might be hamiltonian
         boolean foundHamiltonianCycle = FALSE;
         int start = vertexToRemove == 1 ? 2 : 1;
-        boolean isTraceable = isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(graph, adj, start, &foundHamiltonianCycle, vertexToRemove);
+        boolean isTraceable = isTraceableFromVertexIncludingCheckForHamiltonianCycle_vertexDeleted(graph, adj, currentPath, start, &foundHamiltonianCycle, vertexToRemove);
         if(foundHamiltonianCycle){
             return FALSE;
         }
@@ -194,7 +196,7 @@ boolean removingVertexLeavesTraceableNotHamiltonian(GRAPH graph, ADJACENCY adj,
              * starting at that vertex would already have been found from the other
              * end.
              */
-            while(start < order && !isTraceableFromVertex_vertexDeleted(graph, adj, start, vertexToRemove)){
+            while(start < order && !isTraceableFromVertex_vertexDeleted(graph, adj, currentPath, start, vertexToRemove)){
                 start++;
                 if(start==vertexToRemove){
                     start++;
@@ -212,10 +214,10 @@ boolean removingVertexLeavesTraceableNotHamiltonian(GRAPH graph, ADJACENCY adj,
 }
 
 
-boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj, int startVertex, boolean *foundHamiltonianCycle){
+static boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle(GRAPH graph, ADJACENCY adj, boolean *currentPath, int startVertex, boolean *foundHamiltonianCycle){
     int i;
     
-    for(i=0; i<=MAXN; i++){
+    for(i=0; i<=graph[0][0]; i++){
         currentPath[i] = FALSE;
     }
     boolean traceable = FALSE;
@@ -224,7 +226,7 @@ boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle(GRAPH graph, ADJA
     for(i = 0; i < adj[startVertex]; i++){
         currentPath[graph[startVertex][i]]=TRUE;
         //search for path containing the edge (startVertex, graph[startVertex][i])
-        if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, graph[startVertex][i], graph[0][0] - 2, startVertex, foundHamiltonianCycle)){
+        if(continuePathIncludingCheckForHamiltonianCycle(graph, adj, currentPath, graph[startVertex][i], graph[0][0] - 2, startVertex, foundHamiltonianCycle)){
             if(*foundHamiltonianCycle){
                 return TRUE;
             } else {
@@ -238,10 +240,10 @@ boolean isTraceableFromVertexIncludingCheckForHamiltonianCycle(GRAPH graph, ADJA
     return traceable;
 }
 
-boolean isTraceableFromVertex(GRAPH graph, ADJACENCY adj, int startVertex){
+static boolean isTraceableFromVertex(GRAPH graph, ADJACENCY adj, boolean *currentPath, int startVertex){
     int i;
     
-    for(i=0; i<=MAXN; i++){
+    for(i=0; i<=graph[0][0]; i++){
         currentPath[i] = FALSE;
     }
     
@@ -249,7 +251,7 @@ boolean isTraceableFromVertex(GRAPH graph, ADJACENCY adj, int startVertex){
     for(i = 0; i < adj[startVertex]; i++){
         currentPath[graph[startVertex][i]]=TRUE;
         //search for path containing the edge (startVertex, graph[startVertex][i])
-        if(continuePath(graph, adj, graph[startVertex][i], graph[0][0] - 2)){
+        if(continuePath(graph, adj, currentPath, graph[startVertex][i], graph[0][0] - 2)){
             return TRUE;
         }
         currentPath[graph[startVertex][i]]=FALSE;
@@ -259,24 +261,19 @@ boolean isTraceableFromVertex(GRAPH graph, ADJACENCY adj, int startVertex){
     return FALSE;
 }
 
-boolean is2LeafStable(GRAPH graph, ADJACENCY adj){
-    int i, v;
+boolean is2LeafStable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int v;
     int order = graph[0][0];
     int minDegree;
-    int minDegreeVertex;
+    boolean *currentPath;
+    int *degreeModification;
     
     if(order<3){
         return FALSE;
     }
     
     //check conditions for Dirac's theorem
-    minDegree = order;
-    for(i = 1; i <= order; i++){
-        if(adj[i] < minDegree){
-            minDegree = adj[i];
-            minDegreeVertex = i;
-        }
-    }
+    minDegree = getDegreeData(graph, adj, context)->minimumDegree;
     
     if(2*minDegree >= order){
         //this graph is hamiltonian
@@ -287,9 +284,12 @@ boolean is2LeafStable(GRAPH graph, ADJACENCY adj){
         return FALSE;
     }
     
+    currentPath = getInvariantWorkspace(context, CURRENT_PATH, sizeof(boolean)*(order + 1));
+    degreeModification = getInvariantWorkspace(context, DEGREE_MODIFICATION, sizeof(int)*(order + 1));
+    
     //check traceable but not hamiltonian
     boolean foundHamiltonianCycle = FALSE;
-    boolean isTraceable = isTraceableFromVertexIncludingCheckForHamiltonianCycle(graph, adj, 1, &foundHamiltonianCycle);
+    boolean isTraceable = isTraceableFromVertexIncludingCheckForHamiltonianCycle(graph, adj, currentPath, 1, &foundHamiltonianCycle);
     if(foundHamiltonianCycle){
         return FALSE;
     }
@@ -299,7 +299,7 @@ boolean is2LeafStable(GRAPH graph, ADJACENCY adj){
          * starting at that vertex would already have been found from the other
          * end.
          */
-        while(start < order && !isTraceableFromVertex(graph, adj, start)){
+        while(start < order && !isTraceableFromVertex(graph, adj, currentPath, start)){
             start++;
         }
         if(start == order){
@@ -313,7 +313,7 @@ boolean is2LeafStable(GRAPH graph, ADJACENCY adj){
     //try removing each vertex once and check that the resulting graph is 
     //traceable but not hamiltonian
     for(v = 1; v <= order; v++){
-        if(!removingVertexLeavesTraceableNotHamiltonian(graph, adj, v)){
+        if(!removingVertexLeavesTraceableNotHamiltonian(graph, adj, currentPath, degreeModification, v)){
             return FALSE;
         }
     }
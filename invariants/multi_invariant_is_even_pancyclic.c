@@ -22,34 +22,41 @@
 #include <stdio.h>
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
 
-boolean verticesInCycle[MAXN + 1];
+#define VERTICES_IN_CYCLE 0
+#define OBSERVED_CYCLE_SIZES 1
 
-boolean observedCycleSizes[MAXN + 1];
-int largestMissingCycle, smallestMissingCycle;
+typedef struct __cycle_search {
+    boolean *verticesInCycle;
+    boolean *observedCycleSizes;
+    int largestMissingCycle, smallestMissingCycle;
+} CYCLE_SEARCH;
 
-boolean handleSimpleCycle(int size){
-    if(largestMissingCycle == size && smallestMissingCycle == size){
+static boolean handleSimpleCycle(CYCLE_SEARCH *search, int size){
+    boolean *observedCycleSizes = search->observedCycleSizes;
+    if(search->largestMissingCycle == size && search->smallestMissingCycle == size){
         return TRUE;
     } else {
         observedCycleSizes[size] = TRUE;
-        if(largestMissingCycle == size){
-            while(observedCycleSizes[largestMissingCycle]){
-                largestMissingCycle-=2;
+        if(search->largestMissingCycle == size){
+            while(observedCycleSizes[search->largestMissingCycle]){
+                search->largestMissingCycle-=2;
             }
-        } else if(smallestMissingCycle == size){
-            while(observedCycleSizes[smallestMissingCycle]){
-                smallestMissingCycle+=2;
+        } else if(search->smallestMissingCycle == size){
+            while(observedCycleSizes[search->smallestMissingCycle]){
+                search->smallestMissingCycle+=2;
             }
         }
         return FALSE;
     }
 }
 
-boolean checkSimpleCycles_impl(
-            GRAPH graph, ADJACENCY adj, int firstVertex,
+static boolean checkSimpleCycles_impl(
+            GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search, int firstVertex,
             int secondVertex, int currentVertex, int size){
     int i;
+    boolean *verticesInCycle = search->verticesInCycle;
     for(i=0; i<adj[currentVertex]; i++){
         int neighbour = graph[currentVertex][i];
         if((neighbour != firstVertex) && verticesInCycle[neighbour]){
@@ -64,14 +71,14 @@ boolean checkSimpleCycles_impl(
                 //cycle not in canonical form
                 continue;
             }
-            if(!observedCycleSizes[size] && !(size%2) && handleSimpleCycle(size)){
+            if(!search->observedCycleSizes[size] && !(size%2) && handleSimpleCycle(search, size)){
                 return TRUE;
             }
-        } else if (size < largestMissingCycle) {
+        } else if (size < search->largestMissingCycle) {
             //we continue the cycle
             verticesInCycle[neighbour] = TRUE;
                 
-            if(checkSimpleCycles_impl(graph, adj, firstVertex, secondVertex,
+            if(checkSimpleCycles_impl(graph, adj, search, firstVertex, secondVertex,
                     neighbour, size+1)){
                 return TRUE;
             }
@@ -84,15 +91,26 @@ boolean checkSimpleCycles_impl(
 
 /* Returns TRUE if the graph is even pancyclic.
  */
-boolean isEvenPancyclic(GRAPH graph, ADJACENCY adj){
+boolean isEvenPancyclic(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int v, i;
     int order = graph[0][0];
+    CYCLE_SEARCH search;
+    boolean *verticesInCycle, *observedCycleSizes;
+    
+    search.verticesInCycle = verticesInCycle =
+            getInvariantWorkspace(context, VERTICES_IN_CYCLE, sizeof(boolean)*(order + 1));
+    search.observedCycleSizes = observedCycleSizes =
+            getInvariantWorkspace(context, OBSERVED_CYCLE_SIZES, sizeof(boolean)*(order + 1));
     
     for(v = 4; v <= order; v+=2){
         observedCycleSizes[v] = FALSE;
     }
-    smallestMissingCycle = 4;
-    largestMissingCycle = order%2 ? order - 1 : order;
+    //a previous call may have returned while vertices were still in the cycle
+    for(v = 1; v <= order; v++){
+        verticesInCycle[v] = FALSE;
+    }
+    search.smallestMissingCycle = 4;
+    search.largestMissingCycle = order%2 ? order - 1 : order;
     
     v = 1;
     for(v = 1; v < order; v++){ //intentionally skip v==order!
@@ -106,7 +124,7 @@ boolean isEvenPancyclic(GRAPH graph, ADJACENCY adj){
             } else {
                 //start a cycle
                 verticesInCycle[neighbour] = TRUE;
-                if(checkSimpleCycles_impl(graph, adj, v, neighbour, neighbour, 2)){
+                if(checkSimpleCycles_impl(graph, adj, &search, v, neighbour, neighbour, 2)){
                     return TRUE;
                 }
                 verticesInCycle[neighbour] = FALSE;
@@ -19,23 +19,17 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 #include <stdio.h>
 
-boolean isOverfull(GRAPH graph, ADJACENCY adj){
-    int i;
+boolean isOverfull(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int order = graph[0][0];
     if(!(order%2)){
         return FALSE;
     }
     
-    int maxDegree = 0;
-    int doubleEdgeCount = 0;
-    for(i = 1; i <= order; i++){
-        doubleEdgeCount += adj[i];
-        if(adj[i] > maxDegree){
-            maxDegree = adj[i];
-        }
-    }
+    INVARIANT_GRAPH_DATA *degrees = getDegreeData(graph, adj, context);
     
-    return doubleEdgeCount > (order - 1)*maxDegree;
+    return 2*degrees->edgeCount > (order - 1)*degrees->maximumDegree;
 }
\ No newline at end of file
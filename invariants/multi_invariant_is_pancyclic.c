@@ -20,35 +20,43 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 #include <stdio.h>
 
-boolean verticesInCycle[MAXN + 1];
+#define VERTICES_IN_CYCLE 0
+#define OBSERVED_CYCLE_SIZES 1
 
-boolean observedCycleSizes[MAXN + 1];
-int largestMissingCycle, smallestMissingCycle;
+typedef struct __cycle_search {
+    boolean *verticesInCycle;
+    boolean *observedCycleSizes;
+    int largestMissingCycle, smallestMissingCycle;
+} CYCLE_SEARCH;
 
-boolean handleSimpleCycle(int size){
-    if(largestMissingCycle == size && smallestMissingCycle == size){
+static boolean handleSimpleCycle(CYCLE_SEARCH *search, int size){
+    boolean *observedCycleSizes = search->observedCycleSizes;
+    if(search->largestMissingCycle == size && search->smallestMissingCycle == size){
         return TRUE;
     } else {
         observedCycleSizes[size] = TRUE;
-        if(largestMissingCycle == size){
-            while(observedCycleSizes[largestMissingCycle]){
-                largestMissingCycle--;
+        if(search->largestMissingCycle == size){
+            while(observedCycleSizes[search->largestMissingCycle]){
+                search->largestMissingCycle--;
             }
-        } else if(smallestMissingCycle == size){
-            while(observedCycleSizes[smallestMissingCycle]){
-                smallestMissingCycle++;
+        } else if(search->smallestMissingCycle == size){
+            while(observedCycleSizes[search->smallestMissingCycle]){
+                search->smallestMissingCycle++;
             }
         }
         return FALSE;
     }
 }
 
-boolean checkSimpleCycles_impl(
-            GRAPH graph, ADJACENCY adj, int firstVertex,
+static boolean checkSimpleCycles_impl(
+            GRAPH graph, ADJACENCY adj, CYCLE_SEARCH *search, int firstVertex,
             int secondVertex, int currentVertex, int size){
     int i;
+    boolean *verticesInCycle = search->verticesInCycle;
     for(i=0; i<adj[currentVertex]; i++){
         int neighbour = graph[currentVertex][i];
         if((neighbour != firstVertex) && verticesInCycle[neighbour]){
@@ -63,14 +71,14 @@ boolean checkSimpleCycles_impl(
                 //cycle not in canonical form
                 continue;
             }
-            if(!observedCycleSizes[size] && handleSimpleCycle(size)){
+            if(!search->observedCycleSizes[size] && handleSimpleCycle(search, size)){
                 return TRUE;
             }
-        } else if (size < largestMissingCycle) {
+        } else if (size < search->largestMissingCycle) {
             //we continue the cycle
             verticesInCycle[neighbour] = TRUE;
                 
-            if(checkSimpleCycles_impl(graph, adj, firstVertex, secondVertex,
+            if(checkSimpleCycles_impl(graph, adj, search, firstVertex, secondVertex,
                     neighbour, size+1)){
                 return TRUE;
             }
@@ -83,15 +91,31 @@ boolean checkSimpleCycles_impl(
 
 /* Returns TRUE if the graph is pancyclic.
  */
-boolean isPancyclic(GRAPH graph, ADJACENCY adj){
+boolean isPancyclic(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int v, i;
     int order = graph[0][0];
+    CYCLE_SEARCH search;
+    boolean *verticesInCycle, *observedCycleSizes;
+    
+    if(order >= 3 && !isBiconnectedGraph(graph, adj, context)){
+        //a pancyclic graph is hamiltonian, so it has no cut vertices
+        return FALSE;
+    }
+    
+    search.verticesInCycle = verticesInCycle =
+            getInvariantWorkspace(context, VERTICES_IN_CYCLE, sizeof(boolean)*(order + 1));
+    search.observedCycleSizes = observedCycleSizes =
+            getInvariantWorkspace(context, OBSERVED_CYCLE_SIZES, sizeof(boolean)*(order + 1));
     
     for(v = 3; v <= order; v++){
         observedCycleSizes[v] = FALSE;
     }
-    smallestMissingCycle = 3;
-    largestMissingCycle = order;
+    //a previous call may have returned while vertices were still in the cycle
+    for(v = 1; v <= order; v++){
+        verticesInCycle[v] = FALSE;
+    }
+    search.smallestMissingCycle = 3;
+    search.largestMissingCycle = order;
     
     for(v = 1; v < order; v++){ //intentionally skip v==order!
         verticesInCycle[v] = TRUE;
@@ -103,7 +127,7 @@ boolean isPancyclic(GRAPH graph, ADJACENCY adj){
             } else {
                 //start a cycle
                 verticesInCycle[neighbour] = TRUE;
-                if(checkSimpleCycles_impl(graph, adj, v, neighbour, neighbour, 2)){
+                if(checkSimpleCycles_impl(graph, adj, &search, v, neighbour, neighbour, 2)){
                     return TRUE;
                 }
                 verticesInCycle[neighbour] = FALSE;
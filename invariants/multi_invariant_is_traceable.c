@@ -16,72 +16,27 @@
  *     ../multicode/shared/multicode_base.c\
  *     ../multicode/shared/multicode_input.c \
  *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_hamiltonian_cycles.c
+ *     shared/invariant_context.c shared/invariant_graph_data.c \
+ *     shared/hamiltonian_search.c \
+ *     multi_invariant_is_traceable.c
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
+#include "shared/hamiltonian_search.h"
 #include <stdio.h>
 
-boolean currentPath[MAXN+1];
-
-/**
-  * 
-  */
-boolean continuePath(GRAPH graph, ADJACENCY adj, int last, int remaining) {
-    int i;
-    
-    if(remaining==0){
-        return TRUE;
-    }
-    
-    for(i = 0; i < adj[last]; i++){
-        if(!currentPath[graph[last][i]]){
-            currentPath[graph[last][i]]=TRUE;
-            if(continuePath(graph, adj, graph[last][i], remaining - 1)){
-                return TRUE;
-            }
-            currentPath[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean startPath(GRAPH graph, ADJACENCY adj, int startVertex, int order){
-    int i;
-    
-    currentPath[startVertex]=TRUE;
-    for(i = 1; i < adj[startVertex]; i++){
-        currentPath[graph[startVertex][i]]=TRUE;
-        //search for path containing the edge (v, graph[v][i])
-        if(continuePath(graph, adj, graph[startVertex][i], order - 2)){
-            return TRUE;
-        }
-        currentPath[graph[startVertex][i]]=FALSE;
-    }
-    currentPath[startVertex]=FALSE;
-    
-    return FALSE;
-}
-
-boolean isTraceable(GRAPH graph, ADJACENCY adj){
-    int i, v;
+boolean isTraceable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     int order = graph[0][0];
     int minDegree;
-    int minDegreeVertex;
     int minDegreeCount;
+    INVARIANT_GRAPH_DATA *degrees;
     
     //check conditions for Dirac's theorem
-    minDegree = order;
-    for(i = 1; i <= order; i++){
-        if(adj[i] < minDegree){
-            minDegree = adj[i];
-            minDegreeVertex = i;
-            minDegreeCount = 1;
-        } else if(adj[i] == minDegree){
-            minDegreeCount++;
-        }
-    }
+    degrees = getDegreeData(graph, adj, context);
+    minDegree = degrees->minimumDegree;
+    minDegreeCount = degrees->minimumDegreeCount;
     
     if(minDegree == 1 && minDegreeCount > 2){
         return FALSE;
@@ -92,22 +47,10 @@ boolean isTraceable(GRAPH graph, ADJACENCY adj){
         return TRUE;
     }
     
-    //just look for a hamiltonian path
-    for(i=0; i<=MAXN; i++){
-        currentPath[i] = FALSE;
-    }
-    
-    if(minDegree > 1){
-        for(v = 1; v < order; v++){
-            //we try to start the path from each vertex (except the last)
-            if(startPath(graph, adj, v, order)){
-                return TRUE;
-            }
-        }
+    if(!isConnectedGraph(graph, adj, context)){
         return FALSE;
-    } else {
-        //if there is a degree 1 vertex, then any hamiltonian path will start with that vertex
-        return startPath(graph, adj, minDegreeVertex, order);
     }
     
+    //just look for a hamiltonian path
+    return searchHamiltonianPath(prepareHamiltonianSearch(graph, adj, context), 0, 0);
 }
\ No newline at end of file
@@ -17,76 +17,22 @@
  *     ../multicode/shared/multicode_base.c\
  *     ../multicode/shared/multicode_input.c \
  *     ../multicode/shared/multicode_output.c \
- *     multi_invariant_hamiltonian_cycles.c
+ *     shared/invariant_context.c shared/invariant_graph_data.c \
+ *     shared/hamiltonian_search.c \
+ *     multi_invariant_is_weak_hypotraceable.c
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
+#include "shared/hamiltonian_search.h"
 #include <stdio.h>
 
-boolean currentPath[MAXN+1];
-
-/**
-  * 
-  */
-boolean continuePath(GRAPH graph, ADJACENCY adj, int last, int remaining) {
-    int i;
-    
-    if(remaining==0){
-        return TRUE;
-    }
-    
-    for(i = 0; i < adj[last]; i++){
-        if(!currentPath[graph[last][i]]){
-            currentPath[graph[last][i]]=TRUE;
-            if(continuePath(graph, adj, graph[last][i], remaining - 1)){
-                return TRUE;
-            }
-            currentPath[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean startPath(GRAPH graph, ADJACENCY adj, int startVertex, int order){
-    int i;
-    //mark the start vertex as being in the path
-    currentPath[startVertex]=TRUE;
-    for(i = 0; i < adj[startVertex]; i++){
-        if(!currentPath[graph[startVertex][i]]){
-            currentPath[graph[startVertex][i]]=TRUE;
-            //search for path containing the edge (v, graph[v][i])
-            if(continuePath(graph, adj, graph[startVertex][i], order - 2)){
-                return TRUE;
-            }
-            currentPath[graph[startVertex][i]]=FALSE;
-        }
-    }
-    currentPath[startVertex]=FALSE;
-    
-    return FALSE;
-}
-
-boolean remainingGraphIsTraceable(GRAPH graph, ADJACENCY adj, int remainingOrder, int removedVertex){
-    int i;
-    
-    for(i = 1; i <= remainingOrder; i++){
-        if(i!=removedVertex){
-            //we try to start the path from each vertex (except the last)
-            if(startPath(graph, adj, i, remainingOrder)){
-                return TRUE;
-            }
-        }
-    }
-    return FALSE;
-}
-
-boolean isWeakHypotraceable(GRAPH graph, ADJACENCY adj){
-    int i, v;
+boolean isWeakHypotraceable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int v;
+    HAMILTONIAN_SEARCH *search;
     int order = graph[0][0];
     int minDegree;
-    int minDegreeVertex;
-    int minDegreeCount;
     
     if(order < 3){
         //not well defined for graphs with less than 3 vertices
@@ -94,16 +40,7 @@ boolean isWeakHypotraceable(GRAPH graph, ADJACENCY adj){
     }
     
     //check conditions for Dirac's theorem
-    minDegree = order;
-    for(i = 1; i <= order; i++){
-        if(adj[i] < minDegree){
-            minDegree = adj[i];
-            minDegreeVertex = i;
-            minDegreeCount = 1;
-        } else if(adj[i] == minDegree){
-            minDegreeCount++;
-        }
-    }
+    minDegree = getDegreeData(graph, adj, context)->minimumDegree;
     
     if(minDegree == 1){
         //the graph obtained by removing the neighbour of the degree 1 vertex
@@ -118,18 +55,13 @@ boolean isWeakHypotraceable(GRAPH graph, ADJACENCY adj){
     }
     
     //just look for a hamiltonian path in all graphs
+    search = prepareHamiltonianSearch(graph, adj, context);
     for(v = 1; v <= order; v++){
-        //clear possible previous path
-        for(i=0; i<=MAXN; i++){
-            currentPath[i] = FALSE;
-        }
-        
-        currentPath[v] = TRUE;
-        //we mark v as visited, so it is as if it got removed
-        if(!remainingGraphIsTraceable(graph, adj, order-1, v)){
+        excludeVertexFromHamiltonianSearch(search, v);
+        if(!searchHamiltonianPath(search, 0, 0)){
             return FALSE;
         }
-        currentPath[v] = FALSE;
+        includeVertexInHamiltonianSearch(search, v);
     }
     return TRUE;
     
@@ -20,15 +20,9 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
 
-int maximumDegree(GRAPH graph, ADJACENCY adj){
-    int i, maximumDegree = 0;
-    
-    for(i = 1; i <= graph[0][0]; i++){
-        if(adj[i] > maximumDegree){
-            maximumDegree = adj[i];
-        }
-    }
-    
-    return maximumDegree;
+int maximumDegree(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return getDegreeData(graph, adj, context)->maximumDegree;
 }
\ No newline at end of file
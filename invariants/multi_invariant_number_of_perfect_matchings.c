@@ -18,17 +18,53 @@
  *     multi_invariant_number_of_perfect_matchings.c
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+
+#define AVAILABLE 0
+#define POSITION 1
+#define VERTEX_AT_POSITION 2
+#define STATES_1 3
+#define STATES_2 4
+#define STATES_3 5
+
+/* The dynamic programming handles the vertices in a fixed order and stores the
+ * set of vertices that are already matched to an earlier vertex as a bitset
+ * relative to the current vertex. This only works if every edge connects two
+ * vertices whose positions differ by at most MAXIMUM_BANDWIDTH.
+ */
+#define MAXIMUM_BANDWIDTH 62
+#define EMPTY_STATE (~0ULL)
 
-unsigned long long int perfectMatchingCount;
+typedef struct __matching_state {
+    //bit k is set if the vertex k positions further is already matched
+    unsigned long long int matched;
+    //the number of ways in which this state can be reached
+    unsigned long long int count;
+} MATCHING_STATE;
 
-boolean available[MAXN + 1];
+//a hash table of states that is stored in a workspace slot
+typedef struct __state_table {
+    int slot;
+    MATCHING_STATE *states;
+    int capacity;
+    int size;
+} STATE_TABLE;
 
-void handlePerfectMatching(){
-    perfectMatchingCount++;
+static void exitTooManyPerfectMatchings(){
+    fprintf(stderr, "The number of perfect matchings is too large -- exiting!\n");
+    exit(EXIT_FAILURE);
 }
 
-void extendPerfectMatching(GRAPH graph, ADJACENCY adj){
+static void handlePerfectMatching(unsigned long long int *perfectMatchingCount){
+    (*perfectMatchingCount)++;
+}
+
+static void extendPerfectMatching(GRAPH graph, ADJACENCY adj, boolean *available, unsigned long long int *perfectMatchingCount){
     int i = 1, j;
     
     while(i <= graph[0][0] && !available[i]){
@@ -36,13 +72,13 @@ void extendPerfectMatching(GRAPH graph, ADJACENCY adj){
     }
     
     if(i > graph[0][0]){
-        handlePerfectMatching();
+        handlePerfectMatching(perfectMatchingCount);
     } else {
         available[i] = FALSE;
         for(j = 0; j < adj[i]; j++){
             if(available[graph[i][j]]){
                 available[graph[i][j]] = FALSE;
-                extendPerfectMatching(graph, adj);
+                extendPerfectMatching(graph, adj, available, perfectMatchingCount);
                 available[graph[i][j]] = TRUE;
             }
         }
@@ -50,21 +86,193 @@ void extendPerfectMatching(GRAPH graph, ADJACENCY adj){
     }
 }
 
-int numberPM(GRAPH graph, ADJACENCY adj){
+static unsigned long long int enumeratePerfectMatchings(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int i;
+    unsigned long long int perfectMatchingCount = 0;
+    boolean *available;
+    
+    available = getInvariantWorkspace(context, AVAILABLE, sizeof(boolean)*(graph[0][0] + 1));
+    for(i = 1; i <= graph[0][0]; i++){
+        available[i] = TRUE;
+    }
+    
+    extendPerfectMatching(graph, adj, available, &perfectMatchingCount);
+    
+    return perfectMatchingCount;
+}
+
+/* Orders the vertices by a breadth-first search starting from a vertex with
+ * minimum degree in each component, which keeps the neighbours of a vertex
+ * close to it in the order. Returns the largest difference between the
+ * positions of two adjacent vertices.
+ */
+static int orderVertices(GRAPH graph, ADJACENCY adj, int *position, int *vertexAtPosition){
+    int i, v;
+    int order = graph[0][0];
+    int head = 0, tail = 0;
+    int bandwidth = 0;
+    
+    for(v = 1; v <= order; v++){
+        position[v] = -1;
+    }
+    
+    while(head < order){
+        int start = 0;
+        for(v = 1; v <= order; v++){
+            if(position[v] < 0 && (start == 0 || adj[v] < adj[start])){
+                start = v;
+            }
+        }
+        position[start] = head;
+        vertexAtPosition[head++] = start;
+        while(tail < head){
+            int current = vertexAtPosition[tail++];
+            for(i = 0; i < adj[current]; i++){
+                int neighbour = graph[current][i];
+                if(position[neighbour] < 0){
+                    position[neighbour] = head;
+                    vertexAtPosition[head++] = neighbour;
+                }
+                if(position[neighbour] - position[current] > bandwidth){
+                    bandwidth = position[neighbour] - position[current];
+                }
+            }
+        }
+    }
+    
+    return bandwidth;
+}
+
+static void clearStateTable(INVARIANT_CONTEXT *context, STATE_TABLE *table, int capacity){
     int i;
     
-    if(graph[0][0]%2){
+    table->states = getInvariantWorkspace(context, table->slot, sizeof(MATCHING_STATE)*capacity);
+    table->capacity = capacity;
+    table->size = 0;
+    for(i = 0; i < capacity; i++){
+        table->states[i].matched = EMPTY_STATE;
+    }
+}
+
+static void insertState(STATE_TABLE *table, unsigned long long int matched, unsigned long long int count){
+    //the capacity is a power of two
+    int i = (int)((matched * 0x9E3779B97F4A7C15ULL) >> 32) & (table->capacity - 1);
+    
+    while(table->states[i].matched != EMPTY_STATE && table->states[i].matched != matched){
+        i = (i + 1) & (table->capacity - 1);
+    }
+    if(table->states[i].matched == EMPTY_STATE){
+        table->states[i].matched = matched;
+        table->states[i].count = count;
+        table->size++;
+    } else {
+        if(table->states[i].count > ULLONG_MAX - count){
+            exitTooManyPerfectMatchings();
+        }
+        table->states[i].count += count;
+    }
+}
+
+/* Adds count to the state. If the table becomes too full, the states are moved
+ * to a table twice as large that uses the spare slot, and the old slot
+ * becomes the new spare slot.
+ */
+static void addState(INVARIANT_CONTEXT *context, STATE_TABLE *table, int *spareSlot,
+        unsigned long long int matched, unsigned long long int count){
+    int i;
+    
+    if(2*(table->size + 1) > table->capacity){
+        STATE_TABLE larger;
+        larger.slot = *spareSlot;
+        clearStateTable(context, &larger, 2*table->capacity);
+        for(i = 0; i < table->capacity; i++){
+            if(table->states[i].matched != EMPTY_STATE){
+                insertState(&larger, table->states[i].matched, table->states[i].count);
+            }
+        }
+        *spareSlot = table->slot;
+        *table = larger;
+    }
+    insertState(table, matched, count);
+}
+
+/* Counts the perfect matchings by dynamic programming over the sets of
+ * vertices that are still unmatched. The vertices are matched in the order
+ * given by orderVertices, and each vertex that is not yet matched when it is
+ * handled is matched to a later neighbour. Since all earlier vertices are
+ * matched at that point, the set of unmatched vertices is determined by the
+ * matched vertices among the next MAXIMUM_BANDWIDTH vertices.
+ */
+static unsigned long long int countPerfectMatchings(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context,
+        int *position, int *vertexAtPosition){
+    int i, j, p;
+    int order = graph[0][0];
+    int spareSlot = STATES_3;
+    STATE_TABLE current, next, swap;
+    
+    current.slot = STATES_1;
+    next.slot = STATES_2;
+    clearStateTable(context, &current, 16);
+    insertState(&current, 0ULL, 1ULL);
+    
+    for(p = 0; p < order; p++){
+        int v = vertexAtPosition[p];
+        //the number of states does not change much from one vertex to the next
+        clearStateTable(context, &next, current.capacity);
+        for(i = 0; i < current.capacity; i++){
+            unsigned long long int matched = current.states[i].matched;
+            unsigned long long int count = current.states[i].count;
+            if(matched == EMPTY_STATE){
+                continue;
+            }
+            if(matched & 1ULL){
+                //v is already matched
+                addState(context, &next, &spareSlot, matched >> 1, count);
+            } else {
+                for(j = 0; j < adj[v]; j++){
+                    int distance = position[graph[v][j]] - p;
+                    if(distance > 0 && !(matched & (1ULL << distance))){
+                        addState(context, &next, &spareSlot,
+                                (matched | (1ULL << distance)) >> 1, count);
+                    }
+                }
+            }
+        }
+        swap = current;
+        current = next;
+        next = swap;
+    }
+    
+    for(i = 0; i < current.capacity; i++){
+        if(current.states[i].matched == 0ULL){
+            return current.states[i].count;
+        }
+    }
+    return 0;
+}
+
+int numberPM(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int order = graph[0][0];
+    int *position, *vertexAtPosition;
+    unsigned long long int count;
+    
+    if(order%2){
         //an graph with an odd number of vertices does not have a perfect matching
         return 0;
     }
     
-    perfectMatchingCount = 0;
+    position = getInvariantWorkspace(context, POSITION, sizeof(int)*(order + 1));
+    vertexAtPosition = getInvariantWorkspace(context, VERTEX_AT_POSITION, sizeof(int)*(order + 1));
     
-    for(i = 1; i <= MAXN; i++){
-        available[i] = TRUE;
+    if(orderVertices(graph, adj, position, vertexAtPosition) > MAXIMUM_BANDWIDTH){
+        count = enumeratePerfectMatchings(graph, adj, context);
+    } else {
+        count = countPerfectMatchings(graph, adj, context, position, vertexAtPosition);
     }
     
-    extendPerfectMatching(graph, adj);
-    
-    return perfectMatchingCount;
+    //the invariant is an int
+    if(count > INT_MAX){
+        exitTooManyPerfectMatchings();
+    }
+    return (int)count;
 }
\ No newline at end of file
@@ -20,7 +20,8 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
 
-int order(GRAPH graph, ADJACENCY adj){
+int order(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     return graph[0][0];
 }
\ No newline at end of file
@@ -21,130 +21,49 @@
  */
 
 #include "../multicode/shared/multicode_base.h"
+#include "shared/invariant_context.h"
+#include "shared/invariant_graph_data.h"
+#include "shared/flow_network.h"
 
-int directedGraph[2*(MAXN) + 1][2*(MAXN) + 1];
-
-boolean currentPath[2*(MAXN)+1];
-
-boolean findPath_impl(GRAPH graph, ADJACENCY adj, int currentVertex, int target) {
-    int j;
-    int order = graph[0][0];
-    
-    currentPath[currentVertex]=TRUE;
-    if(currentVertex==target){
-        return TRUE;
-    }
-
-    if(currentVertex <= order){ //in-vertex
-
-        for(j = 0; j < adj[currentVertex]; j++){
-            int nextVertex = graph[currentVertex][j] + order;
-            if(directedGraph[currentVertex][nextVertex]>0 && !currentPath[nextVertex]){
-                directedGraph[currentVertex][nextVertex]--;
-                directedGraph[nextVertex][currentVertex]++;
-                if(findPath_impl(graph, adj, nextVertex, target)){
-                    return TRUE;
-                } else {
-                    directedGraph[currentVertex][nextVertex]++;
-                    directedGraph[nextVertex][currentVertex]--;
-                }
-            }
-        }           
-        int nextVertex = currentVertex + order;
-        if(directedGraph[currentVertex][nextVertex]>0 && !currentPath[nextVertex]){
-            directedGraph[currentVertex][nextVertex]--;
-            directedGraph[nextVertex][currentVertex]++;
-            if(findPath_impl(graph, adj, nextVertex, target)){
-                return TRUE;
-            } else {
-                directedGraph[currentVertex][nextVertex]++;
-                directedGraph[nextVertex][currentVertex]--;
-            }
-        }     
-
-    } else { //out-vertex
-
-        for(j = 0; j < adj[currentVertex - order]; j++){
-            int nextVertex = graph[currentVertex - order][j];
-            if(directedGraph[currentVertex][nextVertex]>0 && !currentPath[nextVertex]){
-                directedGraph[currentVertex][nextVertex]--;
-                directedGraph[nextVertex][currentVertex]++;
-                if(findPath_impl(graph, adj, nextVertex, target)){
-                    return TRUE;
-                } else {
-                    directedGraph[currentVertex][nextVertex]++;
-                    directedGraph[nextVertex][currentVertex]--;
-                }
-            }
-        }           
-        int nextVertex = currentVertex - order;
-        if(directedGraph[currentVertex][nextVertex]>0 && !currentPath[nextVertex]){
-            directedGraph[currentVertex][nextVertex]--;
-            directedGraph[nextVertex][currentVertex]++;
-            if(findPath_impl(graph, adj, nextVertex, target)){
-                return TRUE;
-            } else {
-                directedGraph[currentVertex][nextVertex]++;
-                directedGraph[nextVertex][currentVertex]--;
-            }
-        }     
-
-    }
-
-    currentPath[currentVertex]=FALSE;
-    return FALSE;
-}
-
-//try to find a path from the current vertex to the target
-boolean findPath(GRAPH graph, ADJACENCY adj, int currentVertex, int target) {
-    int i;
-    for(i = 1; i <= 2*(graph[0][0]); i++){
-        currentPath[i] = FALSE;
-    }
-    return findPath_impl(graph, adj, currentVertex, target);
-}
-
+#define IS_NEIGHBOUR 0
 
 //returns the minimum of the maxflow of the st-network and satisfied
-int findMaxFlowInSTNetwork(GRAPH graph, ADJACENCY adj, int source, int target, int satisfied){
-    int i, j, order = graph[0][0];
-    
-    //construct directed graph
-    for(i = 1; i <= 2*order; i++){
-        for(j = 1; j <= 2*order; j++){
-            directedGraph[i][j] = 0;
-        }
-    }
-    for(i=1; i<=order; i++){
-        for(j = 0; j < adj[i]; j++){
-            directedGraph[i + order][graph[i][j]]++;
-        }
-        directedGraph[i][i + order] = 1;
-        
-    }
-    int pathCount = 0;
-    while(findPath(graph, adj, source + order, target) && pathCount < satisfied){
-        pathCount++;
-    }
-    return pathCount;
+static int findMaxFlowInSTNetwork(FLOW_NETWORK *network, int order, int source, int target, int satisfied){
+    resetFlowNetwork(network);
+    setFlowTerminal(network, source + order, FLOW_SOURCE);
+    setFlowTerminal(network, target, FLOW_TARGET);
+    return computeMaximumFlow(network, satisfied);
 }
 
-int vertex_connectivity(GRAPH graph, ADJACENCY adj){
+int vertex_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
     if(graph[0][0] < 2) return 0;
     
+    if(!isConnectedGraph(graph, adj, context)) return 0;
+    
     //find minimum degree (i.e., upperbound for vertex connectivity)
-    int minDeg = graph[0][0];
-    int i, j;
-    for(i = 1; i <= graph[0][0]; i++){
-        if(adj[i] < minDeg){
-            minDeg = adj[i];
-        }
-    }
+    int minDeg = getDegreeData(graph, adj, context)->minimumDegree;
+    int i, j, order = graph[0][0];
+    FLOW_NETWORK *network = prepareVertexFlowNetwork(graph, adj, context);
+    boolean *isNeighbour = getInvariantWorkspace(context, IS_NEIGHBOUR, sizeof(boolean)*(order + 1));
     
-    int minimumCutSize = minDeg;
+    /* A complete graph has connectivity order - 1. Otherwise the connectivity
+     * is the minimum over all pairs of non-adjacent vertices of the maximum
+     * number of internally disjoint paths, and by Even's argument it suffices
+     * to consider the pairs in which the smallest vertex is one of the first
+     * minimumCutSize + 1 vertices.
+     */
+    int minimumCutSize = minDeg < order - 1 ? minDeg : order - 1;
     for(i = 1; i <= minimumCutSize + 1; i++){
-        for(j = i; j <= graph[0][0]; j++){
-            minimumCutSize = findMaxFlowInSTNetwork(graph, adj, i, j, minimumCutSize);
+        for(j = 1; j <= order; j++){
+            isNeighbour[j] = FALSE;
+        }
+        for(j = 0; j < adj[i]; j++){
+            isNeighbour[graph[i][j]] = TRUE;
+        }
+        for(j = i + 1; j <= order; j++){
+            if(!isNeighbour[j]){
+                minimumCutSize = findMaxFlowInSTNetwork(network, order, i, j, minimumCutSize);
+            }
         }
     }
     return minimumCutSize;
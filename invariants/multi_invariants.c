@@ -0,0 +1,307 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads graphs in multicode format from standard in, computes
+ * several invariants for each graph and writes one row with the values per
+ * graph in CSV or TSV format to standard out. Each graph is decoded only once
+ * and data that is used by several invariants (e.g., the degrees or the cut
+ * vertices) is only computed once per graph.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o multi_invariants -O4 \
+ *     multi_invariants.c \
+ *     ../multicode/shared/multicode_base.c \
+ *     ../multicode/shared/multicode_input.c \
+ *     ../multicode/shared/multicode_output.c \
+ *     ../shared/code_reader.c \
+ *     shared/invariant_driver.c shared/invariant_context.c \
+ *     shared/invariant_graph_data.c \
+ *     connectivity/multi_connectivity.c \
+ *     multi_invariant_*.c -pthread
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "../multicode/shared/multicode_base.h"
+#include "../multicode/shared/multicode_input.h"
+#include "shared/invariant_driver.h"
+
+int order(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int maximumDegree(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int girth(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int chromaticNumber(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int edge_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int essential_edge_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int vertex_connectivity(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int numberPM(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCycles(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCyclesEnumeration(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCyclesInclusionExclusion(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCyclesBackend(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+double hamiltonianCyclesEdgeIncidence(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCyclesUniversalEdges(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+int hamiltonianCyclesUncoveredEdges(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isHamiltonian(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isTraceable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isWeakHypotraceable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean is2LeafStable(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean containsWheel(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean containsWheelLargeGraphs(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isPancyclic(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isEvenPancyclic(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+boolean isOverfull(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+boolean containsWheelAnyOrder(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    //the faster version uses bitsets and only supports graphs up to 63 vertices
+    if(graph[0][0] <= 63){
+        return containsWheel(graph, adj, context);
+    } else {
+        return containsWheelLargeGraphs(graph, adj, context);
+    }
+}
+
+typedef enum {INTEGER_VALUE, BOOLEAN_VALUE, REAL_VALUE} VALUE_TYPE;
+
+typedef struct __invariant_description {
+    const char *name;
+    VALUE_TYPE type;
+    //booleans are ints, so boolean invariants are stored as int invariants
+    int (*intInvariant)(GRAPH, ADJACENCY, INVARIANT_CONTEXT *);
+    double (*realInvariant)(GRAPH, ADJACENCY, INVARIANT_CONTEXT *);
+    const char *description;
+} INVARIANT_DESCRIPTION;
+
+INVARIANT_DESCRIPTION invariants[] = {
+    {"order", INTEGER_VALUE, order, NULL, "number of vertices"},
+    {"maximum_degree", INTEGER_VALUE, maximumDegree, NULL, "maximum degree"},
+    {"girth", INTEGER_VALUE, girth, NULL, "length of a shortest cycle"},
+    {"chromatic_number", INTEGER_VALUE, chromaticNumber, NULL, "chromatic number"},
+    {"edge_connectivity", INTEGER_VALUE, edge_connectivity, NULL, "edge connectivity"},
+    {"essential_edge_connectivity", INTEGER_VALUE, essential_edge_connectivity, NULL, "essential edge connectivity"},
+    {"vertex_connectivity", INTEGER_VALUE, vertex_connectivity, NULL, "vertex connectivity"},
+    {"number_of_perfect_matchings", INTEGER_VALUE, numberPM, NULL, "number of perfect matchings"},
+    {"hamiltonian_cycles", INTEGER_VALUE, hamiltonianCycles, NULL, "number of hamiltonian cycles"},
+    {"hamiltonian_cycles_enumeration", INTEGER_VALUE, hamiltonianCyclesEnumeration, NULL,
+            "number of hamiltonian cycles, counted by enumerating them"},
+    {"hamiltonian_cycles_inclusion_exclusion", INTEGER_VALUE, hamiltonianCyclesInclusionExclusion, NULL,
+            "number of hamiltonian cycles, counted by inclusion-exclusion"},
+    {"hamiltonian_cycles_backend", INTEGER_VALUE, hamiltonianCyclesBackend, NULL,
+            "method used by hamiltonian_cycles (0: enumeration, 1: inclusion-exclusion)"},
+    {"hamiltonian_cycles_edge_incidence", REAL_VALUE, NULL, hamiltonianCyclesEdgeIncidence,
+            "ratio of edges in no hamiltonian cycle to edges in all hamiltonian cycles"},
+    {"hamiltonian_cycles_universal_edges", INTEGER_VALUE, hamiltonianCyclesUniversalEdges, NULL,
+            "number of edges that lie in all hamiltonian cycles"},
+    {"hamiltonian_cycles_uncovered_edges", INTEGER_VALUE, hamiltonianCyclesUncoveredEdges, NULL,
+            "number of edges that do not lie in any hamiltonian cycle"},
+    {"is_hamiltonian", BOOLEAN_VALUE, isHamiltonian, NULL, "hamiltonian"},
+    {"is_traceable", BOOLEAN_VALUE, isTraceable, NULL, "traceable"},
+    {"is_weak_hypotraceable", BOOLEAN_VALUE, isWeakHypotraceable, NULL, "weak hypotraceable"},
+    {"is_2_leaf_stable", BOOLEAN_VALUE, is2LeafStable, NULL, "2-leaf-stable"},
+    {"is_hamiltonian_connected", BOOLEAN_VALUE, isHamiltonianConnected, NULL, "hamiltonian connected"},
+    {"contains_wheel", BOOLEAN_VALUE, containsWheelAnyOrder, NULL, "contains a wheel"},
+    {"is_pancyclic", BOOLEAN_VALUE, isPancyclic, NULL, "pancyclic"},
+    {"is_even_pancyclic", BOOLEAN_VALUE, isEvenPancyclic, NULL, "even pancyclic"},
+    {"is_overfull", BOOLEAN_VALUE, isOverfull, NULL, "overfull"}
+};
+
+#define INVARIANT_COUNT (sizeof(invariants)/sizeof(INVARIANT_DESCRIPTION))
+
+typedef union __invariant_value {
+    int intValue;
+    double realValue;
+} INVARIANT_VALUE;
+
+INVARIANT_DESCRIPTION **selectedInvariants;
+int selectedCount;
+
+char separator = ',';
+
+int graphCount = 0;
+
+void computeInvariants(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context, void *result){
+    INVARIANT_VALUE *values = (INVARIANT_VALUE *)result;
+    int i;
+
+    for(i = 0; i < selectedCount; i++){
+        //each invariant has its own workspace, but all share the graph data
+        INVARIANT_CONTEXT *subcontext = getInvariantSubcontext(context, i);
+        if(selectedInvariants[i]->type == REAL_VALUE){
+            values[i].realValue = selectedInvariants[i]->realInvariant(graph, adj, subcontext);
+        } else {
+            values[i].intValue = selectedInvariants[i]->intInvariant(graph, adj, subcontext);
+        }
+    }
+}
+
+void writeRow(unsigned long long graphNumber, CODE_VIEW *view, void *result, void *data){
+    INVARIANT_VALUE *values = (INVARIANT_VALUE *)result;
+    int i;
+
+    graphCount = graphNumber;
+
+    fprintf(stdout, "%llu", graphNumber);
+    for(i = 0; i < selectedCount; i++){
+        switch(selectedInvariants[i]->type){
+            case INTEGER_VALUE:
+                fprintf(stdout, "%c%d", separator, values[i].intValue);
+                break;
+            case BOOLEAN_VALUE:
+                fprintf(stdout, "%c%d", separator, values[i].intValue ? 1 : 0);
+                break;
+            case REAL_VALUE:
+                fprintf(stdout, "%c%f", separator, values[i].realValue);
+                break;
+        }
+    }
+    fprintf(stdout, "\n");
+}
+
+void writeHeader(){
+    int i;
+
+    fprintf(stdout, "graph");
+    for(i = 0; i < selectedCount; i++){
+        fprintf(stdout, "%c%s", separator, selectedInvariants[i]->name);
+    }
+    fprintf(stdout, "\n");
+}
+
+INVARIANT_DESCRIPTION *findInvariant(const char *name){
+    int i;
+
+    for(i = 0; i < INVARIANT_COUNT; i++){
+        if(!strcmp(invariants[i].name, name)){
+            return invariants + i;
+        }
+    }
+    return NULL;
+}
+
+//====================== USAGE =======================
+
+void listInvariants(){
+    int i;
+
+    for(i = 0; i < INVARIANT_COUNT; i++){
+        fprintf(stderr, "    %-40s %s%s\n", invariants[i].name, invariants[i].description,
+                invariants[i].type == BOOLEAN_VALUE ? " (1 or 0)" : "");
+    }
+}
+
+void help(char *name) {
+    fprintf(stderr, "The program %s calculates several invariants at once\nfor graphs in multicode format.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] invariant [invariant ...]\n\n", name);
+    fprintf(stderr, "For each graph one row is written with the number of the graph followed by\n");
+    fprintf(stderr, "the values of the invariants in the given order.\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
+    fprintf(stderr, "graphs.\n\n");
+    fprintf(stderr, "Valid invariants\n================\n");
+    listInvariants();
+    fprintf(stderr, "\nValid options\n=============\n");
+    fprintf(stderr, "    -t, --tsv\n");
+    fprintf(stderr, "       Separate the values by tabs instead of commas.\n");
+    fprintf(stderr, "    -n, --no-header\n");
+    fprintf(stderr, "       Do not write a header row with the names of the invariants.\n");
+    fprintf(stderr, "    -j #, --threads #\n");
+    fprintf(stderr, "       Compute the invariants with the specified number of threads.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] invariant [invariant ...]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    int threads = 1;
+    boolean writeHeaderRow = TRUE;
+    int i;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"tsv", no_argument, NULL, 't'},
+        {"no-header", no_argument, NULL, 'n'},
+        {"threads", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "htnj:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 't':
+                separator = '\t';
+                break;
+            case 'n':
+                writeHeaderRow = FALSE;
+                break;
+            case 'j':
+                threads = atoi(optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(argc == optind){
+        fprintf(stderr, "No invariants specified.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    selectedCount = argc - optind;
+    selectedInvariants = (INVARIANT_DESCRIPTION **)malloc(sizeof(INVARIANT_DESCRIPTION *)*selectedCount);
+    if(selectedInvariants == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        return EXIT_FAILURE;
+    }
+    for(i = 0; i < selectedCount; i++){
+        selectedInvariants[i] = findInvariant(argv[optind + i]);
+        if(selectedInvariants[i] == NULL){
+            fprintf(stderr, "Unknown invariant %s.\n", argv[optind + i]);
+            usage(name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(writeHeaderRow){
+        writeHeader();
+    }
+
+    CODE_READER *reader = newMultiCodeReader(stdin);
+    runInvariant(reader, threads, computeInvariants, sizeof(INVARIANT_VALUE)*selectedCount, writeRow, NULL);
+    freeCodeReader(reader);
+
+    free(selectedInvariants);
+
+    fprintf(stderr, "Read %d graph%s.\n", graphCount, graphCount==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
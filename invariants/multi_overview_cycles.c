@@ -12,7 +12,7 @@
  * Compile like this:
  *     
  *     cc -o multi_overview_cycles -O4 ../multicode/shared/multicode_base.c\
- *     ../multicode/shared/multicode_input.c multi_overview_cycles.c
+ *     ../multicode/shared/multicode_input.c ../shared/frequency_table.c multi_overview_cycles.c
  */
 
 #include <stdio.h>
@@ -23,18 +23,11 @@
 
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
-
-typedef struct freqTable {
-    int key;
-    int frequency;
-    
-    struct freqTable *smaller;
-    struct freqTable *larger;
-} FREQUENCY_TABLE;
+#include "../shared/frequency_table.h"
 
 boolean verticesInCycle[MAXN+1];
 
-FREQUENCY_TABLE *overviewTable = NULL;
+FREQUENCY_TABLE *overviewTable;
 
 boolean interrupted = FALSE;
 
@@ -56,50 +49,22 @@ void handleAlarmSignal(int sig){
     }
 }
 
-FREQUENCY_TABLE *newFrequencyTableElement(int key){
-    FREQUENCY_TABLE *fte = malloc(sizeof(FREQUENCY_TABLE));
-    
-    fte->key = key;
-    fte->frequency = 1;
-    
-    fte->smaller = fte->larger = NULL;
-    
-    return fte;
-}
+void printOverview(FREQUENCY_TABLE *ft){
+    int i;
 
-void freeFrequencyTable(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
-    } else {
-        freeFrequencyTable(ft->smaller);
-        freeFrequencyTable(ft->larger);
-        free(ft);
+    sortFrequencyTable(ft);
+    for(i = 0; i < ft->size; i++){
+        fprintf(stderr, "%llu cycle%s with %d vertices.\n",
+                ft->entries[i].frequency, ft->entries[i].frequency == 1 ? "" : "s",
+                ft->entries[i].key);
     }
 }
 
-void addToFrequencyTable(FREQUENCY_TABLE *ft, int key){
-   if(ft->key == key){
-       ft->frequency++;
-   } else if(ft->key > key) {
-       if(ft->smaller == NULL){
-           ft->smaller = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->smaller, key);
-       }
-   } else {
-       if(ft->larger == NULL){
-           ft->larger = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->larger, key);
-       }
-   }
-}
-
 void handleSimpleCycle(int size){
-    if(overviewTable==NULL){
-        overviewTable = newFrequencyTableElement(size);
-    } else {
-        addToFrequencyTable(overviewTable, size);
+    addToFrequencyTable(overviewTable, size, 1);
+    if(isFrequencyTableSnapshotDue(overviewTable)){
+        fprintf(stderr, "Intermediate overview:\n");
+        printOverview(overviewTable);
     }
 }
 
@@ -162,17 +127,6 @@ void buildOverviewTable(GRAPH graph, ADJACENCY adj){
     }
 }
 
-void printOverview(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
-    }
-    
-    printOverview(ft->smaller);
-    fprintf(stderr, "%d cycle%s with %d vertices.\n",
-            ft->frequency, ft->frequency == 1 ? "" : "s", ft->key);
-    printOverview(ft->larger);
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -185,6 +139,9 @@ void help(char *name) {
     fprintf(stderr, "    -t n\n");
     fprintf(stderr, "    --timeout n\n");
     fprintf(stderr, "       Stop looking for wheels after n seconds.\n");
+    fprintf(stderr, "    -s n\n");
+    fprintf(stderr, "    --snapshot n\n");
+    fprintf(stderr, "       Print the overview found so far for the current graph every n seconds.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -199,6 +156,7 @@ void usage(char *name) {
  */
 int main(int argc, char** argv) {
     unsigned long int timeOut = 0;
+    unsigned int snapshotInterval = 0;
     
     GRAPH graph;
     ADJACENCY adj;
@@ -209,15 +167,19 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"timeout", required_argument, NULL, 't'},
+        {"snapshot", required_argument, NULL, 's'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "ht:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "ht:s:", long_options, &option_index)) != -1) {
         switch (c) {
             case 't':
                 timeOut = strtoul(optarg, NULL, 10);
                 break;
+            case 's':
+                snapshotInterval = strtoul(optarg, NULL, 10);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -241,18 +203,22 @@ int main(int argc, char** argv) {
         alarm(timeOut);
     }
     
+    overviewTable = newFrequencyTable();
+    
     unsigned short code[MAXCODELENGTH];
     int length;
     while (!interrupted && readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+        decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
         
+        setFrequencyTableSnapshotInterval(overviewTable, snapshotInterval);
         buildOverviewTable(graph, adj);
         
         printOverview(overviewTable);
         
-        freeFrequencyTable(overviewTable);
-        overviewTable = NULL;
+        clearFrequencyTable(overviewTable);
     }
+    
+    freeFrequencyTable(overviewTable);
 
     return (EXIT_SUCCESS);
 }
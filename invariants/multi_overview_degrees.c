@@ -12,7 +12,8 @@
  * Compile like this:
  *     
  *     cc -o multi_overview_degrees -O4 ../multicode/shared/multicode_base.c\
- *     ../multicode/shared/multicode_input.c multi_overview_degrees.c
+ *     ../multicode/shared/multicode_input.c ../multicode/shared/multicode_csr.c\
+ *     ../shared/frequency_table.c multi_overview_degrees.c
  */
 
 #include <stdio.h>
@@ -23,16 +24,11 @@
 
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
+#include "../multicode/shared/multicode_csr.h"
+#include "../shared/frequency_table.h"
 
-typedef struct freqTable {
-    int key;
-    int frequency;
-    
-    struct freqTable *smaller;
-    struct freqTable *larger;
-} FREQUENCY_TABLE;
-
-FREQUENCY_TABLE *overviewTable = NULL;
+FREQUENCY_TABLE *overviewTable;
+FREQUENCY_TABLE *summaryTable = NULL;
 
 boolean interrupted = FALSE;
 
@@ -54,66 +50,26 @@ void handleAlarmSignal(int sig){
     }
 }
 
-FREQUENCY_TABLE *newFrequencyTableElement(int key){
-    FREQUENCY_TABLE *fte = malloc(sizeof(FREQUENCY_TABLE));
-    
-    fte->key = key;
-    fte->frequency = 1;
-    
-    fte->smaller = fte->larger = NULL;
-    
-    return fte;
-}
-
-void freeFrequencyTable(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
-    } else {
-        freeFrequencyTable(ft->smaller);
-        freeFrequencyTable(ft->larger);
-        free(ft);
-    }
-}
-
-void addToFrequencyTable(FREQUENCY_TABLE *ft, int key){
-   if(ft->key == key){
-       ft->frequency++;
-   } else if(ft->key > key) {
-       if(ft->smaller == NULL){
-           ft->smaller = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->smaller, key);
-       }
-   } else {
-       if(ft->larger == NULL){
-           ft->larger = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->larger, key);
-       }
-   }
-}
-
-void buildOverviewTable(GRAPH graph, ADJACENCY adj){
+void buildOverviewTable(CSR_GRAPH *graph){
     int v;
-    int order = graph[0][0];
-    
-    overviewTable = newFrequencyTableElement(adj[1]);
+    int order = CSR_ORDER(graph);
     
-    for(v = 2; v <= order; v++){
-        addToFrequencyTable(overviewTable, adj[v]);
+    for(v = 1; v <= order; v++){
+        addToFrequencyTable(overviewTable, CSR_DEGREE(graph, v), 1);
         if(interrupted) break;
     }
 }
 
 void printOverview(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
+    int i;
+
+    sortFrequencyTable(ft);
+    for(i = 0; i < ft->size; i++){
+        fprintf(stderr, "%llu %s with degree %d.\n",
+                ft->entries[i].frequency,
+                ft->entries[i].frequency == 1 ? "vertex" : "vertices",
+                ft->entries[i].key);
     }
-    
-    printOverview(ft->smaller);
-    fprintf(stderr, "%d %s with degree %d.\n",
-            ft->frequency, ft->frequency == 1 ? "vertex" : "vertices", ft->key);
-    printOverview(ft->larger);
 }
 
 //====================== USAGE =======================
@@ -129,6 +85,9 @@ void help(char *name) {
     fprintf(stderr, "    --timeout n\n");
     fprintf(stderr, "       Stop building the overview after n seconds and use the data found up to\n");
     fprintf(stderr, "       that moment.\n");
+    fprintf(stderr, "    -s, --summary\n");
+    fprintf(stderr, "       Also give an overview of the degrees in all graphs together after the\n");
+    fprintf(stderr, "       last graph.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -144,8 +103,8 @@ void usage(char *name) {
 int main(int argc, char** argv) {
     unsigned long int timeOut = 0;
     
-    GRAPH graph;
-    ADJACENCY adj;
+    CSR_GRAPH *graph = newCsrGraph(0, 0);
+    overviewTable = newFrequencyTable();
 
     /*=========== commandline parsing ===========*/
 
@@ -153,15 +112,19 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"timeout", required_argument, NULL, 't'},
+        {"summary", no_argument, NULL, 's'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "ht:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hst:", long_options, &option_index)) != -1) {
         switch (c) {
             case 't':
                 timeOut = strtoul(optarg, NULL, 10);
                 break;
+            case 's':
+                summaryTable = newFrequencyTable();
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -188,15 +151,27 @@ int main(int argc, char** argv) {
     unsigned short code[MAXCODELENGTH];
     int length;
     while (!interrupted && readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+        decodeMultiCodeToCsr(code, length, graph);
         
-        buildOverviewTable(graph, adj);
+        buildOverviewTable(graph);
         
         printOverview(overviewTable);
         
-        freeFrequencyTable(overviewTable);
-        overviewTable = NULL;
+        if(summaryTable != NULL){
+            mergeFrequencyTables(summaryTable, overviewTable);
+        }
+        
+        clearFrequencyTable(overviewTable);
     }
+    
+    if(summaryTable != NULL){
+        fprintf(stderr, "All graphs together:\n");
+        printOverview(summaryTable);
+        freeFrequencyTable(summaryTable);
+    }
+    
+    freeFrequencyTable(overviewTable);
+    freeCsrGraph(graph);
 
     return (EXIT_SUCCESS);
 }
@@ -12,7 +12,7 @@
  * Compile like this:
  *     
  *     cc -o multi_wheels_overview -O4 ../multicode/shared/multicode_base.c\
- *     ../multicode/shared/multicode_input.c multi_wheels_overview.c
+ *     ../multicode/shared/multicode_input.c ../shared/frequency_table.c multi_wheels_overview.c
  */
 
 #include <stdio.h>
@@ -23,20 +23,13 @@
 
 #include "../multicode/shared/multicode_base.h"
 #include "../multicode/shared/multicode_input.h"
-
-typedef struct freqTable {
-    int key;
-    int frequency;
-    
-    struct freqTable *smaller;
-    struct freqTable *larger;
-} FREQUENCY_TABLE;
+#include "../shared/frequency_table.h"
 
 boolean verticesInCycle[MAXN+1];
 boolean neighbourhoods[MAXN+1][MAXN+1];
 boolean universalNeighbours[MAXN+1][MAXN+1];
 
-FREQUENCY_TABLE *wheelsTable = NULL;
+FREQUENCY_TABLE *wheelsTable;
 
 boolean interrupted = FALSE;
 
@@ -58,54 +51,34 @@ void handleAlarmSignal(int sig){
     }
 }
 
-FREQUENCY_TABLE *newFrequencyTableElement(int key){
-    FREQUENCY_TABLE *fte = malloc(sizeof(FREQUENCY_TABLE));
-    
-    fte->key = key;
-    fte->frequency = 1;
-    
-    fte->smaller = fte->larger = NULL;
-    
-    return fte;
-}
+/* An intermediate overview is printed while the graph is still being
+ * searched, so the wheels with 3 spokes need not be found 4 times yet.
+ */
+void printWheelsOverview(FREQUENCY_TABLE *ft, boolean intermediate){
+    int i;
 
-void freeFrequencyTable(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
-    } else {
-        freeFrequencyTable(ft->smaller);
-        freeFrequencyTable(ft->larger);
-        free(ft);
+    sortFrequencyTable(ft);
+    for(i = 0; i < ft->size; i++){
+        unsigned long long frequency = ft->entries[i].frequency;
+        if(ft->entries[i].key==3){
+            //each wheel with 3 spokes is a K4 and is found 4 times
+            if(!interrupted && !intermediate && (frequency % 4 != 0)){
+                fprintf(stderr, "ERROR -- wrong number of wheels with 3 spokes!\n");
+                exit(EXIT_FAILURE);
+            }
+            frequency /= 4;
+        }
+        fprintf(stderr, "%llu wheel%s with %d spokes.\n",
+                frequency, frequency == 1 ? "" : "s", ft->entries[i].key);
     }
 }
 
-void addToFrequencyTable(FREQUENCY_TABLE *ft, int key){
-   if(ft->key == key){
-       ft->frequency++;
-   } else if(ft->key > key) {
-       if(ft->smaller == NULL){
-           ft->smaller = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->smaller, key);
-       }
-   } else {
-       if(ft->larger == NULL){
-           ft->larger = newFrequencyTableElement(key);
-       } else {
-           addToFrequencyTable(ft->larger, key);
-       }
-   }
-}
-
 void handleSimpleCycle(int size, int universalNeighbourCount){
     //if there is a universal neighbour then we have a wheel
-    int i;
-    for(i = 0; i < universalNeighbourCount; i++){
-        if(wheelsTable==NULL){
-            wheelsTable = newFrequencyTableElement(size);
-        } else {
-            addToFrequencyTable(wheelsTable, size);
-        }
+    addToFrequencyTable(wheelsTable, size, universalNeighbourCount);
+    if(isFrequencyTableSnapshotDue(wheelsTable)){
+        fprintf(stderr, "Intermediate overview:\n");
+        printWheelsOverview(wheelsTable, TRUE);
     }
 }
 
@@ -198,26 +171,6 @@ void buildWheelsTable(GRAPH graph, ADJACENCY adj){
     }
 }
 
-void printWheelsOverview(FREQUENCY_TABLE *ft){
-    if(ft == NULL){
-        return;
-    }
-    
-    printWheelsOverview(ft->smaller);
-    if(ft->key==3){
-        if(!interrupted && (ft->frequency % 4 != 0)){
-            fprintf(stderr, "ERROR -- wrong number of wheels with 3 spokes!\n");
-            exit(EXIT_FAILURE);
-        }
-        fprintf(stderr, "%d wheel%s with %d spokes.\n",
-                (ft->frequency)/4, (ft->frequency)/4 == 1 ? "" : "s", ft->key);
-    } else {
-        fprintf(stderr, "%d wheel%s with %d spokes.\n",
-                ft->frequency, ft->frequency == 1 ? "" : "s", ft->key);
-    }
-    printWheelsOverview(ft->larger);
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -230,6 +183,9 @@ void help(char *name) {
     fprintf(stderr, "    -t n\n");
     fprintf(stderr, "    --timeout n\n");
     fprintf(stderr, "       Stop looking for wheels after n seconds.\n");
+    fprintf(stderr, "    -s n\n");
+    fprintf(stderr, "    --snapshot n\n");
+    fprintf(stderr, "       Print the overview found so far for the current graph every n seconds.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -244,6 +200,7 @@ void usage(char *name) {
  */
 int main(int argc, char** argv) {
     unsigned long int timeOut = 0;
+    unsigned int snapshotInterval = 0;
     
     GRAPH graph;
     ADJACENCY adj;
@@ -254,15 +211,19 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"timeout", required_argument, NULL, 't'},
+        {"snapshot", required_argument, NULL, 's'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "ht:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "ht:s:", long_options, &option_index)) != -1) {
         switch (c) {
             case 't':
                 timeOut = strtoul(optarg, NULL, 10);
                 break;
+            case 's':
+                snapshotInterval = strtoul(optarg, NULL, 10);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -286,18 +247,22 @@ int main(int argc, char** argv) {
         alarm(timeOut);
     }
     
+    wheelsTable = newFrequencyTable();
+    
     unsigned short code[MAXCODELENGTH];
     int length;
     while (!interrupted && readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+        decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
         
+        setFrequencyTableSnapshotInterval(wheelsTable, snapshotInterval);
         buildWheelsTable(graph, adj);
         
-        printWheelsOverview(wheelsTable);
+        printWheelsOverview(wheelsTable, FALSE);
         
-        freeFrequencyTable(wheelsTable);
-        wheelsTable = NULL;
+        clearFrequencyTable(wheelsTable);
     }
+    
+    freeFrequencyTable(wheelsTable);
 
     return (EXIT_SUCCESS);
 }
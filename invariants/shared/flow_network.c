@@ -0,0 +1,222 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "flow_network.h"
+
+#define NETWORK 0
+#define ARC_DATA 1
+#define NODE_DATA 2
+
+static FLOW_NETWORK *_allocateFlowNetwork(INVARIANT_CONTEXT *context, int nodeCount, int maximumArcCount){
+    int v;
+    INVARIANT_CONTEXT *networkContext = getInvariantSubcontext(context, 0);
+    FLOW_NETWORK *network = getInvariantWorkspace(networkContext, NETWORK, sizeof(FLOW_NETWORK));
+    //4 arrays indexed by arc and 6 arrays indexed by node
+    int *arcData = getInvariantWorkspace(networkContext, ARC_DATA, sizeof(int)*4*maximumArcCount);
+    int *nodeData = getInvariantWorkspace(networkContext, NODE_DATA, sizeof(int)*6*(nodeCount + 1));
+
+    network->nodeCount = nodeCount;
+    network->arcCount = 0;
+    network->nextArc = arcData;
+    network->head = arcData + maximumArcCount;
+    network->capacity = arcData + 2*maximumArcCount;
+    network->residual = arcData + 3*maximumArcCount;
+    network->firstArc = nodeData;
+    network->terminal = nodeData + (nodeCount + 1);
+    network->level = nodeData + 2*(nodeCount + 1);
+    network->currentArc = nodeData + 3*(nodeCount + 1);
+    network->queue = nodeData + 4*(nodeCount + 1);
+    network->path = nodeData + 5*(nodeCount + 1);
+
+    for(v = 0; v <= nodeCount; v++){
+        network->firstArc[v] = -1;
+    }
+
+    return network;
+}
+
+//adds an arc from u to v and the reverse arc from v to u
+static void _addArcPair(FLOW_NETWORK *network, int u, int v, int capacityUV, int capacityVU){
+    int a = network->arcCount;
+
+    network->head[a] = v;
+    network->capacity[a] = capacityUV;
+    network->nextArc[a] = network->firstArc[u];
+    network->firstArc[u] = a;
+
+    network->head[a + 1] = u;
+    network->capacity[a + 1] = capacityVU;
+    network->nextArc[a + 1] = network->firstArc[v];
+    network->firstArc[v] = a + 1;
+
+    network->arcCount += 2;
+}
+
+FLOW_NETWORK *prepareEdgeFlowNetwork(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int v, i, order = graph[0][0], arcCount = 0;
+    FLOW_NETWORK *network;
+
+    for(v = 1; v <= order; v++){
+        arcCount += adj[v];
+    }
+    network = _allocateFlowNetwork(context, order, arcCount);
+
+    //each edge is added from its smallest end
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < adj[v]; i++){
+            if(v < graph[v][i]){
+                _addArcPair(network, v, graph[v][i], 1, 1);
+            }
+        }
+    }
+    resetFlowNetwork(network);
+
+    return network;
+}
+
+FLOW_NETWORK *prepareVertexFlowNetwork(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int v, i, order = graph[0][0], arcCount = 2*order;
+    FLOW_NETWORK *network;
+
+    for(v = 1; v <= order; v++){
+        arcCount += 2*adj[v];
+    }
+    network = _allocateFlowNetwork(context, 2*order, arcCount);
+
+    for(v = 1; v <= order; v++){
+        _addArcPair(network, v, v + order, 1, 0);
+        for(i = 0; i < adj[v]; i++){
+            if(v != graph[v][i]){
+                _addArcPair(network, v + order, graph[v][i], 1, 0);
+            }
+        }
+    }
+    resetFlowNetwork(network);
+
+    return network;
+}
+
+void resetFlowNetwork(FLOW_NETWORK *network){
+    int i;
+
+    for(i = 0; i < network->arcCount; i++){
+        network->residual[i] = network->capacity[i];
+    }
+    for(i = 0; i <= network->nodeCount; i++){
+        network->terminal[i] = 0;
+    }
+}
+
+void setFlowTerminal(FLOW_NETWORK *network, int node, int type){
+    network->terminal[node] = type;
+}
+
+/* Computes the distance in the residual network from the sources to each
+ * node. Returns TRUE if a target can be reached.
+ */
+static boolean _buildLevels(FLOW_NETWORK *network){
+    int v, a, head = 0, tail = 0;
+    boolean targetReached = FALSE;
+
+    for(v = 1; v <= network->nodeCount; v++){
+        if(network->terminal[v] == FLOW_SOURCE){
+            network->level[v] = 0;
+            network->queue[tail++] = v;
+        } else {
+            network->level[v] = -1;
+        }
+    }
+
+    while(head < tail){
+        v = network->queue[head++];
+        for(a = network->firstArc[v]; a != -1; a = network->nextArc[a]){
+            int w = network->head[a];
+            if(network->residual[a] > 0 && network->level[w] == -1){
+                network->level[w] = network->level[v] + 1;
+                if(network->terminal[w] == FLOW_TARGET){
+                    //no need to continue from a target
+                    targetReached = TRUE;
+                } else {
+                    network->queue[tail++] = w;
+                }
+            }
+        }
+    }
+
+    return targetReached;
+}
+
+/* Augments along paths from source in the layered network until there are no
+ * more such paths or until the flow reaches limit. Returns the new value of
+ * the flow.
+ */
+static int _augmentFromSource(FLOW_NETWORK *network, int source, int flow, int limit){
+    int v = source, depth = 0;
+    int *path = network->path;
+
+    while(flow < limit){
+        if(network->terminal[v] == FLOW_TARGET){
+            int i, bottleneck = limit - flow;
+            for(i = 0; i < depth; i++){
+                if(network->residual[path[i]] < bottleneck){
+                    bottleneck = network->residual[path[i]];
+                }
+            }
+            for(i = 0; i < depth; i++){
+                network->residual[path[i]] -= bottleneck;
+                network->residual[path[i]^1] += bottleneck;
+            }
+            flow += bottleneck;
+            v = source;
+            depth = 0;
+            continue;
+        }
+
+        //advance along the first usable arc
+        while(network->currentArc[v] != -1){
+            int a = network->currentArc[v];
+            int w = network->head[a];
+            if(network->residual[a] > 0 && network->level[w] == network->level[v] + 1){
+                break;
+            }
+            network->currentArc[v] = network->nextArc[a];
+        }
+
+        if(network->currentArc[v] != -1){
+            int a = network->currentArc[v];
+            path[depth++] = a;
+            v = network->head[a];
+        } else if(depth == 0){
+            break;
+        } else {
+            //v is a dead end: retreat and skip the arc that led to v
+            int a = path[--depth];
+            network->level[v] = -1;
+            v = network->head[a^1];
+            network->currentArc[v] = network->nextArc[a];
+        }
+    }
+
+    return flow;
+}
+
+int computeMaximumFlow(FLOW_NETWORK *network, int limit){
+    int v, flow = 0;
+
+    while(flow < limit && _buildLevels(network)){
+        for(v = 1; v <= network->nodeCount; v++){
+            network->currentArc[v] = network->firstArc[v];
+        }
+        for(v = 1; v <= network->nodeCount && flow < limit; v++){
+            if(network->terminal[v] == FLOW_SOURCE){
+                flow = _augmentFromSource(network, v, flow, limit);
+            }
+        }
+    }
+
+    return flow;
+}
@@ -0,0 +1,96 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef FLOW_NETWORK_H
+#define	FLOW_NETWORK_H
+
+#include "../../multicode/shared/multicode_base.h"
+#include "invariant_context.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A flow network with integer capacities in which maximum flows are computed
+ * with Dinic's algorithm: the residual network is layered by a breadth-first
+ * search and a blocking flow in the layered network is found by an iterative
+ * depth-first search.
+ *
+ * The arcs leaving a node are stored as a linked list. Arcs are created in
+ * pairs: the reverse of arc a is arc a^1. The network is built once per graph
+ * and can then be used for any number of flow computations, each of which only
+ * restores the residual capacities.
+ */
+
+typedef struct __flow_network {
+    //nodes are numbered 1 up to nodeCount
+    int nodeCount;
+    int arcCount;
+
+    //the first arc leaving each node or -1
+    int *firstArc;
+    //for each arc: the next arc leaving the same node or -1
+    int *nextArc;
+    int *head;
+    int *capacity;
+    int *residual;
+
+    //SOURCE, TARGET or 0 for each node
+    int *terminal;
+
+    //arrays used by Dinic's algorithm
+    int *level;
+    int *currentArc;
+    int *queue;
+    int *path;
+} FLOW_NETWORK;
+
+#define FLOW_SOURCE 1
+#define FLOW_TARGET 2
+
+/**
+ * Returns a network in which each edge of the graph corresponds to a pair of
+ * arcs with capacity 1 in both directions, so a maximum flow is a maximum set
+ * of edge-disjoint paths. Loops are ignored. The memory is taken from
+ * subcontext 0 of the context.
+ */
+FLOW_NETWORK *prepareEdgeFlowNetwork(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns a network in which each vertex v is split into an in-node v and an
+ * out-node v + order which are joined by an arc with capacity 1. Each edge uv
+ * corresponds to an arc from the out-node of u to the in-node of v and an arc
+ * from the out-node of v to the in-node of u. A maximum flow from the out-node
+ * of s to the in-node of t is a maximum set of internally disjoint paths from
+ * s to t. Loops are ignored. The memory is taken from subcontext 0 of the
+ * context.
+ */
+FLOW_NETWORK *prepareVertexFlowNetwork(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Removes all flow and all sources and targets from the network.
+ */
+void resetFlowNetwork(FLOW_NETWORK *network);
+
+/**
+ * Marks a node as a source (FLOW_SOURCE) or a target (FLOW_TARGET).
+ */
+void setFlowTerminal(FLOW_NETWORK *network, int node, int type);
+
+/**
+ * Augments the current flow from the sources to the targets until it is
+ * maximum or until its value reaches limit, and returns the value of the
+ * flow.
+ */
+int computeMaximumFlow(FLOW_NETWORK *network, int limit);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FLOW_NETWORK_H */
+
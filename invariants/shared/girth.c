@@ -0,0 +1,228 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "girth.h"
+#include <limits.h>
+
+#define CURRENT_STAMP 0
+#define STAMPS 1
+#define LEVELS 2
+#define BITSETS 3
+
+typedef unsigned long long int bitset;
+
+typedef struct __girth_search {
+    int *currentStamp;
+    //the level of v is only valid if stamp[v] == *currentStamp
+    int *stamp;
+    int *level;
+    int *queue;
+} GIRTH_SEARCH;
+
+static void _prepareGirthSearch(GIRTH_SEARCH *search, int order, INVARIANT_CONTEXT *context){
+    INVARIANT_CONTEXT *searchContext = getInvariantSubcontext(context, 0);
+
+    search->currentStamp = getInvariantWorkspace(searchContext, CURRENT_STAMP, sizeof(int));
+    search->stamp = getInvariantWorkspace(searchContext, STAMPS, sizeof(int)*(order + 1));
+    search->level = getInvariantWorkspace(searchContext, LEVELS, sizeof(int)*2*(order + 1));
+    search->queue = search->level + order + 1;
+}
+
+//invalidates all levels
+static void _nextStamp(GIRTH_SEARCH *search, int order){
+    int i;
+
+    if(*search->currentStamp == INT_MAX){
+        for(i = 0; i <= order; i++){
+            search->stamp[i] = 0;
+        }
+        *search->currentStamp = 0;
+    }
+    (*search->currentStamp)++;
+}
+
+/* Returns a lower bound for the girth: 1 if the graph has a loop, 2 if it has
+ * a multi-edge, 4 if it is bipartite and 3 otherwise.
+ */
+static int _girthLowerBound(GRAPH graph, ADJACENCY adj, GIRTH_SEARCH *search){
+    int i, v, head, tail;
+    int order = graph[0][0];
+    boolean bipartite = TRUE;
+    boolean hasMultiEdge = FALSE;
+
+    for(v = 1; v <= order; v++){
+        _nextStamp(search, order);
+        for(i = 0; i < adj[v]; i++){
+            if(graph[v][i] == v){
+                return 1;
+            } else if(search->stamp[graph[v][i]] == *search->currentStamp){
+                hasMultiEdge = TRUE;
+            }
+            search->stamp[graph[v][i]] = *search->currentStamp;
+        }
+    }
+    if(hasMultiEdge){
+        return 2;
+    }
+
+    _nextStamp(search, order);
+    for(v = 1; v <= order && bipartite; v++){
+        if(search->stamp[v] == *search->currentStamp) continue;
+        search->stamp[v] = *search->currentStamp;
+        search->level[v] = 0;
+        head = tail = 0;
+        search->queue[tail++] = v;
+        while(head < tail && bipartite){
+            int vertex = search->queue[head++];
+            for(i = 0; i < adj[vertex]; i++){
+                int nb = graph[vertex][i];
+                if(search->stamp[nb] != *search->currentStamp){
+                    search->stamp[nb] = *search->currentStamp;
+                    search->level[nb] = search->level[vertex] + 1;
+                    search->queue[tail++] = nb;
+                } else if(search->level[nb] == search->level[vertex]){
+                    bipartite = FALSE;
+                }
+            }
+        }
+    }
+    return bipartite ? 4 : 3;
+}
+
+/**
+  * Return the minimum of the given girth and the length of the shortest
+  * cycle through the given vertex.
+  */
+static int _pseudoGirth(GRAPH graph, ADJACENCY adj, int v, int girth, GIRTH_SEARCH *search) {
+    int i;
+    int head = 0;
+    int tail = 0;
+    int lim = girth / 2;
+    int *level = search->level;
+    int *queue = search->queue;
+
+    _nextStamp(search, graph[0][0]);
+    queue[head++] = v;
+    search->stamp[v] = *search->currentStamp;
+    level[v] = 0;
+    while (head > tail) {
+        int vertex = queue[tail];
+        int d = level[vertex];
+        if (d >= lim)
+            return girth; // can never improve current girth
+        tail ++;
+        for (i=0; i<adj[vertex]; i++) {
+            int nb = graph[vertex][i];
+            if (search->stamp[nb] != *search->currentStamp) {
+                // not yet encountered
+                search->stamp[nb] = *search->currentStamp;
+                level[nb] = d+1;
+                queue[head++] = nb;
+            } else if (level[nb] == d) {
+                // odd cycle
+                return 2*d + 1;
+            } else if (level[nb] > d) {
+                // even cycle
+                if (girth > 2*level[nb]) {
+                    girth = 2*level[nb]; // == 2*d+2
+                }
+            } //else {
+                // returns towards v, ignore
+            //}
+        }
+    }
+    return girth;
+}
+
+/* Performs the breadth-first searches from all vertices at once: bit r-1 of
+ * frontier[v] is set if v is at the current level in the search from r.
+ */
+static int _bitParallelGirth(GRAPH graph, ADJACENCY adj, int upperBound, INVARIANT_CONTEXT *context){
+    int i, v, d;
+    int order = graph[0][0];
+    bitset *visited = getInvariantWorkspace(getInvariantSubcontext(context, 0), BITSETS,
+            sizeof(bitset)*3*(order + 1));
+    bitset *frontier = visited + order + 1;
+    bitset *next = frontier + order + 1;
+    boolean grown = TRUE;
+
+    for(v = 1; v <= order; v++){
+        visited[v] = frontier[v] = 1ULL << (v - 1);
+    }
+
+    for(d = 0; grown; d++){
+        if(2*d + 1 >= upperBound){
+            return upperBound;
+        }
+        //two adjacent vertices at level d close a cycle of length 2d+1
+        for(v = 1; v <= order; v++){
+            for(i = 0; i < adj[v]; i++){
+                if(frontier[v] & frontier[graph[v][i]]){
+                    return 2*d + 1;
+                }
+            }
+        }
+
+        if(2*d + 2 >= upperBound){
+            return upperBound;
+        }
+        //a new vertex with two neighbours at level d closes a cycle of length 2d+2
+        grown = FALSE;
+        for(v = 1; v <= order; v++){
+            bitset once = 0ULL, twice = 0ULL;
+            for(i = 0; i < adj[v]; i++){
+                twice |= once & frontier[graph[v][i]];
+                once |= frontier[graph[v][i]];
+            }
+            if(twice & ~visited[v]){
+                return 2*d + 2;
+            }
+            next[v] = once & ~visited[v];
+            grown = grown || next[v];
+        }
+        for(v = 1; v <= order; v++){
+            visited[v] |= next[v];
+            frontier[v] = next[v];
+        }
+    }
+
+    return upperBound;
+}
+
+/* Returns the minimum of upperBound and the girth, but stops as soon as a
+ * cycle of length at most stop is found.
+ */
+static int _girth(GRAPH graph, ADJACENCY adj, int upperBound, int stop, INVARIANT_CONTEXT *context){
+    int v, lowerBound;
+    int order = graph[0][0];
+    int girth = upperBound;
+    GIRTH_SEARCH search;
+
+    if(order <= 64){
+        return _bitParallelGirth(graph, adj, upperBound, context);
+    }
+
+    _prepareGirthSearch(&search, order, context);
+    lowerBound = _girthLowerBound(graph, adj, &search);
+    if(stop < lowerBound){
+        stop = lowerBound;
+    }
+
+    for(v = 1; v <= order && girth > stop; v++){
+        girth = _pseudoGirth(graph, adj, v, girth, &search);
+    }
+
+    return girth;
+}
+
+int computeGirth(GRAPH graph, ADJACENCY adj, int upperBound, INVARIANT_CONTEXT *context){
+    return _girth(graph, adj, upperBound, 0, context);
+}
+
+boolean hasGirthAtLeast(GRAPH graph, ADJACENCY adj, int k, INVARIANT_CONTEXT *context){
+    return _girth(graph, adj, k, k - 1, context) >= k;
+}
@@ -0,0 +1,49 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef GIRTH_H
+#define	GIRTH_H
+
+#include "../../multicode/shared/multicode_base.h"
+#include "invariant_context.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* The girth is computed by a breadth-first search from each vertex which is
+ * cut off as soon as it cannot find a shorter cycle than the shortest one
+ * found so far. The level of a vertex is only valid if its time stamp is the
+ * one of the current search, so the levels never need to be cleared. The
+ * searches stop as soon as the girth reaches the smallest value that is
+ * possible for the graph.
+ *
+ * Graphs with at most 64 vertices are handled by a single bit-parallel
+ * breadth-first search from all vertices at once, which finds the girth at
+ * the first level at which any search closes a cycle.
+ *
+ * A loop is a cycle of length 1 and a multi-edge is a cycle of length 2. The
+ * memory is taken from subcontext 0 of the context.
+ */
+
+/**
+ * Returns the minimum of upperBound and the girth of the graph.
+ */
+int computeGirth(GRAPH graph, ADJACENCY adj, int upperBound, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns TRUE if the graph contains no cycle that is shorter than k. The
+ * search stops as soon as such a cycle is found.
+ */
+boolean hasGirthAtLeast(GRAPH graph, ADJACENCY adj, int k, INVARIANT_CONTEXT *context);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* GIRTH_H */
+
@@ -0,0 +1,381 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "hamiltonian_search.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned long long int bitset;
+
+//vertex v is stored in bit v-1
+#define WORD(v) (((v) - 1) >> 6)
+#define SINGLETON(v) (1ULL << (((v) - 1) & 63))
+#define CONTAINS(s, v) ((s)[WORD(v)] & SINGLETON(v))
+#define ADD(s, v) ((s)[WORD(v)] |= SINGLETON(v))
+#define REMOVE(s, v) ((s)[WORD(v)] &= ~SINGLETON(v))
+
+#define NEIGHBOURS(search, v) ((search)->neighbourhoods + (v)*(search)->words)
+
+//the vertex that corresponds to the lowest bit of the non-empty word w
+#define FIRST_VERTEX(word, w) (64*(w) + __builtin_ctzll(word) + 1)
+
+#define SEARCH 0
+#define NEIGHBOURHOODS 1
+#define SETS 2
+#define AVAILABLE 3
+#define PATH 4
+
+HAMILTONIAN_SEARCH *prepareHamiltonianSearch(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    int i, v;
+    int order = graph[0][0];
+    int words = (order + 63)/64;
+    INVARIANT_CONTEXT *searchContext = getInvariantSubcontext(context, 0);
+    HAMILTONIAN_SEARCH *search = getInvariantWorkspace(searchContext, SEARCH, sizeof(HAMILTONIAN_SEARCH));
+    bitset *sets;
+
+    if(words == 0){
+        words = 1;
+    }
+
+    search->order = order;
+    search->words = words;
+    search->neighbourhoods = getInvariantWorkspace(searchContext, NEIGHBOURHOODS,
+            sizeof(bitset)*words*(order + 1));
+    sets = getInvariantWorkspace(searchContext, SETS, sizeof(bitset)*words*6);
+    search->active = sets;
+    search->unvisited = sets + words;
+    search->ends = sets + 2*words;
+    search->reached = sets + 3*words;
+    search->frontier = sets + 4*words;
+    search->expansion = sets + 5*words;
+    search->available = getInvariantWorkspace(searchContext, AVAILABLE, sizeof(int)*(order + 1));
+    search->path = getInvariantWorkspace(searchContext, PATH, sizeof(int)*(order + 1));
+    search->pathLength = 0;
+
+    for(i = 0; i < words*(order + 1); i++){
+        search->neighbourhoods[i] = 0ULL;
+    }
+    for(i = 0; i < words; i++){
+        search->active[i] = 0ULL;
+    }
+    for(v = 1; v <= order; v++){
+        bitset *neighbours = NEIGHBOURS(search, v);
+        for(i = 0; i < adj[v]; i++){
+            ADD(neighbours, graph[v][i]);
+        }
+        ADD(search->active, v);
+    }
+    search->activeCount = order;
+
+    return search;
+}
+
+void excludeVertexFromHamiltonianSearch(HAMILTONIAN_SEARCH *search, int v){
+    if(CONTAINS(search->active, v)){
+        REMOVE(search->active, v);
+        search->activeCount--;
+    }
+}
+
+void includeVertexInHamiltonianSearch(HAMILTONIAN_SEARCH *search, int v){
+    if(!CONTAINS(search->active, v)){
+        ADD(search->active, v);
+        search->activeCount++;
+    }
+}
+
+static int _countActiveNeighbours(HAMILTONIAN_SEARCH *search, int v){
+    int w, count = 0;
+    bitset *neighbours = NEIGHBOURS(search, v);
+
+    for(w = 0; w < search->words; w++){
+        count += __builtin_popcountll(neighbours[w] & search->active[w]);
+    }
+    return count;
+}
+
+/* Returns TRUE if all unvisited vertices can be reached from last by only
+ * passing through unvisited vertices.
+ */
+static boolean _unvisitedVerticesAreReachable(HAMILTONIAN_SEARCH *search, int last){
+    int w, w2, v;
+    int words = search->words;
+    bitset *unvisited = search->unvisited;
+    bitset *reached = search->reached;
+    bitset *frontier = search->frontier;
+    bitset *expansion = search->expansion;
+    bitset *lastNeighbours = NEIGHBOURS(search, last);
+    boolean grown = FALSE;
+
+    for(w = 0; w < words; w++){
+        reached[w] = frontier[w] = lastNeighbours[w] & unvisited[w];
+        grown = grown || frontier[w];
+    }
+    while(grown){
+        for(w = 0; w < words; w++){
+            expansion[w] = 0ULL;
+        }
+        for(w = 0; w < words; w++){
+            bitset word = frontier[w];
+            while(word){
+                bitset *neighbours;
+                v = FIRST_VERTEX(word, w);
+                word &= word - 1;
+                neighbours = NEIGHBOURS(search, v);
+                for(w2 = 0; w2 < words; w2++){
+                    expansion[w2] |= neighbours[w2];
+                }
+            }
+        }
+        grown = FALSE;
+        for(w = 0; w < words; w++){
+            frontier[w] = expansion[w] & unvisited[w] & ~reached[w];
+            reached[w] |= frontier[w];
+            grown = grown || frontier[w];
+        }
+    }
+
+    for(w = 0; w < words; w++){
+        if(reached[w] != unvisited[w]){
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static boolean _extendPath(HAMILTONIAN_SEARCH *search, int last){
+    int w, w2, v;
+    int words = search->words;
+    bitset *unvisited = search->unvisited;
+    bitset *lastNeighbours = NEIGHBOURS(search, last);
+    boolean canEnd = FALSE;
+    int forcedEnd = 0;
+    int forcedNext = 0;
+
+    if(search->unvisitedCount == 0){
+        return CONTAINS(search->ends, last) ? TRUE : FALSE;
+    }
+
+    for(w = 0; w < words; w++){
+        if(search->ends[w] & unvisited[w]){
+            canEnd = TRUE;
+            break;
+        }
+    }
+    if(!canEnd){
+        return FALSE;
+    }
+
+    //an unvisited vertex with less than two possible neighbours has to be the end
+    for(w = 0; w < words; w++){
+        bitset word = unvisited[w];
+        while(word){
+            int available = 0;
+            bitset *neighbours;
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            neighbours = NEIGHBOURS(search, v);
+            for(w2 = 0; w2 < words; w2++){
+                available += __builtin_popcountll(neighbours[w2] & unvisited[w2]);
+            }
+            if(CONTAINS(neighbours, last)){
+                available++;
+            }
+            search->available[v] = available;
+            if(available < 2){
+                if(forcedEnd || !CONTAINS(search->ends, v)){
+                    return FALSE;
+                }
+                forcedEnd = v;
+            }
+        }
+    }
+
+    if(!_unvisitedVerticesAreReachable(search, last)){
+        return FALSE;
+    }
+
+    //an unvisited neighbour of last that cannot be the end and that has only
+    //one other possible neighbour has to follow last
+    for(w = 0; w < words; w++){
+        bitset word = lastNeighbours[w] & unvisited[w];
+        while(word){
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            if(v == forcedEnd){
+                if(search->available[v] == 1 && search->unvisitedCount > 1){
+                    //last is the only neighbour of the end
+                    return FALSE;
+                }
+            } else if(search->available[v] == 2 &&
+                    (forcedEnd || !CONTAINS(search->ends, v))){
+                if(forcedNext){
+                    return FALSE;
+                }
+                forcedNext = v;
+            }
+        }
+    }
+
+    for(w = 0; w < words; w++){
+        bitset word = lastNeighbours[w] & unvisited[w];
+        if(forcedNext){
+            word = (WORD(forcedNext) == w) ? SINGLETON(forcedNext) : 0ULL;
+        }
+        while(word){
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+
+            REMOVE(unvisited, v);
+            search->unvisitedCount--;
+            search->path[search->pathLength++] = v;
+            if(_extendPath(search, v)){
+                return TRUE;
+            }
+            search->pathLength--;
+            search->unvisitedCount++;
+            ADD(unvisited, v);
+        }
+    }
+
+    return FALSE;
+}
+
+static void _startPath(HAMILTONIAN_SEARCH *search, int start){
+    int w;
+
+    for(w = 0; w < search->words; w++){
+        search->unvisited[w] = search->active[w];
+    }
+    REMOVE(search->unvisited, start);
+    search->unvisitedCount = search->activeCount - 1;
+    search->path[0] = start;
+    search->pathLength = 1;
+}
+
+boolean searchHamiltonianCycle(HAMILTONIAN_SEARCH *search){
+    int w, v, first;
+    int words = search->words;
+    int start = 0, minimumDegree = search->order + 1;
+    bitset *startNeighbours;
+
+    if(search->activeCount < 3){
+        return FALSE;
+    }
+
+    //start in a vertex with the fewest choices
+    for(w = 0; w < words; w++){
+        bitset word = search->active[w];
+        while(word){
+            int degree;
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            degree = _countActiveNeighbours(search, v);
+            if(degree < minimumDegree){
+                minimumDegree = degree;
+                start = v;
+            }
+        }
+    }
+    if(minimumDegree < 2){
+        return FALSE;
+    }
+    startNeighbours = NEIGHBOURS(search, start);
+
+    _startPath(search, start);
+    for(w = 0; w < words; w++){
+        bitset word = startNeighbours[w] & search->active[w];
+        while(word){
+            int w2;
+            first = FIRST_VERTEX(word, w);
+            word &= word - 1;
+
+            //each cycle is only found in the direction in which the second
+            //vertex is larger than the last vertex
+            for(w2 = 0; w2 < words; w2++){
+                search->ends[w2] = startNeighbours[w2] & search->active[w2];
+            }
+            for(v = first; v <= search->order; v++){
+                REMOVE(search->ends, v);
+            }
+
+            REMOVE(search->unvisited, first);
+            search->unvisitedCount--;
+            search->path[1] = first;
+            search->pathLength = 2;
+            if(_extendPath(search, first)){
+                return TRUE;
+            }
+            search->unvisitedCount++;
+            ADD(search->unvisited, first);
+        }
+    }
+
+    return FALSE;
+}
+
+boolean searchHamiltonianPath(HAMILTONIAN_SEARCH *search, int start, int end){
+    int w, v;
+    int words = search->words;
+    int lastStart = 0;
+    int leafCount = 0;
+
+    if(start){
+        _startPath(search, start);
+        if(end){
+            for(w = 0; w < words; w++){
+                search->ends[w] = 0ULL;
+            }
+            ADD(search->ends, end);
+        } else {
+            for(w = 0; w < words; w++){
+                search->ends[w] = search->active[w];
+            }
+        }
+        return _extendPath(search, start);
+    }
+
+    if(search->activeCount == 0){
+        return FALSE;
+    }
+
+    //a vertex with at most one neighbour has to be an end of the path
+    for(w = 0; w < words; w++){
+        bitset word = search->active[w];
+        while(word){
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            if(_countActiveNeighbours(search, v) < 2){
+                leafCount++;
+                start = v;
+            }
+            lastStart = v;
+        }
+    }
+    if(leafCount > 2){
+        return FALSE;
+    } else if(leafCount > 0){
+        return searchHamiltonianPath(search, start, 0);
+    }
+
+    //each path has two ends, so the last vertex does not need to be tried
+    for(w = 0; w < words; w++){
+        bitset word = search->active[w];
+        while(word){
+            v = FIRST_VERTEX(word, w);
+            word &= word - 1;
+            if(v == lastStart && search->activeCount > 1){
+                return FALSE;
+            }
+            if(searchHamiltonianPath(search, v, 0)){
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
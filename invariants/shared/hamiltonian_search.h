@@ -0,0 +1,102 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef HAMILTONIAN_SEARCH_H
+#define	HAMILTONIAN_SEARCH_H
+
+#include "../../multicode/shared/multicode_base.h"
+#include "invariant_context.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A backtracking search for hamiltonian cycles and paths. All sets of vertices
+ * are stored as bitsets (one 64-bit word for graphs with at most 64 vertices),
+ * which makes it cheap to prune a partial path at each step:
+ *
+ *  - the unvisited vertices together with the end of the path need to induce
+ *    a connected graph, which also guarantees that the path can still reach
+ *    the vertex in which it has to end,
+ *  - an unvisited vertex with less than two possible neighbours left has to
+ *    be the last vertex of the path, so there can be at most one,
+ *  - an unvisited vertex which cannot be the last vertex and which has
+ *    exactly two possible neighbours left, one of which is the end of the
+ *    path, has to be the next vertex of the path.
+ *
+ * Multi-edges are ignored.
+ */
+
+typedef struct __hamiltonian_search {
+    int order;
+    //the number of 64-bit words in each set of vertices
+    int words;
+
+    //the neighbours of v are stored in the words starting at v*words
+    unsigned long long int *neighbourhoods;
+
+    //the vertices that need to be visited
+    unsigned long long int *active;
+    int activeCount;
+
+    unsigned long long int *unvisited;
+    int unvisitedCount;
+    //the vertices in which the path is allowed to end
+    unsigned long long int *ends;
+
+    //scratch sets for the connectivity check
+    unsigned long long int *reached;
+    unsigned long long int *frontier;
+    unsigned long long int *expansion;
+
+    //the number of neighbours of an unvisited vertex among the unvisited
+    //vertices and the end of the path
+    int *available;
+
+    //the path or cycle that was found by the last successful search
+    int *path;
+    int pathLength;
+} HAMILTONIAN_SEARCH;
+
+/**
+ * Prepares a search in the given graph. The memory is taken from subcontext 0
+ * of the context, so the caller can use all workspace slots of the context.
+ * Initially all vertices of the graph are active.
+ */
+HAMILTONIAN_SEARCH *prepareHamiltonianSearch(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Removes a vertex from the graph in which the search is performed.
+ */
+void excludeVertexFromHamiltonianSearch(HAMILTONIAN_SEARCH *search, int v);
+
+/**
+ * Restores a vertex that was removed by excludeVertexFromHamiltonianSearch.
+ */
+void includeVertexInHamiltonianSearch(HAMILTONIAN_SEARCH *search, int v);
+
+/**
+ * Returns TRUE if the active vertices induce a hamiltonian graph. In that case
+ * the cycle is stored in search->path. Graphs with less than 3 vertices are
+ * not hamiltonian.
+ */
+boolean searchHamiltonianCycle(HAMILTONIAN_SEARCH *search);
+
+/**
+ * Returns TRUE if the active vertices induce a graph with a hamiltonian path
+ * from start to end. If end is 0, the path can end in any vertex. If start is
+ * also 0, the path can start in any vertex. In case of success the path is
+ * stored in search->path.
+ */
+boolean searchHamiltonianPath(HAMILTONIAN_SEARCH *search, int start, int end);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* HAMILTONIAN_SEARCH_H */
+
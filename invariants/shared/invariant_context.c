@@ -0,0 +1,95 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "invariant_context.h"
+#include "invariant_graph_data.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+INVARIANT_CONTEXT *_allocateInvariantContext(){
+    INVARIANT_CONTEXT *context = (INVARIANT_CONTEXT *)calloc(1, sizeof(INVARIANT_CONTEXT));
+    if(context == NULL){
+        fprintf(stderr, "Insufficient memory for invariant context -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return context;
+}
+
+INVARIANT_CONTEXT *newInvariantContext(){
+    INVARIANT_CONTEXT *context = _allocateInvariantContext();
+    context->graphData = newInvariantGraphData();
+    return context;
+}
+
+void freeInvariantContext(INVARIANT_CONTEXT *context){
+    int i;
+
+    for(i = 0; i < context->subcontextCount; i++){
+        if(context->subcontexts[i] != NULL){
+            freeInvariantContext(context->subcontexts[i]);
+        }
+    }
+    free(context->subcontexts);
+    for(i = 0; i < INVARIANT_WORKSPACE_SLOTS; i++){
+        free(context->workspace[i]);
+    }
+    if(context->parent == NULL){
+        freeInvariantGraphData(context->graphData);
+    }
+    free(context);
+}
+
+INVARIANT_CONTEXT *getInvariantSubcontext(INVARIANT_CONTEXT *context, int i){
+    if(i >= context->subcontextCount){
+        int j;
+        INVARIANT_CONTEXT **subcontexts = (INVARIANT_CONTEXT **)realloc(
+                context->subcontexts, sizeof(INVARIANT_CONTEXT *)*(i + 1));
+        if(subcontexts == NULL){
+            fprintf(stderr, "Insufficient memory for invariant context -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        for(j = context->subcontextCount; j <= i; j++){
+            subcontexts[j] = NULL;
+        }
+        context->subcontexts = subcontexts;
+        context->subcontextCount = i + 1;
+    }
+    if(context->subcontexts[i] == NULL){
+        INVARIANT_CONTEXT *subcontext = _allocateInvariantContext();
+        subcontext->graphData = context->graphData;
+        subcontext->parent = context;
+        context->subcontexts[i] = subcontext;
+    }
+    return context->subcontexts[i];
+}
+
+void *getInvariantWorkspace(INVARIANT_CONTEXT *context, int slot, size_t size){
+    size_t newSize;
+    void *newWorkspace;
+
+    if(size <= context->workspaceSize[slot]){
+        return context->workspace[slot];
+    }
+
+    //grow geometrically to avoid reallocating for each slightly larger graph
+    newSize = 2*context->workspaceSize[slot];
+    if(newSize < size){
+        newSize = size;
+    }
+    newWorkspace = realloc(context->workspace[slot], newSize);
+    if(newWorkspace == NULL){
+        fprintf(stderr, "Insufficient memory for invariant workspace -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    memset((char *)newWorkspace + context->workspaceSize[slot], 0,
+            newSize - context->workspaceSize[slot]);
+
+    context->workspace[slot] = newWorkspace;
+    context->workspaceSize[slot] = newSize;
+    return newWorkspace;
+}
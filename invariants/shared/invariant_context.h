@@ -0,0 +1,77 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef INVARIANT_CONTEXT_H
+#define	INVARIANT_CONTEXT_H
+
+#include <stddef.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* The working memory of an invariant. Every invariant receives a context and
+ * keeps all its scratch arrays in the context instead of in global variables.
+ * A context should only be used by one thread at a time, so several graphs
+ * can be handled at the same time by giving each thread its own context.
+ *
+ * The memory is kept between calls, so for a sequence of graphs it is only
+ * allocated for the first graph and again whenever a graph needs more memory.
+ * The arrays are sized to the graph at hand and not to MAXN.
+ *
+ * A context also contains the data derived from the current graph that is
+ * shared between invariants (see invariant_graph_data.h).
+ */
+
+typedef struct __invariant_context INVARIANT_CONTEXT;
+typedef struct __invariant_graph_data INVARIANT_GRAPH_DATA;
+
+//the number of separate arrays that an invariant can request
+#define INVARIANT_WORKSPACE_SLOTS 8
+
+struct __invariant_context {
+    void *workspace[INVARIANT_WORKSPACE_SLOTS];
+    size_t workspaceSize[INVARIANT_WORKSPACE_SLOTS];
+
+    //shared with the parent and the subcontexts
+    INVARIANT_GRAPH_DATA *graphData;
+    //NULL if this context owns graphData
+    INVARIANT_CONTEXT *parent;
+
+    INVARIANT_CONTEXT **subcontexts;
+    int subcontextCount;
+};
+
+INVARIANT_CONTEXT *newInvariantContext();
+
+/**
+ * Frees the context and all its subcontexts.
+ */
+void freeInvariantContext(INVARIANT_CONTEXT *context);
+
+/**
+ * Returns subcontext i (i >= 0) of the context, which is created when it is
+ * first requested. A subcontext has its own workspace, but shares the graph
+ * data with its parent. This allows several invariants to be computed for the
+ * same graph without recomputing the shared data.
+ */
+INVARIANT_CONTEXT *getInvariantSubcontext(INVARIANT_CONTEXT *context, int i);
+
+/**
+ * Returns an array of at least size bytes for the given slot
+ * (0 <= slot < INVARIANT_WORKSPACE_SLOTS). The contents are the ones left
+ * behind by the previous user of the slot. Bytes that were not part of the
+ * array before are set to zero. Exits if there is not enough memory.
+ */
+void *getInvariantWorkspace(INVARIANT_CONTEXT *context, int slot, size_t size);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INVARIANT_CONTEXT_H */
+
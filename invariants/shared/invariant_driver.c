@@ -0,0 +1,276 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "invariant_driver.h"
+#include "invariant_graph_data.h"
+#include "../../multicode/shared/multicode_input.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+//the number of graphs per worker in a batch
+#define GRAPHS_PER_WORKER 64
+
+//the maximum number of bytes of code in a batch (unless it contains one graph)
+#define MAXIMUM_BATCH_BYTES (8 << 20)
+
+//the kernels are recursive, so the workers get a large stack
+#define WORKER_STACK_SIZE (64 << 20)
+
+typedef struct __graph_batch {
+    //copies of the codes in this batch
+    unsigned char *codes;
+    size_t codesLength;
+    size_t codesCapacity;
+
+    CODE_VIEW *views;
+    size_t *positions;
+    unsigned char *results;
+    int count;
+    int capacity;
+} GRAPH_BATCH;
+
+typedef struct __invariant_pool {
+    INVARIANT_COMPUTATION compute;
+    size_t resultSize;
+
+    pthread_mutex_t lock;
+    pthread_cond_t batchAvailable;
+    pthread_cond_t batchFinished;
+
+    //the batch that is being processed and the number of this batch
+    GRAPH_BATCH *batch;
+    unsigned long long generation;
+    boolean stop;
+
+    //the next graph in the batch that has not been claimed by a worker
+    atomic_int nextGraph;
+    //the number of workers that are still working on the batch
+    int busyWorkers;
+    int workerCount;
+} INVARIANT_POOL;
+
+void *_allocateOrExit(void *p){
+    if(p == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void _initBatch(GRAPH_BATCH *batch, int capacity, size_t resultSize){
+    batch->codesCapacity = 1 << 16;
+    batch->codes = _allocateOrExit(malloc(batch->codesCapacity));
+    batch->codesLength = 0;
+    batch->capacity = capacity;
+    batch->count = 0;
+    batch->views = _allocateOrExit(malloc(sizeof(CODE_VIEW)*capacity));
+    batch->positions = _allocateOrExit(malloc(sizeof(size_t)*capacity));
+    batch->results = _allocateOrExit(malloc(resultSize*capacity));
+}
+
+void _freeBatch(GRAPH_BATCH *batch){
+    free(batch->codes);
+    free(batch->views);
+    free(batch->positions);
+    free(batch->results);
+}
+
+/* Fills the batch with the next graphs from the reader. The codes are copied
+ * because the views of the reader are invalidated by the next read.
+ */
+void _readBatch(GRAPH_BATCH *batch, CODE_READER *reader){
+    CODE_VIEW view;
+    int i;
+
+    batch->count = 0;
+    batch->codesLength = 0;
+    while(batch->count < batch->capacity &&
+            (batch->count == 0 || batch->codesLength < MAXIMUM_BATCH_BYTES) &&
+            nextCode(reader, &view)){
+        if(batch->codesLength + view.length > batch->codesCapacity){
+            while(batch->codesLength + view.length > batch->codesCapacity){
+                batch->codesCapacity *= 2;
+            }
+            batch->codes = _allocateOrExit(realloc(batch->codes, batch->codesCapacity));
+        }
+        memcpy(batch->codes + batch->codesLength, view.data, view.length);
+        batch->views[batch->count] = view;
+        batch->positions[batch->count] = batch->codesLength;
+        batch->codesLength += view.length;
+        batch->count++;
+    }
+
+    //the codes are only moved while the batch is filled
+    for(i = 0; i < batch->count; i++){
+        CODE_VIEW *v = batch->views + i;
+        v->data = batch->codes + batch->positions[i];
+        v->body = v->data + (v->shortCode ? 3 : 1);
+    }
+}
+
+void *_invariantWorker(void *arg){
+    INVARIANT_POOL *pool = arg;
+    GRAPH *graph = _allocateOrExit(malloc(sizeof(GRAPH)));
+    ADJACENCY adj;
+    INVARIANT_CONTEXT *context = newInvariantContext();
+    unsigned long long seenGeneration = 0;
+    GRAPH_BATCH *batch;
+    int i;
+
+    while(TRUE){
+        pthread_mutex_lock(&pool->lock);
+        while(pool->generation == seenGeneration && !pool->stop){
+            pthread_cond_wait(&pool->batchAvailable, &pool->lock);
+        }
+        if(pool->stop){
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seenGeneration = pool->generation;
+        batch = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+
+        while((i = atomic_fetch_add(&pool->nextGraph, 1)) < batch->count){
+            decodeMultiCodeView(batch->views + i, *graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+            clearInvariantGraphData(context);
+            pool->compute(*graph, adj, context, batch->results + i*pool->resultSize);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->busyWorkers--;
+        if(pool->busyWorkers == 0){
+            pthread_cond_signal(&pool->batchFinished);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    freeInvariantContext(context);
+    free(graph);
+    return NULL;
+}
+
+void _startBatch(INVARIANT_POOL *pool, GRAPH_BATCH *batch){
+    pthread_mutex_lock(&pool->lock);
+    pool->batch = batch;
+    atomic_store(&pool->nextGraph, 0);
+    pool->busyWorkers = pool->workerCount;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->batchAvailable);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void _waitForBatch(INVARIANT_POOL *pool){
+    pthread_mutex_lock(&pool->lock);
+    while(pool->busyWorkers > 0){
+        pthread_cond_wait(&pool->batchFinished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+unsigned long long _runInvariantSerial(CODE_READER *reader,
+        INVARIANT_COMPUTATION compute, size_t resultSize,
+        INVARIANT_RESULT_HANDLER handle, void *data){
+    GRAPH *graph = _allocateOrExit(malloc(sizeof(GRAPH)));
+    ADJACENCY adj;
+    INVARIANT_CONTEXT *context = newInvariantContext();
+    void *result = _allocateOrExit(malloc(resultSize));
+    unsigned long long graphCount = 0;
+    CODE_VIEW view;
+
+    while(nextCode(reader, &view)){
+        decodeMultiCodeView(&view, *graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+        clearInvariantGraphData(context);
+        compute(*graph, adj, context, result);
+        graphCount++;
+        handle(graphCount, &view, result, data);
+    }
+
+    freeInvariantContext(context);
+    free(result);
+    free(graph);
+    return graphCount;
+}
+
+unsigned long long runInvariant(CODE_READER *reader, int threads,
+        INVARIANT_COMPUTATION compute, size_t resultSize,
+        INVARIANT_RESULT_HANDLER handle, void *data){
+    INVARIANT_POOL pool;
+    GRAPH_BATCH batches[2];
+    GRAPH_BATCH *current = batches, *next = batches + 1, *swap;
+    pthread_t *workers;
+    pthread_attr_t attributes;
+    unsigned long long graphCount = 0;
+    int i;
+
+    if(threads <= 1){
+        return _runInvariantSerial(reader, compute, resultSize, handle, data);
+    }
+
+    pool.compute = compute;
+    pool.resultSize = resultSize;
+    pool.batch = NULL;
+    pool.generation = 0;
+    pool.stop = FALSE;
+    pool.busyWorkers = 0;
+    pool.workerCount = threads;
+    atomic_init(&pool.nextGraph, 0);
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.batchAvailable, NULL);
+    pthread_cond_init(&pool.batchFinished, NULL);
+
+    _initBatch(batches, GRAPHS_PER_WORKER*threads, resultSize);
+    _initBatch(batches + 1, GRAPHS_PER_WORKER*threads, resultSize);
+
+    workers = _allocateOrExit(malloc(sizeof(pthread_t)*threads));
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, WORKER_STACK_SIZE);
+    for(i = 0; i < threads; i++){
+        if(pthread_create(workers + i, &attributes, _invariantWorker, &pool)){
+            fprintf(stderr, "Could not start thread -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    pthread_attr_destroy(&attributes);
+
+    _readBatch(current, reader);
+    while(current->count > 0){
+        _startBatch(&pool, current);
+
+        //read the next batch while the workers are busy
+        _readBatch(next, reader);
+
+        _waitForBatch(&pool);
+        for(i = 0; i < current->count; i++){
+            graphCount++;
+            handle(graphCount, current->views + i, current->results + i*resultSize, data);
+        }
+
+        swap = current;
+        current = next;
+        next = swap;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = TRUE;
+    pthread_cond_broadcast(&pool.batchAvailable);
+    pthread_mutex_unlock(&pool.lock);
+    for(i = 0; i < threads; i++){
+        pthread_join(workers[i], NULL);
+    }
+
+    free(workers);
+    _freeBatch(batches);
+    _freeBatch(batches + 1);
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.batchAvailable);
+    pthread_cond_destroy(&pool.batchFinished);
+
+    return graphCount;
+}
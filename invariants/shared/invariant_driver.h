@@ -0,0 +1,58 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef INVARIANT_DRIVER_H
+#define	INVARIANT_DRIVER_H
+
+#include "../../multicode/shared/multicode_base.h"
+#include "../../shared/code_reader.h"
+#include "invariant_context.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* Runs an invariant on all graphs read by a code reader, possibly using
+ * several threads. The main thread reads the graphs in batches. While the
+ * worker threads compute the invariant for the graphs in one batch, the main
+ * thread already reads the next batch. The workers take the graphs of a batch
+ * one by one, so a few expensive graphs do not hold up the other workers. Each
+ * worker decodes the graphs in its own GRAPH and ADJACENCY and passes its own
+ * invariant context to the invariant.
+ *
+ * The results are handed to the result handler in the main thread in the
+ * order in which the graphs were read, so the output does not depend on the
+ * number of threads.
+ *
+ * The invariant may be called from several threads at the same time, so it
+ * should keep its working memory in the context.
+ */
+
+/* Computes the invariant for the graph and stores it in result. */
+typedef void (*INVARIANT_COMPUTATION)(GRAPH graph, ADJACENCY adj,
+        INVARIANT_CONTEXT *context, void *result);
+
+/* Handles the result for the graphNumber-th graph (starting from 1). The view
+ * can be used to decode the graph again. */
+typedef void (*INVARIANT_RESULT_HANDLER)(unsigned long long graphNumber,
+        CODE_VIEW *view, void *result, void *data);
+
+/**
+ * Computes the invariant for all graphs in reader and passes the results to
+ * handle. If threads is at most 1, everything is done in the calling thread.
+ * Returns the number of graphs that were read.
+ */
+unsigned long long runInvariant(CODE_READER *reader, int threads,
+        INVARIANT_COMPUTATION compute, size_t resultSize,
+        INVARIANT_RESULT_HANDLER handle, void *data);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INVARIANT_DRIVER_H */
+
@@ -0,0 +1,211 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "invariant_graph_data.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+INVARIANT_GRAPH_DATA *newInvariantGraphData(){
+    INVARIANT_GRAPH_DATA *data = (INVARIANT_GRAPH_DATA *)calloc(1, sizeof(INVARIANT_GRAPH_DATA));
+    if(data == NULL){
+        fprintf(stderr, "Insufficient memory for graph data -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return data;
+}
+
+void freeInvariantGraphData(INVARIANT_GRAPH_DATA *data){
+    free(data->distance);
+    free(data->layers);
+    free(data->layerStart);
+    free(data->isCutVertex);
+    free(data->discovery);
+    free(data->low);
+    free(data);
+}
+
+void clearInvariantGraphData(INVARIANT_CONTEXT *context){
+    INVARIANT_GRAPH_DATA *data = context->graphData;
+    data->degreesKnown = FALSE;
+    data->layersKnown = FALSE;
+    data->cutVerticesKnown = FALSE;
+}
+
+void *_resizeGraphDataArray(void *array, size_t size){
+    array = realloc(array, size);
+    if(array == NULL){
+        fprintf(stderr, "Insufficient memory for graph data -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+/* Makes sure that the arrays can be indexed by all vertices of a graph with the
+ * given order.
+ */
+void _ensureGraphDataCapacity(INVARIANT_GRAPH_DATA *data, int order){
+    int capacity = order + 2;
+
+    if(capacity <= data->capacity){
+        return;
+    }
+    if(capacity < 2*data->capacity){
+        capacity = 2*data->capacity;
+    }
+
+    data->distance = _resizeGraphDataArray(data->distance, sizeof(int)*capacity);
+    data->layers = _resizeGraphDataArray(data->layers, sizeof(int)*capacity);
+    data->layerStart = _resizeGraphDataArray(data->layerStart, sizeof(int)*capacity);
+    data->isCutVertex = _resizeGraphDataArray(data->isCutVertex, sizeof(boolean)*capacity);
+    data->discovery = _resizeGraphDataArray(data->discovery, sizeof(int)*capacity);
+    data->low = _resizeGraphDataArray(data->low, sizeof(int)*capacity);
+    data->capacity = capacity;
+}
+
+INVARIANT_GRAPH_DATA *getDegreeData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    INVARIANT_GRAPH_DATA *data = context->graphData;
+    int i, order = graph[0][0];
+    int degreeSum = 0;
+
+    if(data->degreesKnown){
+        return data;
+    }
+
+    data->minimumDegree = order;
+    data->minimumDegreeVertex = 0;
+    data->minimumDegreeCount = 0;
+    data->maximumDegree = 0;
+    for(i = 1; i <= order; i++){
+        if(adj[i] < data->minimumDegree){
+            data->minimumDegree = adj[i];
+            data->minimumDegreeVertex = i;
+            data->minimumDegreeCount = 1;
+        } else if(adj[i] == data->minimumDegree){
+            data->minimumDegreeCount++;
+        }
+        if(adj[i] > data->maximumDegree){
+            data->maximumDegree = adj[i];
+        }
+        degreeSum += adj[i];
+    }
+    data->edgeCount = degreeSum/2;
+
+    data->degreesKnown = TRUE;
+    return data;
+}
+
+INVARIANT_GRAPH_DATA *getLayerData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    INVARIANT_GRAPH_DATA *data = context->graphData;
+    int i, order = graph[0][0];
+    int head, tail;
+
+    if(data->layersKnown){
+        return data;
+    }
+    _ensureGraphDataCapacity(data, order);
+
+    for(i = 1; i <= order; i++){
+        data->distance[i] = -1;
+    }
+    data->layerCount = 0;
+    data->reachedCount = 0;
+    data->layerStart[0] = 0;
+    if(order > 0){
+        data->distance[1] = 0;
+        data->layers[0] = 1;
+        head = 1;
+        tail = 0;
+        while(tail < head){
+            int v = data->layers[tail];
+            if(data->distance[v] == data->layerCount){
+                //v is the first vertex of a new layer
+                data->layerStart[data->layerCount] = tail;
+                data->layerCount++;
+            }
+            for(i = 0; i < adj[v]; i++){
+                int w = graph[v][i];
+                if(data->distance[w] < 0){
+                    data->distance[w] = data->distance[v] + 1;
+                    data->layers[head++] = w;
+                }
+            }
+            tail++;
+        }
+        data->reachedCount = head;
+    }
+    data->layerStart[data->layerCount] = data->reachedCount;
+
+    data->layersKnown = TRUE;
+    return data;
+}
+
+int _findCutVertices(GRAPH graph, ADJACENCY adj, INVARIANT_GRAPH_DATA *data,
+        int v, int parent, int time){
+    int i;
+    int children = 0;
+
+    data->discovery[v] = data->low[v] = ++time;
+    for(i = 0; i < adj[v]; i++){
+        int w = graph[v][i];
+        if(data->discovery[w] == 0){
+            children++;
+            time = _findCutVertices(graph, adj, data, w, v, time);
+            if(data->low[w] < data->low[v]){
+                data->low[v] = data->low[w];
+            }
+            if(parent && data->low[w] >= data->discovery[v]){
+                data->isCutVertex[v] = TRUE;
+            }
+        } else if(w != parent && data->discovery[w] < data->low[v]){
+            data->low[v] = data->discovery[w];
+        }
+    }
+    if(!parent && children > 1){
+        data->isCutVertex[v] = TRUE;
+    }
+
+    return time;
+}
+
+INVARIANT_GRAPH_DATA *getCutVertexData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    INVARIANT_GRAPH_DATA *data = context->graphData;
+    int i, order = graph[0][0];
+    int time = 0;
+
+    if(data->cutVerticesKnown){
+        return data;
+    }
+    _ensureGraphDataCapacity(data, order);
+
+    for(i = 1; i <= order; i++){
+        data->discovery[i] = 0;
+        data->isCutVertex[i] = FALSE;
+    }
+    for(i = 1; i <= order; i++){
+        if(data->discovery[i] == 0){
+            time = _findCutVertices(graph, adj, data, i, 0, time);
+        }
+    }
+    data->cutVertexCount = 0;
+    for(i = 1; i <= order; i++){
+        if(data->isCutVertex[i]){
+            data->cutVertexCount++;
+        }
+    }
+
+    data->cutVerticesKnown = TRUE;
+    return data;
+}
+
+boolean isConnectedGraph(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return getLayerData(graph, adj, context)->reachedCount == graph[0][0];
+}
+
+boolean isBiconnectedGraph(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context){
+    return isConnectedGraph(graph, adj, context) &&
+            getCutVertexData(graph, adj, context)->cutVertexCount == 0;
+}
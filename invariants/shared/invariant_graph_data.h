@@ -0,0 +1,104 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef INVARIANT_GRAPH_DATA_H
+#define	INVARIANT_GRAPH_DATA_H
+
+#include "../../multicode/shared/multicode_base.h"
+#include "invariant_context.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* Data that is derived from a graph and that is used by several invariants.
+ * The data is stored in the invariant context and is only computed the first
+ * time an invariant asks for it. Contexts that are created with
+ * getInvariantSubcontext share the data of their parent, so when several
+ * invariants are computed for the same graph the data is computed only once.
+ *
+ * clearInvariantGraphData should be called before the invariants are computed
+ * for a new graph.
+ */
+
+struct __invariant_graph_data {
+    boolean degreesKnown;
+    int minimumDegree;
+    //the first vertex with minimum degree
+    int minimumDegreeVertex;
+    //the number of vertices with minimum degree
+    int minimumDegreeCount;
+    int maximumDegree;
+    //the number of edges (a multi-edge is counted with its multiplicity)
+    int edgeCount;
+
+    /* A breadth-first search from vertex 1. layers contains the reached
+     * vertices in the order in which they were reached: layer d consists of
+     * layers[layerStart[d]] up to layers[layerStart[d+1] - 1]. distance[v] is
+     * -1 for vertices that were not reached.
+     */
+    boolean layersKnown;
+    int *distance;
+    int *layers;
+    int *layerStart;
+    int layerCount;
+    int reachedCount;
+
+    boolean cutVerticesKnown;
+    //TRUE for the vertices whose removal increases the number of components
+    boolean *isCutVertex;
+    int cutVertexCount;
+
+    //arrays used by the depth-first search for cut vertices
+    int *discovery;
+    int *low;
+
+    int capacity;
+};
+
+INVARIANT_GRAPH_DATA *newInvariantGraphData();
+
+void freeInvariantGraphData(INVARIANT_GRAPH_DATA *data);
+
+/**
+ * Marks all data as unknown. This should be called whenever a new graph is
+ * handled with this context (or one of its subcontexts).
+ */
+void clearInvariantGraphData(INVARIANT_CONTEXT *context);
+
+/**
+ * Returns the data with the degree information filled in.
+ */
+INVARIANT_GRAPH_DATA *getDegreeData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns the data with the breadth-first search layers filled in.
+ */
+INVARIANT_GRAPH_DATA *getLayerData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns the data with the cut vertices filled in.
+ */
+INVARIANT_GRAPH_DATA *getCutVertexData(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns TRUE if the graph is connected. The graph with no vertices is
+ * considered to be connected.
+ */
+boolean isConnectedGraph(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+/**
+ * Returns TRUE if the graph is connected and has no cut vertices.
+ */
+boolean isBiconnectedGraph(GRAPH graph, ADJACENCY adj, INVARIANT_CONTEXT *context);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INVARIANT_GRAPH_DATA_H */
+
@@ -11,7 +11,8 @@
  * Compile with:
  *     
  *     cc -o multi_filter_bipartite -O4  multi_filter_bipartite.c \
- *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c
+ *     shared/multicode_base.c shared/multicode_input.c \
+ *     ../shared/code_reader.c
  * 
  */
 
@@ -21,7 +22,7 @@
 
 #include "shared/multicode_base.h"
 #include "shared/multicode_input.h"
-#include "shared/multicode_output.h"
+#include "../shared/code_reader.h"
 
 #define WHITE 1
 #define BLACK 0
@@ -130,10 +131,10 @@ int main(int argc, char** argv) {
         }
     }
     
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+    CODE_READER *reader = newMultiCodeReader(stdin);
+    CODE_VIEW view;
+    while (nextCode(reader, &view)) {
+        decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
         graphsRead++;
         
         if(isBipartite(graph, adj)){
@@ -141,16 +142,17 @@ int main(int argc, char** argv) {
                 continue;
             }
             if(!onlyCount){
-                writeMultiCode(graph, adj, stdout);
+                writeCodeView(&view, graphsFiltered ? NULL : MULTICODE_HEADER, stdout);
             }
             graphsFiltered++;
         } else if(invertFilter){
             if(!onlyCount){
-                writeMultiCode(graph, adj, stdout);
+                writeCodeView(&view, graphsFiltered ? NULL : MULTICODE_HEADER, stdout);
             }
             graphsFiltered++;
         }
     }
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
     fprintf(stderr, "Filtered %d graph%s that %s %s bipartite.\n",
@@ -0,0 +1,132 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads graphs in multicode format from standard in and
+ * writes those that have girth at least k to standard out in multicode format.
+ *
+ * Compile with:
+ *
+ *     cc -o multi_filter_girth -O4  multi_filter_girth.c \
+ *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c \
+ *     ../invariants/shared/invariant_context.c \
+ *     ../invariants/shared/invariant_graph_data.c ../invariants/shared/girth.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "shared/multicode_base.h"
+#include "shared/multicode_input.h"
+#include "shared/multicode_output.h"
+#include "../invariants/shared/invariant_context.h"
+#include "../invariants/shared/girth.h"
+
+boolean onlyCount = FALSE;
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s filters out graphs that have girth at least k.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] k\n\n", name);
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
+    fprintf(stderr, "graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -c, --count\n");
+    fprintf(stderr, "       Only count the number of graphs that have girth at least k.\n");
+    fprintf(stderr, "    -i, --invert\n");
+    fprintf(stderr, "       Accept graphs only if they have girth less than k.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] k\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    ADJACENCY adj;
+
+    int graphsRead = 0;
+    int graphsFiltered = 0;
+
+    boolean invertFilter = FALSE;
+    int k;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"invert", no_argument, NULL, 'i'},
+        {"count", no_argument, NULL, 'c'},
+        {"help", no_argument, NULL, 'h'}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hci", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'i':
+                invertFilter = TRUE;
+                break;
+            case 'c':
+                onlyCount = TRUE;
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 1) {
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    k = atoi(argv[optind]);
+
+    INVARIANT_CONTEXT *context = newInvariantContext();
+
+    unsigned short code[MAXCODELENGTH];
+    int length;
+    while (readMultiCode(code, &length, stdin)) {
+        decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+        graphsRead++;
+
+        if(hasGirthAtLeast(graph, adj, k, context) != invertFilter){
+            if(!onlyCount){
+                writeMultiCode(graph, adj, stdout);
+            }
+            graphsFiltered++;
+        }
+    }
+
+    freeInvariantContext(context);
+
+    fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
+    fprintf(stderr, "Filtered %d graph%s with girth %s %d.\n",
+            graphsFiltered,
+            graphsFiltered==1 ? "" : "s",
+            invertFilter ? "less than" : "at least",
+            k);
+
+    return (EXIT_SUCCESS);
+}
@@ -11,7 +11,8 @@
  * Compile with:
  *     
  *     cc -o multi_filter_regular -O4  multi_filter_regular.c \
- *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c
+ *     shared/multicode_base.c shared/multicode_input.c \
+ *     ../shared/code_reader.c
  * 
  */
 
@@ -21,7 +22,7 @@
 
 #include "shared/multicode_base.h"
 #include "shared/multicode_input.h"
-#include "shared/multicode_output.h"
+#include "../shared/code_reader.h"
 
 boolean kRegular = FALSE;
 int k;
@@ -112,19 +113,20 @@ int main(int argc, char** argv) {
         }
     }
     
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+    CODE_READER *reader = newMultiCodeReader(stdin);
+    CODE_VIEW view;
+    while (nextCode(reader, &view)) {
+        decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
         graphsRead++;
         
         if(isRegular(graph, adj)){
             if(!onlyCount){
-                writeMultiCode(graph, adj, stdout);
+                writeCodeView(&view, graphsFiltered ? NULL : MULTICODE_HEADER, stdout);
             }
             graphsFiltered++;
         }
     }
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
     fprintf(stderr, "Filtered %d graph%s.\n", graphsFiltered, graphsFiltered==1 ? "" : "s");
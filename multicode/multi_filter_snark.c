@@ -11,7 +11,9 @@
  * Compile with:
  *     
  *     cc -o multi_filter_snarks -O4  multi_filter_snarks.c \
- *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c
+ *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c \
+ *     ../invariants/shared/invariant_context.c \
+ *     ../invariants/shared/invariant_graph_data.c ../invariants/shared/girth.c
  * 
  */
 
@@ -22,6 +24,8 @@
 #include "shared/multicode_base.h"
 #include "shared/multicode_input.h"
 #include "shared/multicode_output.h"
+#include "../invariants/shared/invariant_context.h"
+#include "../invariants/shared/girth.h"
 
 #define DEBUGASSERT(assertion) if(!(assertion)) {fprintf(stderr, "%s:%u Assertion failed: %s\n", __FILE__, __LINE__, #assertion); fflush(stderr); exit(1);}
 //#define DEBUGASSERT(assertion)
@@ -34,6 +38,8 @@ boolean girthAtLeast5 = TRUE;
 
 boolean cyclically4EdgeConnected = TRUE;
 
+INVARIANT_CONTEXT *girthContext;
+
 //------------------Start connectivity methods--------------------------------
 
 //adapted from snarkhunter
@@ -156,77 +162,6 @@ int has_nontrivial_threecut(GRAPH graph) {
 
 //------------------End connectivity methods--------------------------------
 
-//------------------Start girth methods--------------------------------
-
-/**
-  * Return the minimum of the given girth and the length of the shortest
-  * cycle through the given vertex.
-  */
-int pseudoGirth(GRAPH graph, int v, int girth) {
-    int i;
-    
-    int n = graph[0][0];
-        
-    int queue[n];
-    int head = 0;
-    int tail = 0;
-
-    int levels[n+1];
-    for(i=1; i<=n; i++){
-        levels[i]=-1;
-    }
-    queue[head] = v;
-
-    int lim = girth / 2;
-
-    head ++;
-    levels[v] = 0;
-    while (head > tail) {
-        int vertex = queue[tail];
-        int d = levels[vertex];
-        if (d >= lim)
-            return girth; // can never improve current girth
-        tail ++;
-        for (i=0; i<3; i++) {
-            int nb = graph[vertex][i];
-            int e = levels[nb];
-            if (e < 0) {
-                // not yet encountered
-                levels[nb] = d+1;
-                queue[head] = nb;
-                head ++;
-            } else if (e == d) {
-                // odd cycle
-                return 2*d + 1;
-            } else if (e > d) {
-                // even cycle
-                if (girth > 2*e) {
-                    girth = 2*e; // == 2*d+2
-                }
-            } //else {
-                // returns towards v, ignore
-            //}
-        }
-    }
-    return girth;
-}
-
-/**
-  * Return the minimum of the given upperBound and the girth.
-  */
-int girth(GRAPH graph, int upperBound){
-    int i;
-    int girth = upperBound;
-    
-    for(i=1; i<=graph[0][0]; i++){
-        girth = pseudoGirth(graph, i, girth);
-    }
-    
-    return girth;
-}
-
-//------------------End girth methods--------------------------------
-
 //------------------Start colouring methods--------------------------------
 
 /* Store the colouring of the current graph
@@ -523,7 +458,7 @@ boolean isSnark(GRAPH graph, ADJACENCY adj){
     
     if(girthAtLeast5 || cyclically4EdgeConnected){
 
-        int g = girth(graph, 5); //calculate the minimum of the girth and 5
+        int g = computeGirth(graph, adj, 5, girthContext); //calculate the minimum of the girth and 5
 
         if(girthAtLeast5 && g<5){
             if(verbose){
@@ -636,10 +571,12 @@ int main(int argc, char** argv) {
         }
     }
     
+    girthContext = newInvariantContext();
+    
     unsigned short code[MAXCODELENGTH];
     int length;
     while (readMultiCode(code, &length, stdin)) {
-        decodeMultiCode(code, length, graph, adj);
+        decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
         graphsRead++;
         
         if(isSnark(graph, adj)){
@@ -652,6 +589,8 @@ int main(int argc, char** argv) {
     
     fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
     fprintf(stderr, "Filtered %d snark%s.\n", graphsFiltered, graphsFiltered==1 ? "" : "s");
+    
+    freeInvariantContext(girthContext);
 
     return (EXIT_SUCCESS);
 }
@@ -1,478 +1,248 @@
-// cc -O4 -o multi_non_iso multi_non_iso.c nautil.c nauty.c
-
-#include<stdio.h>
-#include<stdlib.h>
-#include<memory.h>
-#include "nauty.h"
-
-#define leer 0
-#define nil 0
-#define knoten 210 
-
-#define reg 3
-#define MAXVAL knoten-1
-
-
-typedef unsigned char GRAPH[knoten+1][MAXVAL];
-typedef unsigned char ADJAZENZ[knoten+1];
-typedef unsigned long *NAUTYGRAPH;
-typedef struct le { NAUTYGRAPH nautyg;
-		    int knotenzahl;
-		    struct le *smaller;
-		    struct le *larger;
-			int id;} LISTENTRY;
-
-int  zaehlen=0;
-
-int graphenzahl=0, noniso, debugzaehler=0, ausgabezaehler=0;
-LISTENTRY *arbeitsliste;
-GRAPH global_puffer_gr;
-
-/*extern UPROC distances();*/
-
-void schreibegraph(g)
-GRAPH g;
-{
-int   x,y, unten,oben,maxval,maxkn;
-
-
-for (maxval=0, x=1; x<=g[0][0]; x++)
-   while (g[x][maxval]!=leer) maxval++;
-
-//for (maxkn=knoten; g[maxkn][0]==leer; maxkn--);
-maxkn=g[0][0];
-
-fprintf(stderr,"\n\n ");
-
-fprintf(stderr,"|%2d",maxkn);
-
-for(x=1; (x <= maxkn)&&(x<=24); x++)  fprintf(stderr,"|%2d",x); fprintf(stderr,"|\n");
-
-fprintf(stderr," ");
-
-for(x=0; (x <= maxkn)&&(x<=24); x++) fprintf(stderr,"|==");    fprintf(stderr,"|\n");
-
-for(x=0; x < maxval; x++)
- {
-  fprintf(stderr," |  ");
-  for(y=1; (y<=maxkn)&&(y<=24); y++)
-      if (g[y][x] ==leer) fprintf(stderr,"|  "); else fprintf(stderr,"|%2d",g[y][x]);
-      fprintf(stderr,"|\n");
- }
-
-unten=25; oben=48;
-
-while(maxkn>=unten)
-{
-fprintf(stderr,"\n");
-
-fprintf(stderr,"    ");
-
-for(x=unten; (x <= maxkn)&&(x<=oben); x++)  fprintf(stderr,"|%2d",x); fprintf(stderr,"|\n");
-
-fprintf(stderr,"    ");
-
-for(x=unten; (x <= maxkn)&&(x<=oben); x++) fprintf(stderr,"|==");    fprintf(stderr,"|\n");
-
-for(y=0; y < maxval; y++)
- {
-  fprintf(stderr,"    ");
-  for(x=unten; (x <= maxkn)&&(x<=oben); x++)
-      if (g[x][y]==leer) fprintf(stderr,"|  "); else fprintf(stderr,"|%2d",g[x][y]);
-      fprintf(stderr,"|\n");
- }
-unten += 24; oben += 24;
-}
-
-}
-
-
-/**********UMWANDELN****************************************************/
-
-void umwandeln(g,nautyg,m)
-
-GRAPH g;
-NAUTYGRAPH nautyg;
-int m; /* die fuer nauty kanonische m-Variable */
-
-/* wandelt einen graphen in der normalen darstellung in einen fuer nauty
-  passenden graphen um */
-/* alle knotennamen muessen fuer nauty um 1 nach unten verschoben werden */
-
-{
-
-int i,j;
-
-
-for (i=0; i<g[0][0]*m; i++) nautyg[i]=0;
-for (i=0; i<g[0][0]; i++) { 
-                          for (j=0; g[i+1][j]!=leer; j++) 
-                                   ADDELEMENT(nautyg+(m*i),g[i+1][j]-1);
-		         }
-}
-
-
-/**************************EINBAUEN********************************/
-void einbauen(LISTENTRY *el, NAUTYGRAPH canong,int m, int knotenzahl)
-
-{
-
-debugzaehler++;
-     el->nautyg= canong;
-     el->knotenzahl=knotenzahl;
-     el->smaller=nil;
-     el->larger=nil;
-	 el->id=zaehlen;
-   }
-
-
-
-/**************************IN_LISTE********************************/
-
-void in_liste(LISTENTRY *el, NAUTYGRAPH canong,int m, int knotenzahl, int *test, int *copy)
-/* schaut nach, ob canong schon in der Liste ist und schreibt ihn eventuell
-  rein */
-{ int compare;
- int n;
-
-
-
- compare = knotenzahl - el->knotenzahl;
- if (compare==0)
-   compare=memcmp(canong,el->nautyg,m*knotenzahl*sizeof(unsigned long));
- if (compare==0) {
-     *test=0;
-	 *copy=el->id;
- } else if (compare<0){
-	if (el->smaller==nil){
-		*test=1; 
-		*copy=0;
-		el->smaller=(LISTENTRY *)malloc(sizeof(LISTENTRY));
-		if (el->smaller==nil) {
-			fprintf(stderr,"Can not get more memory !\n"); exit(99);
-		}
-		einbauen(el->smaller,canong,m,knotenzahl);
-	} else {
-		in_liste(el->smaller,canong,m,knotenzahl,test,copy);
-	}
- } else { /* compare > 0 */
-   if (el->larger==nil){
-		*test=1;
-		*copy=0; 
-		el->larger=(LISTENTRY *)malloc(sizeof(LISTENTRY));
-		if (el->larger==nil) {
-			fprintf(stderr,"Can not get more memory !\n");
-			exit(99);
-		}
-		einbauen(el->larger,canong,m,knotenzahl);
-	} else {
-		in_liste(el->larger,canong,m,knotenzahl,test,copy);
-	}
- }
-
-}
-
-
-
-
-/**************************NEU*************************************/
-
-int add_to_list(GRAPH gr, LISTENTRY **liste)
-/* Entscheidet, ob ein graph schon in der Liste behandelter Graphen ist 
-  und fuegt ihn ein, wenn nicht */
-/* returns 0 if the graph wasn't in the list, otherwise returns the number of the graph of which it is a copy*/
-{
-NAUTYGRAPH nautyg, canong;
-nvector lab[knoten], ptn[knoten], orbits[knoten];
-static DEFAULTOPTIONS(options);
-statsblk(stats);
-setword workspace[100*knoten];
-int m,n,test,knotenzahl,copy;
-
-knotenzahl=gr[0][0];
-/*options.invarproc= &distances;*/
-options.getcanon=TRUE;
-options.writeautoms=FALSE;
-options.writemarkers=FALSE;
-
-if ((gr[0][0]%32)==0) m=gr[0][0]/32; else m=gr[0][0]/32+1;
-
-nautyg= (NAUTYGRAPH)calloc(m*knotenzahl,sizeof(unsigned long));
-canong= (NAUTYGRAPH)calloc(m*knotenzahl,sizeof(unsigned long));
-if ((nautyg==nil) || (canong==nil) )
-	    { fprintf(stderr,"Can not get more memory (1)!\n"); exit(99); }
-
-umwandeln(gr,nautyg,m);
-nauty(nautyg,lab,ptn,NILSET,orbits,&options, &stats,workspace,100,
-                                                  m,gr[0][0],canong); 
-
 /*
-for (n=0; n<gr[0][0]; n++) fprintf(stderr," %d ",canong[n]);
-fprintf(stderr,"\n");
-*/
-
-if ((*liste)==nil)
-	{ test=1; 
-	  *liste =(LISTENTRY *)malloc(sizeof(LISTENTRY));
-	  if (*liste==nil) 
-	    { fprintf(stderr,"Can not get more memory (0)!\n"); exit(99); }
-	  einbauen(*liste,canong,m,knotenzahl); 
-	}
-else in_liste(*liste,canong,m,gr[0][0],&test,&copy);
-
-
-free(nautyg); 
-if (test==0) free(canong); /* sonst wurde er in die Liste geschrieben */
-
-return copy;
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads simple graphs in multicode format from standard in and
+ * determines which of them are pairwise non-isomorphic. The canonical form
+ * of each graph is computed by nauty and stored in a hash store, so a graph
+ * is isomorphic to an earlier graph exactly when its canonical form is
+ * already in the store.
+ *
+ * With the option -e the canonical forms are not kept in memory, but are
+ * deduplicated externally in partition files in the given directory. An
+ * interrupted run can be continued by restarting it on the same input with the
+ * same directory.
+ *
+ * Compile with:
+ *
+ *     cc -o multi_non_iso -O4 -DMAXN=1000 -DMAXVAL=999 multi_non_iso.c \
+ *          shared/multicode_base.c shared/multicode_input.c \
+ *          ../shared/code_reader.c ../shared/hash_store.c \
+ *          ../shared/external_dedup.c \
+ *          ../nauty/nauty.c ../nauty/nautil.c ../nauty/naugraph.c\
+ *          ../nauty/schreier.c ../nauty/naurng.c
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+
+#include "../nauty/nauty.h"
+
+#include "shared/multicode_base.h"
+#include "shared/multicode_input.h"
+#include "../shared/code_reader.h"
+#include "../shared/hash_store.h"
+#include "../shared/external_dedup.h"
+
+/* Nauty worksize */
+#define WORKSIZE 50 * MAXM
+
+/** Nauty variables */
+int lab[MAXN], ptn[MAXN], orbits[MAXN];
+static DEFAULTOPTIONS_GRAPH(options);
+statsblk stats;
+setword workspace[WORKSIZE];
+
+graph ng[MAXN*MAXM]; /* nauty graph datastructure */
+graph canong[MAXN*MAXM]; /* canonical form of ng */
+
+int n;
+int m;
+
+boolean writeGraphs = FALSE;
+boolean info = FALSE;
+boolean headerWritten = FALSE;
+unsigned long long nonIsomorphicCount = 0;
+
+/* This method translates the internal data structure to nauty's dense graph
+ * data structure, so the graph can be passed to nauty.
+ */
+static inline void translateGraphToNautyDenseGraph(GRAPH graph, ADJACENCY adj){
+    int i, j;
+
+    n = graph[0][0];
+
+    if(n > MAXN){
+        fprintf(stderr, "We only support graphs with up to %d vertices - exiting!\n", MAXN);
+        exit(EXIT_FAILURE);
+    }
+
+    m = SETWORDSNEEDED(n);
+
+    nauty_check(WORDSIZE,m,n,NAUTYVERSIONID);
+
+    EMPTYGRAPH(ng,m,n);
+
+    for(i = 1; i <= graph[0][0]; i++){
+        for(j = 0; j < adj[i]; j++){
+            if(i < graph[i][j]){
+                ADDONEEDGE(ng, i - 1, graph[i][j] - 1, m);
+            }
+        }
+    }
 }
 
-
-/****************************EINFUGEN****************************************/
-
-void einfugen (gr,adj,v,w)
-GRAPH gr;
-unsigned char adj[knoten+1];
-unsigned char v, w;
-/* Fuegt die Kante (v,w) in den Graphen graph ein. Dabei wird aber davon */
-/* ausgegangen, dass in adj die wirklich aktuellen werte fuer die */
-/* Adjazenzen stehen. Die adjazenzen werden dann aktualisiert. */
-
-{
-gr[v][adj[v]]=w;
-gr[w][adj[w]]=v;
-adj[v]++;
-adj[w]++;
+static inline void computeCanonicalForm(){
+    nauty((graph*) &ng, lab, ptn, NULL, orbits, &options, &stats, workspace, WORKSIZE, m, n, canong);
 }
 
-
-/**************************DECODIERE*****************************************/
-
-
-void decodiere(unsigned char *code,GRAPH graph,ADJAZENZ adj,int codelaenge)
-
-{
-int i,j;
-unsigned char knotenzahl;
-
-/*for(i=0;i<codelaenge;i++) printf(" %d ",code[i]); printf("\n");*/
-
-graph[0][0]=knotenzahl=code[0];
-
-for (i=1; i<= knotenzahl; i++) { adj[i]=0;
-                                for (j=0; j<MAXVAL; j++) graph[i][j]=leer;
-                              }
-for (j=1; j<knoten; j++) graph[0][j]=0;
-
-
-j=1;
-
-for (i=1; i<codelaenge; i++) 
-           { if (code[i]==0) j++; else einfugen(graph,adj,j,code[i]); }
+/* Returns 0 if the graph that was passed to nauty is not isomorphic to a graph
+ * that was stored before, and stores it with the given number. Otherwise
+ * returns the number of the first graph that is isomorphic to this graph.
+ */
+unsigned long long storeCanonicalForm(HASH_STORE *store, unsigned long long number){
+    unsigned long long copy;
+
+    computeCanonicalForm();
+
+    //the length of the canonical form determines the order
+    if(addToHashStore(store, canong, sizeof(setword)*m*n, number, &copy)){
+        return 0;
+    } else {
+        return copy;
+    }
 }
 
-
-
-
-/**********************************CODIERE********************************/
-
-void codiere_und_schreibe(gr)
-GRAPH gr;
-
-{
-int i,j,codestelle;
-unsigned char code[knoten*knoten];
-
-/* Codierung: Erstes byte: knotenzahl danach die zu knoten 1 adjazenten
-  ALLE GROESSEREN vertices, beendet durch 0, danach die zu knoten 2 
-  adjazenten GROESSEREN .... jeweils beendet durch 0. Da der letzte Knoten
-  nie zu groesseren adjazent sein kann, braucht seine (immer leere) Liste 
-  nicht durch 0 abgeschlossen werden*/
-
-
-code[0]=gr[0][0];
-
-for (codestelle=1; gr[1][codestelle-1]!=leer; codestelle++) 
-                        code[codestelle]=gr[1][codestelle-1]; 
-/* 0 ist das Trennzeichen fuer den naechsten Code */
-/* Gesamtcodelaenge: Kantenzahl+knotenzahl      */
-
-for (j=2; j<=gr[0][0]; j++)
-{ code[codestelle]=0; codestelle++;
- for (i=0; gr[j][i]!=leer; i++) 
-                    if (gr[j][i]>j) 
-                           { code[codestelle]=gr[j][i]; codestelle++; }
+static void writeCode(const void *code, size_t length){
+    //the code is written exactly as it was read
+    if (!headerWritten) {
+        fprintf(stdout, "%s<<", MULTICODE_HEADER);
+        headerWritten = TRUE;
+    }
+    fwrite(code, 1, length, stdout);
 }
 
-fwrite(code,sizeof(unsigned char),codestelle,stdout);
-
+static void reportGraph(unsigned long long number, unsigned long long copy){
+    if (info) {
+        if (!copy) {
+            fprintf(stdout, "Graph %llu is new.\n", number);
+        } else {
+            fprintf(stdout, "Graph %llu is not new, copy is %llu.\n", number, copy);
+        }
+    }
 }
 
-
-/***********************NAUTY_TO_GRAPH*************************/
-
-void nauty_to_graph(NAUTYGRAPH nautyg, GRAPH gr, int knotenzahl)
-{
-int i,j,m;
-ADJAZENZ adj;
-
-
-if ((knotenzahl%32)==0) m=knotenzahl/32; else m=knotenzahl/32+1;
-
-for (i=0; i<=knoten; i++) 
-  { for (j=0;j<MAXVAL; j++) gr[i][j]=leer;
-    adj[i]=0; }
-
-gr[0][0]=knotenzahl;
-
-for (i=0; i<knotenzahl; i++)
-   { j = -1;
-     while ((j = nextelement(nautyg+m*i,m,j)) >= 0)
-	  if (j>i) { einfugen(gr,adj,i+1,j+1); }
-   }
-
+static void reportExternalGraph(unsigned long long number, unsigned long long copy,
+        const void *payload, size_t payloadLength, void *data){
+    if (!copy) {
+        nonIsomorphicCount++;
+        if (writeGraphs) {
+            writeCode(payload, payloadLength);
+        }
+    }
+    reportGraph(number, copy);
 }
 
-/*********************AUSGABE***********************************/
-
-void ausgabe(LISTENTRY *liste)
-
-{ 
-
-/* GRAPH gr;  muss global gehandhabt werden, um beim iterierten aufruf Platz zu
-sparen */
-if (liste==nil) return;
-
-ausgabezaehler++;
-
-if (liste->larger != nil) ausgabe(liste->larger);
-
-//nauty_to_graph(liste->nautyg,global_puffer_gr,liste->knotenzahl);
-noniso++;
-//codiere_und_schreibe(global_puffer_gr);
-
-if (liste->smaller != nil) ausgabe(liste->smaller); 
-
+void usage(char *name){
+    fprintf(stderr, "usage: %s [-e dir [-p n] [-m n]] [w|i]\n", name);
+    fprintf(stderr, "It reads multigraph codes from stdin, and writes them --\n");
+    fprintf(stderr, "In case option w is given -- \n");
+    fprintf(stderr, "one of each isomorphism class -- on stdout and in the order \n");
+    fprintf(stderr, "that they were read.\n");
+    fprintf(stderr, "In case option i is given, it writes for each graph whether it is new.\n");
+    fprintf(stderr, "With -e dir the canonical forms are stored in files in the directory dir\n");
+    fprintf(stderr, "instead of in memory, split into n partitions (-p, default 64) that are\n");
+    fprintf(stderr, "handled with at most n MB of memory (-m, default 1024). An interrupted run\n");
+    fprintf(stderr, "is resumed when it is restarted with the same input and directory.\n");
+    fprintf(stderr, "ONLY FOR SIMPLE GRAPHS !! \n");
 }
 
-
-
-/****************************LESE_MULTICODE************************/
-
-int lese_multicode(unsigned char**code, int *codelaenge, FILE *fil)
-
-/* Liest den code und gibt EOF zurueck, wenn das Ende der Datei erreicht
-  ist, 1 sonst. Der Speicher fuer den code wird alloziert, falls noetig,
-  was entschieden wird anhand der lokalen Variablen maxknotenzahl */
-{
-static int maxknotenzahl= -1;
-int codel, gepuffert=0;
-int knotenzahl,a,b,nuller;
-unsigned char ucharpuffer;
-
-if ((knotenzahl=getc(fil))==EOF) return EOF;
-if (knotenzahl==0) { fprintf(stderr,"Umschaltung auf short noch nicht implementiert.\n");
-                    exit(0);
-                   } 
-nuller=0; codel=1;
-if (knotenzahl=='>') /* koennte ein header sein -- oder 'ne 62, also ausreichend fuer
-			     unsigned char */
-     { gepuffert=1;
-	a=getc(fil);
-	if(a==0) nuller++; 
-	b=getc(fil);
-	if(b==0) nuller++; 
-	/* jetzt wurden 3 Zeichen gelesen */
-	if ((a=='>') && (b=='m')) /*garantiert header*/
-	  { 
-	    gepuffert=0;
-	    while ((ucharpuffer=getc(fil)) != '<')
-            ;
-	    /* noch zweimal: */ ucharpuffer=getc(fil); 
-	    if (ucharpuffer!='<') { fprintf(stderr,"Problems with header -- single '<'\n"); exit(1); }
-	    if ((knotenzahl=getc(fil))==EOF) return EOF;
-	    /* kein graph drin */
-	  }
-	/* else kein header */
-     }
-
-
-if (knotenzahl > maxknotenzahl)
- { if (*code) free(*code);
-   *code=(unsigned char *)malloc((knotenzahl*(knotenzahl-1)/2+knotenzahl)*sizeof(unsigned char));
-   if (code==NULL) { fprintf(stderr,"Do not get memory for code\n"); exit(0); }
-   maxknotenzahl=knotenzahl;
- }
-
-(*code)[0]=knotenzahl; if (gepuffert) { codel=3; (*code)[1]=a; (*code)[2]=b; }
-
-while (nuller<knotenzahl-1)
- { if (((*code)[codel]=getc(fil))==0) nuller++;
-   codel++; }
-
-*codelaenge=codel;
-return 1;
+int main(int argc, char *argv[]) {
+    GRAPH graph;
+    ADJACENCY adj;
+    CODE_VIEW view;
+    unsigned long long graphsRead = 0, copy, resumePoint = 0;
+    char *externalDirectory = NULL;
+    int partitionCount = 64;
+    size_t memoryBudget = 1024;
+    HASH_STORE *store = NULL;
+    EXTERNAL_DEDUP *dedup = NULL;
+    int c;
+
+    while ((c = getopt(argc, argv, "e:p:m:")) != -1) {
+        switch (c) {
+            case 'e':
+                externalDirectory = optarg;
+                break;
+            case 'p':
+                partitionCount = atoi(optarg);
+                break;
+            case 'm':
+                memoryBudget = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind > 1 || partitionCount <= 0 ||
+            (argc - optind == 1 && argv[optind][0] != 'w' && argv[optind][0] != 'i')) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    writeGraphs = argc - optind == 1 && argv[optind][0] == 'w';
+    info = argc - optind == 1 && argv[optind][0] == 'i';
+
+    options.getcanon = TRUE;
+
+    if (externalDirectory != NULL) {
+        dedup = openExternalDedup(externalDirectory, partitionCount, memoryBudget << 20);
+        resumePoint = externalDedupResumePoint(dedup);
+        if (resumePoint) {
+            fprintf(stderr, "Resuming after graph %llu.\n", resumePoint);
+        }
+    } else {
+        store = newHashStore();
+    }
+    CODE_READER *reader = newMultiCodeReader(stdin);
+
+    while (nextCode(reader, &view)) {
+        if (view.order > MAXN) {
+            fprintf(stderr, "Constant N too small %d > %d -- exiting!\n", view.order, MAXN);
+            exit(EXIT_FAILURE);
+        }
+        graphsRead++;
+        if (graphsRead <= resumePoint) {
+            //this graph was already stored by the interrupted run
+            continue;
+        }
+        decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+
+        translateGraphToNautyDenseGraph(graph, adj);
+
+        if (dedup != NULL) {
+            computeCanonicalForm();
+            addToExternalDedup(dedup, graphsRead, canong, sizeof(setword)*m*n,
+                    view.data, writeGraphs ? view.length : 0);
+            continue;
+        }
+
+        copy = storeCanonicalForm(store, graphsRead);
+
+        if (!copy && writeGraphs) {
+            writeCode(view.data, view.length);
+        }
+        reportGraph(graphsRead, copy);
+    }
+
+    if (dedup != NULL) {
+        finishExternalDedup(dedup, reportExternalGraph, NULL);
+        closeExternalDedup(dedup);
+    } else {
+        nonIsomorphicCount = hashStoreSize(store);
+        freeHashStore(store);
+    }
+
+    fprintf(stderr, "Gelesen: %llu Graphen, davon %llu paarweise nicht isomorph.\n",
+            graphsRead, nonIsomorphicCount);
+
+    freeCodeReader(reader);
+
+    return EXIT_SUCCESS;
 }
-
-
-
-/******************************MAIN************************************/
-
-int main(argc,argv)
-
-int argc;
-char *argv[];
-
-
-{
-GRAPH gr;
-ADJAZENZ adj;
-unsigned char *code=NULL;
-int  number=0, after=0, codelaenge;
-int dreier=0, vierer=0, dummy, writethem, info;
-int i,j, nuller;
-int anzB=0, anzC=0, anzS=0;
-
-
-
-arbeitsliste=nil;
-
-if (argc==2 && argv[1][0]=='w') writethem=1; else writethem=0;
-if (argc==2 && argv[1][0]=='i') info=1; else info=0;
-
-if (argc > 2 || (argc==2 && (argv[1][0]!='w' && argv[1][0]!='i'))) 
-{ fprintf(stderr,"usage: mu_non_iso [w]");
- fprintf(stderr,"It reads multigraph codes from stdin, and writes them --\n");
- fprintf(stderr,"In case option w is given -- \n");
- fprintf(stderr,"one of each isomorphism class -- on stdout and in the order \n");
- fprintf(stderr,"that they were read.\n");
- fprintf(stderr,"ONLY FOR SIMPLE GRAPHS !! \n");
-     exit(0); }
-
-
-zaehlen=noniso=0;
-
-while(lese_multicode(&code, &codelaenge, stdin) != EOF)
- {
-   zaehlen++; 
-   decodiere(code,gr,adj,codelaenge);
-   //schreibegraph(gr);
-   int copy = add_to_list(gr,&arbeitsliste);
-   if (!copy && writethem) fwrite(code,sizeof(unsigned char),codelaenge,stdout);
-   if (info){
-      if(!copy){
-		fprintf(stdout, "Graph %d is new.\n", zaehlen);
-	  } else {
-		fprintf(stdout, "Graph %d is not new, copy is %d.\n", zaehlen, copy);
-	  }
-   }
- }
-
-  if (arbeitsliste != nil) ausgabe(arbeitsliste);
-
-fprintf(stderr,"Gelesen: %d Graphen, davon %d paarweise nicht isomorph.\n",zaehlen,noniso);
-
-return(0);
-
-}
-
@@ -11,7 +11,8 @@
  * Compile with:
  *     
  *     cc -o multi_select -O4  multi_select.c \
- *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c
+ *     shared/multicode_base.c shared/multicode_input.c shared/multicode_output.c \
+ *     ../shared/code_reader.c ../shared/code_index.c
  * 
  */
 
@@ -22,6 +23,7 @@
 #include "shared/multicode_base.h"
 #include "shared/multicode_input.h"
 #include "shared/multicode_output.h"
+#include "../shared/code_index.h"
 
 //====================== USAGE =======================
 
@@ -34,6 +36,13 @@ void help(char *name) {
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -m, --modulo r:m\n");
     fprintf(stderr, "       Split the input into m parts and only output part r (0<=r<m).\n");
+    fprintf(stderr, "    -I, --indexed file\n");
+    fprintf(stderr, "       Read the graphs from the specified file instead of from stdin. The file\n");
+    fprintf(stderr, "       needs an index (see multi_index), which is used to jump directly to the\n");
+    fprintf(stderr, "       selected graphs.\n");
+    fprintf(stderr, "    -s, --shard r:m\n");
+    fprintf(stderr, "       Split the input into m ranges of consecutive graphs and only output range\n");
+    fprintf(stderr, "       r (0<=r<m). Requires the option -I.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -41,6 +50,7 @@ void help(char *name) {
 void usage(char *name) {
     fprintf(stderr, "Usage: %s [options] g1 g2\n", name);
     fprintf(stderr, "       %s -m r:m\n", name);
+    fprintf(stderr, "       %s -I file -s r:m\n", name);
     fprintf(stderr, "For more information type: %s -h \n\n", name);
 }
 
@@ -58,6 +68,12 @@ int main(int argc, char** argv) {
     boolean moduloEnabled = FALSE;
     int moduloRest;
     int moduloMod;
+    
+    char *indexedFileName = NULL;
+    
+    boolean shardEnabled = FALSE;
+    int shardPart;
+    int shardCount;
 
     /*=========== commandline parsing ===========*/
 
@@ -65,11 +81,13 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"modulo", required_argument, NULL, 'm'},
+        {"indexed", required_argument, NULL, 'I'},
+        {"shard", required_argument, NULL, 's'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hm:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hm:I:s:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'm':
                 moduloEnabled = TRUE;
@@ -79,6 +97,18 @@ int main(int argc, char** argv) {
                     return EXIT_FAILURE;
                 }
                 break;
+            case 'I':
+                indexedFileName = optarg;
+                break;
+            case 's':
+                shardEnabled = TRUE;
+                if(sscanf(optarg, "%d:%d", &shardPart, &shardCount)!=2 ||
+                        shardCount <= 0 || shardPart < 0 || shardPart >= shardCount){
+                    fprintf(stderr, "Error while reading shard -- exiting.\n");
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -92,10 +122,17 @@ int main(int argc, char** argv) {
         }
     }
         
-    if (argc - optind == 0 && !moduloEnabled) {
+    if (argc - optind == 0 && !(moduloEnabled || shardEnabled)) {
         usage(name);
         return EXIT_FAILURE;
-    } else if(argc - optind > 0 && moduloEnabled){
+    } else if(argc - optind > 0 && (moduloEnabled || shardEnabled)){
+        usage(name);
+        return EXIT_FAILURE;
+    } else if(moduloEnabled && shardEnabled){
+        usage(name);
+        return EXIT_FAILURE;
+    } else if(shardEnabled && indexedFileName == NULL){
+        fprintf(stderr, "Sharding requires an indexed file -- exiting!\n");
         usage(name);
         return EXIT_FAILURE;
     }
@@ -106,7 +143,55 @@ int main(int argc, char** argv) {
         selectedGraphs[i] = atoi(argv[i + optind]);
     }
     
-
+    if(indexedFileName != NULL){
+        CODE_INDEX *index = openMultiCodeIndex(indexedFileName, NULL);
+        CODE_VIEW view;
+        unsigned long long graphNumber, end;
+        
+        if(index == NULL){
+            fprintf(stderr, "No index found for %s (see multi_index) -- exiting!\n", indexedFileName);
+            return EXIT_FAILURE;
+        }
+        
+        if(shardEnabled){
+            codeIndexShard(index, shardPart, shardCount, &graphNumber, &end);
+            //graphs are numbered starting from 1
+            for(graphNumber++; graphNumber <= end; graphNumber++){
+                codeIndexView(index, graphNumber - 1, &view);
+                decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+                graphsFiltered++;
+                writeMultiCode(graph, adj, stdout);
+            }
+        } else if(moduloEnabled){
+            end = codeIndexSize(index);
+            graphNumber = moduloRest > 0 ? moduloRest : moduloMod;
+            for(; graphNumber <= end; graphNumber += moduloMod){
+                codeIndexView(index, graphNumber - 1, &view);
+                decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+                graphsFiltered++;
+                writeMultiCode(graph, adj, stdout);
+            }
+        } else {
+            for (i = 0; i < argc - optind; i++){
+                if(selectedGraphs[i] < 1 || selectedGraphs[i] > codeIndexSize(index)){
+                    fprintf(stderr, "Graph %d is not in the file -- exiting!\n", selectedGraphs[i]);
+                    return EXIT_FAILURE;
+                }
+                codeIndexView(index, selectedGraphs[i] - 1, &view);
+                decodeMultiCodeView(&view, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
+                graphsFiltered++;
+                writeMultiCode(graph, adj, stdout);
+            }
+        }
+        //report the graphs in the file, as when the graphs are read from stdin
+        graphsRead = codeIndexSize(index);
+        closeCodeIndex(index);
+        
+        fprintf(stderr, "Read %llu graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
+        fprintf(stderr, "Filtered %d graph%s.\n", graphsFiltered, graphsFiltered==1 ? "" : "s");
+        
+        return (EXIT_SUCCESS);
+    }
     
     unsigned short code[MAXCODELENGTH];
     int length;
@@ -115,12 +200,12 @@ int main(int argc, char** argv) {
         
         if(moduloEnabled){
             if(graphsRead % moduloMod == moduloRest){
-                decodeMultiCode(code, length, graph, adj);
+                decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
                 graphsFiltered++;
                 writeMultiCode(graph, adj, stdout);
             }
         } else if (graphsFiltered < argc - optind && (graphsRead == selectedGraphs[graphsFiltered])) {
-            decodeMultiCode(code, length, graph, adj);
+            decodeMultiCodeWithFlags(code, length, graph, adj, MULTICODE_DECODE_NO_SENTINELS);
             graphsFiltered++;
             writeMultiCode(graph, adj, stdout);
         }
@@ -114,12 +114,13 @@ int main(int argc, char *argv[]) {
     }
 
     graphCount = 0;
+    prepareGraph(graph, adj, MAXN);
 
     while (readMultiCode(code, &codeLength, stdin)){
 
         graphCount++;
         if ((!filterGraph) || (filterGraph == graphCount)) {
-            decodeMultiCode(code, codeLength, graph, adj);
+            decodeMultiCodeWithFlags(code, codeLength, graph, adj, MULTICODE_DECODE_LAZY);
             for (i = 1, maxvalence = 0; i <= graph[0][0]; i++) {
                 if (adj[i] > maxvalence) {
                     maxvalence = adj[i];
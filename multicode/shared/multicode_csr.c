@@ -0,0 +1,258 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "multicode_csr.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Makes sure that g can store a graph with the given order and the given
+ * number of neighbour entries. Existing content is kept.
+ */
+void _ensureCsrMemory(CSR_GRAPH *g, int order, int slots){
+    if(order > g->maxOrder){
+        int newMaxOrder = 2*g->maxOrder > order ? 2*g->maxOrder : order;
+        int *newOffset = realloc(g->offset, sizeof(int)*(newMaxOrder + 2));
+        unsigned short *newDegree = realloc(g->degree, sizeof(unsigned short)*(newMaxOrder + 1));
+        if(newOffset == NULL || newDegree == NULL){
+            fprintf(stderr, "Insufficient memory for CSR graph -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        g->offset = newOffset;
+        g->degree = newDegree;
+        g->maxOrder = newMaxOrder;
+    }
+    if(slots > g->maxSlots){
+        int newMaxSlots = 2*g->maxSlots > slots ? 2*g->maxSlots : slots;
+        unsigned short *newNeighbours = realloc(g->neighbours, sizeof(unsigned short)*newMaxSlots);
+        if(newNeighbours == NULL){
+            fprintf(stderr, "Insufficient memory for CSR graph -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        g->neighbours = newNeighbours;
+        g->maxSlots = newMaxSlots;
+    }
+}
+
+CSR_GRAPH *newCsrGraph(int maxOrder, int maxSlots){
+    CSR_GRAPH *g = (CSR_GRAPH *)malloc(sizeof(CSR_GRAPH));
+    if(g == NULL){
+        fprintf(stderr, "Insufficient memory for CSR graph -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    g->order = g->edgeCount = 0;
+    g->maxOrder = g->maxSlots = 0;
+    g->offset = NULL;
+    g->degree = NULL;
+    g->neighbours = NULL;
+
+    //always allocate the offsets, so that an empty graph is valid
+    _ensureCsrMemory(g, maxOrder > 0 ? maxOrder : 1, maxSlots);
+    g->offset[1] = 0;
+
+    return g;
+}
+
+void freeCsrGraph(CSR_GRAPH *g){
+    free(g->neighbours);
+    free(g->degree);
+    free(g->offset);
+    free(g);
+}
+
+void prepareCsrGraph(CSR_GRAPH *g, int order, int slotsPerVertex){
+    int v;
+
+    _ensureCsrMemory(g, order, order*slotsPerVertex);
+
+    g->order = order;
+    g->edgeCount = 0;
+    for(v = 1; v <= order + 1; v++){
+        g->offset[v] = (v - 1)*slotsPerVertex;
+    }
+    for(v = 1; v <= order; v++){
+        g->degree[v] = 0;
+    }
+}
+
+/* Gives the row of v more free entries by moving all following rows.
+ */
+void _makeRoomInCsrRow(CSR_GRAPH *g, int v){
+    int u;
+    int capacity = g->offset[v+1] - g->offset[v];
+    int delta = capacity < 2 ? 4 - capacity : capacity;
+    int used = g->offset[g->order + 1];
+
+    _ensureCsrMemory(g, g->order, used + delta);
+    memmove(g->neighbours + g->offset[v+1] + delta,
+            g->neighbours + g->offset[v+1],
+            sizeof(unsigned short)*(used - g->offset[v+1]));
+    for(u = v + 1; u <= g->order + 1; u++){
+        g->offset[u] += delta;
+    }
+}
+
+/* This method adds the edge (v,w) to the graph. The degrees of v and w are
+ * updated and rows are grown if needed.
+ */
+void csrAddEdge(CSR_GRAPH *g, int v, int w){
+    if(g->offset[v] + g->degree[v] == g->offset[v+1]){
+        _makeRoomInCsrRow(g, v);
+    }
+    g->neighbours[g->offset[v] + g->degree[v]] = w;
+    g->degree[v]++;
+
+    if(g->offset[w] + g->degree[w] == g->offset[w+1]){
+        _makeRoomInCsrRow(g, w);
+    }
+    g->neighbours[g->offset[w] + g->degree[w]] = v;
+    g->degree[w]++;
+
+    g->edgeCount++;
+}
+
+boolean _csrRemoveEdge(CSR_GRAPH *g, int v, int w){
+    int vi = 0, wi = 0;
+    unsigned short *vNeighbours = CSR_NEIGHBOURS(g, v);
+    unsigned short *wNeighbours = CSR_NEIGHBOURS(g, w);
+
+    //find first position of w in the adjacency list of v
+    while(vi < g->degree[v] && vNeighbours[vi]!=w){
+        vi++;
+    }
+    if(vi == g->degree[v]){
+        return FALSE;
+    }
+
+    //find first position of v in the adjacency list of w
+    while(wi < g->degree[w] && wNeighbours[wi]!=v){
+        wi++;
+    }
+    if(wi == g->degree[w]){
+        //shouldn't happen!
+        return FALSE;
+    }
+
+    //the edge exists
+    g->degree[v]--;
+    g->degree[w]--;
+    vNeighbours[vi] = vNeighbours[g->degree[v]];
+    wNeighbours[wi] = wNeighbours[g->degree[w]];
+    g->edgeCount--;
+
+    return TRUE;
+}
+
+/* This method removes an edge (v,w) from the graph. If all is TRUE, then all
+ * edges between v and w are removed. For simple graphs the value of all is
+ * ignored.
+ */
+void csrRemoveEdge(CSR_GRAPH *g, int v, int w, boolean all){
+    boolean edgeRemoved = _csrRemoveEdge(g, v, w);
+    while(all && edgeRemoved){
+        edgeRemoved = _csrRemoveEdge(g, v, w);
+    }
+}
+
+boolean csrAreAdjacent(CSR_GRAPH *g, int v, int w){
+    int i;
+    unsigned short *neighbours = CSR_NEIGHBOURS(g, v);
+
+    for(i = 0; i < g->degree[v]; i++){
+        if(neighbours[i]==w) return TRUE;
+    }
+
+    return FALSE;
+}
+
+void decodeMultiCodeToCsr(unsigned short* code, int length, CSR_GRAPH *g) {
+    int i, v, currentVertex;
+    int order = code[0];
+
+    _ensureCsrMemory(g, order, 0);
+    g->order = order;
+
+    //first pass: count the degrees
+    for (v = 1; v <= order; v++) {
+        g->degree[v] = 0;
+    }
+    currentVertex = 1;
+    for (i = 1; i < length; i++) {
+        if (code[i] == 0) {
+            currentVertex++;
+        } else if (code[i] > order) {
+            fprintf(stderr, "Illegal vertex %d in graph with order %d -- exiting!\n", code[i], order);
+            exit(EXIT_FAILURE);
+        } else {
+            g->degree[currentVertex]++;
+            g->degree[code[i]]++;
+        }
+    }
+
+    //compute the offsets and reset the degrees so they can be used as cursors
+    g->offset[1] = 0;
+    for (v = 1; v <= order; v++) {
+        g->offset[v+1] = g->offset[v] + g->degree[v];
+        g->degree[v] = 0;
+    }
+    g->edgeCount = g->offset[order+1]/2;
+    _ensureCsrMemory(g, order, g->offset[order+1]);
+
+    //second pass: store the neighbours
+    currentVertex = 1;
+    for (i = 1; i < length; i++) {
+        if (code[i] == 0) {
+            currentVertex++;
+        } else {
+            g->neighbours[g->offset[currentVertex] + g->degree[currentVertex]++] = code[i];
+            g->neighbours[g->offset[code[i]] + g->degree[code[i]]++] = currentVertex;
+        }
+    }
+}
+
+/* The entries graph[v][adj[v]] and further are not cleared.
+ */
+void csrToGraph(CSR_GRAPH *csr, GRAPH graph, ADJACENCY adj){
+    int v;
+
+    if(csr->order > MAXN){
+        fprintf(stderr, "Constant N too small %d > %d \n", csr->order, MAXN);
+        exit(EXIT_FAILURE);
+    }
+
+    graph[0][0] = csr->order;
+    for(v = 1; v <= csr->order; v++){
+        if(csr->degree[v] > MAXVAL){
+            fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+            exit(EXIT_FAILURE);
+        }
+        adj[v] = csr->degree[v];
+        memcpy(graph[v], CSR_NEIGHBOURS(csr, v), sizeof(unsigned short)*csr->degree[v]);
+    }
+}
+
+void graphToCsr(GRAPH graph, ADJACENCY adj, CSR_GRAPH *csr, int extraSlots){
+    int v;
+    int order = graph[0][0];
+    int slots = 0;
+
+    for(v = 1; v <= order; v++){
+        slots += adj[v] + extraSlots;
+    }
+    _ensureCsrMemory(csr, order, slots);
+
+    csr->order = order;
+    csr->offset[1] = 0;
+    slots = 0;
+    for(v = 1; v <= order; v++){
+        csr->offset[v+1] = csr->offset[v] + adj[v] + extraSlots;
+        csr->degree[v] = adj[v];
+        memcpy(CSR_NEIGHBOURS(csr, v), graph[v], sizeof(unsigned short)*adj[v]);
+        slots += adj[v];
+    }
+    csr->edgeCount = slots/2;
+}
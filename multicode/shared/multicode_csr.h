@@ -0,0 +1,95 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef MULTICODE_CSR_H
+#define	MULTICODE_CSR_H
+
+#include "multicode_base.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef struct __csr_graph CSR_GRAPH;
+
+/* A graph stored in compressed sparse row format. The vertices are numbered
+ * from 1 to order. The neighbours of a vertex v are stored in the entries
+ * neighbours[offset[v]] up to neighbours[offset[v] + degree[v] - 1]. The
+ * entries up to neighbours[offset[v+1] - 1] are free and are used when an
+ * edge is added at v. If there is no free entry left, the rows are moved to
+ * make room.
+ *
+ * The memory is sized from the order and the number of edges of the graphs
+ * that are stored in it, and is reused (and grown if needed) when the same
+ * structure is used for several graphs.
+ */
+struct __csr_graph {
+    int order;
+    int edgeCount;
+
+    //the number of vertices and neighbour entries for which memory is allocated
+    int maxOrder;
+    int maxSlots;
+
+    //maxOrder + 2 entries
+    int *offset;
+    //maxOrder + 1 entries
+    unsigned short *degree;
+    //maxSlots entries
+    unsigned short *neighbours;
+};
+
+#define CSR_ORDER(g) ((g)->order)
+#define CSR_DEGREE(g, v) ((g)->degree[v])
+#define CSR_NEIGHBOURS(g, v) ((g)->neighbours + (g)->offset[v])
+#define CSR_NEIGHBOUR(g, v, i) ((g)->neighbours[(g)->offset[v] + (i)])
+
+/**
+ * Creates a new CSR graph that can hold graphs with up to maxOrder vertices
+ * and maxSlots neighbour entries (i.e., twice the number of edges) without
+ * reallocating. Both values may be 0. Exits if there is insufficient memory.
+ */
+CSR_GRAPH *newCsrGraph(int maxOrder, int maxSlots);
+
+void freeCsrGraph(CSR_GRAPH *g);
+
+/**
+ * Clears g and prepares it to hold a graph with the given order. Each vertex
+ * gets room for slotsPerVertex neighbours.
+ */
+void prepareCsrGraph(CSR_GRAPH *g, int order, int slotsPerVertex);
+
+void csrAddEdge(CSR_GRAPH *g, int v, int w);
+
+void csrRemoveEdge(CSR_GRAPH *g, int v, int w, boolean all);
+
+boolean csrAreAdjacent(CSR_GRAPH *g, int v, int w);
+
+/**
+ * Decodes the multicode into g. Only as much memory as is needed for this
+ * graph is touched: the cost is linear in the order and the size of the graph.
+ */
+void decodeMultiCodeToCsr(unsigned short* code, int length, CSR_GRAPH *g);
+
+/**
+ * Copies the CSR graph into the fixed size graph structure, so that methods
+ * written for GRAPH and ADJACENCY can be used. Exits if the graph does not fit.
+ */
+void csrToGraph(CSR_GRAPH *csr, GRAPH graph, ADJACENCY adj);
+
+/**
+ * Copies the graph into the CSR graph. Each vertex gets extraSlots free entries
+ * in addition to its neighbours.
+ */
+void graphToCsr(GRAPH graph, ADJACENCY adj, CSR_GRAPH *csr, int extraSlots);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MULTICODE_CSR_H */
+
@@ -8,23 +8,59 @@
 #include "multicode_input.h"
 #include<string.h>
 
+/* Resets the adjacency lists of the previous graph stored in graph. The lists
+ * are cleared up to the first EMPTY entry, so this also covers entries that
+ * were left behind by removeEdge.
+ */
+void _clearPreviousGraph(GRAPH graph){
+    int i, j;
+    int previousVertexCount = graph[0][0] > MAXN ? MAXN : graph[0][0];
+    
+    for (i = 1; i <= previousVertexCount; i++) {
+        for (j = 0; j <= MAXVAL && graph[i][j] != EMPTY; j++) {
+            graph[i][j] = EMPTY;
+        }
+    }
+}
+
 void decodeMultiCode(unsigned short* code, int length, GRAPH graph, ADJACENCY adj) {
-    int i, j, currentVertex;
-    unsigned short vertexCount;
+    decodeMultiCodeWithFlags(code, length, graph, adj, 0);
+}
 
-    graph[0][0] = vertexCount = code[0];
+/* Prepares graph and adj to hold a graph with the given number of vertices.
+ */
+void _prepareDecoding(GRAPH graph, ADJACENCY adj, unsigned short vertexCount, int flags) {
+    int i, j;
 
-    //mark all vertices as having degree 0
-    for (i = 1; i <= vertexCount; i++) {
-        adj[i] = 0;
-        for (j = 0; j <= MAXVAL; j++) {
-            graph[i][j] = EMPTY;
+    if (flags & MULTICODE_DECODE_NO_SENTINELS) {
+        for (i = 1; i <= vertexCount; i++) {
+            adj[i] = 0;
+        }
+    } else if (flags & MULTICODE_DECODE_LAZY) {
+        _clearPreviousGraph(graph);
+        for (i = 1; i <= vertexCount; i++) {
+            adj[i] = 0;
+        }
+    } else {
+        //mark all vertices as having degree 0
+        for (i = 1; i <= vertexCount; i++) {
+            adj[i] = 0;
+            for (j = 0; j <= MAXVAL; j++) {
+                graph[i][j] = EMPTY;
+            }
+        }
+        //clear first row
+        for (j = 1; j <= MAXVAL; j++) {
+            graph[0][j] = 0;
         }
     }
-    //clear first row
-    for (j = 1; j <= MAXVAL; j++) {
-        graph[0][j] = 0;
-    }
+    graph[0][0] = vertexCount;
+}
+
+void decodeMultiCodeWithFlags(unsigned short* code, int length, GRAPH graph, ADJACENCY adj, int flags) {
+    int i, currentVertex;
+
+    _prepareDecoding(graph, adj, code[0], flags);
 
     //go through code and add edges
     currentVertex = 1;
@@ -42,7 +78,36 @@ void decodeMultiCode(unsigned short* code, int length, GRAPH graph, ADJACENCY ad
     }
 }
 
+void decodeMultiCodeView(CODE_VIEW *view, GRAPH graph, ADJACENCY adj, int flags) {
+    int i, currentVertex;
+
+    if (view->order > MAXN) {
+        fprintf(stderr, "Constant N too small %d > %d \n", view->order, MAXN);
+        exit(1);
+    }
+
+    _prepareDecoding(graph, adj, view->order, flags);
+
+    //go through code and add edges
+    currentVertex = 1;
+
+    for (i = 0; i < view->entryCount; i++) {
+        unsigned short neighbour = CODE_ENTRY(view, i);
+        if (neighbour == 0) {
+            currentVertex++;
+        } else {
+            addEdge(graph, adj, currentVertex, (int) neighbour);
+            if ((adj[neighbour] > MAXVAL) || (adj[currentVertex] > MAXVAL)) {
+                fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+                exit(0);
+            }
+        }
+    }
+}
+
 /**
+ * Reads the next code with a reader that is bound to file. The reader is
+ * created at the first call and replaced when a different file is passed.
  * 
  * @param code
  * @param length
@@ -50,117 +115,31 @@ void decodeMultiCode(unsigned short* code, int length, GRAPH graph, ADJACENCY ad
  * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
  */
 int readMultiCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
+    static CODE_READER *reader = NULL;
+    static FILE *readerFile = NULL;
+    CODE_VIEW view;
 
-        if (fread(&testheader, sizeof (unsigned char), 12, file) != 12) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[12] = 0;
-        if (strcmp(testheader, ">>multi_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No multicode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
+    if (reader == NULL || readerFile != file) {
+        if (reader != NULL) {
+            freeCodeReader(reader);
         }
+        reader = newMultiCodeReader(file);
+        readerFile = file;
     }
 
-    /* possibly removing interior headers -- only done for multicode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
+    if (!nextCode(reader, &view)) {
         return (0);
     }
 
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'm')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
+    if (view.order > MAXN) {
+        fprintf(stderr, "Constant N too small %d > %d \n", view.order, MAXN);
+        exit(1);
     }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]-1) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]-1) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
+    if (view.entryCount >= MAXCODELENGTH) {
+        fprintf(stderr, "Code too long (%d entries) -- exiting!\n", view.entryCount);
+        exit(1);
     }
 
-    *length = bufferSize;
+    *length = codeViewToArray(&view, code);
     return (1);
-
-
 }
@@ -9,14 +9,36 @@
 #define	MULTICODE_INPUT_H
 
 #include "multicode_base.h"
+#include "../../shared/code_reader.h"
 #include<stdio.h>
 
 #ifdef	__cplusplus
 extern "C" {
 #endif
 
+/* Flags for decodeMultiCodeWithFlags */
+
+/* Only reset the entries that were used by the previous graph. This assumes
+ * that graph was prepared once with prepareGraph(graph, adj, MAXN) and since
+ * then only decoded with this flag or changed with addEdge and removeEdge.
+ */
+#define MULTICODE_DECODE_LAZY 1
+
+/* Do not write EMPTY in the unused entries of the adjacency lists. Only use this
+ * if the entries graph[v][adj[v]] and further are never read.
+ */
+#define MULTICODE_DECODE_NO_SENTINELS 2
+
 void decodeMultiCode(unsigned short* code, int length, GRAPH graph, ADJACENCY adj);
 
+void decodeMultiCodeWithFlags(unsigned short* code, int length, GRAPH graph, ADJACENCY adj, int flags);
+
+/**
+ * Decodes the code in the view without copying it first. The flags are the
+ * same as for decodeMultiCodeWithFlags.
+ */
+void decodeMultiCodeView(CODE_VIEW *view, GRAPH graph, ADJACENCY adj, int flags);
+
 int readMultiCode(unsigned short code[], int *length, FILE *file);
 
 #ifdef	__cplusplus
@@ -0,0 +1,116 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads plane graphs from standard in and reports how long it
+ * takes to decode them (including the computation of the dual). Only the
+ * decoding is timed, not the reading.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o decode_benchmark_pl -O4 decode_benchmark_pl.c \
+ *         ../shared/planar_base.c ../shared/planar_input.c \
+ *         ../../shared/code_reader.c
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "../shared/planar_base.h"
+#include "../shared/planar_input.h"
+#include "../../shared/code_reader.h"
+
+PLANE_GRAPH *pg = NULL;
+
+int numberOfGraphs = 0;
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s reports the time needed to decode plane graphs.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -r, --repeat n\n");
+    fprintf(stderr, "       Decode each graph n times (default: 1).\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+    int i, repeat = 1;
+    clock_t start, decodingTime = 0;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"repeat", required_argument, NULL, 'r'},
+        {"help", no_argument, NULL, 'h'}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hr:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'r':
+                repeat = atoi(optarg);
+                if(repeat <= 0){
+                    fprintf(stderr, "The number of repetitions should be positive -- exiting!\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    /*=========== read planar graphs ===========*/
+
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        start = clock();
+        for(i = 0; i < repeat; i++){
+            pg = decodePlanarCodeView(&view, pg, &options);
+        }
+        decodingTime += clock() - start;
+        numberOfGraphs++;
+    }
+    freeCodeReader(reader);
+
+    fprintf(stderr, "Read %d graph%s.\n", numberOfGraphs,
+                numberOfGraphs==1 ? "" : "s");
+    if(numberOfGraphs){
+        fprintf(stderr, "Decoded in %.1f microseconds per graph.\n",
+                1000000.0 * decodingTime / CLOCKS_PER_SEC / numberOfGraphs / repeat);
+    }
+
+    if(pg != NULL){
+        freePlaneGraph(pg);
+    }
+
+    return EXIT_SUCCESS;
+}
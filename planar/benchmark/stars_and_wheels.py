@@ -0,0 +1,44 @@
+'''
+Writes stars or wheels in planar code to standard out. These graphs have one
+vertex of high degree, so the time needed to decode them shows whether the
+decoder is linear in the degree.
+
+Usage: python stars_and_wheels.py star|wheel degree count
+'''
+import struct
+import sys
+
+def neighbourLists(kind, degree):
+    #the centre is vertex 1 and the rim vertices are 2, ..., degree + 1
+    rim = list(range(2, degree + 2))
+    lists = [rim]
+    for i in range(degree):
+        if kind == 'star':
+            lists.append([1])
+        else:
+            lists.append([1, rim[i - 1], rim[(i + 1) % degree]])
+    return lists
+
+def writeGraph(out, lists):
+    if len(lists) < 255:
+        out.write(struct.pack('B', len(lists)))
+        for neighbours in lists:
+            out.write(struct.pack('{}B'.format(len(neighbours) + 1), *(neighbours + [0])))
+    else:
+        out.write(struct.pack('=BH', 0, len(lists)))
+        for neighbours in lists:
+            out.write(struct.pack('={}H'.format(len(neighbours) + 1), *(neighbours + [0])))
+
+if len(sys.argv) != 4 or sys.argv[1] not in ('star', 'wheel'):
+    sys.stderr.write('Usage: python stars_and_wheels.py star|wheel degree count\n')
+    sys.exit(1)
+
+kind = sys.argv[1]
+degree = int(sys.argv[2])
+count = int(sys.argv[3])
+
+out = getattr(sys.stdout, 'buffer', sys.stdout)
+out.write(b'>>planar_code<<')
+lists = neighbourLists(kind, degree)
+for _ in range(count):
+    writeGraph(out, lists)
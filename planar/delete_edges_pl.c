@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o delete_edges_pl -O4 delete_edges_pl.c
+ *     cc -o delete_edges_pl -O4 delete_edges_pl.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c ../shared/code_reader.c
  * 
  */
 
@@ -21,49 +22,12 @@
 #include <string.h>
 #include <time.h>
 
-#define MAXN 400            /* the maximum number of vertices */
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "shared/planar_output.h"
+#include "../shared/code_reader.h"
 
-#define INFI (MAXN + 1)
-
-#define FALSE 0
-#define TRUE  1
-
-typedef int boolean;
-
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
-
-int nv;
-int ne;
+PLANE_GRAPH *pg = NULL;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -71,13 +35,13 @@ int ne;
 
 void writeEdgeDeletedPlanarCodeChar(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     //write the number of vertices
-    fputc(nv, stdout);
+    fputc(pg->nv, stdout);
     
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
+    for(i=0; i<pg->nv; i++){
+        e = elast = pg->firstedge[i];
         do {
             if(!ISMARKED(e)){
                 fputc(e->end + 1, stdout);
@@ -97,15 +61,15 @@ void writeShort(unsigned short value){
 
 void writeEdgeDeletedPlanarCodeShort(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     //write the number of vertices
     fputc(0, stdout);
-    writeShort(nv);
+    writeShort(pg->nv);
     
     
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
+    for(i=0; i<pg->nv; i++){
+        e = elast = pg->firstedge[i];
         do {
             if(!ISMARKED(e)){
                 writeShort(e->end + 1);
@@ -125,9 +89,9 @@ void writeEdgeDeletedPlanarCode(){
         fprintf(stdout, ">>planar_code<<");
     }
     
-    if (nv + 1 <= 255) {
+    if (pg->nv + 1 <= 255) {
         writeEdgeDeletedPlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
+    } else if (pg->nv + 1 <= 65535) {
         writeEdgeDeletedPlanarCodeShort();
     } else {
         fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
@@ -136,210 +100,12 @@ void writeEdgeDeletedPlanarCode(){
     
 }
 
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-    
-    if(from < 0 || from >= nv){
-        return NULL;
-    }
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    
-    return NULL;
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-}
-
-/**
- * 
- * @param code
- * @param length
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
     fprintf(stderr, "The program %s removes edges from a planar graph.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options] u1,v1 u2,v2 ...\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
-    fprintf(stderr, "graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
@@ -378,12 +144,13 @@ int main(int argc, char *argv[]) {
 
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    if (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    if (nextCode(reader, &view)) {
+        pg = decodePlanarCodeView(&view, pg, &options);
         
-        RESETMARKS;
+        RESETMARKS(pg);
         
         int from, to;
         int edgesRemoved = 0;
@@ -395,7 +162,7 @@ int main(int argc, char *argv[]) {
                 usage(name);
                 return EXIT_FAILURE;
             }
-            EDGE *e = findEdge(from-1, to-1);
+            PG_EDGE *e = findEdgeIfPresent(pg, from-1, to-1);
             if(e!=NULL){
                 MARK(e);
                 MARK(e->inverse);
@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o dual_pl -O4 dual_pl.c
+ *     cc -o dual_pl -O4 dual_pl.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c ../shared/code_reader.c
  * 
  */
 
@@ -20,53 +21,12 @@
 #include <getopt.h>
 #include <string.h>
 
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "shared/planar_output.h"
+#include "../shared/code_reader.h"
 
-#ifndef MAXN
-#define MAXN 64            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
-
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
-
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
+PLANE_GRAPH *pg = NULL;
 
 int filterEnabled = FALSE;
 int filterOnly = 0;
@@ -77,29 +37,24 @@ int writeOriginal = FALSE;
 int numberOfGraphs = 0;
 int reportsWritten = 0;
 
-int nv;
-int ne;
-int nf;
-
-
 //////////////////////////////////////////////////////////////////////////////
 
 //=============== Writing edgecode of dual graph ===========================
 
 void writeDualEdgeCodeSmall(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     //write the length of the body
-    fputc(ne + nf - 1, stdout);
+    fputc(pg->ne + pg->nf - 1, stdout);
     
-    for(i=0; i<nf; i++){
-        e = elast = facestart[i];
+    for(i=0; i<pg->nf; i++){
+        e = elast = pg->facestart[i];
         do {
             fputc(e->index, stdout);
             e = e->inverse->prev;
         } while (e != elast);
-        if(i < nf - 1){
+        if(i < pg->nf - 1){
             fputc(255, stdout);
         }
     }
@@ -107,7 +62,7 @@ void writeDualEdgeCodeSmall(){
 
 void writeDualEdgeCodeLarge(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
     exit(-1);
@@ -116,7 +71,7 @@ void writeDualEdgeCodeLarge(){
 void writeDualEdgeCode(){
     static int first = TRUE;
     int i, counter=0;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     if(first && !writeOriginal){
         first = FALSE;
@@ -125,15 +80,15 @@ void writeDualEdgeCode(){
     }
     
     //label the edges
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
+    for(i=0; i<pg->nv; i++){
+        e = elast = pg->firstedge[i];
         do {
             e->index = -1;
             e = e->next;
         } while (e != elast);
     }
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
+    for(i=0; i<pg->nv; i++){
+        e = elast = pg->firstedge[i];
         do {
             if(e->index == -1){
                 e->index = counter;
@@ -144,7 +99,7 @@ void writeDualEdgeCode(){
         } while (e != elast);
     }
     
-    if (ne + nf - 1 <= 255) {
+    if (pg->ne + pg->nf - 1 <= 255) {
         writeDualEdgeCodeSmall();
     } else {
         writeDualEdgeCodeLarge();
@@ -156,13 +111,13 @@ void writeDualEdgeCode(){
 
 void writeDualPlanarCodeChar(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
     //write the number of vertices of the dual
-    fputc(nf, stdout);
+    fputc(pg->nf, stdout);
     
-    for(i=0; i<nf; i++){
-        e = elast = facestart[i];
+    for(i=0; i<pg->nf; i++){
+        e = elast = pg->facestart[i];
         do {
             fputc(e->inverse->rightface + 1, stdout);
             e = e->inverse->prev;
@@ -173,19 +128,19 @@ void writeDualPlanarCodeChar(){
 
 void writeDualPlanarCodeShort(){
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     unsigned short temp;
     
     //write the number of vertices of the dual
     fputc(0, stdout);
-    temp = nf;
+    temp = pg->nf;
     if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
         fprintf(stderr, "fwrite() failed -- exiting!\n");
         exit(-1);
     }
     
-    for(i=0; i<nf; i++){
-        e = elast = facestart[i];
+    for(i=0; i<pg->nf; i++){
+        e = elast = pg->facestart[i];
         do {
             temp = e->inverse->rightface + 1;
             if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
@@ -211,9 +166,9 @@ void writeDualPlanarCode(){
         fprintf(stdout, ">>planar_code<<");
     }
     
-    if (nf + 1 <= 255) {
+    if (pg->nf + 1 <= 255) {
         writeDualPlanarCodeChar();
-    } else if (nf + 1 <= 65535) {
+    } else if (pg->nf + 1 <= 65535) {
         writeDualPlanarCodeShort();
     } else {
         fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
@@ -222,382 +177,12 @@ void writeDualPlanarCode(){
     
 }
 
-//=============== Writing edgecode of graph ===========================
-
-void writeEdgeCodeSmall(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the length of the body
-    fputc(ne + nv - 1, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->index, stdout);
-            e = e->next;
-        } while (e != elast);
-        if(i < nv - 1){
-            fputc(255, stdout);
-        }
-    }
-}
-
-void writeEdgeCodeLarge(){
-    int i;
-    EDGE *e, *elast;
-    
-    fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-    exit(-1);
-}
-
-void writeEdgeCode(){
-    static int first = TRUE;
-    int i, counter=0;
-    EDGE *e, *elast;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>edge_code<<");
-    }
-    
-    //label the edges
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            e->index = -1;
-            e = e->next;
-        } while (e != elast);
-    }
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            if(e->index == -1){
-                e->index = counter;
-                e->inverse->index = counter;
-                counter++;
-            }
-            e = e->next;
-        } while (e != elast);
-    }
-    
-    if (ne + nv - 1 <= 255) {
-        writeEdgeCodeSmall();
-    } else {
-        writeEdgeCodeLarge();
-    }
-    
-}
-
-//=============== Writing planarcode of original graph ===========================
-
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
-    }
-}
-
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    unsigned short temp;
-    
-    //write the number of vertices
-    fputc(0, stdout);
-    temp = nv;
-    if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
-    }
-    
-    for(i=0; i<nf; i++){
-        e = elast = firstedge[i];
-        do {
-            temp = e->end + 1;
-            if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-                fprintf(stderr, "fwrite() failed -- exiting!\n");
-                exit(-1);
-            }
-            e = e->next;
-        } while (e != elast);
-        temp = 0;
-        if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-            fprintf(stderr, "fwrite() failed -- exiting!\n");
-            exit(-1);
-        }
-    }
-}
-
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
-    }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
-    
-}
-
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS;
-
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
-
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
-}
-
-/**
- * 
- * @param code
- * @param length
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
     fprintf(stderr, "The program %s generates the duals of planar graphs.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
-    fprintf(stderr, "graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -E, --edgecode\n");
     fprintf(stderr, "       Write edge code instead of planar code.\n");
@@ -650,15 +235,17 @@ int main(int argc, char *argv[]) {
 
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        pg = decodePlanarCodeView(&view, pg, &options);
         if(writeOriginal){
             if(edgecode){
-                writeEdgeCode();
+                writeEdgeCode(pg, stdout);
             } else {
-                writePlanarCode();
+                writePlanarCode(pg, stdout);
             }
         }
         if(edgecode){
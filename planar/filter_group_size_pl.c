@@ -11,210 +11,159 @@
  * 
  * Compile with:
  *     
- *     cc -o filter_group_size -O4 filter_group_size.c
+ *     cc -o filter_group_size -O4 filter_group_size.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c \
+ *         shared/planar_halfedge.c ../shared/code_reader.c
  * 
+ * The certificates are computed on the half-edge layout. Compile with
+ * -DPLANAR_POINTER_LAYOUT to use the PG_EDGE structs instead.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <limits.h>
 
-
-#ifndef MAXN
-#define MAXN 1000            /* the maximum number of vertices */
+#ifndef PLANAR_POINTER_LAYOUT
+#define PLANAR_HALFEDGE_LAYOUT
 #endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
-
-typedef int boolean;
-
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
 
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-} EDGE;
+#include "shared/planar_layout.h"
+#include "shared/planar_starting_edges.h"
+#include "../shared/code_reader.h"
 
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
+PL_GRAPH *pg = NULL;
 
 int numberOfGraphs = 0;
 int filteredGraphs = 0;
 
-int nv;
-int ne;
-int nf;
-
 int automorphismsCount;
 int orientationPreservingAutomorphismsCount;
 int orientationReversingAutomorphismsCount;
 
+//the search for automorphisms stops as soon as more automorphisms are found,
+//because at any time there are at most as many automorphisms as the group has
+int automorphismsLimit = INT_MAX;
+
 //////////////////////////////////////////////////////////////////////////////
 
-int certificate[MAXE+MAXN];
-int canonicalLabelling[MAXN];
-int reverseCanonicalLabelling[MAXN];
-EDGE *canonicalFirstedge[MAXN];
-int alternateLabelling[MAXN];
-EDGE *alternateFirstedge[MAXN];
-int queue[MAXN];
+int *certificate = NULL;
+int *canonicalLabelling = NULL;
+int *reverseCanonicalLabelling = NULL;
+PL_EDGE *canonicalFirstedge = NULL;
+int *alternateLabelling = NULL;
+PL_EDGE *alternateFirstedge = NULL;
+int *queue = NULL;
 boolean hasChiralGroup;
 
-EDGE *orientationPreservingStartingEdges[MAXE];
-EDGE *orientationReversingStartingEdges[MAXE];
-int startingEdgesCount; //the number of starting edges is always the same for both orientations
+PL_EDGE *orientationPreservingStartingEdges = NULL;
+PL_EDGE *orientationReversingStartingEdges = NULL;
+int orientationPreservingStartingEdgesCount;
+int orientationReversingStartingEdgesCount;
 
-void findStartingEdges(){
-    int i, startingDegree, startingFaceSize, minimumFrequency;
-    int degreeFrequency[MAXN] = {0};
-    int faceSizeFrequency[MAXN] = {0};
-    EDGE *start, *edge;
-    
-    startingEdgesCount = 0;
-    
-    //build the degree frequency table
-    for(i = 0; i < nv; i++){
-        degreeFrequency[degree[i]]++;
-    }
-    
-    //find the smallest degree with the lowest frequency
-    minimumFrequency = MAXN;
-    for(i = 0; i < MAXN; i++){
-        if(degreeFrequency[i] && degreeFrequency[i] < minimumFrequency){
-            startingDegree = i;
-            minimumFrequency = degreeFrequency[i];
-        }
-    }
-    
-    //build the frequency table of face sizes incident to a vertex with startingDegree
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                faceSizeFrequency[faceSize[edge->rightface]]++;
-                edge = edge->next;
-            } while (start != edge);
-        }
-    }
-    
-    //find the smallest face size incident with a vertex of startingDegree and with smallest frequency
-    minimumFrequency = MAXE;
-    for(i = 0; i < MAXN; i++){
-        if(faceSizeFrequency[i] && faceSizeFrequency[i] < minimumFrequency){
-            startingFaceSize = i;
-            minimumFrequency = faceSizeFrequency[i];
-        }
-    }
-    
-    //store all starting edges
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                if(faceSize[edge->rightface] == startingFaceSize){
-                    orientationPreservingStartingEdges[startingEdgesCount] = edge;
-                    orientationReversingStartingEdges[startingEdgesCount] = edge->next;
-                    startingEdgesCount++;
-                }
-                edge = edge->next;
-            } while (start != edge);
-        }
+int *frequencies = NULL;
+
+int verticesCapacity = 0; //the number of vertices for which there is room
+int edgesCapacity = 0; //the number of oriented edges for which there is room
+
+void *resizeBuffer(void *buffer, size_t size){
+    buffer = realloc(buffer, size);
+    if(buffer == NULL && size > 0){
+        fprintf(stderr, "Insufficient memory for the automorphism buffers -- exiting!\n");
+        exit(EXIT_FAILURE);
     }
+    return buffer;
+}
+
+/* Makes sure that the buffers for the certificates can hold the current graph.
+ * The buffers only grow, so they are reused for all graphs that are read.
+ */
+void growCertificateBuffers(){
+    if(PL_ORDER(pg) <= verticesCapacity && PL_EDGE_COUNT(pg) <= edgesCapacity){
+        return;
+    }
+    if(PL_ORDER(pg) > verticesCapacity){
+        verticesCapacity = PL_ORDER(pg);
+    }
+    if(PL_EDGE_COUNT(pg) > edgesCapacity){
+        edgesCapacity = PL_EDGE_COUNT(pg);
+    }
+    certificate = resizeBuffer(certificate, (edgesCapacity + verticesCapacity)*sizeof(int));
+    canonicalLabelling = resizeBuffer(canonicalLabelling, verticesCapacity*sizeof(int));
+    reverseCanonicalLabelling = resizeBuffer(reverseCanonicalLabelling, verticesCapacity*sizeof(int));
+    canonicalFirstedge = resizeBuffer(canonicalFirstedge, verticesCapacity*sizeof(PL_EDGE));
+    alternateLabelling = resizeBuffer(alternateLabelling, verticesCapacity*sizeof(int));
+    alternateFirstedge = resizeBuffer(alternateFirstedge, verticesCapacity*sizeof(PL_EDGE));
+    queue = resizeBuffer(queue, verticesCapacity*sizeof(int));
+    orientationPreservingStartingEdges = resizeBuffer(orientationPreservingStartingEdges,
+            edgesCapacity*sizeof(PL_EDGE));
+    orientationReversingStartingEdges = resizeBuffer(orientationReversingStartingEdges,
+            edgesCapacity*sizeof(PL_EDGE));
+    //degrees and face sizes are at most the number of oriented edges
+    frequencies = resizeBuffer(frequencies, (edgesCapacity + 1)*sizeof(int));
 }
 
-void constructCertificate(EDGE *eStart){
+void constructCertificate(PL_EDGE eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<PL_ORDER(pg); i++){
+        canonicalLabelling[i] = PL_ORDER(pg);
     }
-    EDGE *e, *elast;
+    PL_EDGE e, elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
     int position = 0;
-    queue[0] = eStart->start;
-    canonicalFirstedge[eStart->start] = eStart;
-    canonicalLabelling[eStart->start] = 0;
+    queue[0] = PL_START(pg, eStart);
+    canonicalFirstedge[PL_START(pg, eStart)] = eStart;
+    canonicalLabelling[PL_START(pg, eStart)] = 0;
     while(head>tail){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
-                queue[head++] = e->end;
-                canonicalLabelling[e->end] = vertexCounter++;
-                canonicalFirstedge[e->end] = e->inverse;
+            if(canonicalLabelling[PL_END(pg, e)]==PL_ORDER(pg)){
+                queue[head++] = PL_END(pg, e);
+                canonicalLabelling[PL_END(pg, e)] = vertexCounter++;
+                canonicalFirstedge[PL_END(pg, e)] = PL_INVERSE(pg, e);
             }
-            certificate[position++] = canonicalLabelling[e->end];
-            e = e->next;
+            certificate[position++] = canonicalLabelling[PL_END(pg, e)];
+            e = PL_NEXT(pg, e);
         } while (e!=elast);
-        certificate[position++] = MAXN;
+        certificate[position++] = PL_ORDER(pg);
     }
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < PL_ORDER(pg); i++){
         reverseCanonicalLabelling[canonicalLabelling[i]] = i;
     }
 }
 
-void constructCertificateOrientationReversed(EDGE *eStart){
+void constructCertificateOrientationReversed(PL_EDGE eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<PL_ORDER(pg); i++){
+        canonicalLabelling[i] = PL_ORDER(pg);
     }
-    EDGE *e, *elast;
+    PL_EDGE e, elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
     int position = 0;
-    queue[0] = eStart->start;
-    canonicalFirstedge[eStart->start] = eStart;
-    canonicalLabelling[eStart->start] = 0;
+    queue[0] = PL_START(pg, eStart);
+    canonicalFirstedge[PL_START(pg, eStart)] = eStart;
+    canonicalLabelling[PL_START(pg, eStart)] = 0;
     while(head>tail){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
-                queue[head++] = e->end;
-                canonicalLabelling[e->end] = vertexCounter++;
-                canonicalFirstedge[e->end] = e->inverse;
+            if(canonicalLabelling[PL_END(pg, e)]==PL_ORDER(pg)){
+                queue[head++] = PL_END(pg, e);
+                canonicalLabelling[PL_END(pg, e)] = vertexCounter++;
+                canonicalFirstedge[PL_END(pg, e)] = PL_INVERSE(pg, e);
             }
-            certificate[position++] = canonicalLabelling[e->end];
-            e = e->prev;
+            certificate[position++] = canonicalLabelling[PL_END(pg, e)];
+            e = PL_PREV(pg, e);
         } while (e!=elast);
-        certificate[position++] = MAXN;
+        certificate[position++] = PL_ORDER(pg);
     }
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < PL_ORDER(pg); i++){
        reverseCanonicalLabelling[canonicalLabelling[i]] = i;
     }
 }
@@ -223,41 +172,41 @@ void constructCertificateOrientationReversed(EDGE *eStart){
  * returns 0 if this edge leads to the same certificate
  * returns -1 if this edge leads to a worse certificate
  */
-int hasBetterCertificateOrientationPreserving(EDGE *eStart){
+int hasBetterCertificateOrientationPreserving(PL_EDGE eStart){
     int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+    for(i=0; i<PL_ORDER(pg); i++){
+        alternateLabelling[i] = PL_ORDER(pg);
     }
-    EDGE *e, *elast;
+    PL_EDGE e, elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
     int currentPos = 0;
-    queue[0] = eStart->start;
-    alternateFirstedge[eStart->start] = eStart;
-    alternateLabelling[eStart->start] = 0;
+    queue[0] = PL_START(pg, eStart);
+    alternateFirstedge[PL_START(pg, eStart)] = eStart;
+    alternateLabelling[PL_START(pg, eStart)] = 0;
     while(head>tail){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
-                queue[head++] = e->end;
-                alternateLabelling[e->end] = vertexCounter++;
-                alternateFirstedge[e->end] = e->inverse;
+            if(alternateLabelling[PL_END(pg, e)]==PL_ORDER(pg)){
+                queue[head++] = PL_END(pg, e);
+                alternateLabelling[PL_END(pg, e)] = vertexCounter++;
+                alternateFirstedge[PL_END(pg, e)] = PL_INVERSE(pg, e);
             }
-            if(alternateLabelling[e->end] < certificate[currentPos]){
+            if(alternateLabelling[PL_END(pg, e)] < certificate[currentPos]){
                 constructCertificate(eStart);
                 automorphismsCount = 1;
                 orientationPreservingAutomorphismsCount = 1;
                 return 1;
-            } else if(alternateLabelling[e->end] > certificate[currentPos]){
+            } else if(alternateLabelling[PL_END(pg, e)] > certificate[currentPos]){
                 return -1;
             }
             currentPos++;
-            e = e->next;
+            e = PL_NEXT(pg, e);
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(PL_ORDER(pg) > certificate[currentPos]){
             return -1;
         }
         currentPos++;
@@ -267,43 +216,43 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
     return 0;
 }
 
-int hasBetterCertificateOrientationReversing(EDGE *eStart){
+int hasBetterCertificateOrientationReversing(PL_EDGE eStart){
     int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+    for(i=0; i<PL_ORDER(pg); i++){
+        alternateLabelling[i] = PL_ORDER(pg);
     }
-    EDGE *e, *elast;
+    PL_EDGE e, elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
     int currentPos = 0;
-    queue[0] = eStart->start;
-    alternateFirstedge[eStart->start] = eStart;
-    alternateLabelling[eStart->start] = 0;
+    queue[0] = PL_START(pg, eStart);
+    alternateFirstedge[PL_START(pg, eStart)] = eStart;
+    alternateLabelling[PL_START(pg, eStart)] = 0;
     while(head>tail){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
-                queue[head++] = e->end;
-                alternateLabelling[e->end] = vertexCounter++;
-                alternateFirstedge[e->end] = e->inverse;
+            if(alternateLabelling[PL_END(pg, e)]==PL_ORDER(pg)){
+                queue[head++] = PL_END(pg, e);
+                alternateLabelling[PL_END(pg, e)] = vertexCounter++;
+                alternateFirstedge[PL_END(pg, e)] = PL_INVERSE(pg, e);
             }
-            if(alternateLabelling[e->end] < certificate[currentPos]){
+            if(alternateLabelling[PL_END(pg, e)] < certificate[currentPos]){
                 constructCertificateOrientationReversed(eStart);
                 hasChiralGroup = TRUE;
                 automorphismsCount = 1;
                 orientationPreservingAutomorphismsCount = 1;
                 orientationReversingAutomorphismsCount = 0;
                 return 1;
-            } else if(alternateLabelling[e->end] > certificate[currentPos]){
+            } else if(alternateLabelling[PL_END(pg, e)] > certificate[currentPos]){
                 return -1;
             }
             currentPos++;
-            e = e->prev;
+            e = PL_PREV(pg, e);
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(PL_ORDER(pg) > certificate[currentPos]){
             return -1;
         }
         currentPos++;
@@ -320,6 +269,8 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
 void calculateAutomorphismGroup(){
     int i;
     
+    growCertificateBuffers();
+    
     hasChiralGroup = FALSE;
     
     //identity    
@@ -328,19 +279,23 @@ void calculateAutomorphismGroup(){
     orientationReversingAutomorphismsCount = 0;
     
     //find starting edges
-    findStartingEdges();
+    findPlanarStartingEdges(pg, frequencies,
+            orientationPreservingStartingEdges, &orientationPreservingStartingEdgesCount,
+            orientationReversingStartingEdges, &orientationReversingStartingEdgesCount);
     
     //construct initial certificate
     constructCertificate(orientationPreservingStartingEdges[0]);
     
     //look for better automorphism
-    for(i = 1; i < startingEdgesCount; i++){
+    for(i = 1; i < orientationPreservingStartingEdgesCount &&
+            automorphismsCount <= automorphismsLimit; i++){
         int result = hasBetterCertificateOrientationPreserving(
                                 orientationPreservingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
         //if result == 0, then the automorphism is already stored
     }
-    for(i = 0; i < startingEdgesCount; i++){
+    for(i = 0; i < orientationReversingStartingEdgesCount &&
+            automorphismsCount <= automorphismsLimit; i++){
         int result = hasBetterCertificateOrientationReversing(
                                 orientationReversingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
@@ -348,300 +303,6 @@ void calculateAutomorphismGroup(){
     }
 }
 
-//=============== Writing planarcode of graph ===========================
-
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
-    }
-}
-
-void writeShort(unsigned short value){
-    if (fwrite(&value, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
-    }
-}
-
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(0, stdout);
-    writeShort(nv);
-    
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            writeShort(e->end + 1);
-            e = e->next;
-        } while (e != elast);
-        writeShort(0);
-    }
-}
-
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
-    }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
-    
-}
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS;
-
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
-
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
-}
-
-/**
- * 
- * @param code
- * @param laenge
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -649,9 +310,10 @@ void help(char *name) {
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options] s\n", name);
     fprintf(stderr, " %s [-n/-p/-r]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile if you need larger\n", MAXN);
-    fprintf(stderr, "graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -l, --larger\n");
+    fprintf(stderr, "       Filter out the graphs that have more than s automorphisms. The\n");
+    fprintf(stderr, "       computation of the group stops as soon as it is larger than s.\n");
     fprintf(stderr, "    -n, --non-trivial\n");
     fprintf(stderr, "       Filter out the graphs that have a non-trivial automorphism group.\n");
     fprintf(stderr, "    -p, --orientation-preserving\n");
@@ -676,6 +338,7 @@ int main(int argc, char *argv[]) {
     boolean orientationPreserving = FALSE;
     boolean orientationReversing = FALSE;
     boolean numbers = FALSE;
+    boolean larger = FALSE;
 
     /*=========== commandline parsing ===========*/
 
@@ -686,11 +349,12 @@ int main(int argc, char *argv[]) {
         {"orientation-preserving", no_argument, NULL, 'p'},
         {"orientation-reversing", no_argument, NULL, 'r'},
         {"numbers", no_argument, NULL, 'N'},
+        {"larger", no_argument, NULL, 'l'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "nprhN", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "nprhNl", long_options, &option_index)) != -1) {
         switch (c) {
             case 0:
                 break;
@@ -706,6 +370,9 @@ int main(int argc, char *argv[]) {
             case 'N':
                 numbers = TRUE;
                 break;
+            case 'l':
+                larger = TRUE;
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -737,18 +404,30 @@ int main(int argc, char *argv[]) {
         size = atoi(argv[optind]);
     }
     
+    //for these filters it suffices to know whether the group is larger than a
+    //given size
+    if(nonTrivial){
+        automorphismsLimit = 1;
+    } else if(!(orientationPreserving || orientationReversing)){
+        automorphismsLimit = size;
+    }
+    
     
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        pg = PL_DECODE(&view, pg, &options);
         numberOfGraphs++;
         calculateAutomorphismGroup();
         
         boolean filterGraph = FALSE;
-        if(automorphismsCount == size){
+        if(larger){
+            filterGraph = automorphismsCount > size;
+        } else if(automorphismsCount == size){
             filterGraph = TRUE;
         } else if(nonTrivial && automorphismsCount > 1) {
             filterGraph = TRUE;
@@ -764,7 +443,7 @@ int main(int argc, char *argv[]) {
             if(numbers){
                 fprintf(stdout, "%d\n", numberOfGraphs);
             } else {
-                writePlanarCode();
+                PL_WRITE_PLANAR_CODE(pg, stdout);
             }
             filteredGraphs++;
         }
@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o group_pl -O4 group_pl.c
+ *     cc -o group_pl -O4 group_pl.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c ../shared/code_reader.c
  * 
  */
 
@@ -21,6 +22,12 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "shared/planar_output.h"
+#include "shared/planar_starting_edges.h"
+#include "../shared/code_reader.h"
+
 #define UNKNOWN 0
 #define Cn__    1
 #define Cnh__   2
@@ -37,60 +44,21 @@
 #define I__    13
 #define Ih__   14
 
+PLANE_GRAPH *pg = NULL;
 
-#ifndef MAXN
-#define MAXN 1000            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
-
-typedef int boolean;
-
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
-
-typedef struct e /* The data type used for edges */ {
-    int start;       /* vertex where the edge starts */
-    int end;         /* vertex where the edge ends */
-    int rightface;   /* face on the right side of the edge
-                        note: only valid if make_dual() called */
-    struct e *prev;  /* previous edge in clockwise direction */
-    struct e *next;  /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
-
-int nv;
-int ne;
-int nf;
-
-int automorphisms[2*MAXE][MAXN]; //there are at most 2e automorphisms (e = #arcs)
+/* Each automorphism is stored as the starting edge that it maps to the first
+ * edge of the canonical certificate. This edge and the orientation determine
+ * the automorphism, and the images of the vertices are only computed when
+ * they are needed.
+ */
+PG_EDGE **automorphismEdges = NULL;
+int automorphismEdgesCapacity = 0; //the number of automorphisms for which there is room
+PG_EDGE *canonicalStartingEdge;
+
+//the images of the vertices under each automorphism (see expandAutomorphisms())
+int **automorphisms = NULL;
+int *automorphismsData = NULL;
+int automorphismsCapacity = 0; //the number of automorphisms for which there is room
 int automorphismsCount;
 int orientationPreservingAutomorphismsCount;
 int orientationReversingAutomorphismsCount;
@@ -377,85 +345,149 @@ void printGroupList(FILE *f, GROUPLIST *list, int minimumGroupNameLength,
 
 //////////////////////////////////////////////////////////////////////////////
 
-int certificate[MAXE+MAXN];
-int canonicalLabelling[MAXN];
-int reverseCanonicalLabelling[MAXN];
-EDGE *canonicalFirstedge[MAXN];
-int alternateLabelling[MAXN];
-EDGE *alternateFirstedge[MAXN];
-int queue[MAXN];
+int *certificate = NULL;
+int *canonicalLabelling = NULL;
+PG_EDGE **canonicalFirstedge = NULL;
+int *alternateLabelling = NULL;
+PG_EDGE **alternateFirstedge = NULL;
+int *queue = NULL;
 boolean hasChiralGroup;
 
-EDGE *orientationPreservingStartingEdges[MAXE];
-EDGE *orientationReversingStartingEdges[MAXE];
-int startingEdgesCount; //the number of starting edges is always the same for both orientations
+PG_EDGE **orientationPreservingStartingEdges = NULL;
+PG_EDGE **orientationReversingStartingEdges = NULL;
+int orientationPreservingStartingEdgesCount;
+int orientationReversingStartingEdgesCount;
 
-void findStartingEdges(){
-    int i, startingDegree, startingFaceSize, minimumFrequency;
-    int degreeFrequency[MAXN] = {0};
-    int faceSizeFrequency[MAXN] = {0};
-    EDGE *start, *edge;
-    
-    startingEdgesCount = 0;
-    
-    //build the degree frequency table
-    for(i = 0; i < nv; i++){
-        degreeFrequency[degree[i]]++;
+int *frequencies = NULL;
+
+int verticesCapacity = 0; //the number of vertices for which there is room
+int edgesCapacity = 0; //the number of oriented edges for which there is room
+
+void *resizeBuffer(void *buffer, size_t size){
+    buffer = realloc(buffer, size);
+    if(buffer == NULL && size > 0){
+        fprintf(stderr, "Insufficient memory for the automorphism buffers -- exiting!\n");
+        exit(EXIT_FAILURE);
     }
-    
-    //find the smallest degree with the lowest frequency
-    minimumFrequency = MAXN;
-    for(i = 0; i < MAXN; i++){
-        if(degreeFrequency[i] && degreeFrequency[i] < minimumFrequency){
-            startingDegree = i;
-            minimumFrequency = degreeFrequency[i];
-        }
+    return buffer;
+}
+
+void layoutAutomorphisms(){
+    int i;
+    automorphisms = resizeBuffer(automorphisms, automorphismsCapacity*sizeof(int *));
+    automorphismsData = resizeBuffer(automorphismsData,
+            (size_t)automorphismsCapacity*verticesCapacity*sizeof(int));
+    for(i = 0; i < automorphismsCapacity; i++){
+        automorphisms[i] = automorphismsData + (size_t)i*verticesCapacity;
     }
-    
-    //build the frequency table of face sizes incident to a vertex with startingDegree
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                faceSizeFrequency[faceSize[edge->rightface]]++;
-                edge = edge->next;
-            } while (start != edge);
-        }
+}
+
+/* Makes sure that there is room to store the automorphism with index
+ * automorphismsCount. There are at most 2e automorphisms (e = #arcs), but
+ * most graphs have far less, so the room is doubled when needed.
+ */
+void growAutomorphisms(){
+    if(automorphismsCount < automorphismEdgesCapacity){
+        return;
     }
+    automorphismEdgesCapacity = automorphismEdgesCapacity ? 2*automorphismEdgesCapacity : 16;
+    automorphismEdges = resizeBuffer(automorphismEdges, automorphismEdgesCapacity*sizeof(PG_EDGE *));
+}
+
+/* Stores the image of each vertex under the automorphism with index i in
+ * images, and the image of each edge in edgeImages if it is not NULL. Both
+ * starting edges are followed in parallel: the rotations are followed in the
+ * same direction if the automorphism preserves the orientation, and in
+ * opposite directions otherwise.
+ */
+void expandAutomorphism(int i, int *images, PG_EDGE **edgeImages){
+    int j;
+    PG_EDGE *e, *elast, *image;
+    boolean reversing = (i >= orientationPreservingAutomorphismsCount);
+    int head = 1;
+    int tail = 0;
     
-    //find the smallest face size incident with a vertex of startingDegree and with smallest frequency
-    minimumFrequency = MAXE;
-    for(i = 0; i < MAXN; i++){
-        if(faceSizeFrequency[i] && faceSizeFrequency[i] < minimumFrequency){
-            startingFaceSize = i;
-            minimumFrequency = faceSizeFrequency[i];
-        }
+    for(j = 0; j < pg->nv; j++){
+        images[j] = pg->nv;
+    }
+    e = automorphismEdges[i];
+    queue[0] = e->start;
+    //the first edges of a vertex and of its image
+    alternateFirstedge[e->start] = e;
+    canonicalFirstedge[e->start] = canonicalStartingEdge;
+    images[e->start] = canonicalStartingEdge->start;
+    while(head>tail){
+        int currentVertex = queue[tail++];
+        e = elast = alternateFirstedge[currentVertex];
+        image = canonicalFirstedge[currentVertex];
+        do {
+            if(images[e->end]==pg->nv){
+                queue[head++] = e->end;
+                images[e->end] = image->end;
+                alternateFirstedge[e->end] = e->inverse;
+                canonicalFirstedge[e->end] = image->inverse;
+            }
+            if(edgeImages != NULL){
+                edgeImages[e->index] = image;
+            }
+            e = e->next;
+            image = reversing ? image->prev : image->next;
+        } while (e!=elast);
     }
+}
+
+/* Stores the images of the vertices under all automorphisms in the rows of
+ * automorphisms.
+ */
+void expandAutomorphisms(){
+    int i;
     
-    //store all starting edges
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                if(faceSize[edge->rightface] == startingFaceSize){
-                    orientationPreservingStartingEdges[startingEdgesCount] = edge;
-                    orientationReversingStartingEdges[startingEdgesCount] = edge->next;
-                    startingEdgesCount++;
-                }
-                edge = edge->next;
-            } while (start != edge);
-        }
+    if(automorphismsCount > automorphismsCapacity){
+        automorphismsCapacity = 2*automorphismsCapacity > automorphismsCount ?
+            2*automorphismsCapacity : automorphismsCount;
+        layoutAutomorphisms();
+    }
+    for(i = 0; i < automorphismsCount; i++){
+        expandAutomorphism(i, automorphisms[i], NULL);
+    }
+}
+
+/* Makes sure that the buffers for the certificates can hold the current graph.
+ * The buffers only grow, so they are reused for all graphs that are read.
+ */
+void growCertificateBuffers(){
+    if(pg->nv <= verticesCapacity && pg->ne <= edgesCapacity){
+        return;
+    }
+    if(pg->nv > verticesCapacity){
+        verticesCapacity = pg->nv;
+    }
+    if(pg->ne > edgesCapacity){
+        edgesCapacity = pg->ne;
+    }
+    certificate = resizeBuffer(certificate, (edgesCapacity + verticesCapacity)*sizeof(int));
+    canonicalLabelling = resizeBuffer(canonicalLabelling, verticesCapacity*sizeof(int));
+    canonicalFirstedge = resizeBuffer(canonicalFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    alternateLabelling = resizeBuffer(alternateLabelling, verticesCapacity*sizeof(int));
+    alternateFirstedge = resizeBuffer(alternateFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    queue = resizeBuffer(queue, verticesCapacity*sizeof(int));
+    orientationPreservingStartingEdges = resizeBuffer(orientationPreservingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    orientationReversingStartingEdges = resizeBuffer(orientationReversingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    //degrees and face sizes are at most the number of oriented edges
+    frequencies = resizeBuffer(frequencies, (edgesCapacity + 1)*sizeof(int));
+    if(automorphismsCapacity){
+        layoutAutomorphisms();
     }
 }
 
-void constructCertificate(EDGE *eStart){
+void constructCertificate(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -467,7 +499,7 @@ void constructCertificate(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -475,19 +507,17 @@ void constructCertificate(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->next;
         } while (e!=elast);
-        certificate[position++] = MAXN;
-    }
-    for(i = 0; i < nv; i++){
-        reverseCanonicalLabelling[canonicalLabelling[i]] = i;
+        certificate[position++] = pg->nv;
     }
+    canonicalStartingEdge = eStart;
 }
 
-void constructCertificateOrientationReversed(EDGE *eStart){
+void constructCertificateOrientationReversed(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -499,7 +529,7 @@ void constructCertificateOrientationReversed(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -507,23 +537,21 @@ void constructCertificateOrientationReversed(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->prev;
         } while (e!=elast);
-        certificate[position++] = MAXN;
-    }
-    for(i = 0; i < nv; i++){
-       reverseCanonicalLabelling[canonicalLabelling[i]] = i;
+        certificate[position++] = pg->nv;
     }
+    canonicalStartingEdge = eStart;
 }
 
 /* returns 1 if this edge leads to a better certificate
  * returns 0 if this edge leads to the same certificate
  * returns -1 if this edge leads to a worse certificate
  */
-int hasBetterCertificateOrientationPreserving(EDGE *eStart){
-    int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+int hasBetterCertificateOrientationPreserving(PG_EDGE *eStart){
+    int i;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -535,7 +563,7 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -551,27 +579,25 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
             currentPos++;
             e = e->next;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    for(j = 0; j < nv; j++){
-        automorphisms[automorphismsCount][j] 
-                = reverseCanonicalLabelling[alternateLabelling[j]];
-    }
+    growAutomorphisms();
+    automorphismEdges[automorphismsCount] = eStart;
     automorphismsCount++;
     orientationPreservingAutomorphismsCount++;
     return 0;
 }
 
-int hasBetterCertificateOrientationReversing(EDGE *eStart){
-    int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+int hasBetterCertificateOrientationReversing(PG_EDGE *eStart){
+    int i;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -583,7 +609,7 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -601,16 +627,14 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
             currentPos++;
             e = e->prev;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    for(j = 0; j < nv; j++){
-        automorphisms[automorphismsCount][j] 
-                = reverseCanonicalLabelling[alternateLabelling[j]];
-    }
+    growAutomorphisms();
+    automorphismEdges[automorphismsCount] = eStart;
     if(hasChiralGroup){
         orientationPreservingAutomorphismsCount++;
     } else {
@@ -623,36 +647,42 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
 void determineAutomorphisms(){
     int i;
     
+    growCertificateBuffers();
+    
     hasChiralGroup = FALSE;
     
     //identity
-    for(i = 0; i < nv; i++){
-        automorphisms[0][i] = i;
-    }
+    automorphismsCount = 0;
+    growAutomorphisms();
     
     automorphismsCount = 1;
     orientationPreservingAutomorphismsCount = 1;
     orientationReversingAutomorphismsCount = 0;
     
     //find starting edges
-    findStartingEdges();
+    findPlanarStartingEdges(pg, frequencies,
+            orientationPreservingStartingEdges, &orientationPreservingStartingEdgesCount,
+            orientationReversingStartingEdges, &orientationReversingStartingEdgesCount);
     
     //construct initial certificate
     constructCertificate(orientationPreservingStartingEdges[0]);
     
     //look for better automorphism
-    for(i = 1; i < startingEdgesCount; i++){
+    for(i = 1; i < orientationPreservingStartingEdgesCount; i++){
         int result = hasBetterCertificateOrientationPreserving(
                                 orientationPreservingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
         //if result == 0, then the automorphism is already stored
     }
-    for(i = 0; i < startingEdgesCount; i++){
+    for(i = 0; i < orientationReversingStartingEdgesCount; i++){
         int result = hasBetterCertificateOrientationReversing(
                                 orientationReversingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
         //if result == 0, then the automorphism is already stored
     }
+    
+    //the identity maps the first edge of the certificate to itself
+    automorphismEdges[0] = canonicalStartingEdge;
 }
 
 boolean hasOrientationPreservingSymmetryWithGivenAction(int v, int w, int vImage, int wImage){
@@ -668,11 +698,11 @@ boolean hasOrientationPreservingSymmetryWithGivenAction(int v, int w, int vImage
 }
 
 int identifyRotationalSymmetryThroughVertex(int v){
-    EDGE *edge;
+    PG_EDGE *edge;
     int deg, neighbour, i;
     
-    deg = degree[v];
-    edge = firstedge[v];
+    deg = pg->degree[v];
+    edge = pg->firstedge[v];
     i = 0;
     neighbour = edge->end;
     
@@ -688,11 +718,11 @@ int identifyRotationalSymmetryThroughVertex(int v){
 }
 
 int identifyRotationalSymmetryThroughFace(int f){
-    EDGE *edge;
+    PG_EDGE *edge;
     int deg, i, v, w;
     
-    deg = faceSize[f];
-    edge = facestart[f];
+    deg = pg->faceSize[f];
+    edge = pg->facestart[f];
     i = 0;
     v = edge->start;
     w = edge->end;
@@ -708,7 +738,7 @@ int identifyRotationalSymmetryThroughFace(int f){
     return 1;
 }
 
-boolean hasRotationalSymmetryThroughEdge(EDGE *e){
+boolean hasRotationalSymmetryThroughEdge(PG_EDGE *e){
     return hasOrientationPreservingSymmetryWithGivenAction(e->start, e->end, e->end, e->start);
 }
 
@@ -732,13 +762,13 @@ boolean hasOrientationReversingSymmetryStabilisingGivenVertex(int v){
  */
 boolean hasOrientationReversingSymmetryStabilisingGivenFace(int f){
     int i, from, to;
-    EDGE *e;
+    PG_EDGE *e;
     
     for(i = orientationPreservingAutomorphismsCount; i < automorphismsCount; i++){
-        e = facestart[f];
+        e = pg->facestart[f];
         from = automorphisms[i][e->start];
         to = automorphisms[i][e->end];
-        e = firstedge[from];
+        e = pg->firstedge[from];
         while(e->end != to) {
             e = e->next;
         }
@@ -755,7 +785,7 @@ boolean hasOrientationReversingSymmetryStabilisingGivenFace(int f){
  */
 boolean hasOrientationReversingSymmetryStabilisingGivenEdge(int e){
     int i, from, to;
-    EDGE *edge = edges+e;
+    PG_EDGE *edge = pg->edges+e;
     
     for(i = orientationPreservingAutomorphismsCount; i < automorphismsCount; i++){
         from = automorphisms[i][edge->start];
@@ -774,7 +804,7 @@ boolean hasOrientationReversingSymmetryWithFixPoint(){
     
     //first check if any vertices are fixed
     for(i = orientationPreservingAutomorphismsCount; i < automorphismsCount; i++){
-        for(j = 0; j < nv; j++){
+        for(j = 0; j < pg->nv; j++){
             if(automorphisms[i][j] == j){
                 return TRUE;
             }
@@ -785,10 +815,10 @@ boolean hasOrientationReversingSymmetryWithFixPoint(){
     //we don't need to check that a directed edge is fixed
     //because in that case also the vertices are fixed
     for(i = orientationPreservingAutomorphismsCount; i < automorphismsCount; i++){
-        for(j = 0; j < ne; j++){
-            if(j < edges[j].inverse->index){
-                int start = edges[j].start;
-                int end = edges[j].end;
+        for(j = 0; j < pg->ne; j++){
+            if(j < pg->edges[j].inverse->index){
+                int start = pg->edges[j].start;
+                int end = pg->edges[j].end;
                 if(automorphisms[i][start] == end &&
                         automorphisms[i][end] == start){
                     return TRUE;
@@ -807,7 +837,7 @@ boolean isSymmetryWithFixPoint(int i){
     int j;
         
     //first check if any vertices are fixed
-    for(j = 0; j < nv; j++){
+    for(j = 0; j < pg->nv; j++){
         if(automorphisms[i][j] == j){
             return TRUE;
         }
@@ -816,10 +846,10 @@ boolean isSymmetryWithFixPoint(int i){
     //next we check if any edge is fixed as a set
     //we don't need to check that a directed edge is fixed
     //because in that case also the vertices are fixed
-    for(j = 0; j < ne; j++){
-        if(j < edges[j].inverse->index){
-            int start = edges[j].start;
-            int end = edges[j].end;
+    for(j = 0; j < pg->ne; j++){
+        if(j < pg->edges[j].inverse->index){
+            int start = pg->edges[j].start;
+            int end = pg->edges[j].end;
             if(automorphisms[i][start] == end &&
                     automorphisms[i][end] == start){
                 return TRUE;
@@ -959,7 +989,12 @@ void determineAutomorphismGroup(int *groupId, int *groupParameter){
         *groupId = Cn__;
         *groupParameter = automorphismsCount;
         return;
-    } else if(orientationReversingAutomorphismsCount == 1 && automorphismsCount == 2){
+    }
+    
+    //the other groups are identified by looking at the images of the vertices
+    expandAutomorphisms();
+    
+    if(orientationReversingAutomorphismsCount == 1 && automorphismsCount == 2){
         if(hasOrientationReversingSymmetryWithFixPoint()){
             *groupId = Cnh__;
             *groupParameter = 1;
@@ -980,7 +1015,7 @@ void determineAutomorphismGroup(int *groupId, int *groupParameter){
     }
     
     //first we look for rotational axis through a vertex
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < pg->nv; i++){
         int rotDegree = identifyRotationalSymmetryThroughVertex(i);
         
         //if the order of the rotation is larger than 5, then we known that it 
@@ -1022,7 +1057,7 @@ void determineAutomorphismGroup(int *groupId, int *groupParameter){
         }
     }
     
-    for(i = 0; i < nf; i++){
+    for(i = 0; i < pg->nf; i++){
         int rotDegree = identifyRotationalSymmetryThroughFace(i);
         
         //if the order of the rotation is larger than 5, then we known that it 
@@ -1065,9 +1100,9 @@ void determineAutomorphismGroup(int *groupId, int *groupParameter){
     
     if(foldCount[3]<=2){
         //first we also check all edges, so that we also have all 2-fold rotations
-        for(i = 0; i < ne; i++){
-            if(i < edges[i].inverse->index 
-                    && hasRotationalSymmetryThroughEdge(edges+i)){
+        for(i = 0; i < pg->ne; i++){
+            if(i < pg->edges[i].inverse->index 
+                    && hasRotationalSymmetryThroughEdge(pg->edges+i)){
                 foldCount[2]++;
                 
                 //store the maxRotationCenter
@@ -1090,302 +1125,6 @@ void determineAutomorphismGroup(int *groupId, int *groupParameter){
 
 //////////////////////////////////////////////////////////////////////////////
 
-//=============== Writing planarcode of graph ===========================
-
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
-    }
-}
-
-void writeShort(unsigned short value){
-    if (fwrite(&value, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
-    }
-}
-
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(0, stdout);
-    writeShort(nv);
-    
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            writeShort(e->end + 1);
-            e = e->next;
-        } while (e != elast);
-        writeShort(0);
-    }
-}
-
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
-    }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
-    
-}
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS;
-
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
-
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edges[edgeCounter].index = edgeCounter;
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edges[edgeCounter].index = edgeCounter;
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
-}
-
-/**
- * 
- * @param code
- * @param laenge
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first && !oldStyleInput) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //================== PARSE GROUP NAME ================
 
 int parseGroupParameter(char* input, int* groupParameter, boolean *anyParameterAllowed){
@@ -1537,8 +1276,6 @@ void help(char *name) {
     fprintf(stderr, "The program %s determines the symmetry type of plane graphs.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
-    fprintf(stderr, "value for MAXN if you need larger graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
@@ -1669,10 +1406,15 @@ int main(int argc, char *argv[]) {
 
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    if(oldStyleInput){
+        skipCodeHeader(reader);
+    }
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        pg = decodePlanarCodeView(&view, pg, &options);
         numberOfGraphs++;
         int groupId = UNKNOWN;
         int groupParameter = 0;
@@ -1680,12 +1422,12 @@ int main(int argc, char *argv[]) {
         if(filterEnabled){
             if(inverted){
                 if(!groupIncludedInList(filterList, groupId, groupParameter)){
-                    writePlanarCode();
+                    writePlanarCode(pg, stdout);
                     graphsWritten++;
                 }
             } else {
                 if(groupIncludedInList(filterList, groupId, groupParameter)){
-                    writePlanarCode();
+                    writePlanarCode(pg, stdout);
                     graphsWritten++;
                 }
             }
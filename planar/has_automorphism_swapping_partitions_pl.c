@@ -12,7 +12,8 @@
  * 
  * Compile with:
  *     
- *     cc -o has_automorphism_swapping_partitions_pl -O4 has_automorphism_swapping_partitions_pl.c
+ *     cc -o has_automorphism_swapping_partitions_pl -O4 has_automorphism_swapping_partitions_pl.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c ../shared/code_reader.c
  * 
  */
 
@@ -21,62 +22,19 @@
 #include <getopt.h>
 #include <string.h>
 
-#ifndef MAXN
-#define MAXN 200            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
-
-typedef int boolean;
-
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
-
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "shared/planar_output.h"
+#include "../shared/code_reader.h"
+
+PLANE_GRAPH *pg = NULL;
 
 int graphsRead = 0;
 int graphsWritten = 0;
 
-int nv;
-int ne;
-int nf;
-
-int automorphisms[2*MAXE][MAXN]; //there are at most 2e automorphisms (e = #arcs)
+int **automorphisms = NULL;
+int *automorphismsData = NULL;
+int automorphismsCapacity = 0; //the number of automorphisms for which there is room
 int automorphismsCount;
 int orientationPreservingAutomorphismsCount;
 int orientationReversingAutomorphismsCount;
@@ -85,73 +43,145 @@ int orientationReversingAutomorphismsCount;
 #define BLACK 0
 #define GRAY -1
 
-int colours[MAXN];
+int *colours = NULL;
+int coloursSize = 0;
 
 //////////////////////////////////////////////////////////////////////////////
 
-int certificate[MAXE+MAXN];
-int canonicalLabelling[MAXN];
-int reverseCanonicalLabelling[MAXN];
-EDGE *canonicalFirstedge[MAXN];
-int alternateLabelling[MAXN];
-EDGE *alternateFirstedge[MAXN];
-int queue[MAXN];
+int *certificate = NULL;
+int *canonicalLabelling = NULL;
+int *reverseCanonicalLabelling = NULL;
+PG_EDGE **canonicalFirstedge = NULL;
+int *alternateLabelling = NULL;
+PG_EDGE **alternateFirstedge = NULL;
+int *queue = NULL;
 boolean hasChiralGroup;
 
-EDGE *orientationPreservingStartingEdges[MAXE];
-EDGE *orientationReversingStartingEdges[MAXE];
+PG_EDGE **orientationPreservingStartingEdges = NULL;
+PG_EDGE **orientationReversingStartingEdges = NULL;
 int startingEdgesCount; //the number of starting edges is always the same for both orientations
 
+int *frequencies = NULL;
+
+int verticesCapacity = 0; //the number of vertices for which there is room
+int edgesCapacity = 0; //the number of oriented edges for which there is room
+
+void *resizeBuffer(void *buffer, size_t size){
+    buffer = realloc(buffer, size);
+    if(buffer == NULL && size > 0){
+        fprintf(stderr, "Insufficient memory for the automorphism buffers -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return buffer;
+}
+
+void layoutAutomorphisms(){
+    int i;
+    automorphisms = resizeBuffer(automorphisms, automorphismsCapacity*sizeof(int *));
+    automorphismsData = resizeBuffer(automorphismsData,
+            (size_t)automorphismsCapacity*verticesCapacity*sizeof(int));
+    for(i = 0; i < automorphismsCapacity; i++){
+        automorphisms[i] = automorphismsData + (size_t)i*verticesCapacity;
+    }
+}
+
+/* Makes sure that there is room to store the automorphism with index
+ * automorphismsCount. There are at most 2e automorphisms (e = #arcs), but
+ * most graphs have far less, so the room is doubled when needed.
+ */
+void growAutomorphisms(){
+    if(automorphismsCount < automorphismsCapacity){
+        return;
+    }
+    automorphismsCapacity = automorphismsCapacity ? 2*automorphismsCapacity : 16;
+    layoutAutomorphisms();
+}
+
+/* Makes sure that the buffers for the certificates can hold the current graph.
+ * The buffers only grow, so they are reused for all graphs that are read.
+ */
+void growCertificateBuffers(){
+    if(pg->nv <= verticesCapacity && pg->ne <= edgesCapacity){
+        return;
+    }
+    if(pg->nv > verticesCapacity){
+        verticesCapacity = pg->nv;
+    }
+    if(pg->ne > edgesCapacity){
+        edgesCapacity = pg->ne;
+    }
+    certificate = resizeBuffer(certificate, (edgesCapacity + verticesCapacity)*sizeof(int));
+    canonicalLabelling = resizeBuffer(canonicalLabelling, verticesCapacity*sizeof(int));
+    reverseCanonicalLabelling = resizeBuffer(reverseCanonicalLabelling, verticesCapacity*sizeof(int));
+    canonicalFirstedge = resizeBuffer(canonicalFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    alternateLabelling = resizeBuffer(alternateLabelling, verticesCapacity*sizeof(int));
+    alternateFirstedge = resizeBuffer(alternateFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    queue = resizeBuffer(queue, verticesCapacity*sizeof(int));
+    orientationPreservingStartingEdges = resizeBuffer(orientationPreservingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    orientationReversingStartingEdges = resizeBuffer(orientationReversingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    //degrees and face sizes are at most the number of oriented edges
+    frequencies = resizeBuffer(frequencies, (edgesCapacity + 1)*sizeof(int));
+    if(automorphismsCapacity){
+        layoutAutomorphisms();
+    }
+}
+
 void findStartingEdges(){
     int i, startingDegree, startingFaceSize, minimumFrequency;
-    int degreeFrequency[MAXN] = {0};
-    int faceSizeFrequency[MAXN] = {0};
-    EDGE *start, *edge;
+    PG_EDGE *start, *edge;
     
     startingEdgesCount = 0;
     
     //build the degree frequency table
-    for(i = 0; i < nv; i++){
-        degreeFrequency[degree[i]]++;
+    for(i = 0; i <= pg->ne; i++){
+        frequencies[i] = 0;
+    }
+    for(i = 0; i < pg->nv; i++){
+        frequencies[pg->degree[i]]++;
     }
     
     //find the smallest degree with the lowest frequency
-    minimumFrequency = MAXN;
-    for(i = 0; i < MAXN; i++){
-        if(degreeFrequency[i] && degreeFrequency[i] < minimumFrequency){
+    minimumFrequency = pg->nv + 1;
+    for(i = 0; i <= pg->ne; i++){
+        if(frequencies[i] && frequencies[i] < minimumFrequency){
             startingDegree = i;
-            minimumFrequency = degreeFrequency[i];
+            minimumFrequency = frequencies[i];
         }
     }
     
     //build the frequency table of face sizes incident to a vertex with startingDegree
-    for(i = 0; i < MAXN; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
+    for(i = 0; i <= pg->ne; i++){
+        frequencies[i] = 0;
+    }
+    for(i = 0; i < pg->nv; i++){
+        if(pg->degree[i] == startingDegree){
+            start = edge = pg->firstedge[i];
             
             do {
-                faceSizeFrequency[faceSize[edge->rightface]]++;
+                frequencies[pg->faceSize[edge->rightface]]++;
                 edge = edge->next;
             } while (start != edge);
         }
     }
     
     //find the smallest face size incident with a vertex of startingDegree and with smallest frequency
-    minimumFrequency = MAXE;
-    for(i = 0; i < MAXN; i++){
-        if(faceSizeFrequency[i] && faceSizeFrequency[i] < minimumFrequency){
+    minimumFrequency = pg->ne + 1;
+    for(i = 0; i <= pg->ne; i++){
+        if(frequencies[i] && frequencies[i] < minimumFrequency){
             startingFaceSize = i;
-            minimumFrequency = faceSizeFrequency[i];
+            minimumFrequency = frequencies[i];
         }
     }
     
     //store all starting edges
-    for(i = 0; i < MAXN; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
+    for(i = 0; i < pg->nv; i++){
+        if(pg->degree[i] == startingDegree){
+            start = edge = pg->firstedge[i];
             
             do {
-                if(faceSize[edge->rightface] == startingFaceSize){
+                if(pg->faceSize[edge->rightface] == startingFaceSize){
                     orientationPreservingStartingEdges[startingEdgesCount] = edge;
                     orientationReversingStartingEdges[startingEdgesCount] = edge->next;
                     startingEdgesCount++;
@@ -162,12 +192,12 @@ void findStartingEdges(){
     }
 }
 
-void constructCertificate(EDGE *eStart){
+void constructCertificate(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -179,7 +209,7 @@ void constructCertificate(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -187,19 +217,19 @@ void constructCertificate(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->next;
         } while (e!=elast);
-        certificate[position++] = MAXN;
+        certificate[position++] = pg->nv;
     }
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < pg->nv; i++){
         reverseCanonicalLabelling[canonicalLabelling[i]] = i;
     }
 }
 
-void constructCertificateOrientationReversed(EDGE *eStart){
+void constructCertificateOrientationReversed(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -211,7 +241,7 @@ void constructCertificateOrientationReversed(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -219,9 +249,9 @@ void constructCertificateOrientationReversed(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->prev;
         } while (e!=elast);
-        certificate[position++] = MAXN;
+        certificate[position++] = pg->nv;
     }
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < pg->nv; i++){
        reverseCanonicalLabelling[canonicalLabelling[i]] = i;
     }
 }
@@ -230,12 +260,12 @@ void constructCertificateOrientationReversed(EDGE *eStart){
  * returns 0 if this edge leads to the same certificate
  * returns -1 if this edge leads to a worse certificate
  */
-int hasBetterCertificateOrientationPreserving(EDGE *eStart){
+int hasBetterCertificateOrientationPreserving(PG_EDGE *eStart){
     int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -247,7 +277,7 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -263,13 +293,14 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
             currentPos++;
             e = e->next;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    for(j = 0; j < nv; j++){
+    growAutomorphisms();
+    for(j = 0; j < pg->nv; j++){
         automorphisms[automorphismsCount][j] 
                 = reverseCanonicalLabelling[alternateLabelling[j]];
     }
@@ -278,12 +309,12 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
     return 0;
 }
 
-int hasBetterCertificateOrientationReversing(EDGE *eStart){
+int hasBetterCertificateOrientationReversing(PG_EDGE *eStart){
     int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -295,7 +326,7 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -313,13 +344,14 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
             currentPos++;
             e = e->prev;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    for(j = 0; j < nv; j++){
+    growAutomorphisms();
+    for(j = 0; j < pg->nv; j++){
         automorphisms[automorphismsCount][j] 
                 = reverseCanonicalLabelling[alternateLabelling[j]];
     }
@@ -335,6 +367,8 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
 void calculateAutomorphismGroup(){
     int i;
     
+    growCertificateBuffers();
+    
     hasChiralGroup = FALSE;
     
     //identity    
@@ -409,14 +443,19 @@ boolean hasAutomorphismSwappingPartitions() {
 boolean isBipartite(){
     
     int i;
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     
-    for(i = 0; i < MAXN; i++) {
+    if(pg->nv > coloursSize){
+        coloursSize = pg->nv;
+        colours = resizeBuffer(colours, coloursSize*sizeof(int));
+    }
+    
+    for(i = 0; i < pg->nv; i++) {
         colours[i] = GRAY;
     }
     
     int queueHead, queueTail;
-    int queue[MAXN];
+    int queue[pg->nv];
 
     queueHead = 0;
     queueTail = 1;
@@ -425,7 +464,7 @@ boolean isBipartite(){
 
     while(queueTail > queueHead){
         int currentVertex = queue[queueHead++];
-        e = elast = firstedge[currentVertex];
+        e = elast = pg->firstedge[currentVertex];
         do {
             int neighbour = e->end;
             if(colours[neighbour]==GRAY){
@@ -443,300 +482,6 @@ boolean isBipartite(){
     return TRUE;
 }
 
-//=============== Writing planarcode of graph ===========================
-
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
-    }
-}
-
-void writeShort(unsigned short value){
-    if (fwrite(&value, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
-    }
-}
-
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(0, stdout);
-    writeShort(nv);
-    
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            writeShort(e->end + 1);
-            e = e->next;
-        } while (e != elast);
-        writeShort(0);
-    }
-}
-
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
-    }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
-    
-}
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS;
-
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
-
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
-}
-
-/**
- * 
- * @param code
- * @param laenge
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -744,8 +489,6 @@ void help(char *name) {
     fprintf(stderr, "graphs have an automorphism that switches the partitions.\n\n");
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a greater\n", MAXN);
-    fprintf(stderr, "value for MAXN if you need larger graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
@@ -823,10 +566,12 @@ int main(int argc, char *argv[]) {
 
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        pg = decodePlanarCodeView(&view, pg, &options);
         graphsRead++;
         
         //check whether graph is bipartite and compute the partitions
@@ -838,12 +583,12 @@ int main(int argc, char *argv[]) {
         if(filterGraphs){
             if(invertFilter){
                 if(!hasAutomorphismSwappingPartitions()){
-                    writePlanarCode();
+                    writePlanarCode(pg, stdout);
                     graphsWritten++;
                 }
             } else {
                 if(hasAutomorphismSwappingPartitions()){
-                    writePlanarCode();
+                    writePlanarCode(pg, stdout);
                     graphsWritten++;
                 }
             }
@@ -0,0 +1,110 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program builds an index for a file with graphs in planarcode format.
+ * The index contains the position, order and number of edges of each graph
+ * and allows other programs (e.g., select_pl) to jump directly to a graph.
+ * 
+ * Compile with:
+ *     
+ *     cc -o index_pl -O4  index_pl.c \
+ *     ../shared/code_reader.c ../shared/code_index.c
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "../shared/code_index.h"
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s builds an index for a file with graphs in planarcode format.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] file\n\n", name);
+    fprintf(stderr, "By default the index is written to file%s.\n\n", CODE_INDEX_EXTENSION);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -o, --output file\n");
+    fprintf(stderr, "       Write the index to the specified file.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] file\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ * 
+ */
+int main(int argc, char** argv) {
+    
+    char *indexFileName = NULL;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"output", required_argument, NULL, 'o'},
+        {"help", no_argument, NULL, 'h'}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "ho:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'o':
+                indexFileName = optarg;
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+        
+    if (argc - optind != 1) {
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    
+    char *dataFileName = argv[optind];
+    FILE *data = fopen(dataFileName, "r");
+    if(data == NULL){
+        fprintf(stderr, "Could not open %s to read graphs -- exiting!\n", dataFileName);
+        return EXIT_FAILURE;
+    }
+    
+    char *defaultName = NULL;
+    if(indexFileName == NULL){
+        indexFileName = defaultName = codeIndexFileName(dataFileName);
+    }
+    FILE *indexFile = fopen(indexFileName, "w");
+    if(indexFile == NULL){
+        fprintf(stderr, "Could not open %s to write index -- exiting!\n", indexFileName);
+        return EXIT_FAILURE;
+    }
+    
+    unsigned long long graphCount = writePlanarCodeIndex(data, indexFile);
+    
+    fclose(indexFile);
+    fclose(data);
+    free(defaultName);
+    
+    fprintf(stderr, "Indexed %llu graph%s.\n", graphCount, graphCount==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
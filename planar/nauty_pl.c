@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o nauty_pl -O4 nauty_pl.c nauty/nauty.c nauty/nautil.c nauty/naugraph.c nauty/schreier.c nauty/naurng.c
+ *     cc -o nauty_pl -O4 nauty_pl.c nauty/nauty.c nauty/nautil.c nauty/naugraph.c nauty/schreier.c nauty/naurng.c \
+ *         ../shared/code_reader.c
  * 
  * A recent version of nauty is assumed to be present in a directory called nauty.
  */
@@ -26,102 +27,40 @@
 #endif
 
 #include "nauty/nauty.h"
+#include "../shared/code_reader.h"
 
 int nv;
 
 int numberOfGraphs = 0;
 
-boolean readPlanarCode(FILE *f){
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int zeroCounter;
+void handleGraph(CODE_VIEW *view){
     graph g[MAXN*MAXM];
-        
-    int i;
+    int i, vertex;
+    
+    if (view->order > MAXN) {
+        fprintf(stderr, "Constant N too small %d > %d \n", view->order, MAXN);
+        exit(1);
+    }
+    
     for(i=0; i<MAXN; i++){
         set *v;
         v = GRAPHROW(g, i, MAXM);
         EMPTYSET(v, MAXM);
     }
     
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, f) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") != 0) {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, f) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, f) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, f) == 0) {
-            return FALSE;
-        }
-    }
+    nv = view->order;
     
-
-    if (fread(&c, sizeof (unsigned char), 1, f) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        int order = c;
-        nv = order;
-        
-        zeroCounter = 0;
-        while (zeroCounter < order) {
-            int neighbour = (unsigned short) getc(f);
-            if (neighbour == 0) {
-                zeroCounter++;
-            } else {
-                fprintf(stderr, "%d - %d\n", zeroCounter, neighbour-1);
-                set *gv, *gn;
-                gv = GRAPHROW(g, zeroCounter, MAXM);
-                gn = GRAPHROW(g, neighbour-1, MAXM);
-                ADDELEMENT(gv, neighbour-1);
-                ADDELEMENT(gn, zeroCounter);
-            }
-        }
-    } else {
-        int order = 0;
-        int readCount = fread(&order, sizeof (unsigned short), 1, f);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        nv = order;
-        
-        int neighbour = 0;
-        zeroCounter = 0;
-        while (zeroCounter < order) {
-            readCount = fread(&neighbour, sizeof (unsigned short), 1, f);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (neighbour == 0) {
-                zeroCounter++;
-            } else {
-                set *gv, *gn;
-                gv = GRAPHROW(g, zeroCounter, MAXM);
-                gn = GRAPHROW(g, neighbour-1, MAXM);
-                ADDELEMENT(gv, neighbour-1);
-                ADDELEMENT(gn, zeroCounter);
-            }
+    vertex = 0;
+    for(i = 0; i < view->entryCount; i++){
+        int neighbour = CODE_ENTRY(view, i);
+        if (neighbour == 0) {
+            vertex++;
+        } else {
+            set *gv, *gn;
+            gv = GRAPHROW(g, vertex, MAXM);
+            gn = GRAPHROW(g, neighbour-1, MAXM);
+            ADDELEMENT(gv, neighbour-1);
+            ADDELEMENT(gn, vertex);
         }
     }
     
@@ -136,8 +75,6 @@ boolean readPlanarCode(FILE *f){
     fprintf(stderr, "Vertices: %d\n", nv);
     fprintf(stderr, "%lf %d\n", stats.grpsize1, stats.grpsize2);
     fprintf(stderr, "Generators: %d\n", stats.numgenerators);
-
-    return (1);
 }
 
 //====================== USAGE =======================
@@ -192,9 +129,13 @@ int main(int argc, char** argv) {
 
     /*=========== read planar graphs ===========*/
 
-    while (readPlanarCode(stdin)) {
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    while (nextCode(reader, &view)) {
+        handleGraph(&view);
         numberOfGraphs++;
     }
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", numberOfGraphs, numberOfGraphs==1 ? "" : "s");
 }
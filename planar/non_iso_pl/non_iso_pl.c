@@ -13,12 +13,16 @@
 #include<string.h>
 #include <time.h>
 #include <sys/times.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #ifdef MD5
 //#include <gcrypt.h>
 //#include "md5.h" /* compile with "-lmd" */
 //#include "md5c.c"
 #endif
-#include "hashfunction.c"
+#include "../../shared/external_dedup.h"
+#include "../../shared/hash_store.h"
+#include "../../shared/hash_set.h"
 
 #define N 200     /* Maximal moegliche Anzahl der Knoten KN_MAX-2*/
 #define MAXVAL 10 //MAXE  /* maximale valenz */
@@ -40,12 +44,13 @@
 #define nil      0
 #define reg      3
 
-#define NUMBERHASHES 1 // it uses 2*numberhashes uints as hash value
-#define HASHFIELDEXPONENT 24 //the initial hashfield has size 1<<HASHFIELDEXPONENT
 
+/* Everything that describes the graph which is currently treated is thread
+  local, so that with option "threads" every worker has its own map. */
+#define THREADLOCAL __thread
 
 #define SUBDIVISION (1<<17)
-int nvbeforesubdiv=INT_MAX, numbersubdivided=0;
+THREADLOCAL int nvbeforesubdiv=INT_MAX, numbersubdivided=0;
 #define ISSUBDIVVERTEX(i) ((i)>nvbeforesubdiv) 
 /* this depends on the order in which edges are subdivided! */
 
@@ -87,21 +92,22 @@ typedef struct sp { short *graph;
  struct sp *left, *right, *parent; } SPLAYNODE;
 
 
-typedef struct hashfield { uint32_t graphhash1[2*NUMBERHASHES];
-                          uint32_t graphhash2[2*NUMBERHASHES];
-                          struct hashfield *next;} HASHFIELD;
-
 SPLAYNODE *worklist=NULL;
 
-HASHFIELD *hashlist;
+HASH_SET *hashset; /* the 128 bit hashes of the canonical forms -- option hash */
 int write_new=0, write_old=0, output=0, writemap_old=0, writemap_new=0;
 int without_mirror=0, do_rooted=0, do_rooted_v=0, do_rooted_e=0;
 int do_rooted_f=0, do_rooted_fl=0, write_roots=0, only_roots=0;
 int rest=0, mod=0;
 int use_hash=0;
+EXTERNAL_DEDUP *external_dedup=NULL; /* for deduplication on disk -- option ext */
+char *ext_directory=NULL;
+int ext_partitions=64;
+size_t ext_memory=1024; /* in MB */
+int threads=0; /* number of worker threads -- option threads */
 int print_ascii=0, print_ascii_short=0, md5out=0;
 unsigned long long int numrootedf=0, numrootedv=0, numrootede=0, numrootedfl=0;
-int nv, ne; /* Knoten und Kantenzahl des Graphen -- noch aus historischen Gruenden aus
+THREADLOCAL int nv, ne; /* Knoten und Kantenzahl des Graphen -- noch aus historischen Gruenden aus
 	       plantri.c global */
 char codetype=0;
 
@@ -129,15 +135,15 @@ static int canon_form();
 void new_splaynode();
 void old_splaynode();
 
-PLANMAP map;
+THREADLOCAL PLANMAP map;
 
-EDGE *firstedge[MAXN+1];
-int degree[MAXN+1];
+THREADLOCAL EDGE *firstedge[MAXN+1];
+THREADLOCAL int degree[MAXN+1];
 
 //static EDGE *numbering[2*MAXE][MAXE]; 
  /* holds numberings produced by canon() or canon_edge() */
 
-static int markvalue = 300000;
+static THREADLOCAL int markvalue = 300000;
 #define RESETMARKS {int mki,mkj; if ((markvalue += 2) > 300000) \
       { markvalue = 2; \
 	 for (mki=1;mki<=N;++mki) for (mkj=0;mkj<MAXVAL;++mkj) \
@@ -151,8 +157,8 @@ static int markvalue = 300000;
 
 /* and the same for vertices */
 
-static int markvalue_v = 300000;
-static int marks__v[MAXN+1];
+static THREADLOCAL int markvalue_v = 300000;
+static THREADLOCAL int marks__v[MAXN+1];
 #define RESETMARKS_V {int mki; if ((markvalue_v += 2) > 300000) \
       { markvalue_v = 1; for (mki=0;mki<MAXN;++mki) marks__v[mki]=0;}}
 #define UNMARK_V(x) (marks__v[x] = 0)
@@ -163,8 +169,8 @@ static int marks__v[MAXN+1];
 #define ISMARKEDHI_V(x) (marks__v[x] == markvalue_v+1)
 #define MARKHI_V(x) (marks__v[x] = markvalue_v+1)
 
-int elmarkvalue=INT_MAX;
-int elmarks[MAXE+1];
+THREADLOCAL int elmarkvalue=INT_MAX;
+THREADLOCAL int elmarks[MAXE+1];
 #define RESETMARKS_EL {if (elmarkvalue==INT_MAX) \
                        {int i; for (i=0;i<=MAXE;i++) elmarks[i]=0; elmarkvalue=1; }\
                   else elmarkvalue++; }
@@ -174,7 +180,6 @@ int elmarks[MAXE+1];
 
 int comparenodes(short *, int , SPLAYNODE *);
 void outputnode(SPLAYNODE*);
-int hashit(HASHFIELD *, uint32_t *);
 
 #include "splay.c"
 
@@ -213,61 +218,6 @@ short *canformmalloc(int howmany, int free)
  return mymemory+memstart-howmany;
 }
 
-HASHFIELD *hashcalloc()
-{
- static int memstart=ALLOCSIZE;
- static HASHFIELD *mymemory=NULL;
-
- if (memstart>=ALLOCSIZE)
-   { mymemory=calloc(ALLOCSIZE,sizeof(HASHFIELD));
-   if (mymemory==NULL)
-     { fprintf(stderr,"Do not get more memory -- exiting!\n"); exit(1); }
-   memstart=0;
-   }
-
- memstart++;
-
- return mymemory+memstart-1;
-}
-
-int newhash(uint32_t *value)
-/* inserts the value into the hashlist if not yet present and returns 1
-  if the value is new and 0 otherwise. */
-{ 
-
- return hashit(hashlist+
-		(value[2*NUMBERHASHES-2]&((uint32_t)((1<<HASHFIELDEXPONENT)-1)))
-		,value);
-}
-
-
-int hashit(HASHFIELD *where, uint32_t *value)
-{
- int adres;
- static uint32_t empty[2*NUMBERHASHES]={0};
-
- if (memcmp(where->graphhash1,value,2*NUMBERHASHES*sizeof(uint32_t))==0)
-   return 0;
- if (memcmp(where->graphhash1,empty,2*NUMBERHASHES*sizeof(uint32_t))==0)
-   { memcpy(where->graphhash1,value,2*NUMBERHASHES*sizeof(uint32_t)); return 1; }
-
-
- if (memcmp(where->graphhash2,value,2*NUMBERHASHES*sizeof(uint32_t))==0)
-   return 0;
- if (memcmp(where->graphhash2,empty,2*NUMBERHASHES*sizeof(uint32_t))==0)
-   { memcpy(where->graphhash2,value,2*NUMBERHASHES*sizeof(uint32_t)); return 1; }
-
- if (where->next==NULL)
-   { where->next=hashcalloc();
-
-     memcpy(where->next->graphhash1,value,2*NUMBERHASHES*sizeof(uint32_t));
-     return 1;
-   }
-
- return hashit(where->next,value);
-}
-
-
 static void
 check_itp1(int code, int triang)
 
@@ -602,7 +552,6 @@ int neu( int laenge, int nummer, int colour[])
 */
 {
 short *can_form;
-uint32_t hashvalues[2*NUMBERHASHES];
 int m,n,test,test2, auts, auts_or_pres;
 unsigned char charbuffer[33],printbuffer[17];
 
@@ -648,20 +597,16 @@ canformmalloc(0,1);
 return 0;
 }/* end print ascii */
 
-if (use_hash)
-  { int i;
-  for (i=0;i<2*NUMBERHASHES;i++)
-    { if (i<laenge) hashvalues[i]=can_form[laenge-i-1];
-      else hashvalues[i]=(char)(can_form[i%laenge]); }
-
-  for (i=0;i<NUMBERHASHES;i++)
-    {
-      hashlittle2((char *)(can_form+(i*laenge/NUMBERHASHES)),
-		   (sizeof(short))*laenge/NUMBERHASHES,
-		   hashvalues+2*i, hashvalues+(2*i+1));
-    }
-  test=newhash(hashvalues);
+if (external_dedup)
+  { /* the answer is only known once all graphs are read */
+    addToExternalDedup(external_dedup, nummer, can_form, laenge*sizeof(short),
+		       output ? can_form : NULL, output ? laenge*sizeof(short) : 0);
+    canformmalloc(0,1);
+    return 0;
   }
+
+if (use_hash)
+  test=addToHashSet(hashset, computeHash128(can_form, laenge*sizeof(short)));
 else
   {
     if (!only_roots) /*in_liste(liste,can_form,laenge, nummer,&test);*/
@@ -703,7 +648,7 @@ return(test);
 
 /*********************OUTPUTNODE***********************************/
 
-void outputnode(SPLAYNODE *liste)
+void write_canform(short *graph, int length)
 
 {
 static char first=1;
@@ -711,12 +656,34 @@ int i;
 
 if (first) { first=0; fprintf(stdout,">>planar_code<<"); }
 
-if ((liste->graph)[0]>250)
+if (graph[0]>250)
  { putc(0,stdout);
-   fwrite(liste->graph,sizeof(unsigned short),liste->length,stdout);
+   fwrite(graph,sizeof(unsigned short),length,stdout);
  }
 else
- for (i=0;i<liste->length; i++) putc((liste->graph)[i],stdout);
+ for (i=0;i<length; i++) putc(graph[i],stdout);
+}
+
+void outputnode(SPLAYNODE *liste)
+
+{
+write_canform(liste->graph, liste->length);
+}
+
+/*********************REPORT_EXTERNAL*********************************/
+
+void report_external(unsigned long long nummer, unsigned long long copy,
+		     const void *payload, size_t payloadlength, void *non_iso)
+/* is called for every graph in the order they were read, once the
+  deduplication on disk is finished */
+{
+if (copy==0)
+ { (*(int *)non_iso)++;
+   if (write_new) fprintf(stderr,"Number %llu is new\n",nummer);
+   if (output) write_canform((short *)payload, payloadlength/sizeof(short));
+ }
+else
+ if (write_old) fprintf(stderr,"Number %llu and number %llu are isomorphic\n",nummer,copy);
 }
 
 
@@ -2017,6 +1984,250 @@ void  subdividedubbelandloop(int colour[])
 
 }
 
+/*******************PREPARE_GRAPH***************************/
+
+int prepare_graph(unsigned short code[], int lauf, int colour[], int *renumbered)
+/* decodes the code into the map and colours the vertices. Returns 1 if the
+  graph is selected by option mod and 0 otherwise. renumbered is set to 1 if
+  the planarcode had to be renumbered. */
+{
+unsigned short neuer_code[MAXCODELENGTH];
+int i;
+
+*renumbered=0;
+
+if (mod && (codetype=='e') && ((invariant_code(code, lauf)%mod)!=rest)) return 0;
+
+if (codetype=='p')
+  {
+    if (check_code(code,neuer_code)) decodiereplanar(code,map,degree);
+    else { decodiereplanar(neuer_code,map,degree); *renumbered=1; }
+    for (i=1;i<=nv;i++) colour[i]=degree[i];
+  }
+else // type=='e'
+  {
+    decode_edgecode(code, lauf);
+    for (i=1;i<=nv;i++) colour[i]=degree[i];
+    subdividedubbelandloop(colour);
+  }
+
+if (mod && (codetype!='e') && ((invariant()%mod)!=rest)) return 0;
+
+return 1;
+}
+
+/*******************THREADS********************************/
+
+/* With option threads the canonical forms are computed by worker threads,
+  each on its own (thread local) map. The graphs are read in batches, and
+  while the workers treat one batch, the next one is read. The canonical
+  forms are stored in a hash set that is split into shards with their own
+  lock. Since the graphs of a batch are inserted in any order, a shard
+  keeps the smallest number for each canonical form. Once a batch is
+  finished, the graphs are reported in the order they were read, so the
+  output is the same as without threads. */
+
+#define GRAPHS_PER_WORKER 64
+#define SHARDS 64 /* a power of 2 */
+#define MAXCANFORM (MAXN+(N+1)*MAXVAL+1)
+
+typedef struct { unsigned short code[MAXCODELENGTH];
+                 int laenge, nummer;
+                 int selected, renumbered;
+                 short can_form[MAXCANFORM];
+                 int can_laenge;
+                 unsigned long long *first; /* the number of the first graph with
+                                               this canonical form */
+               } BATCHGRAPH;
+
+typedef struct { BATCHGRAPH *graphs;
+                 int count;
+               } BATCH;
+
+typedef struct { pthread_mutex_t lock;
+                 HASH_STORE *store;
+               } SHARD;
+
+typedef struct { pthread_mutex_t lock;
+                 pthread_cond_t available, finished;
+                 BATCH *batch;
+                 unsigned long long generation; /* number of the current batch */
+                 int stop;
+                 atomic_int next; /* next graph of the batch that is not yet taken */
+                 int busy; /* number of workers still working on the batch */
+                 int workers;
+               } POOL;
+
+SHARD shards[SHARDS];
+
+void treat_batchgraph(BATCHGRAPH *graph)
+{
+int colour[MAXN];
+int auts, auts_or_pres, added;
+HASH_128 hash;
+SHARD *shard;
+
+graph->first=NULL;
+graph->selected=prepare_graph(graph->code, graph->laenge, colour, &(graph->renumbered));
+if (!graph->selected) return;
+if (external_dedup && graph->nummer<=externalDedupResumePoint(external_dedup)) return;
+
+canon_form(colour, NULL, &auts, &auts_or_pres, graph->can_form);
+graph->can_laenge=nv+ne+1;
+
+/* with ext the canonical forms are stored on disk by the main thread */
+if (external_dedup) return;
+
+hash=computeHash128(graph->can_form, graph->can_laenge*sizeof(short));
+shard=shards+(hash.high & (SHARDS-1));
+pthread_mutex_lock(&(shard->lock));
+graph->first=findOrAddToHashStore(shard->store, hash, graph->can_form,
+                                  graph->can_laenge*sizeof(short), graph->nummer, &added);
+if (*(graph->first) > graph->nummer) *(graph->first)=graph->nummer;
+pthread_mutex_unlock(&(shard->lock));
+}
+
+void *worker(void *arg)
+{
+POOL *pool=arg;
+unsigned long long seen=0;
+BATCH *batch;
+int i;
+
+while (1)
+  { pthread_mutex_lock(&(pool->lock));
+    while ((pool->generation==seen) && !pool->stop)
+      pthread_cond_wait(&(pool->available), &(pool->lock));
+    if (pool->stop) { pthread_mutex_unlock(&(pool->lock)); return NULL; }
+    seen=pool->generation;
+    batch=pool->batch;
+    pthread_mutex_unlock(&(pool->lock));
+
+    while ((i=atomic_fetch_add(&(pool->next),1)) < batch->count)
+      treat_batchgraph(batch->graphs+i);
+
+    pthread_mutex_lock(&(pool->lock));
+    pool->busy--;
+    if (pool->busy==0) pthread_cond_signal(&(pool->finished));
+    pthread_mutex_unlock(&(pool->lock));
+  }
+}
+
+void read_batch(BATCH *batch, int capacity, int *zaehlen)
+{
+BATCHGRAPH *graph;
+
+for (batch->count=0; batch->count<capacity; batch->count++)
+  { graph=batch->graphs+batch->count;
+    if (!lesecode(graph->code, &(graph->laenge), stdin, &codetype)) return;
+    (*zaehlen)++;
+    graph->nummer= *zaehlen;
+  }
+}
+
+void report_batchgraph(BATCHGRAPH *graph, int *non_iso)
+{
+unsigned long long copy;
+short *can_form;
+int test;
+
+if (external_dedup)
+  { if (graph->nummer>externalDedupResumePoint(external_dedup))
+      addToExternalDedup(external_dedup, graph->nummer, graph->can_form,
+                         graph->can_laenge*sizeof(short),
+                         output ? graph->can_form : NULL,
+                         output ? graph->can_laenge*sizeof(short) : 0);
+    return;
+  }
+
+copy= *(graph->first);
+if (copy==graph->nummer)
+  { (*non_iso)++;
+    if (output)
+      { /* the splay tree gives the output the same order as without threads --
+           new_splaynode also writes the number in case of option n */
+        can_form=canformmalloc(graph->can_laenge,0);
+        memcpy(can_form, graph->can_form, graph->can_laenge*sizeof(short));
+        splay_insert(&worklist, can_form, graph->can_laenge, graph->nummer, &test);
+      }
+    else if (write_new) fprintf(stderr,"Number %d is new\n",graph->nummer);
+  }
+else
+  if (write_old) fprintf(stderr,"Number %d and number %d are isomorphic\n",graph->nummer,(int)copy);
+}
+
+void run_threads(int *zaehlen, int *zaehlen2, int *non_iso, int *globaltest)
+{
+POOL pool;
+BATCH batches[2], *current=batches, *next=batches+1, *swap;
+pthread_t *workers;
+int i, capacity=GRAPHS_PER_WORKER*threads;
+
+for (i=0; i<SHARDS; i++)
+  { pthread_mutex_init(&(shards[i].lock), NULL);
+    shards[i].store=newHashStore(); }
+
+for (i=0; i<2; i++)
+  { batches[i].graphs=malloc(capacity*sizeof(BATCHGRAPH));
+    if (batches[i].graphs==NULL)
+      { fprintf(stderr,"Do not get memory for the batches -- exiting!\n"); exit(1); }
+  }
+
+pool.batch=NULL; pool.generation=0; pool.stop=0; pool.busy=0; pool.workers=threads;
+atomic_init(&(pool.next),0);
+pthread_mutex_init(&(pool.lock), NULL);
+pthread_cond_init(&(pool.available), NULL);
+pthread_cond_init(&(pool.finished), NULL);
+
+workers=malloc(threads*sizeof(pthread_t));
+if (workers==NULL) { fprintf(stderr,"Do not get memory for the threads -- exiting!\n"); exit(1); }
+for (i=0; i<threads; i++)
+  if (pthread_create(workers+i, NULL, worker, &pool))
+    { fprintf(stderr,"Could not start thread -- exiting!\n"); exit(1); }
+
+read_batch(current, capacity, zaehlen);
+while (current->count)
+  { pthread_mutex_lock(&(pool.lock));
+    pool.batch=current;
+    atomic_store(&(pool.next),0);
+    pool.busy=pool.workers;
+    pool.generation++;
+    pthread_cond_broadcast(&(pool.available));
+    pthread_mutex_unlock(&(pool.lock));
+
+    /* read the next batch while the workers are busy */
+    read_batch(next, capacity, zaehlen);
+
+    pthread_mutex_lock(&(pool.lock));
+    while (pool.busy) pthread_cond_wait(&(pool.finished), &(pool.lock));
+    pthread_mutex_unlock(&(pool.lock));
+
+    for (i=0; i<current->count; i++)
+      { *globaltest += current->graphs[i].renumbered;
+        if (current->graphs[i].selected)
+          { (*zaehlen2)++;
+            report_batchgraph(current->graphs+i, non_iso); }
+      }
+
+    swap=current; current=next; next=swap;
+  }
+
+pthread_mutex_lock(&(pool.lock));
+pool.stop=1;
+pthread_cond_broadcast(&(pool.available));
+pthread_mutex_unlock(&(pool.lock));
+for (i=0; i<threads; i++) pthread_join(workers[i], NULL);
+
+free(workers);
+free(batches[0].graphs); free(batches[1].graphs);
+for (i=0; i<SHARDS; i++)
+  { pthread_mutex_destroy(&(shards[i].lock));
+    freeHashStore(shards[i].store); }
+pthread_mutex_destroy(&(pool.lock));
+pthread_cond_destroy(&(pool.available));
+pthread_cond_destroy(&(pool.finished));
+}
+
 /*******************MAIN********************************/
 
 int main(argc,argv)
@@ -2030,10 +2241,9 @@ GRAPH graph;
 int colour[MAXN];
 int zaehlen, zaehlen2, non_iso;
 unsigned short code[MAXCODELENGTH];
-unsigned short neuer_code[MAXCODELENGTH];
 int lauf, nullenzaehler;
 unsigned char ucharpuffer;
-int too_large, i, test, globaltest=0;
+int too_large, i, test, renumbered, globaltest=0;
 
 char outputstring[300];
 int first_call=1;
@@ -2071,6 +2281,10 @@ if (strcmp(argv[i],"md5")==0) {print_ascii=md5out=1; } else
 		//if (strcmp(argv[i],"rf")==0) { do_rooted=1; do_rooted_f=1;} else
 		//if (strcmp(argv[i],"ro")==0) { only_roots=1; } else
 		  if (strcmp(argv[i],"hash")==0) { use_hash=1; } else
+		  if (strcmp(argv[i],"ext")==0) { i++; ext_directory=argv[i]; } else
+		  if (strcmp(argv[i],"parts")==0) { i++; ext_partitions=atoi(argv[i]); } else
+		  if (strcmp(argv[i],"mem")==0) { i++; ext_memory=atoi(argv[i]); } else
+		  if (strcmp(argv[i],"threads")==0) { i++; threads=atoi(argv[i]); } else
 		  if (strcmp(argv[i],"t")==0) { return_total=1; } else
 		    if (strcmp(argv[i],"mod")==0) { i++; rest=atoi(argv[i]);
                                                    i++; mod=atoi(argv[i]); } else
@@ -2084,6 +2298,12 @@ fprintf(stderr,"in ascii format)\n");
 fprintf(stderr,"md5 (print an ascii md5 representation to stdout)\n");
 fprintf(stderr,"hash (use a hash value instead of the real canonical form)\n");
 fprintf(stderr,"In case hash is used no output of the graph is possible.\n");
+fprintf(stderr,"ext dir (store the canonical forms in partition files in the directory dir\n");
+fprintf(stderr,"instead of in memory. An interrupted run can be resumed by starting it again\n");
+fprintf(stderr,"with the same directory and the same input.)\n");
+fprintf(stderr,"parts n (use n partition files with ext -- default 64)\n");
+fprintf(stderr,"mem n (with ext, partitions of more than n MB are split again -- default 1024)\n");
+fprintf(stderr,"threads n (compute the canonical forms with n threads)\n");
 		fprintf(stderr,"wo wn (write the map if old/new)\n");
 		fprintf(stderr,"or (don't regard orientation reversing automorphisms)\n");
 		//fprintf(stderr,"rv, re, rfl, rf (count the rooted nonisomorphic structures)\n");
@@ -2099,13 +2319,21 @@ fprintf(stderr,"In case hash is used no output of the graph is possible.\n");
 		  { fprintf(stderr,"unidentified option %s  -- try option u.\n",argv[i]); exit(0); }
  }
 
-if (use_hash) 
-  { hashlist=calloc((1<<HASHFIELDEXPONENT),sizeof(HASHFIELD));
-    if (hashlist==NULL) 
-      { fprintf(stderr,"don't get memory for hashfield\n"); exit(1); }
+if (use_hash) hashset=newHashSet();
 
+if (ext_directory)
+  { if (use_hash || print_ascii || writemap_old || writemap_new)
+      { fprintf(stderr,"Option ext can not be combined with hash, p, ps, md5, wo or wn.\n");
+	exit(1); }
+    external_dedup=openExternalDedup(ext_directory, ext_partitions, ext_memory<<20);
+    if (externalDedupResumePoint(external_dedup))
+      fprintf(stderr,"Resuming after graph %llu.\n",externalDedupResumePoint(external_dedup));
   }
 
+if (threads && (use_hash || print_ascii || writemap_old || writemap_new))
+  { fprintf(stderr,"Option threads can not be combined with hash, p, ps, md5, wo or wn.\n");
+    exit(1); }
+
 if (mod) { fprintf(stderr,"Note: modulo saves memory -- but time is a bad.\n");
 fprintf(stderr,"The sum of the runs takes MUCH more times than a single one! \n"); }
 
@@ -2115,46 +2343,29 @@ if (do_rooted_v || do_rooted_f || do_rooted_e)
     fprintf(stderr,"__DO__ test it against known numbers before using the results!\n"); }
 */
 
+if (threads) run_threads(&zaehlen, &zaehlen2, &non_iso, &globaltest);
+else
 while (lesecode(code, &lauf, stdin, &codetype))
   { zaehlen++; 
-  if ((mod==0) || (codetype!='e') || ((invariant_code(code, lauf)%mod)==rest))
- { 
-
-
    //fprintf(stderr,"number %d\n",zaehlen);
 
-   if (codetype=='p')
-     {
-	if ((test=check_code(code,neuer_code))) decodiereplanar(code,map,degree);
-	else { decodiereplanar(neuer_code,map,degree); globaltest++; }
-	for (i=1;i<=nv;i++) colour[i]=degree[i];
-     }
-   else // type=='e'
-     {
-	decode_edgecode(code, lauf);
-	for (i=1;i<=nv;i++) colour[i]=degree[i];
-	//writemap();
-	subdividedubbelandloop(colour);
-	/*	if (zaehlen==2 || zaehlen==5) 
-	  	  { int i; 
-fprintf(stderr,"colours: ");for (i=1;i<=nv;i++) fprintf(stderr," %d",colour[i]); fprintf(stderr,"\n");
-writemap(); }*/
-     }
-
-
-
-
-   if ((mod==0) || (codetype=='e') || ((invariant()%mod)==rest))
+   test=prepare_graph(code, lauf, colour, &renumbered);
+   globaltest += renumbered;
+   if (test)
      { zaehlen2++;
-     if (neu(nv+ne+1,zaehlen,colour)) non_iso++;
+     /* when resuming, the canonical forms of these graphs are already stored */
+     if (external_dedup && zaehlen<=externalDedupResumePoint(external_dedup)) ;
+     else if (neu(nv+ne+1,zaehlen,colour)) non_iso++;
      }
-
- }
   }
 
 
 
-if (output && !use_hash) splay_scan(worklist);
+if (external_dedup)
+  { finishExternalDedup(external_dedup, report_external, &non_iso);
+    closeExternalDedup(external_dedup);
+  }
+else if (output && !use_hash) splay_scan(worklist);
 
 if (globaltest!=0)
 fprintf(stderr,"WARNING !! %d graphs had to be renumbered, since there was a vertex\n different from 1 not adjacent to a smaller one ! \n",globaltest);
@@ -2164,6 +2375,14 @@ fprintf(stderr,"WARNING !! %d graphs had to be renumbered, since there was a ver
 if (only_roots || print_ascii) fprintf(stderr,"Read %d graphs.\n", zaehlen);
 else fprintf(stderr,"Read %d graphs, %d non-isomorphic.\n", zaehlen,non_iso);
 if (mod) fprintf(stderr,"Selected %d graphs due to an invariant.\n",zaehlen2);
+if (use_hash)
+  { HASH_SET_STATISTICS statistics;
+    getHashSetStatistics(hashset, &statistics);
+    fprintf(stderr,"Hash table: %llu hashes in %llu slots (load factor %.2f, %d resizes).\n",
+	    statistics.size, statistics.slotCount, statistics.loadFactor, statistics.resizes);
+    fprintf(stderr,"Probe length: %.2f on average, %llu at most.\n",
+	    statistics.averageProbeLength, statistics.maximumProbeLength);
+  }
 
 
 if (do_rooted_f) fprintf(stderr,"%llu face rooted graphs.\n",numrootedf);
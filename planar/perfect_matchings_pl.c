@@ -0,0 +1,463 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads plane graphs from standard in and writes the number of
+ * perfect matchings of each graph to standard out.
+ *
+ * The embedding is used to give the edges a Pfaffian orientation (the FKT
+ * algorithm), after which the number of perfect matchings is the absolute
+ * value of the Pfaffian of the signed adjacency matrix. This Pfaffian is
+ * computed exactly by computing it modulo several primes and combining these
+ * residues with the Chinese remainder theorem. Parallel edges are counted as
+ * different edges.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o perfect_matchings_pl -O4 perfect_matchings_pl.c \
+ *     shared/planar_base.c shared/planar_input.c ../shared/code_reader.c \
+ *     ../shared/big_integer.c -lm
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <getopt.h>
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "../shared/big_integer.h"
+
+#define EDGE_INDEX(pg, e) ((e) - (pg)->edges)
+
+void *safeMalloc(size_t size){
+    void *pointer = malloc(size);
+    if(pointer == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return pointer;
+}
+
+//====================== ORIENTATION =======================
+
+/* Stores in orientation for each oriented edge e the value 1 if the edge is
+ * oriented from e->start to e->end and -1 otherwise, such that each face
+ * except one face per component has an odd number of edges that are oriented
+ * in the direction in which the face is traversed.
+ *
+ * The edges of a spanning forest are oriented arbitrarily. The remaining
+ * edges form a spanning forest of the dual graph. Those edges are oriented
+ * starting from the leaves of the dual forest: the edge to the parent is
+ * the last edge of the face that is still free.
+ */
+void computePfaffianOrientation(PLANE_GRAPH *pg, int *orientation){
+    int i, head, tail;
+    PG_EDGE *e, *elast;
+
+    int *queue = safeMalloc(sizeof(int)*(pg->nv > pg->nf ? pg->nv : pg->nf));
+    boolean *visited = safeMalloc(sizeof(boolean)*(pg->nv > pg->nf ? pg->nv : pg->nf));
+    boolean *isTreeEdge = safeMalloc(sizeof(boolean)*pg->ne);
+    PG_EDGE **parentEdge = safeMalloc(sizeof(PG_EDGE *)*pg->nf);
+
+    for(i = 0; i < pg->ne; i++){
+        isTreeEdge[i] = FALSE;
+        orientation[i] = 0;
+    }
+
+    //spanning forest of the graph
+    for(i = 0; i < pg->nv; i++){
+        visited[i] = FALSE;
+    }
+    for(i = 0; i < pg->nv; i++){
+        if(visited[i]) continue;
+        visited[i] = TRUE;
+        head = tail = 0;
+        queue[tail++] = i;
+        while(head < tail){
+            int v = queue[head++];
+            e = elast = pg->firstedge[v];
+            do {
+                if(!visited[e->end]){
+                    visited[e->end] = TRUE;
+                    queue[tail++] = e->end;
+                    isTreeEdge[EDGE_INDEX(pg, e)] = TRUE;
+                    isTreeEdge[EDGE_INDEX(pg, e->inverse)] = TRUE;
+                    orientation[EDGE_INDEX(pg, e)] = 1;
+                    orientation[EDGE_INDEX(pg, e->inverse)] = -1;
+                }
+                e = e->next;
+            } while (e != elast);
+        }
+    }
+
+    //spanning forest of the dual graph using the remaining edges
+    for(i = 0; i < pg->nf; i++){
+        visited[i] = FALSE;
+        parentEdge[i] = NULL;
+    }
+    head = tail = 0;
+    for(i = 0; i < pg->nf; i++){
+        if(visited[i]) continue;
+        visited[i] = TRUE;
+        queue[tail++] = i;
+        while(head < tail){
+            int f = queue[head++];
+            e = elast = pg->facestart[f];
+            do {
+                if(!isTreeEdge[EDGE_INDEX(pg, e)] && !visited[e->inverse->rightface]){
+                    visited[e->inverse->rightface] = TRUE;
+                    queue[tail++] = e->inverse->rightface;
+                    parentEdge[e->inverse->rightface] = e->inverse;
+                }
+                e = e->inverse->prev;
+            } while (e != elast);
+        }
+    }
+
+    //the edges that are in neither forest can be oriented arbitrarily
+    for(i = 0; i < pg->ne; i++){
+        if(orientation[i] == 0 && orientation[EDGE_INDEX(pg, pg->edges[i].inverse)] == 0){
+            orientation[i] = 1;
+            orientation[EDGE_INDEX(pg, pg->edges[i].inverse)] = -1;
+        }
+    }
+    for(i = 0; i < pg->nf; i++){
+        if(parentEdge[i] != NULL){
+            orientation[EDGE_INDEX(pg, parentEdge[i])] = 0;
+            orientation[EDGE_INDEX(pg, parentEdge[i]->inverse)] = 0;
+        }
+    }
+
+    //a face is handled after all its children in the dual forest
+    for(i = tail - 1; i >= 0; i--){
+        int f = queue[i];
+        int count = 0;
+        if(parentEdge[f] == NULL) continue;
+        e = elast = pg->facestart[f];
+        do {
+            if(orientation[EDGE_INDEX(pg, e)] == 1){
+                count++;
+            }
+            e = e->inverse->prev;
+        } while (e != elast);
+        orientation[EDGE_INDEX(pg, parentEdge[f])] = (count % 2) ? -1 : 1;
+        orientation[EDGE_INDEX(pg, parentEdge[f]->inverse)] = (count % 2) ? 1 : -1;
+    }
+
+    free(queue);
+    free(visited);
+    free(isTreeEdge);
+    free(parentEdge);
+}
+
+//====================== PFAFFIAN =======================
+
+boolean isPrime(unsigned int n){
+    unsigned int d;
+    if(n < 2) return FALSE;
+    if(n % 2 == 0) return n == 2;
+    for(d = 3; d <= n / d; d += 2){
+        if(n % d == 0) return FALSE;
+    }
+    return TRUE;
+}
+
+//returns the largest prime that is smaller than n
+unsigned int previousPrime(unsigned int n){
+    n--;
+    while(!isPrime(n)){
+        n--;
+    }
+    return n;
+}
+
+unsigned int powerModulo(unsigned int base, unsigned int exponent, unsigned int p){
+    unsigned long long result = 1, b = base % p;
+    while(exponent){
+        if(exponent & 1){
+            result = (result * b) % p;
+        }
+        b = (b * b) % p;
+        exponent >>= 1;
+    }
+    return (unsigned int)result;
+}
+
+unsigned int inverseModulo(unsigned int a, unsigned int p){
+    return powerModulo(a, p - 2, p);
+}
+
+/* Returns the Pfaffian modulo p of the skew-symmetric matrix of order n.
+ * The matrix is destroyed.
+ */
+unsigned int pfaffianModulo(unsigned int *matrix, int n, unsigned int p){
+    int i, j, k;
+    unsigned long long pfaffian = 1;
+
+    for(k = 0; k < n; k += 2){
+        unsigned int *rowK = matrix + k*n;
+        unsigned int *rowK1;
+        unsigned int inverse;
+
+        //find a pivot in row k
+        for(j = k + 1; j < n && rowK[j] == 0; j++);
+        if(j == n){
+            return 0;
+        }
+        if(j != k + 1){
+            //swap row and column j with row and column k + 1
+            unsigned int *rowJ = matrix + j*n;
+            rowK1 = matrix + (k + 1)*n;
+            for(i = 0; i < n; i++){
+                unsigned int temp = rowJ[i];
+                rowJ[i] = rowK1[i];
+                rowK1[i] = temp;
+            }
+            for(i = 0; i < n; i++){
+                unsigned int temp = matrix[i*n + j];
+                matrix[i*n + j] = matrix[i*n + k + 1];
+                matrix[i*n + k + 1] = temp;
+            }
+            pfaffian = (p - pfaffian) % p;
+        }
+        rowK1 = matrix + (k + 1)*n;
+
+        pfaffian = (pfaffian * rowK[k + 1]) % p;
+        inverse = inverseModulo(rowK[k + 1], p);
+
+        //replace the remaining matrix by its Schur complement
+        for(i = k + 2; i < n; i++){
+            unsigned int *rowI = matrix + i*n;
+            unsigned long long u, w;
+            if(rowI[k] == 0 && rowI[k + 1] == 0) continue;
+            u = p - ((unsigned long long)rowI[k + 1] * inverse) % p;
+            w = ((unsigned long long)rowI[k] * inverse) % p;
+            for(j = k + 2; j < n; j++){
+                rowI[j] = (rowI[j] + u * rowK[j] % p + w * rowK1[j] % p) % p;
+            }
+        }
+    }
+
+    return (unsigned int)pfaffian;
+}
+
+//====================== CHINESE REMAINDERS =======================
+
+/* The residue of the Pfaffian modulo the product of the primes used so far.
+ * As long as this product fits in 64 bits no big integers are used.
+ */
+typedef struct __residue {
+    unsigned long long smallModulus;
+    unsigned long long smallValue;
+
+    boolean big;
+    BIG_INTEGER *modulus;
+    BIG_INTEGER *value;
+} RESIDUE;
+
+void addResidue(RESIDUE *residue, unsigned int value, unsigned int p){
+    unsigned long long current, t, product;
+
+    if(residue->smallModulus == 0){
+        residue->smallModulus = p;
+        residue->smallValue = value;
+        return;
+    }
+
+    //Garner's step: find t such that value + modulus * t is the new value
+    if(residue->big){
+        current = bigIntegerModulo(residue->value, p);
+        t = ((value + (unsigned long long)p - current) % p) *
+                inverseModulo(bigIntegerModulo(residue->modulus, p), p) % p;
+        BIG_INTEGER *increment = newBigInteger(0);
+        copyBigInteger(increment, residue->modulus);
+        multiplyBigInteger(increment, (unsigned int)t);
+        addBigInteger(residue->value, increment);
+        multiplyBigInteger(residue->modulus, p);
+        freeBigInteger(increment);
+        return;
+    }
+
+    current = residue->smallValue % p;
+    t = ((value + (unsigned long long)p - current) % p) *
+            inverseModulo(residue->smallModulus % p, p) % p;
+    if(__builtin_mul_overflow(residue->smallModulus, (unsigned long long)p, &product)){
+        residue->big = TRUE;
+        residue->modulus = newBigInteger(residue->smallModulus);
+        residue->value = newBigInteger(residue->smallModulus);
+        multiplyBigInteger(residue->value, (unsigned int)t);
+        BIG_INTEGER *smallValue = newBigInteger(residue->smallValue);
+        addBigInteger(residue->value, smallValue);
+        freeBigInteger(smallValue);
+        multiplyBigInteger(residue->modulus, p);
+    } else {
+        //smallValue + smallModulus * t < smallModulus * p, so this cannot overflow
+        residue->smallValue += residue->smallModulus * t;
+        residue->smallModulus = product;
+    }
+}
+
+/* Writes the absolute value of the integer with the given residue, i.e., the
+ * residue or the modulus minus the residue, whichever is smaller.
+ */
+void writeAbsoluteValue(RESIDUE *residue, FILE *f){
+    if(residue->big){
+        BIG_INTEGER *doubleValue = newBigInteger(0);
+        copyBigInteger(doubleValue, residue->value);
+        addBigInteger(doubleValue, residue->value);
+        if(compareBigIntegers(doubleValue, residue->modulus) > 0){
+            copyBigInteger(doubleValue, residue->modulus);
+            subtractBigInteger(doubleValue, residue->value);
+            writeBigInteger(doubleValue, f);
+        } else {
+            writeBigInteger(residue->value, f);
+        }
+        freeBigInteger(doubleValue);
+    } else if(residue->smallValue > residue->smallModulus - residue->smallValue){
+        fprintf(f, "%llu", residue->smallModulus - residue->smallValue);
+    } else {
+        fprintf(f, "%llu", residue->smallValue);
+    }
+}
+
+//====================== PERFECT MATCHINGS =======================
+
+void writePerfectMatchingCount(PLANE_GRAPH *pg, FILE *f){
+    int i, j, n = pg->nv;
+    double bits = 0, modulusBits = 0;
+    unsigned int p = 1U << 31;
+    int *orientation, *signedAdjacency;
+    unsigned int *matrix;
+    RESIDUE residue = {0, 0, FALSE, NULL, NULL};
+
+    if(n % 2){
+        fprintf(f, "0");
+        return;
+    }
+
+    if(!pg->dualComputed){
+        makeDual(pg);
+    }
+
+    orientation = safeMalloc(sizeof(int)*pg->ne);
+    computePfaffianOrientation(pg, orientation);
+
+    signedAdjacency = safeMalloc(sizeof(int)*n*n);
+    for(i = 0; i < n*n; i++){
+        signedAdjacency[i] = 0;
+    }
+    for(i = 0; i < pg->ne; i++){
+        if(orientation[i] == 1){
+            signedAdjacency[pg->edges[i].start*n + pg->edges[i].end]++;
+            signedAdjacency[pg->edges[i].end*n + pg->edges[i].start]--;
+        }
+    }
+    free(orientation);
+
+    /* By Hadamard's inequality the square of the Pfaffian (the determinant)
+     * is at most the product of the norms of the rows.
+     */
+    for(i = 0; i < n; i++){
+        double rowSquare = 0;
+        for(j = 0; j < n; j++){
+            rowSquare += (double)signedAdjacency[i*n + j] * signedAdjacency[i*n + j];
+        }
+        if(rowSquare == 0){
+            free(signedAdjacency);
+            fprintf(f, "0");
+            return;
+        }
+        bits += log2(rowSquare)/4;
+    }
+
+    //the modulus needs to be larger than twice the bound to recover the sign
+    matrix = safeMalloc(sizeof(unsigned int)*n*n);
+    while(modulusBits < bits + 2){
+        p = previousPrime(p);
+        for(i = 0; i < n*n; i++){
+            int entry = signedAdjacency[i] % (int)p;
+            matrix[i] = entry < 0 ? (unsigned int)(entry + (int)p) : (unsigned int)entry;
+        }
+        addResidue(&residue, pfaffianModulo(matrix, n, p), p);
+        modulusBits += log2(p);
+    }
+    free(matrix);
+    free(signedAdjacency);
+
+    writeAbsoluteValue(&residue, f);
+    if(residue.big){
+        freeBigInteger(residue.modulus);
+        freeBigInteger(residue.value);
+    }
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s computes the number of perfect matchings of plane graphs.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, " -h, --help\n");
+    fprintf(stderr, "    Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] \n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char** argv) {
+
+    int graphsRead = 0;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"help", no_argument, NULL, 'h'}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "h", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    PLANE_GRAPH *pg = NULL;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    while (nextCode(reader, &view)) {
+        pg = decodePlanarCodeView(&view, pg, &options);
+        graphsRead++;
+        fprintf(stdout, "Graph %d has ", graphsRead);
+        writePerfectMatchingCount(pg, stdout);
+        fprintf(stdout, " perfect matchings.\n");
+    }
+    if(pg != NULL){
+        freePlaneGraph(pg);
+    }
+    freeCodeReader(reader);
+
+    fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o select_pl -O4 select_pl.c
+ *     cc -o select_pl -O4 select_pl.c \
+ *     ../shared/code_reader.c ../shared/code_index.c
  * 
  */
 
@@ -20,16 +21,8 @@
 #include <getopt.h>
 #include <string.h>
 
-
-#ifndef MAXN
-#define MAXN 200            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
+#include "../shared/code_reader.h"
+#include "../shared/code_index.h"
 
 #undef FALSE
 #undef TRUE
@@ -38,291 +31,29 @@
 
 typedef int boolean;
 
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
-
-int nv;
-int ne;
-
-//=============== Writing planarcode of graph ===========================
+//=============== Writing planarcode ===========================
 
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
-    }
-}
-
-void writeShort(unsigned short value){
-    if (fwrite(&value, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
-    }
-}
-
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(0, stdout);
-    writeShort(nv);
-    
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            writeShort(e->end + 1);
-            e = e->next;
-        } while (e != elast);
-        writeShort(0);
-    }
-}
-
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
-    }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
-    
-}
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
-
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
-        }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
-        }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
-    }
+/* The selected graphs are copied to stdout as they appear in the input, so
+ * they are never decoded. The header is written before the first graph.
+ */
+boolean headerWritten = FALSE;
 
-    ne = edgeCounter;
+void writeGraph(CODE_VIEW *view){
+    writeCodeView(view, headerWritten ? NULL : PLANARCODE_HEADER, stdout);
+    headerWritten = TRUE;
 }
 
-/**
- * 
- * @param code
- * @param laenge
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
+/* Writes graph graphNumber (starting from 1) in the index to stdout.
  */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
+void writeIndexedGraph(CODE_INDEX *index, unsigned long long graphNumber){
+    CODE_VIEW view;
     
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
+    if(graphNumber < 1 || graphNumber > codeIndexSize(index)){
+        fprintf(stderr, "Graph %llu is not in the file -- exiting!\n", graphNumber);
+        exit(1);
     }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    return (1);
-
-
+    codeIndexView(index, graphNumber - 1, &view);
+    writeGraph(&view);
 }
 
 //====================== USAGE =======================
@@ -332,9 +63,9 @@ void help(char *name) {
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options] g1 g2 ...\n", name);
     fprintf(stderr, " %s [options] -m r:m\n", name);
-    fprintf(stderr, " %s [options] -F file\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n", MAXN);
-    fprintf(stderr, "Recompile with a larger value for MAXN if you need larger graphs.\n\n");
+    fprintf(stderr, " %s [options] -F file\n", name);
+    fprintf(stderr, " %s [options] -I file -s r:m\n\n", name);
+    fprintf(stderr, "\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, " -m, --modulo r:m\n");
     fprintf(stderr, "    Split the input into m parts and only output part r (0<=r<m).\n");
@@ -343,6 +74,15 @@ void help(char *name) {
     fprintf(stderr, "    are read from the file provided and not from stdin. Instead the numbers of\n");
     fprintf(stderr, "    the graphs that should be filtered are read from stdin. The numbers should\n");
     fprintf(stderr, "    be given in ascending order and at least one number should be given.\n");
+    fprintf(stderr, "    If the file has an index (see index_pl), the index is used to jump directly\n");
+    fprintf(stderr, "    to the selected graphs.\n");
+    fprintf(stderr, " -I, --indexed file\n");
+    fprintf(stderr, "    Read the graphs from the specified file instead of from stdin. The file\n");
+    fprintf(stderr, "    needs an index (see index_pl), which is used to jump directly to the\n");
+    fprintf(stderr, "    selected graphs.\n");
+    fprintf(stderr, " -s, --shard r:m\n");
+    fprintf(stderr, "    Split the input into m ranges of consecutive graphs and only output range\n");
+    fprintf(stderr, "    r (0<=r<m). Requires the option -I.\n");
     fprintf(stderr, " --skip-remainder\n");
     fprintf(stderr, "    Immediately return after filtering the last graph.\n");
     fprintf(stderr, " -h, --help\n");
@@ -353,6 +93,7 @@ void usage(char *name) {
     fprintf(stderr, "Usage: %s [options] g1 g2 ...\n", name);
     fprintf(stderr, "       %s -m r:m\n", name);
     fprintf(stderr, "       %s -F file\n", name);
+    fprintf(stderr, "       %s -I file -s r:m\n", name);
     fprintf(stderr, "For more information type: %s -h \n\n", name);
 }
 
@@ -369,6 +110,12 @@ int main(int argc, char** argv) {
     boolean moduloEnabled = FALSE;
     int moduloRest;
     int moduloMod;
+    
+    char *indexedFileName = NULL;
+    
+    boolean shardEnabled = FALSE;
+    int shardPart;
+    int shardCount;
 
     /*=========== commandline parsing ===========*/
 
@@ -378,11 +125,13 @@ int main(int argc, char** argv) {
         {"skip-remainder", no_argument, NULL, 0},
         {"modulo", required_argument, NULL, 'm'},
         {"from-file", required_argument, NULL, 'F'},
+        {"indexed", required_argument, NULL, 'I'},
+        {"shard", required_argument, NULL, 's'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hm:F:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hm:F:I:s:", long_options, &option_index)) != -1) {
         switch (c) {
             case 0:
                 switch (option_index) {
@@ -406,6 +155,18 @@ int main(int argc, char** argv) {
                 fromFile = TRUE;
                 fromFile_fileName = optarg;
                 break;
+            case 'I':
+                indexedFileName = optarg;
+                break;
+            case 's':
+                shardEnabled = TRUE;
+                if(sscanf(optarg, "%d:%d", &shardPart, &shardCount)!=2 ||
+                        shardCount <= 0 || shardPart < 0 || shardPart >= shardCount){
+                    fprintf(stderr, "Error while reading shard -- exiting.\n");
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -419,39 +180,104 @@ int main(int argc, char** argv) {
         }
     }
         
-    if (argc - optind == 0 && !(moduloEnabled || fromFile)) {
+    if (argc - optind == 0 && !(moduloEnabled || fromFile || shardEnabled)) {
         usage(name);
         return EXIT_FAILURE;
-    } else if(argc - optind > 0 && (moduloEnabled || fromFile)) {
+    } else if(argc - optind > 0 && (moduloEnabled || fromFile || shardEnabled)) {
         usage(name);
         return EXIT_FAILURE;
-    } else if(moduloEnabled && fromFile) {
+    } else if(moduloEnabled + fromFile + shardEnabled > 1) {
         usage(name);
         return EXIT_FAILURE;
+    } else if(fromFile && indexedFileName != NULL) {
+        usage(name);
+        return EXIT_FAILURE;
+    } else if(shardEnabled && indexedFileName == NULL) {
+        fprintf(stderr, "Sharding requires an indexed file -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    
+    CODE_INDEX *index = NULL;
+    if(indexedFileName != NULL){
+        index = openPlanarCodeIndex(indexedFileName, NULL);
+        if(index == NULL){
+            fprintf(stderr, "No index found for %s (see index_pl) -- exiting!\n", indexedFileName);
+            return EXIT_FAILURE;
+        }
+    } else if(fromFile){
+        index = openPlanarCodeIndex(fromFile_fileName, NULL);
     }
     
-    if(!fromFile){
+    if(index != NULL && !fromFile){
+        unsigned long long graphNumber, end;
+        
+        if(shardEnabled){
+            codeIndexShard(index, shardPart, shardCount, &graphNumber, &end);
+            //graphs are numbered starting from 1
+            for(graphNumber++; graphNumber <= end; graphNumber++){
+                writeIndexedGraph(index, graphNumber);
+                graphsFiltered++;
+            }
+        } else if(moduloEnabled){
+            end = codeIndexSize(index);
+            graphNumber = moduloRest > 0 ? moduloRest : moduloMod;
+            for(; graphNumber <= end; graphNumber += moduloMod){
+                writeIndexedGraph(index, graphNumber);
+                graphsFiltered++;
+            }
+        } else {
+            int i;
+            for (i = 0; i < argc - optind; i++){
+                writeIndexedGraph(index, atoi(argv[i + optind]));
+                graphsFiltered++;
+            }
+        }
+        //report the graphs in the file, as when the graphs are read from stdin
+        graphsRead = codeIndexSize(index);
+    } else if(index != NULL){
+        char line[20];
+        long long nextGraph;
+        
+        while(fgets(line, sizeof(line), stdin)){
+            nextGraph = atoll(line);
+            if(nextGraph < graphsRead){
+                fprintf(stderr, "Numbers should be given in ascending order -- exiting!");
+                return EXIT_FAILURE;
+            }
+            writeIndexedGraph(index, nextGraph);
+            graphsRead = nextGraph;
+            graphsFiltered++;
+        }
+        if(graphsFiltered == 0){
+            fprintf(stderr, "Unexpected end of file while reading graph numbers -- exiting!\n");
+            usage(name);
+            return EXIT_FAILURE;
+        }
+        if(!skipRemainder){
+            //the remaining graphs would also have been read
+            graphsRead = codeIndexSize(index);
+        }
+    } else if(!fromFile){
         int i;
         int selectedGraphs[argc - optind];
         for (i = 0; i < argc - optind; i++){
             selectedGraphs[i] = atoi(argv[i + optind]);
         }
 
-        unsigned short code[MAXCODELENGTH];
-        int length;
-        while (readPlanarCode(code, &length, stdin)) {
+        CODE_READER *reader = newPlanarCodeReader(stdin);
+        CODE_VIEW view;
+        while (nextCode(reader, &view)) {
             graphsRead++;
 
             if(moduloEnabled){
                 if(graphsRead % moduloMod == moduloRest){
-                    decodePlanarCode(code);
                     graphsFiltered++;
-                    writePlanarCode();
+                    writeGraph(&view);
                 }
             } else if (graphsFiltered < argc - optind && (graphsRead == selectedGraphs[graphsFiltered])) {
-                decodePlanarCode(code);
                 graphsFiltered++;
-                writePlanarCode();
+                writeGraph(&view);
             }
         }
     } else {
@@ -474,15 +300,14 @@ int main(int argc, char** argv) {
         }
         
         
-        unsigned short code[MAXCODELENGTH];
-        int length;
-        while (readPlanarCode(code, &length, graphsIn)) {
+        CODE_READER *reader = newPlanarCodeReader(graphsIn);
+        CODE_VIEW view;
+        while (nextCode(reader, &view)) {
             graphsRead++;
 
             if (graphsRead == nextGraph) {
-                decodePlanarCode(code);
                 graphsFiltered++;
-                writePlanarCode();
+                writeGraph(&view);
                 //read number of next graph
                 if(fgets(line, sizeof(line), stdin)){
                     nextGraph = atoi(line);
@@ -502,6 +327,10 @@ int main(int argc, char** argv) {
         }
     }
     
+    if(index != NULL){
+        closeCodeIndex(index);
+    }
+    
     fprintf(stderr, "Read %llu graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
     fprintf(stderr, "Filtered %d graph%s.\n", graphsFiltered, graphsFiltered==1 ? "" : "s");
 
@@ -9,14 +9,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+__thread int markvalue = 30000;
+
 PLANE_GRAPH *newPlaneGraph(int maxn, int maxe) {
     if(maxn <= 0){
         fprintf(stderr, "maxn should be a positive integer -- exiting!\n");
         return NULL;
     }
     
-    if(maxe <= 0 || maxe > (6*maxn-12)){
-        maxe = 6*maxn-12;
+    //a larger maxe is kept: plane multigraphs can have more edges
+    if(maxe <= 0){
+        maxe = maxn < 3 ? 2 : 6*maxn-12;
     }
     
     PLANE_GRAPH *pg = (PLANE_GRAPH *)malloc(sizeof(PLANE_GRAPH));
@@ -52,7 +55,18 @@ PLANE_GRAPH *newPlaneGraph(int maxn, int maxe) {
     
     if(pg->degree == NULL){
         fprintf(stderr, "Insufficient memory for degrees -- exiting!\n");
+        free(pg->firstedge);
+        free(pg->edges);
+        free(pg);
+        return NULL;
+    }
+    
+    pg->inverseTable = (PG_EDGE **)malloc(sizeof(PG_EDGE *)*maxn);
+    
+    if(pg->inverseTable == NULL){
+        fprintf(stderr, "Insufficient memory for decoding -- exiting!\n");
         free(pg->degree);
+        free(pg->firstedge);
         free(pg->edges);
         free(pg);
         return NULL;
@@ -76,6 +90,7 @@ void freePlaneGraph(PLANE_GRAPH *pg){
         free(pg->faceSize);
     }
     
+    free(pg->inverseTable);
     free(pg->degree);
     free(pg->firstedge);
     free(pg->edges);
@@ -96,6 +111,24 @@ PG_EDGE *findEdge(PLANE_GRAPH *pg, int from, int to) {
     exit(EXIT_FAILURE);
 }
 
+PG_EDGE *findEdgeIfPresent(PLANE_GRAPH *pg, int from, int to) {
+    PG_EDGE *e, *elast;
+
+    if (from < 0 || from >= pg->nv || pg->degree[from] == 0) {
+        return NULL;
+    }
+
+    e = elast = pg->firstedge[from];
+    do {
+        if (e->end == to) {
+            return e;
+        }
+        e = e->next;
+    } while (e != elast);
+
+    return NULL;
+}
+
 /* Store in the rightface field of each edge the number of the face on
    the right hand side of that edge.  Faces are numbered 0,1,....  Also
    store in facestart[i] an example of an edge in the clockwise orientation
@@ -108,7 +141,12 @@ void makeDual(PLANE_GRAPH *pg) {
     RESETMARKS(pg);
     
     //first allocate the memory to store faces if this has not yet been done
+    //(each face contains at least one oriented edge, which also covers graphs
+    //that are too small or not connected for the bound 2*maxn - 4)
     int maxf = 2*pg->maxn - 4;
+    if(maxf < pg->maxe){
+        maxf = pg->maxe;
+    }
     if(pg->maxf < maxf){
         if(pg->facestart!=NULL){
             free(pg->facestart);
@@ -66,9 +66,14 @@ struct __plane_graph {
     
     //TRUE if the dual of this graph has been computed
     boolean dualComputed;
+    
+    //an array with an entry for each vertex that is used by the decoder to
+    //pair each edge with its inverse
+    PG_EDGE **inverseTable;
 };
 
-static int markvalue = 30000;
+//the marks are thread local, so that threads can handle their own plane graphs
+extern __thread int markvalue;
 #define RESETMARKS(pg) {int mki; if ((markvalue += 2) > 30000) \
        { markvalue = 2; for (mki=0;mki<(pg)->maxe;++mki) (pg)->edges[mki].mark=0;}}
 #define MARK(e) (e)->mark = markvalue
@@ -82,7 +87,7 @@ static int markvalue = 30000;
 /**
  * Creates a new planar graph data structure that can hold plane graphs with
  * up to maxn vertices and maxe oriented edges. If maxe is zero, then the 
- * theoretical maximum for maxn is computed and used.
+ * theoretical maximum for simple plane graphs with maxn vertices is used.
  * 
  * This function might return a NULL pointer if insufficient memory was
  * available or the number of vertices is illegal.
@@ -93,8 +98,17 @@ void freePlaneGraph(PLANE_GRAPH *pg);
 
 void makeDual(PLANE_GRAPH *pg);
 
+/**
+ * Returns the edge from from to to. Exits if there is no such edge.
+ */
 PG_EDGE *findEdge(PLANE_GRAPH *pg, int from, int to);
 
+/**
+ * Returns the edge from from to to, or NULL if from is not a vertex of pg or
+ * if there is no such edge.
+ */
+PG_EDGE *findEdgeIfPresent(PLANE_GRAPH *pg, int from, int to);
+
 void clearAllEdgeLabels(PLANE_GRAPH *pg);
 
 #endif	/* PLANAR_BASE_H */
@@ -0,0 +1,298 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "planar_halfedge.h"
+#include <stdlib.h>
+
+static void *resizeHalfEdgeArray(void *array, size_t size){
+    array = realloc(array, size);
+    if(array == NULL && size > 0){
+        fprintf(stderr, "Insufficient memory for half-edge graph -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+/* Makes sure that g can store a graph with nv vertices and ne half-edges.
+ * Existing content is not kept.
+ */
+static void ensureHalfEdgeMemory(HALFEDGE_GRAPH *g, int nv, int ne){
+    if(nv > g->maxn){
+        int maxn = 2*g->maxn > nv ? 2*g->maxn : nv;
+        g->firstedge = resizeHalfEdgeArray(g->firstedge, sizeof(HE_EDGE)*maxn);
+        g->degree = resizeHalfEdgeArray(g->degree, sizeof(int)*maxn);
+        g->inverseTable = resizeHalfEdgeArray(g->inverseTable, sizeof(HE_EDGE)*maxn);
+        g->maxn = maxn;
+    }
+    if(ne > g->maxe){
+        int maxe = 2*g->maxe > ne ? 2*g->maxe : ne;
+        g->end = resizeHalfEdgeArray(g->end, sizeof(HE_EDGE)*maxe);
+        g->next = resizeHalfEdgeArray(g->next, sizeof(HE_EDGE)*maxe);
+        g->prev = resizeHalfEdgeArray(g->prev, sizeof(HE_EDGE)*maxe);
+        g->rightface = resizeHalfEdgeArray(g->rightface, sizeof(HE_EDGE)*maxe);
+        g->facestart = resizeHalfEdgeArray(g->facestart, sizeof(HE_EDGE)*maxe);
+        g->faceSize = resizeHalfEdgeArray(g->faceSize, sizeof(int)*maxe);
+        //the marks are compared against markvalue, so they have to start at 0
+        free(g->mark);
+        g->mark = (int *)calloc(maxe, sizeof(int));
+        g->label = resizeHalfEdgeArray(g->label, sizeof(void *)*maxe);
+        if(g->mark == NULL){
+            fprintf(stderr, "Insufficient memory for half-edge graph -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        g->maxe = maxe;
+    }
+}
+
+HALFEDGE_GRAPH *newHalfEdgeGraph(int maxn, int maxe){
+    HALFEDGE_GRAPH *g = (HALFEDGE_GRAPH *)malloc(sizeof(HALFEDGE_GRAPH));
+    if(g == NULL){
+        fprintf(stderr, "Insufficient memory for half-edge graph -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    g->nv = g->ne = g->nf = 0;
+    g->maxn = g->maxe = 0;
+    g->end = g->next = g->prev = g->rightface = NULL;
+    g->firstedge = g->facestart = g->inverseTable = NULL;
+    g->degree = g->faceSize = g->mark = NULL;
+    g->label = NULL;
+    g->dualComputed = FALSE;
+
+    ensureHalfEdgeMemory(g, maxn, maxe);
+
+    return g;
+}
+
+void freeHalfEdgeGraph(HALFEDGE_GRAPH *g){
+    free(g->label);
+    free(g->mark);
+    free(g->faceSize);
+    free(g->facestart);
+    free(g->rightface);
+    free(g->prev);
+    free(g->next);
+    free(g->end);
+    free(g->inverseTable);
+    free(g->degree);
+    free(g->firstedge);
+    free(g);
+}
+
+/* The half-edges are numbered in pairs: when the edge from u to a larger
+ * vertex v is read, it gets the next even number e and e^1 becomes the edge
+ * from v to u. The pending edges that end in v are kept in lists in the same
+ * way as in decodeEntries() in planar_input.c. Since e^1 is not yet part of a
+ * rotation while e is pending, the list is linked through next[e^1].
+ */
+static inline void decodeHalfEdgeEntries(HALFEDGE_GRAPH *g, const unsigned char *body, boolean shortCode){
+    int i, j, codePosition = 0, end, nv = g->nv;
+    HE_EDGE e, first, previous, pending, inverse, loop;
+    HE_EDGE *table = g->inverseTable;
+    HE_EDGE *ends = g->end;
+    HE_EDGE *next = g->next;
+    HE_EDGE *prev = g->prev;
+    int edgeCounter = 0;
+    int unpairedEdges = 0;
+
+    for (i = 0; i < nv; i++) {
+        table[i] = HE_NONE;
+    }
+
+    for (i = 0; i < nv; i++) {
+        //split the list of edges that end in i into blocks per start vertex
+        pending = table[i];
+        previous = HE_NONE;
+        while(pending != HE_NONE){
+            e = pending;
+            pending = next[e^1];
+            if(previous == HE_NONE || ends[previous^1] != ends[e^1]){
+                if(previous != HE_NONE){
+                    next[previous^1] = HE_NONE;
+                }
+                table[ends[e^1]] = e;
+            }
+            previous = e;
+        }
+
+        first = previous = loop = HE_NONE;
+        for (j = 0; (end = shortCode ? codeEntryShort(body, codePosition) :
+                body[codePosition]); j++, codePosition++) {
+            end--;
+            if (end >= nv) {
+                fprintf(stderr, "Illegal neighbour %d for vertex %d -- exiting!\n", end + 1, i + 1);
+                exit(EXIT_FAILURE);
+            }
+            if (end < i) {
+                inverse = table[end];
+                if (inverse == HE_NONE || ends[inverse] != i) {
+                    fprintf(stderr, "error while looking for edge from %d to %d.\n", end, i);
+                    exit(EXIT_FAILURE);
+                }
+                table[end] = next[inverse^1];
+                e = inverse^1;
+                unpairedEdges--;
+            } else if (loop != HE_NONE && end == i) {
+                e = loop;
+                loop = HE_NONE;
+            } else {
+                if (edgeCounter + 2 > g->ne) {
+                    fprintf(stderr, "Not every edge has an inverse -- exiting!\n");
+                    exit(EXIT_FAILURE);
+                }
+                e = edgeCounter;
+                edgeCounter += 2;
+                ends[e] = end;
+                ends[e^1] = i;
+                if (end > i) {
+                    next[e^1] = table[end];
+                    table[end] = e;
+                    unpairedEdges++;
+                } else {
+                    loop = e^1;
+                }
+            }
+            if (previous == HE_NONE) {
+                first = e;
+            } else {
+                next[previous] = e;
+                prev[e] = previous;
+            }
+            previous = e;
+        }
+        if (loop != HE_NONE) {
+            unpairedEdges++;
+        }
+        g->firstedge[i] = first;
+        if (j > 0) {
+            next[previous] = first;
+            prev[first] = previous;
+        }
+        g->degree[i] = j;
+
+        codePosition++; /* read the closing 0 */
+    }
+
+    if (unpairedEdges || edgeCounter != g->ne) {
+        fprintf(stderr, "Not every edge has an inverse -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+HALFEDGE_GRAPH *decodePlanarCodeViewToHalfEdges(CODE_VIEW *view, HALFEDGE_GRAPH *g, PG_INPUT_OPTIONS *options){
+    int ne = view->entryCount - view->order;
+
+    if(g == NULL){
+        g = newHalfEdgeGraph(view->order, ne);
+    } else {
+        ensureHalfEdgeMemory(g, view->order, ne);
+    }
+    g->nv = view->order;
+    g->ne = ne;
+    g->nf = 0;
+    g->dualComputed = FALSE;
+
+    if(view->shortCode){
+        decodeHalfEdgeEntries(g, view->body, TRUE);
+    } else {
+        decodeHalfEdgeEntries(g, view->body, FALSE);
+    }
+
+    if(options->computeDual){
+        makeHalfEdgeDual(g);
+    }
+
+    return g;
+}
+
+/* The faces are traversed in the same order as by makeDual(), so both layouts
+ * give the same numbering of the faces. The rightface array is used to
+ * recognise the half-edges that have already been visited.
+ */
+void makeHalfEdgeDual(HALFEDGE_GRAPH *g){
+    int i, sz, nf = 0;
+    HE_EDGE e, ex, ef;
+    HE_EDGE *rightface = g->rightface;
+    HE_EDGE *next = g->next;
+    HE_EDGE *prev = g->prev;
+
+    for(i = 0; i < g->ne; i++){
+        rightface[i] = HE_NONE;
+    }
+
+    for(i = 0; i < g->nv; i++){
+        e = ex = g->firstedge[i];
+        if(e == HE_NONE){
+            continue;
+        }
+        do {
+            if(rightface[e] == HE_NONE){
+                g->facestart[nf] = ef = e;
+                sz = 0;
+                do {
+                    rightface[ef] = nf;
+                    ef = prev[ef^1];
+                    ++sz;
+                } while (ef != e);
+                g->faceSize[nf] = sz;
+                ++nf;
+            }
+            e = next[e];
+        } while (e != ex);
+    }
+    g->nf = nf;
+    g->dualComputed = TRUE;
+}
+
+static void writeHalfEdgeEntry(int entry, boolean shortCode, FILE *f){
+    if(shortCode){
+        unsigned short temp = entry;
+        if (fwrite(&temp, sizeof (unsigned short), 1, f) != 1) {
+            fprintf(stderr, "fwrite() failed -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        fputc(entry, f);
+    }
+}
+
+void writeHalfEdgePlanarCode(HALFEDGE_GRAPH *g, FILE *f){
+    static int first = TRUE;
+    int i;
+    HE_EDGE e, elast;
+    boolean shortCode;
+
+    if(first){
+        first = FALSE;
+
+        fprintf(f, ">>planar_code<<");
+    }
+
+    if (g->nv + 1 <= 255) {
+        shortCode = FALSE;
+    } else if (g->nv + 1 <= 65535) {
+        shortCode = TRUE;
+        fputc(0, f);
+    } else {
+        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    //write the number of vertices
+    writeHalfEdgeEntry(g->nv, shortCode, f);
+
+    for(i=0; i<g->nv; i++){
+        e = elast = g->firstedge[i];
+        if(e != HE_NONE){
+            do {
+                writeHalfEdgeEntry(g->end[e] + 1, shortCode, f);
+                e = g->next[e];
+            } while (e != elast);
+        }
+        writeHalfEdgeEntry(0, shortCode, f);
+    }
+}
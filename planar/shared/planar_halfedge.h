@@ -0,0 +1,124 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef PLANAR_HALFEDGE_H
+#define	PLANAR_HALFEDGE_H
+
+#include "planar_base.h"
+#include "planar_input.h"
+#include "../../shared/code_reader.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef int32_t HE_EDGE;
+typedef struct __halfedge_graph HALFEDGE_GRAPH;
+
+#define HE_NONE (-1)
+
+/* A plane graph stored as an array of half-edges instead of an array of
+ * PG_EDGE structs. A half-edge is an index, and the half-edges 2k and 2k+1
+ * are each other's inverse, so the inverse of e is e^1 and is never stored.
+ * The start of e is the end of its inverse.
+ *
+ * Each field of the half-edges is stored in its own array. The arrays end,
+ * next, prev and rightface are used by the traversals (the topology), and the
+ * arrays mark and label are only touched by the algorithms that need them.
+ *
+ * The memory is sized from the graphs that are stored in it, and is reused
+ * (and grown if needed) when the same structure is used for several graphs.
+ */
+struct __halfedge_graph {
+    int nv;
+    int ne;
+    int nf;
+
+    //the number of vertices and half-edges for which memory is allocated
+    int maxn;
+    int maxe;
+
+    //maxe entries: the topology of the half-edges
+    HE_EDGE *end;
+    HE_EDGE *next; /* next half-edge in clockwise direction */
+    HE_EDGE *prev; /* previous half-edge in clockwise direction */
+    //NOTE: only valid if makeHalfEdgeDual() called
+    HE_EDGE *rightface;
+
+    //maxn entries
+    HE_EDGE *firstedge;
+    int *degree;
+
+    //maxe entries (each face contains at least one half-edge)
+    HE_EDGE *facestart;
+    int *faceSize;
+
+    //TRUE if the dual of this graph has been computed
+    boolean dualComputed;
+
+    //maxe entries
+    int *mark;
+    void **label;
+
+    //maxn entries that are used by the decoder to pair each half-edge with
+    //its inverse
+    HE_EDGE *inverseTable;
+};
+
+#define HE_INVERSE(g, e) ((e)^1)
+#define HE_START(g, e) ((g)->end[(e)^1])
+#define HE_END(g, e) ((g)->end[e])
+#define HE_NEXT(g, e) ((g)->next[e])
+#define HE_PREV(g, e) ((g)->prev[e])
+#define HE_RIGHTFACE(g, e) ((g)->rightface[e])
+#define HE_LABEL(g, e) ((g)->label[e])
+
+#define HE_RESETMARKS(g) {int mki; if ((markvalue += 2) > 30000) \
+       { markvalue = 2; for (mki=0;mki<(g)->maxe;++mki) (g)->mark[mki]=0;}}
+#define HE_MARK(g, e) (g)->mark[e] = markvalue
+#define HE_UNMARK(g, e) (g)->mark[e] = markvalue-1
+#define HE_ISMARKED(g, e) ((g)->mark[e] >= markvalue)
+
+/**
+ * Creates a new half-edge graph that can hold graphs with up to maxn vertices
+ * and maxe half-edges without reallocating. Both values may be 0. Exits if
+ * there is insufficient memory.
+ */
+HALFEDGE_GRAPH *newHalfEdgeGraph(int maxn, int maxe);
+
+void freeHalfEdgeGraph(HALFEDGE_GRAPH *g);
+
+/**
+ * Decodes the planar code in the view into g, which may be NULL. Returns the
+ * graph that contains the decoded graph, so the memory is reused when a
+ * stream of graphs is decoded with
+ *
+ *     g = decodePlanarCodeViewToHalfEdges(&view, g, &options);
+ *
+ * Only the option computeDual is used. Parallel edges are paired in the same
+ * way as by decodePlanarCodeView(), and the two occurrences of a loop in the
+ * rotation of its vertex are paired in the order in which they appear.
+ * Exits in case of error.
+ */
+HALFEDGE_GRAPH *decodePlanarCodeViewToHalfEdges(CODE_VIEW *view, HALFEDGE_GRAPH *g, PG_INPUT_OPTIONS *options);
+
+/**
+ * Stores the number of the face on the right of each half-edge in rightface
+ * and a half-edge and the size of each face in facestart and faceSize.
+ */
+void makeHalfEdgeDual(HALFEDGE_GRAPH *g);
+
+void writeHalfEdgePlanarCode(HALFEDGE_GRAPH *g, FILE *f);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PLANAR_HALFEDGE_H */
+
@@ -9,60 +9,149 @@
 #include <stdlib.h>
 #include <string.h>
 
-PLANE_GRAPH *decodePlanarCode(unsigned short* code, PG_INPUT_OPTIONS *options) {
-    int i, j, codePosition, nv, maxn;
-    int edgeCounter = 0;
-    PG_EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
+/* Returns a plane graph that can hold a graph with nv vertices and ne oriented
+ * edges for these options. The given graph is reused if it is large enough
+ * and freed otherwise.
+ */
+static PLANE_GRAPH *ensurePlaneGraph(PLANE_GRAPH *pg, int nv, int ne, PG_INPUT_OPTIONS *options){
+    int maxn, maxe;
     
     if(options->maxn <= 0){
         maxn = nv*options->maxnFactor;
     } else {
         maxn = options->maxn;
     }
+    if(maxn < nv){
+        maxn = nv;
+    }
+    
+    maxe = options->maxe;
+    if(maxe <= 0 || maxe > (6*maxn-12)){
+        maxe = 6*maxn-12;
+    }
+    if(maxe < ne){
+        maxe = ne;
+    }
+    
+    if(pg != NULL){
+        if(pg->maxn >= maxn && pg->maxe >= maxe){
+            return pg;
+        }
+        freePlaneGraph(pg);
+    }
     
-    PLANE_GRAPH *pg = newPlaneGraph(maxn, options->maxe);
-    pg->nv = nv;
+    pg = newPlaneGraph(maxn, maxe);
+    if(pg == NULL){
+        exit(EXIT_FAILURE);
+    }
+    return pg;
+}
 
+/* The entries of the code are given either as bytes or as two-byte numbers.
+ * Each edge to a smaller vertex is paired with its inverse in constant time.
+ * The edges from u to larger vertices v are added to the list of v in the
+ * inverse table. These lists are linked through the inverse field of the
+ * edges, so the edges from u to v form a consecutive block in the list of v,
+ * in the reverse order of the rotation of u. When vertex v is decoded, the
+ * position of u in the inverse table is set to the start of the block of u,
+ * and each edge from v to u takes the next edge from this block.
+ * 
+ * In case of multiple edges the i-th edge from v to u in the rotation of v is
+ * paired with the i-th edge from u to v counted backwards in the rotation of
+ * u. So the inverse of the inverse of an edge is always the edge itself.
+ * Loops have no inverse.
+ */
+static inline void decodeEntries(PLANE_GRAPH *pg, const unsigned char *body, boolean shortCode){
+    int i, j, codePosition = 0, end, nv = pg->nv;
+    PG_EDGE *e, *previous, *pending, *inverse;
+    PG_EDGE **table = pg->inverseTable;
+    PG_EDGE *edges = pg->edges;
+    int edgeCounter = 0;
+    int unpairedEdges = 0;
+    
     for (i = 0; i < nv; i++) {
-        pg->degree[i] = 0;
-        pg->firstedge[i] = pg->edges + edgeCounter;
-        pg->edges[edgeCounter].start = i;
-        pg->edges[edgeCounter].end = code[codePosition] - 1;
-        pg->edges[edgeCounter].next = pg->edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(pg, code[codePosition] - 1, i);
-            pg->edges[edgeCounter].inverse = inverse;
-            inverse->inverse = pg->edges + edgeCounter;
-        } else {
-            pg->edges[edgeCounter].inverse = NULL;
+        table[i] = NULL;
+    }
+
+    for (i = 0; i < nv; i++) {
+        //split the list of edges that end in i into blocks per start vertex
+        pending = table[i];
+        previous = NULL;
+        while(pending != NULL){
+            e = pending;
+            pending = e->inverse;
+            if(previous == NULL || previous->start != e->start){
+                if(previous != NULL){
+                    previous->inverse = NULL;
+                }
+                table[e->start] = e;
+            }
+            previous = e;
         }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            pg->edges[edgeCounter].start = i;
-            pg->edges[edgeCounter].end = code[codePosition] - 1;
-            pg->edges[edgeCounter].prev = pg->edges + edgeCounter - 1;
-            pg->edges[edgeCounter].next = pg->edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(pg, code[codePosition] - 1, i);
-                pg->edges[edgeCounter].inverse = inverse;
-                inverse->inverse = pg->edges + edgeCounter;
+        
+        pg->firstedge[i] = edges + edgeCounter;
+        for (j = 0; (end = shortCode ? codeEntryShort(body, codePosition) :
+                body[codePosition]); j++, codePosition++) {
+            end--;
+            if (end >= nv) {
+                fprintf(stderr, "Illegal neighbour %d for vertex %d -- exiting!\n", end + 1, i + 1);
+                exit(EXIT_FAILURE);
+            }
+            e = edges + edgeCounter;
+            e->start = i;
+            e->end = end;
+            e->index = edgeCounter;
+            e->prev = e - 1;
+            e->next = e + 1;
+            if (end < i) {
+                inverse = table[end];
+                if (inverse == NULL || inverse->start != end || inverse->end != i) {
+                    fprintf(stderr, "error while looking for edge from %d to %d.\n", end, i);
+                    exit(EXIT_FAILURE);
+                }
+                table[end] = inverse->inverse;
+                e->inverse = inverse;
+                inverse->inverse = e;
+                unpairedEdges--;
+            } else if (end > i) {
+                e->inverse = table[end];
+                table[end] = e;
+                unpairedEdges++;
             } else {
-                pg->edges[edgeCounter].inverse = NULL;
+                e->inverse = NULL;
             }
             edgeCounter++;
         }
-        pg->firstedge[i]->prev = pg->edges + edgeCounter - 1;
-        pg->edges[edgeCounter - 1].next = pg->firstedge[i];
+        if (j == 0) {
+            pg->firstedge[i] = NULL;
+        } else {
+            pg->firstedge[i]->prev = edges + edgeCounter - 1;
+            edges[edgeCounter - 1].next = pg->firstedge[i];
+        }
         pg->degree[i] = j;
 
         codePosition++; /* read the closing 0 */
     }
-
+    
+    if (unpairedEdges) {
+        fprintf(stderr, "Not every edge has an inverse -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
     pg->ne = edgeCounter;
+}
+
+PLANE_GRAPH *decodePlanarCodeView(CODE_VIEW *view, PLANE_GRAPH *pg, PG_INPUT_OPTIONS *options) {
+    pg = ensurePlaneGraph(pg, view->order, view->entryCount - view->order, options);
+    pg->nv = view->order;
+    pg->nf = 0;
+    pg->dualComputed = FALSE;
+    
+    if(view->shortCode){
+        decodeEntries(pg, view->body, TRUE);
+    } else {
+        decodeEntries(pg, view->body, FALSE);
+    }
 
     if(options->computeDual){
         makeDual(pg);
@@ -71,6 +160,26 @@ PLANE_GRAPH *decodePlanarCode(unsigned short* code, PG_INPUT_OPTIONS *options) {
     return pg;
 }
 
+PLANE_GRAPH *decodePlanarCode(unsigned short* code, PG_INPUT_OPTIONS *options) {
+    CODE_VIEW view;
+    int zeroCounter = 0;
+    
+    //the entries in the array are two-byte numbers in the byte order of this
+    //machine, which is exactly how a view reads them
+    view.order = code[0];
+    view.shortCode = TRUE;
+    view.body = (const unsigned char *)(code + 1);
+    view.entryCount = 0;
+    while(zeroCounter < view.order){
+        if(code[1 + view.entryCount] == 0){
+            zeroCounter++;
+        }
+        view.entryCount++;
+    }
+    
+    return decodePlanarCodeView(&view, NULL, options);
+}
+
 /**
  * 
  * @param code
@@ -82,7 +191,7 @@ unsigned short *readPlanarCode(FILE *file, PG_INPUT_OPTIONS *options) {
     static boolean first = TRUE;
     unsigned char c;
     char testheader[20];
-    int bufferSize, zeroCounter;
+    int bufferSize = 1, zeroCounter = 0;
     
     int readCount;
     
@@ -9,6 +9,7 @@
 #define	PLANAR_INPUT_H
 
 #include "planar_base.h"
+#include "../../shared/code_reader.h"
 #include<stdio.h>
 
 #ifdef	__cplusplus
@@ -35,6 +36,21 @@ extern "C" {
 
     PLANE_GRAPH *decodePlanarCode(unsigned short* code, PG_INPUT_OPTIONS *options);
 
+    /**
+     * Decodes the planar code in the view. The given plane graph is reused if
+     * it can hold the graph, and otherwise it is freed and a new plane graph
+     * is returned, so the memory is reused when a stream of graphs is decoded
+     * with
+     * 
+     *     pg = decodePlanarCodeView(&view, pg, &options);
+     * 
+     * The plane graph may be NULL. The index of each edge is set to its
+     * position in the array of edges. Parallel edges are paired in reverse
+     * order: the i-th edge from v to u is the inverse of the i-th edge from u
+     * to v counted backwards. Exits in case of error.
+     */
+    PLANE_GRAPH *decodePlanarCodeView(CODE_VIEW *view, PLANE_GRAPH *pg, PG_INPUT_OPTIONS *options);
+
     unsigned short *readPlanarCode(FILE *file, PG_INPUT_OPTIONS *options);
     
     PLANE_GRAPH *readAndDecodePlanarCode(FILE *f, PG_INPUT_OPTIONS *options);
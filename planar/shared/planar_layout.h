@@ -0,0 +1,75 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Accessors that hide how the edges of a plane graph are stored. Code that
+ * only uses these macros compiles against the PG_EDGE structs of PLANE_GRAPH
+ * by default, and against the half-edge arrays of HALFEDGE_GRAPH when
+ * PLANAR_HALFEDGE_LAYOUT is defined before this file is included.
+ */
+
+#ifndef PLANAR_LAYOUT_H
+#define	PLANAR_LAYOUT_H
+
+#include "planar_base.h"
+#include "planar_input.h"
+#include "planar_output.h"
+
+#ifdef PLANAR_HALFEDGE_LAYOUT
+
+#include "planar_halfedge.h"
+
+typedef HALFEDGE_GRAPH PL_GRAPH;
+typedef HE_EDGE PL_EDGE;
+
+#define PL_NO_EDGE HE_NONE
+
+#define PL_START(g, e) HE_START(g, e)
+#define PL_END(g, e) HE_END(g, e)
+#define PL_NEXT(g, e) HE_NEXT(g, e)
+#define PL_PREV(g, e) HE_PREV(g, e)
+#define PL_INVERSE(g, e) HE_INVERSE(g, e)
+#define PL_RIGHTFACE(g, e) HE_RIGHTFACE(g, e)
+#define PL_LABEL(g, e) HE_LABEL(g, e)
+
+#define PL_DECODE(view, g, options) decodePlanarCodeViewToHalfEdges(view, g, options)
+#define PL_MAKE_DUAL(g) makeHalfEdgeDual(g)
+#define PL_WRITE_PLANAR_CODE(g, f) writeHalfEdgePlanarCode(g, f)
+#define PL_FREE(g) freeHalfEdgeGraph(g)
+
+#else
+
+typedef PLANE_GRAPH PL_GRAPH;
+typedef PG_EDGE *PL_EDGE;
+
+#define PL_NO_EDGE NULL
+
+#define PL_START(g, e) ((e)->start)
+#define PL_END(g, e) ((e)->end)
+#define PL_NEXT(g, e) ((e)->next)
+#define PL_PREV(g, e) ((e)->prev)
+#define PL_INVERSE(g, e) ((e)->inverse)
+#define PL_RIGHTFACE(g, e) ((e)->rightface)
+#define PL_LABEL(g, e) ((e)->label)
+
+#define PL_DECODE(view, g, options) decodePlanarCodeView(view, g, options)
+#define PL_MAKE_DUAL(g) makeDual(g)
+#define PL_WRITE_PLANAR_CODE(g, f) writePlanarCode(g, f)
+#define PL_FREE(g) freePlaneGraph(g)
+
+#endif
+
+//both layouts use the same names for the vertex and face arrays
+#define PL_ORDER(g) ((g)->nv)
+#define PL_EDGE_COUNT(g) ((g)->ne)
+#define PL_FACE_COUNT(g) ((g)->nf)
+#define PL_DEGREE(g, v) ((g)->degree[v])
+#define PL_FIRSTEDGE(g, v) ((g)->firstedge[v])
+#define PL_FACESIZE(g, f) ((g)->faceSize[f])
+#define PL_FACESTART(g, f) ((g)->facestart[f])
+
+#endif	/* PLANAR_LAYOUT_H */
+
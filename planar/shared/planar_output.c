@@ -33,7 +33,7 @@ void writePlanarCodeShort(PLANE_GRAPH *pg, FILE *f){
     //write the number of vertices
     fputc(0, f);
     temp = pg->nv;
-    if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
+    if (fwrite(&temp, sizeof (unsigned short), 1, f) != 1) {
         fprintf(stderr, "fwrite() failed -- exiting!\n");
         exit(EXIT_FAILURE);
     }
@@ -0,0 +1,119 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* The choice of the edges from which the canonical certificates of a plane
+ * graph are constructed. The functions only use the accessors of
+ * planar_layout.h, so they work for the layout that was selected before that
+ * file was first included.
+ */
+
+#ifndef PLANAR_STARTING_EDGES_H
+#define	PLANAR_STARTING_EDGES_H
+
+#include "planar_layout.h"
+
+/* Returns the smallest value in 0..maxValue with the lowest nonzero
+ * frequency, or -1 if all frequencies are zero.
+ */
+static inline int smallestRarestValue(const int *frequencies, int maxValue){
+    int i, value = -1, minimumFrequency = 0;
+
+    for(i = 0; i <= maxValue; i++){
+        if(frequencies[i] && (value == -1 || frequencies[i] < minimumFrequency)){
+            value = i;
+            minimumFrequency = frequencies[i];
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Stores the starting edges of pg in orientationPreserving and
+ * orientationReversing and their numbers in the corresponding counts. The
+ * starting edges start in a vertex with the rarest degree, have a face with
+ * the rarest size among those at such vertices on their right (on their left
+ * for the orientation reversing edges) and end in a vertex with the rarest
+ * degree among those edges. An automorphism maps the first orientation
+ * preserving starting edge to one of the starting edges.
+ *
+ * The dual of pg has to be computed. Both edge arrays need room for
+ * PL_EDGE_COUNT(pg) edges and frequencies for PL_EDGE_COUNT(pg) + 1 values.
+ */
+static inline void findPlanarStartingEdges(PL_GRAPH *pg, int *frequencies,
+        PL_EDGE *orientationPreserving, int *orientationPreservingCount,
+        PL_EDGE *orientationReversing, int *orientationReversingCount){
+    int i, startingDegree, startingFaceSize, startingEndDegree;
+    PL_EDGE start, edge;
+
+    *orientationPreservingCount = 0;
+    *orientationReversingCount = 0;
+
+    //the smallest degree with the lowest frequency
+    for(i = 0; i <= PL_EDGE_COUNT(pg); i++){
+        frequencies[i] = 0;
+    }
+    for(i = 0; i < PL_ORDER(pg); i++){
+        frequencies[PL_DEGREE(pg, i)]++;
+    }
+    startingDegree = smallestRarestValue(frequencies, PL_EDGE_COUNT(pg));
+
+    //the rarest face size incident with a vertex of startingDegree
+    for(i = 0; i <= PL_EDGE_COUNT(pg); i++){
+        frequencies[i] = 0;
+    }
+    for(i = 0; i < PL_ORDER(pg); i++){
+        if(PL_DEGREE(pg, i) == startingDegree){
+            start = edge = PL_FIRSTEDGE(pg, i);
+
+            do {
+                frequencies[PL_FACESIZE(pg, PL_RIGHTFACE(pg, edge))]++;
+                edge = PL_NEXT(pg, edge);
+            } while (start != edge);
+        }
+    }
+    startingFaceSize = smallestRarestValue(frequencies, PL_EDGE_COUNT(pg));
+
+    //the rarest degree at the other end of the edges with that face on the right
+    for(i = 0; i <= PL_EDGE_COUNT(pg); i++){
+        frequencies[i] = 0;
+    }
+    for(i = 0; i < PL_ORDER(pg); i++){
+        if(PL_DEGREE(pg, i) == startingDegree){
+            start = edge = PL_FIRSTEDGE(pg, i);
+
+            do {
+                if(PL_FACESIZE(pg, PL_RIGHTFACE(pg, edge)) == startingFaceSize){
+                    frequencies[PL_DEGREE(pg, PL_END(pg, edge))]++;
+                }
+                edge = PL_NEXT(pg, edge);
+            } while (start != edge);
+        }
+    }
+    startingEndDegree = smallestRarestValue(frequencies, PL_EDGE_COUNT(pg));
+
+    //a mirror image has the face with startingFaceSize on its left
+    for(i = 0; i < PL_ORDER(pg); i++){
+        if(PL_DEGREE(pg, i) == startingDegree){
+            start = edge = PL_FIRSTEDGE(pg, i);
+
+            do {
+                if(PL_FACESIZE(pg, PL_RIGHTFACE(pg, edge)) == startingFaceSize){
+                    if(PL_DEGREE(pg, PL_END(pg, edge)) == startingEndDegree){
+                        orientationPreserving[(*orientationPreservingCount)++] = edge;
+                    }
+                    if(PL_DEGREE(pg, PL_END(pg, PL_NEXT(pg, edge))) == startingEndDegree){
+                        orientationReversing[(*orientationReversingCount)++] = PL_NEXT(pg, edge);
+                    }
+                }
+                edge = PL_NEXT(pg, edge);
+            } while (start != edge);
+        }
+    }
+}
+
+#endif	/* PLANAR_STARTING_EDGES_H */
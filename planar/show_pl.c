@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o show_pl -O4 show_pl.c shared/planar_base.c shared/planar_input.c
+ *     cc -o show_pl -O4 show_pl.c shared/planar_base.c shared/planar_input.c \
+ *         ../shared/code_reader.c
  * 
  */
 
@@ -40,19 +41,19 @@ void printAdjacencyList(PLANE_GRAPH *pg){
     fprintf(stdout, "\n");
 }
 
-void printCode(unsigned short* code) {
+void printCode(CODE_VIEW *view) {
     int i, j, codePosition;
 
-    int nv = code[0];
-    codePosition = 1;
+    int nv = view->order;
+    codePosition = 0;
     
     fprintf(stdout, "%d\n", nv);
 
     for (i = 0; i < nv; i++) {
-        fprintf(stdout, "%d ", code[codePosition]);
+        fprintf(stdout, "%d ", CODE_ENTRY(view, codePosition));
         codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            fprintf(stdout, "%d ", code[codePosition]);
+        for (j = 1; CODE_ENTRY(view, codePosition); j++, codePosition++) {
+            fprintf(stdout, "%d ", CODE_ENTRY(view, codePosition));
         }
         fprintf(stdout, "0\n");
         codePosition++; /* read the closing 0 */
@@ -110,19 +111,23 @@ int main(int argc, char** argv) {
         }
     }
     
-    unsigned short *code;
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    PLANE_GRAPH *pg = NULL;
     DEFAULT_PG_INPUT_OPTIONS(options);
-    while ((code = readPlanarCode(stdin, &options))) {
+    while (nextCode(reader, &view)) {
         if(showCode){
-            printCode(code);
+            printCode(&view);
         } else {
-            PLANE_GRAPH *pg = decodePlanarCode(code, &options);
+            pg = decodePlanarCodeView(&view, pg, &options);
             printAdjacencyList(pg);
-            freePlaneGraph(pg);
         }
-        free(code);
         graphsRead++;
     }
+    if(pg != NULL){
+        freePlaneGraph(pg);
+    }
+    freeCodeReader(reader);
     
     fprintf(stderr, "Read %d graph%s.\n", graphsRead, graphsRead==1 ? "" : "s");
 
@@ -11,7 +11,8 @@
  * 
  * Compile with:
  *     
- *     cc -o split_pl -O4 split_pl.c
+ *     cc -o split_pl -O4 split_pl.c \
+ *     ../shared/code_reader.c ../shared/code_index.c
  * 
  */
 
@@ -20,16 +21,7 @@
 #include <getopt.h>
 #include <string.h>
 
-
-#ifndef MAXN
-#define MAXN 200            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
+#include "../shared/code_index.h"
 
 #undef FALSE
 #undef TRUE
@@ -44,156 +36,17 @@ boolean onePerFile = FALSE;
 
 char *extension = "code";
 
-//=============== Reading and decoding planarcode ===========================
-
-/**
- * 
- * @param code
- * @param length
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
- */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
-    
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
-            }
-        }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
-    }
-
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
-        }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
-    }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
-        }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
-            }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    }
-
-    *length = bufferSize;
-    
-    
-    
-    return (1);
+boolean consecutive = FALSE;
 
+char *indexedFileName = NULL;
 
-}
+//=============== Writing planarcode ===========================
 
-void writePlanarCode(unsigned short code[], int length, FILE *outFile, boolean withHeader){
-    int i;
-    if(withHeader){
-        fprintf(outFile, ">>planar_code<<");
-    }
+void writeIndexedGraph(CODE_INDEX *index, unsigned long long i, FILE *outFile, boolean withHeader){
+    CODE_VIEW view;
     
-    if(code[0]+1 <= 255) {
-        for(i=0; i<length; i++){
-             fputc(code[i], outFile);
-        }
-    } else if(code[0]+1 <= 65535) {
-        fputc(0, outFile);
-        for(i=0; i<length; i++){
-             if (fwrite(code+i, sizeof (unsigned short), 1, outFile) != 1) {
-                fprintf(stderr, "fwrite() failed -- exiting!\n");
-                exit(-1);
-            }
-        }
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
-    }
+    codeIndexView(index, i, &view);
+    writeCodeView(&view, withHeader ? PLANARCODE_HEADER : NULL, outFile);
 }
 
 //====================== USAGE =======================
@@ -202,8 +55,7 @@ void help(char *name) {
     fprintf(stderr, "The program %s splits the given graphs over a given number of files.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n", MAXN);
-    fprintf(stderr, "Recompile with a larger value for MAXN if you need larger graphs.\n\n");
+    fprintf(stderr, "\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, " -h, --help\n");
     fprintf(stderr, "    Print this help and return.\n");
@@ -211,6 +63,12 @@ void help(char *name) {
     fprintf(stderr, "    Split this file such that each file contains only one graph.\n");
     fprintf(stderr, " -e, --extension\n");
     fprintf(stderr, "    Specify the extension of the new files. Defaults to code.\n");
+    fprintf(stderr, " -I, --indexed file\n");
+    fprintf(stderr, "    Read the graphs from the specified file instead of from stdin. The file\n");
+    fprintf(stderr, "    needs an index (see index_pl). The codes are copied directly from the file.\n");
+    fprintf(stderr, " -c, --consecutive\n");
+    fprintf(stderr, "    Put consecutive graphs in the same file instead of distributing the graphs\n");
+    fprintf(stderr, "    in turn over the files. Requires the option -I.\n");
 }
 
 void usage(char *name) {
@@ -228,11 +86,13 @@ int main(int argc, char *argv[]) {
     static struct option long_options[] = {
         {"one-per-file", no_argument, NULL, '1'},
         {"extension", required_argument, NULL, 'e'},
+        {"indexed", required_argument, NULL, 'I'},
+        {"consecutive", no_argument, NULL, 'c'},
         {"help", no_argument, NULL, 'h'}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "h1e:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "h1e:I:c", long_options, &option_index)) != -1) {
         switch (c) {
             case 0:
                 break;
@@ -245,6 +105,12 @@ int main(int argc, char *argv[]) {
             case 'e':
                 extension = optarg;
                 break;
+            case 'I':
+                indexedFileName = optarg;
+                break;
+            case 'c':
+                consecutive = TRUE;
+                break;
             case '?':
                 usage(name);
                 return EXIT_FAILURE;
@@ -267,16 +133,47 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    if(onePerFile){
+    if(consecutive && (indexedFileName == NULL || onePerFile)){
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    
+    CODE_INDEX *index = NULL;
+    if(indexedFileName != NULL){
+        index = openPlanarCodeIndex(indexedFileName, NULL);
+        if(index == NULL){
+            fprintf(stderr, "No index found for %s (see index_pl) -- exiting!\n", indexedFileName);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if(onePerFile && index != NULL){
+        char *fileNameBase = argv[optind];
+        char fileName[100];
+        unsigned long long i;
+        
+        for (i = 0; i < codeIndexSize(index); i++) {
+            numberOfGraphs++;
+            int n = snprintf(fileName, 100, "%s-%d.%s", fileNameBase, numberOfGraphs, extension);
+            if (n<0 || n>=100){
+                fprintf(stderr, "Filename could not be constructed -- exiting.\n");
+                return EXIT_FAILURE;
+            }
+            FILE *f = fopen(fileName, "w");
+            writeIndexedGraph(index, i, f, TRUE);
+            
+            fclose(f);
+        }
+    } else if(onePerFile){
         char *fileNameBase = argv[optind];
         char fileName[100];
         
 
         /*=========== read planar graphs ===========*/
 
-        unsigned short code[MAXCODELENGTH];
-        int length;
-        while (readPlanarCode(code, &length, stdin)) {
+        CODE_READER *reader = newPlanarCodeReader(stdin);
+        CODE_VIEW view;
+        while (nextCode(reader, &view)) {
             numberOfGraphs++;
             int n = snprintf(fileName, 100, "%s-%d.%s", fileNameBase, numberOfGraphs, extension);
             if (n<0 || n>=100){
@@ -284,10 +181,11 @@ int main(int argc, char *argv[]) {
                 return EXIT_FAILURE;
             }
             FILE *f = fopen(fileName, "w");
-            writePlanarCode(code, length, f, TRUE);
+            writeCodeView(&view, PLANARCODE_HEADER, f);
             
             fclose(f);
         }
+        freeCodeReader(reader);
     } else {
         int i;
         
@@ -306,17 +204,39 @@ int main(int argc, char *argv[]) {
             files[i] = f;
         }
 
-        /*=========== read planar graphs ===========*/
+        if(index != NULL){
+            unsigned long long j, end;
+            
+            for (i = 0; i < fileCount; i++){
+                if(consecutive){
+                    codeIndexShard(index, i, fileCount, &j, &end);
+                    for (; j < end; j++){
+                        writeIndexedGraph(index, j, files[i], FALSE);
+                    }
+                } else {
+                    for (j = i; j < codeIndexSize(index); j += fileCount){
+                        writeIndexedGraph(index, j, files[i], FALSE);
+                    }
+                }
+            }
+        } else {
+            /*=========== read planar graphs ===========*/
 
-        unsigned short code[MAXCODELENGTH];
-        int length;
-        while (readPlanarCode(code, &length, stdin)) {
-            writePlanarCode(code, length, files[numberOfGraphs%fileCount], FALSE);
-            numberOfGraphs++;
+            CODE_READER *reader = newPlanarCodeReader(stdin);
+            CODE_VIEW view;
+            while (nextCode(reader, &view)) {
+                writeCodeView(&view, NULL, files[numberOfGraphs%fileCount]);
+                numberOfGraphs++;
+            }
+            freeCodeReader(reader);
         }
 
         for (i = 0; i < fileCount; i++){
             fclose(files[i]);
         }
     }
+    
+    if(index != NULL){
+        closeCodeIndex(index);
+    }
 }
@@ -11,7 +11,9 @@
  * 
  * Compile with:
  *     
- *     cc -o stats_pl -O4 stats_pl.c
+ *     cc -o stats_pl -O4 stats_pl.c shared/planar_base.c \
+ *         shared/planar_input.c shared/planar_output.c ../shared/code_reader.c \
+ *         -pthread
  * 
  */
 
@@ -19,63 +21,31 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
+#include "shared/planar_base.h"
+#include "shared/planar_input.h"
+#include "shared/planar_output.h"
+#include "shared/planar_starting_edges.h"
+#include "../shared/code_reader.h"
 
-#ifndef MAXN
-#define MAXN 64            /* the maximum number of vertices */
-#endif
-#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
-#define MAXF (2*MAXN-4)      /* the maximum number of faces */
-#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
-#define MAXCODELENGTH (MAXN+MAXE+3)
-
-#define INFI (MAXN + 1)
-
-typedef int boolean;
-
-#undef FALSE
-#undef TRUE
-#define FALSE 0
-#define TRUE  1
-
-typedef struct e /* The data type used for edges */ {
-    int start; /* vertex where the edge starts */
-    int end; /* vertex where the edge ends */
-    int rightface; /* face on the right side of the edge
-                          note: only valid if make_dual() called */
-    struct e *prev; /* previous edge in clockwise direction */
-    struct e *next; /* next edge in clockwise direction */
-    struct e *inverse; /* the edge that is inverse to this one */
-    int mark, index; /* two ints for temporary use;
-                          Only access mark via the MARK macros. */
-
-    int left_facesize; /* size of the face in prev-direction of the edge.
-        		  Only used for -p option. */
-} EDGE;
-
-EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
-int degree[MAXN];
-
-EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
-int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
-
-EDGE edges[MAXE];
-
-static int markvalue = 30000;
-#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
-       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
-#define MARK(e) (e)->mark = markvalue
-#define MARKLO(e) (e)->mark = markvalue
-#define MARKHI(e) (e)->mark = markvalue+1
-#define UNMARK(e) (e)->mark = markvalue-1
-#define ISMARKED(e) ((e)->mark >= markvalue)
-#define ISMARKEDLO(e) ((e)->mark == markvalue)
-#define ISMARKEDHI(e) ((e)->mark > markvalue)
+/* Everything that describes the graph which is currently handled is thread
+ * local, so that with option -j every worker has its own graph and buffers.
+ */
+#define THREADLOCAL __thread
+
+THREADLOCAL PLANE_GRAPH *pg = NULL;
+
+//the report of the current graph is written to this file
+THREADLOCAL FILE *reportFile = NULL;
+THREADLOCAL int graphNumber;
 
 int filterEnabled = FALSE;
 int filterOnly = 0;
 
 int includeSummary = FALSE;
+int summaryOnly = FALSE;
 int includeNumbering = FALSE;
 int latex = FALSE;
 
@@ -90,110 +60,190 @@ boolean edgeOrbitInfo = FALSE;
 boolean faceOrbitInfo = FALSE;
 boolean groupedOutput = FALSE;
 
-int vertexOrbits[MAXN];
-int vertexOrbitsSize[MAXN];
-int vertexOrbitCount;
+THREADLOCAL int *vertexOrbits = NULL;
+THREADLOCAL int *vertexOrbitsSize = NULL;
+THREADLOCAL int vertexOrbitCount;
 
 typedef int VERTEXPAIR[2];
-VERTEXPAIR undirectedEdges[MAXE/2];
-int edgeOrbits[MAXE/2];
-int edgeOrbitsSize[MAXE/2];
-int edgeOrbitCount;
+THREADLOCAL VERTEXPAIR *undirectedEdges = NULL;
+//the position in undirectedEdges of each oriented edge from a smaller to a larger vertex
+THREADLOCAL int *undirectedEdgeIndex = NULL;
+THREADLOCAL int *edgeOrbits = NULL;
+THREADLOCAL int *edgeOrbitsSize = NULL;
+THREADLOCAL int edgeOrbitCount;
+
+THREADLOCAL int *faceOrbits = NULL;
+THREADLOCAL int *faceOrbitsSize = NULL;
+THREADLOCAL int faceOrbitCount;
+
+//frequency table for degrees and face sizes
+THREADLOCAL int *valueFrequency = NULL;
+
+//the images of the vertices and the edges under an automorphism
+THREADLOCAL int *vertexImages = NULL;
+THREADLOCAL PG_EDGE **edgeImages = NULL;
+
+//the number of vertices, oriented edges and faces for which the buffers above
+//have room
+THREADLOCAL int statisticsVerticesCapacity = 0;
+THREADLOCAL int statisticsEdgesCapacity = 0;
+THREADLOCAL int statisticsFacesCapacity = 0;
+
+/* Each automorphism is stored as the starting edge that it maps to the first
+ * edge of the canonical certificate. This edge and the orientation determine
+ * the automorphism, and the images of the vertices are only computed when
+ * they are needed.
+ */
+THREADLOCAL PG_EDGE **automorphismEdges = NULL;
+THREADLOCAL int automorphismEdgesCapacity = 0; //the number of automorphisms for which there is room
+THREADLOCAL PG_EDGE *canonicalStartingEdge;
 
-int faceOrbits[MAXN];
-int faceOrbitsSize[MAXN];
-int faceOrbitCount;
+THREADLOCAL int automorphismsCount;
+THREADLOCAL int orientationPreservingAutomorphismsCount;
+THREADLOCAL int orientationReversingAutomorphismsCount;
 
-int nv;
-int ne;
-int nf;
+//////////////////////////////////////////////////////////////////////////////
 
-int automorphisms[2*MAXE][MAXN]; //there are at most 2e automorphisms (e = #arcs)
-int automorphismsCount;
-int orientationPreservingAutomorphismsCount;
-int orientationReversingAutomorphismsCount;
+THREADLOCAL int *certificate = NULL;
+THREADLOCAL int *canonicalLabelling = NULL;
+THREADLOCAL PG_EDGE **canonicalFirstedge = NULL;
+THREADLOCAL int *alternateLabelling = NULL;
+THREADLOCAL PG_EDGE **alternateFirstedge = NULL;
+THREADLOCAL int *queue = NULL;
+THREADLOCAL boolean hasChiralGroup;
 
-//////////////////////////////////////////////////////////////////////////////
+THREADLOCAL PG_EDGE **orientationPreservingStartingEdges = NULL;
+THREADLOCAL PG_EDGE **orientationReversingStartingEdges = NULL;
+THREADLOCAL int orientationPreservingStartingEdgesCount;
+THREADLOCAL int orientationReversingStartingEdgesCount;
 
-int certificate[MAXE+MAXN];
-int canonicalLabelling[MAXN];
-int reverseCanonicalLabelling[MAXN];
-EDGE *canonicalFirstedge[MAXN];
-int alternateLabelling[MAXN];
-EDGE *alternateFirstedge[MAXN];
-int queue[MAXN];
-boolean hasChiralGroup;
-
-EDGE *orientationPreservingStartingEdges[MAXE];
-EDGE *orientationReversingStartingEdges[MAXE];
-int startingEdgesCount; //the number of starting edges is always the same for both orientations
-
-void findStartingEdges(){
-    int i, startingDegree, startingFaceSize, minimumFrequency;
-    int degreeFrequency[MAXN] = {0};
-    int faceSizeFrequency[MAXN] = {0};
-    EDGE *start, *edge;
-    
-    startingEdgesCount = 0;
-    
-    //build the degree frequency table
-    for(i = 0; i < nv; i++){
-        degreeFrequency[degree[i]]++;
+THREADLOCAL int *frequencies = NULL;
+
+THREADLOCAL int verticesCapacity = 0; //the number of vertices for which there is room
+THREADLOCAL int edgesCapacity = 0; //the number of oriented edges for which there is room
+
+void *resizeBuffer(void *buffer, size_t size){
+    buffer = realloc(buffer, size);
+    if(buffer == NULL && size > 0){
+        fprintf(stderr, "Insufficient memory for the automorphism buffers -- exiting!\n");
+        exit(EXIT_FAILURE);
     }
-    
-    //find the smallest degree with the lowest frequency
-    minimumFrequency = MAXN;
-    for(i = 0; i < MAXN; i++){
-        if(degreeFrequency[i] && degreeFrequency[i] < minimumFrequency){
-            startingDegree = i;
-            minimumFrequency = degreeFrequency[i];
-        }
+    return buffer;
+}
+
+/* Makes sure that there is room to store the automorphism with index
+ * automorphismsCount. There are at most 2e automorphisms (e = #arcs), but
+ * most graphs have far less, so the room is doubled when needed.
+ */
+void growAutomorphisms(){
+    if(automorphismsCount < automorphismEdgesCapacity){
+        return;
     }
+    automorphismEdgesCapacity = automorphismEdgesCapacity ? 2*automorphismEdgesCapacity : 16;
+    automorphismEdges = resizeBuffer(automorphismEdges, automorphismEdgesCapacity*sizeof(PG_EDGE *));
+}
+
+/* Stores the image of each vertex under the automorphism with index i in
+ * images, and the image of each edge in edgeImages if it is not NULL. Both
+ * starting edges are followed in parallel: the rotations are followed in the
+ * same direction if the automorphism preserves the orientation, and in
+ * opposite directions otherwise.
+ */
+void expandAutomorphism(int i, int *images, PG_EDGE **edgeImages){
+    int j;
+    PG_EDGE *e, *elast, *image;
+    boolean reversing = (i >= orientationPreservingAutomorphismsCount);
+    int head = 1;
+    int tail = 0;
     
-    //build the frequency table of face sizes incident to a vertex with startingDegree
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                faceSizeFrequency[faceSize[edge->rightface]]++;
-                edge = edge->next;
-            } while (start != edge);
-        }
+    for(j = 0; j < pg->nv; j++){
+        images[j] = pg->nv;
+    }
+    e = automorphismEdges[i];
+    queue[0] = e->start;
+    //the first edges of a vertex and of its image
+    alternateFirstedge[e->start] = e;
+    canonicalFirstedge[e->start] = canonicalStartingEdge;
+    images[e->start] = canonicalStartingEdge->start;
+    while(head>tail){
+        int currentVertex = queue[tail++];
+        e = elast = alternateFirstedge[currentVertex];
+        image = canonicalFirstedge[currentVertex];
+        do {
+            if(images[e->end]==pg->nv){
+                queue[head++] = e->end;
+                images[e->end] = image->end;
+                alternateFirstedge[e->end] = e->inverse;
+                canonicalFirstedge[e->end] = image->inverse;
+            }
+            if(edgeImages != NULL){
+                edgeImages[e->index] = image;
+            }
+            e = e->next;
+            image = reversing ? image->prev : image->next;
+        } while (e!=elast);
     }
-    
-    //find the smallest face size incident with a vertex of startingDegree and with smallest frequency
-    minimumFrequency = MAXE;
-    for(i = 0; i < MAXN; i++){
-        if(faceSizeFrequency[i] && faceSizeFrequency[i] < minimumFrequency){
-            startingFaceSize = i;
-            minimumFrequency = faceSizeFrequency[i];
-        }
+}
+
+/* Makes sure that the buffers for the certificates can hold the current graph.
+ * The buffers only grow, so they are reused for all graphs that are read.
+ */
+void growCertificateBuffers(){
+    if(pg->nv <= verticesCapacity && pg->ne <= edgesCapacity){
+        return;
     }
-    
-    //store all starting edges
-    for(i = 0; i < nv; i++){
-        if(degree[i] == startingDegree){
-            start = edge = firstedge[i];
-            
-            do {
-                if(faceSize[edge->rightface] == startingFaceSize){
-                    orientationPreservingStartingEdges[startingEdgesCount] = edge;
-                    orientationReversingStartingEdges[startingEdgesCount] = edge->next;
-                    startingEdgesCount++;
-                }
-                edge = edge->next;
-            } while (start != edge);
-        }
+    if(pg->nv > verticesCapacity){
+        verticesCapacity = pg->nv;
+    }
+    if(pg->ne > edgesCapacity){
+        edgesCapacity = pg->ne;
+    }
+    certificate = resizeBuffer(certificate, (edgesCapacity + verticesCapacity)*sizeof(int));
+    canonicalLabelling = resizeBuffer(canonicalLabelling, verticesCapacity*sizeof(int));
+    canonicalFirstedge = resizeBuffer(canonicalFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    alternateLabelling = resizeBuffer(alternateLabelling, verticesCapacity*sizeof(int));
+    alternateFirstedge = resizeBuffer(alternateFirstedge, verticesCapacity*sizeof(PG_EDGE *));
+    queue = resizeBuffer(queue, verticesCapacity*sizeof(int));
+    orientationPreservingStartingEdges = resizeBuffer(orientationPreservingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    orientationReversingStartingEdges = resizeBuffer(orientationReversingStartingEdges,
+            edgesCapacity*sizeof(PG_EDGE *));
+    //degrees and face sizes are at most the number of oriented edges
+    frequencies = resizeBuffer(frequencies, (edgesCapacity + 1)*sizeof(int));
+}
+
+/* Makes sure that the buffers for the statistics can hold the current graph.
+ */
+void growStatisticsBuffers(){
+    if(pg->nv > statisticsVerticesCapacity){
+        statisticsVerticesCapacity = pg->nv;
+        vertexOrbits = resizeBuffer(vertexOrbits, statisticsVerticesCapacity*sizeof(int));
+        vertexOrbitsSize = resizeBuffer(vertexOrbitsSize, statisticsVerticesCapacity*sizeof(int));
+        vertexImages = resizeBuffer(vertexImages, statisticsVerticesCapacity*sizeof(int));
+    }
+    if(pg->ne > statisticsEdgesCapacity){
+        statisticsEdgesCapacity = pg->ne;
+        undirectedEdges = resizeBuffer(undirectedEdges, (statisticsEdgesCapacity/2)*sizeof(VERTEXPAIR));
+        edgeOrbits = resizeBuffer(edgeOrbits, (statisticsEdgesCapacity/2)*sizeof(int));
+        edgeOrbitsSize = resizeBuffer(edgeOrbitsSize, (statisticsEdgesCapacity/2)*sizeof(int));
+        undirectedEdgeIndex = resizeBuffer(undirectedEdgeIndex, statisticsEdgesCapacity*sizeof(int));
+        edgeImages = resizeBuffer(edgeImages, statisticsEdgesCapacity*sizeof(PG_EDGE *));
+        //degrees and face sizes are at most the number of oriented edges
+        valueFrequency = resizeBuffer(valueFrequency, statisticsEdgesCapacity*sizeof(int));
+    }
+    if(pg->nf > statisticsFacesCapacity){
+        statisticsFacesCapacity = pg->nf;
+        faceOrbits = resizeBuffer(faceOrbits, statisticsFacesCapacity*sizeof(int));
+        faceOrbitsSize = resizeBuffer(faceOrbitsSize, statisticsFacesCapacity*sizeof(int));
     }
 }
 
-void constructCertificate(EDGE *eStart){
+void constructCertificate(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -205,7 +255,7 @@ void constructCertificate(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -213,19 +263,17 @@ void constructCertificate(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->next;
         } while (e!=elast);
-        certificate[position++] = MAXN;
-    }
-    for(i = 0; i < nv; i++){
-        reverseCanonicalLabelling[canonicalLabelling[i]] = i;
+        certificate[position++] = pg->nv;
     }
+    canonicalStartingEdge = eStart;
 }
 
-void constructCertificateOrientationReversed(EDGE *eStart){
+void constructCertificateOrientationReversed(PG_EDGE *eStart){
     int i;
-    for(i=0; i<MAXN; i++){
-        canonicalLabelling[i] = MAXN;
+    for(i=0; i<pg->nv; i++){
+        canonicalLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -237,7 +285,7 @@ void constructCertificateOrientationReversed(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = canonicalFirstedge[currentVertex];
         do {
-            if(canonicalLabelling[e->end]==MAXN){
+            if(canonicalLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 canonicalLabelling[e->end] = vertexCounter++;
                 canonicalFirstedge[e->end] = e->inverse;
@@ -245,23 +293,21 @@ void constructCertificateOrientationReversed(EDGE *eStart){
             certificate[position++] = canonicalLabelling[e->end];
             e = e->prev;
         } while (e!=elast);
-        certificate[position++] = MAXN;
-    }
-    for(i = 0; i < nv; i++){
-       reverseCanonicalLabelling[canonicalLabelling[i]] = i;
+        certificate[position++] = pg->nv;
     }
+    canonicalStartingEdge = eStart;
 }
 
 /* returns 1 if this edge leads to a better certificate
  * returns 0 if this edge leads to the same certificate
  * returns -1 if this edge leads to a worse certificate
  */
-int hasBetterCertificateOrientationPreserving(EDGE *eStart){
-    int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+int hasBetterCertificateOrientationPreserving(PG_EDGE *eStart){
+    int i;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -273,7 +319,7 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -289,29 +335,25 @@ int hasBetterCertificateOrientationPreserving(EDGE *eStart){
             currentPos++;
             e = e->next;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    if(needAutomorphisms){
-        for(j = 0; j < nv; j++){
-            automorphisms[automorphismsCount][j] 
-                    = reverseCanonicalLabelling[alternateLabelling[j]];
-        }
-    }
+    growAutomorphisms();
+    automorphismEdges[automorphismsCount] = eStart;
     automorphismsCount++;
     orientationPreservingAutomorphismsCount++;
     return 0;
 }
 
-int hasBetterCertificateOrientationReversing(EDGE *eStart){
-    int i, j;
-    for(i=0; i<MAXN; i++){
-        alternateLabelling[i] = MAXN;
+int hasBetterCertificateOrientationReversing(PG_EDGE *eStart){
+    int i;
+    for(i=0; i<pg->nv; i++){
+        alternateLabelling[i] = pg->nv;
     }
-    EDGE *e, *elast;
+    PG_EDGE *e, *elast;
     int head = 1;
     int tail = 0;
     int vertexCounter = 1;
@@ -323,7 +365,7 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
         int currentVertex = queue[tail++];
         e = elast = alternateFirstedge[currentVertex];
         do {
-            if(alternateLabelling[e->end]==MAXN){
+            if(alternateLabelling[e->end]==pg->nv){
                 queue[head++] = e->end;
                 alternateLabelling[e->end] = vertexCounter++;
                 alternateFirstedge[e->end] = e->inverse;
@@ -341,18 +383,14 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
             currentPos++;
             e = e->prev;
         } while (e!=elast);
-        //MAXN will always be at least the value of certificate[currentPos]
-        if(MAXN > certificate[currentPos]){
+        //the order will always be at least the value of certificate[currentPos]
+        if(pg->nv > certificate[currentPos]){
             return -1;
         }
         currentPos++;
     }
-    if(needAutomorphisms){
-        for(j = 0; j < nv; j++){
-            automorphisms[automorphismsCount][j] 
-                    = reverseCanonicalLabelling[alternateLabelling[j]];
-        }
-    }
+    growAutomorphisms();
+    automorphismEdges[automorphismsCount] = eStart;
     if(hasChiralGroup){
         orientationPreservingAutomorphismsCount++;
     } else {
@@ -365,32 +403,42 @@ int hasBetterCertificateOrientationReversing(EDGE *eStart){
 void calculateAutomorphismGroup(){
     int i;
     
+    growCertificateBuffers();
+    
     hasChiralGroup = FALSE;
     
     //identity    
+    automorphismsCount = 0;
+    growAutomorphisms();
+    
     automorphismsCount = 1;
     orientationPreservingAutomorphismsCount = 1;
     orientationReversingAutomorphismsCount = 0;
     
     //find starting edges
-    findStartingEdges();
+    findPlanarStartingEdges(pg, frequencies,
+            orientationPreservingStartingEdges, &orientationPreservingStartingEdgesCount,
+            orientationReversingStartingEdges, &orientationReversingStartingEdgesCount);
     
     //construct initial certificate
     constructCertificate(orientationPreservingStartingEdges[0]);
     
     //look for better automorphism
-    for(i = 1; i < startingEdgesCount; i++){
+    for(i = 1; i < orientationPreservingStartingEdgesCount; i++){
         int result = hasBetterCertificateOrientationPreserving(
                                 orientationPreservingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
         //if result == 0, then the automorphism is already stored
     }
-    for(i = 0; i < startingEdgesCount; i++){
+    for(i = 0; i < orientationReversingStartingEdgesCount; i++){
         int result = hasBetterCertificateOrientationReversing(
                                 orientationReversingStartingEdges[i]);
         //if result == 1, then the counts are already reset and the new certificate is stored
         //if result == 0, then the automorphism is already stored
     }
+    
+    //the identity maps the first edge of the certificate to itself
+    automorphismEdges[0] = canonicalStartingEdge;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -422,11 +470,11 @@ void unionElements(int forest[], int treeSizes[], int *numberOfComponents, int e
 void determineVertexOrbits(){
     int i, j;
     
-    for(i = 0; i < MAXN; i++){
+    for(i = 0; i < pg->nv; i++){
         vertexOrbits[i] = i;
         vertexOrbitsSize[i] = 1;
     }
-    vertexOrbitCount = nv;
+    vertexOrbitCount = pg->nv;
     
     if(automorphismsCount == 1){
         return; //trivial symmetry
@@ -434,31 +482,34 @@ void determineVertexOrbits(){
     
     //we skip the first automorphism since this always corresponds to the identity
     for(j = 1; j < automorphismsCount; j++){
-        for(i = 0; i < nv; i++){
+        expandAutomorphism(j, vertexImages, NULL);
+        for(i = 0; i < pg->nv; i++){
             unionElements(vertexOrbits, vertexOrbitsSize, &vertexOrbitCount,
-                    i, automorphisms[j][i]);
+                    i, vertexImages[i]);
         }
     }
     
     //make sure that each element is connected to its root
-    for(i = 0; i < nv; i++){
+    for(i = 0; i < pg->nv; i++){
         findRootOfElement(vertexOrbits, i);
     }
 }
 
 void determineEdgeOrbits(){
-    int i, j, k, start, end, temp;
+    int i, j;
+    PG_EDGE *image;
     
-    for(i = 0; i < MAXE/2; i++){
+    for(i = 0; i < pg->ne/2; i++){
         edgeOrbits[i] = i;
         edgeOrbitsSize[i] = 1;
     }
-    vertexOrbitCount = ne/2;
+    edgeOrbitCount = pg->ne/2;
     
-    for(i = 0, j = 0; i < ne; i++){
-        if(edges[i].start < edges[i].end){
-            undirectedEdges[j][0] = edges[i].start;
-            undirectedEdges[j][1] = edges[i].end;
+    for(i = 0, j = 0; i < pg->ne; i++){
+        if(pg->edges[i].start < pg->edges[i].end){
+            undirectedEdges[j][0] = pg->edges[i].start;
+            undirectedEdges[j][1] = pg->edges[i].end;
+            undirectedEdgeIndex[i] = j;
             j++;
         }
     }
@@ -469,87 +520,58 @@ void determineEdgeOrbits(){
     
     //we skip the first automorphism since this always corresponds to the identity
     for(j = 1; j < automorphismsCount; j++){
-        for(i = 0; i < ne/2; i++){
-            //determine image of edge
-            start = automorphisms[j][undirectedEdges[i][0]];
-            end = automorphisms[j][undirectedEdges[i][1]];
-            
-            //canonical version of image
-            if(start > end){
-                temp = start;
-                start = end;
-                end = temp;
-            }
-            
-            //search the pair in the list
-            for(k = 0; k<ne/2; k++){
-                if(start == undirectedEdges[k][0] && end == undirectedEdges[k][1]){
-                    unionElements(edgeOrbits, edgeOrbitsSize, &edgeOrbitCount, i, k);
-                    break;
-                    //the list of edges doesn't contain any duplicates so we can stop
+        expandAutomorphism(j, vertexImages, edgeImages);
+        for(i = 0; i < pg->ne; i++){
+            if(pg->edges[i].start < pg->edges[i].end){
+                //canonical version of the image
+                image = edgeImages[i];
+                if(image->start > image->end){
+                    image = image->inverse;
                 }
+                unionElements(edgeOrbits, edgeOrbitsSize, &edgeOrbitCount,
+                        undirectedEdgeIndex[i], undirectedEdgeIndex[image->index]);
             }
         }
     }
     
     //make sure that each element is connected to its root
-    for(i = 0; i < ne/2; i++){
+    for(i = 0; i < pg->ne/2; i++){
         findRootOfElement(edgeOrbits, i);
     }
 }
 
 void determineFaceOrbits(){
-    int i, j, start, end, image;
-    EDGE *e;
+    int i, j;
+    PG_EDGE *image;
     
-    for(i = 0; i < nf; i++){
+    for(i = 0; i < pg->nf; i++){
         faceOrbits[i] = i;
         faceOrbitsSize[i] = 1;
     }
-    faceOrbitCount = nf;
+    faceOrbitCount = pg->nf;
     
     if(automorphismsCount == 1){
         return; //trivial symmetry
     }
     
     //we skip the first automorphism since this always corresponds to the identity
-    for(j = 1; j < orientationPreservingAutomorphismsCount; j++){
-        for(i = 0; i < nf; i++){
-            //determine image
-            start = automorphisms[j][facestart[i]->start];
-            end = automorphisms[j][facestart[i]->end];
-            
-            e = firstedge[start];
-            while(e->end != end){
-                e = e->next;
-            }
-            
-            image = e->rightface;
-            
-            unionElements(faceOrbits, faceOrbitsSize, &faceOrbitCount,
-                    i, image);
-        }
-    }
-    for(j = orientationPreservingAutomorphismsCount; j < automorphismsCount; j++){
-        for(i = 0; i < nf; i++){
-            //determine image
-            start = automorphisms[j][facestart[i]->start];
-            end = automorphisms[j][facestart[i]->end];
-            
-            e = firstedge[start];
-            while(e->end != end){
-                e = e->next;
+    for(j = 1; j < automorphismsCount; j++){
+        expandAutomorphism(j, vertexImages, edgeImages);
+        for(i = 0; i < pg->nf; i++){
+            //an orientation reversing automorphism maps the face on the right
+            //of an edge to the face on the left of the image
+            image = edgeImages[pg->facestart[i]->index];
+            if(j >= orientationPreservingAutomorphismsCount){
+                image = image->inverse;
             }
             
-            image = e->inverse->rightface;
-            
             unionElements(faceOrbits, faceOrbitsSize, &faceOrbitCount,
-                    i, image);
+                    i, image->rightface);
         }
     }
     
     //make sure that each element is connected to its root
-    for(i = 0; i < nf; i++){
+    for(i = 0; i < pg->nf; i++){
         findRootOfElement(faceOrbits, i);
     }
 }
@@ -557,107 +579,107 @@ void determineFaceOrbits(){
 //////////////////////////////////////////////////////////////////////////////
 
 void writeNumbering() {
-    fprintf(stdout, "Graph %d\n", numberOfGraphs);
+    fprintf(reportFile, "Graph %d\n", graphNumber);
 }
 
 void writeData() {
-    fprintf(stdout, "Number of vertices: %d\n", nv);
-    fprintf(stdout, "Number of edges: %d\n", ne/2);
-    fprintf(stdout, "Number of faces: %d\n", nf);
+    fprintf(reportFile, "Number of vertices: %d\n", pg->nv);
+    fprintf(reportFile, "Number of edges: %d\n", pg->ne/2);
+    fprintf(reportFile, "Number of faces: %d\n", pg->nf);
     if(automorphismInfo){
-        fprintf(stdout, "Number of automorphisms: %d\n", automorphismsCount);
-        fprintf(stdout, "Number of orientation preserving automorphisms: %d\n", automorphismsCount - orientationReversingAutomorphismsCount);
-        fprintf(stdout, "Number of orientation reversing automorphisms: %d\n", orientationReversingAutomorphismsCount);
+        fprintf(reportFile, "Number of automorphisms: %d\n", automorphismsCount);
+        fprintf(reportFile, "Number of orientation preserving automorphisms: %d\n", automorphismsCount - orientationReversingAutomorphismsCount);
+        fprintf(reportFile, "Number of orientation reversing automorphisms: %d\n", orientationReversingAutomorphismsCount);
     }
 }
 
 void writeDegreeSequence() {
     int i, j;
-    int degreeFrequency[MAXVAL];
+    int *degreeFrequency = valueFrequency;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         degreeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nv; i++) {
-        degreeFrequency[degree[i] - 1]++;
+    for (i = 0; i < pg->nv; i++) {
+        degreeFrequency[pg->degree[i] - 1]++;
     }
 
-    fprintf(stdout, "Degree sequence:    ");
-    for (i = MAXVAL; i > 0; i--) {
+    fprintf(reportFile, "Degree sequence:    ");
+    for (i = pg->ne; i > 0; i--) {
         for (j = 0; j < degreeFrequency[i - 1]; j++) {
-            fprintf(stdout, "%d ", i);
+            fprintf(reportFile, "%d ", i);
         }
     }
-    fprintf(stdout, "\n");
+    fprintf(reportFile, "\n");
 }
 
 void writeFaceSizeSequence() {
     int i, j;
-    int faceSizeFrequency[MAXVAL];
+    int *faceSizeFrequency = valueFrequency;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         faceSizeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nf; i++) {
-        faceSizeFrequency[faceSize[i] - 1]++;
+    for (i = 0; i < pg->nf; i++) {
+        faceSizeFrequency[pg->faceSize[i] - 1]++;
     }
 
-    fprintf(stdout, "Face size sequence: ");
-    for (i = MAXVAL; i > 0; i--) {
+    fprintf(reportFile, "Face size sequence: ");
+    for (i = pg->ne; i > 0; i--) {
         for (j = 0; j < faceSizeFrequency[i - 1]; j++) {
-            fprintf(stdout, "%d ", i);
+            fprintf(reportFile, "%d ", i);
         }
     }
-    fprintf(stdout, "\n");
+    fprintf(reportFile, "\n");
 }
 
 void writeDegreeVector() {
     int i;
-    int degreeFrequency[MAXVAL];
+    int *degreeFrequency = valueFrequency;
     int maxDegree = 0;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         degreeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nv; i++) {
-        degreeFrequency[degree[i] - 1]++;
-        if(degree[i]>maxDegree) maxDegree = degree[i];
+    for (i = 0; i < pg->nv; i++) {
+        degreeFrequency[pg->degree[i] - 1]++;
+        if(pg->degree[i]>maxDegree) maxDegree = pg->degree[i];
     }
 
-    fprintf(stdout, "Degree vector:    ");
+    fprintf(reportFile, "Degree vector:    ");
     for (i = 1; i <= maxDegree; i++) {
-        fprintf(stdout, "%d ", degreeFrequency[i - 1]);
+        fprintf(reportFile, "%d ", degreeFrequency[i - 1]);
     }
-    fprintf(stdout, "\n");
+    fprintf(reportFile, "\n");
 }
 
 void writeFaceSizeVector() {
     int i;
-    int faceSizeFrequency[MAXVAL];
+    int *faceSizeFrequency = valueFrequency;
     int maxSize = 0;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         faceSizeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nf; i++) {
-        faceSizeFrequency[faceSize[i] - 1]++;
-        if(faceSize[i]>maxSize) maxSize=faceSize[i];
+    for (i = 0; i < pg->nf; i++) {
+        faceSizeFrequency[pg->faceSize[i] - 1]++;
+        if(pg->faceSize[i]>maxSize) maxSize=pg->faceSize[i];
     }
 
-    fprintf(stdout, "Face size vector: ");
+    fprintf(reportFile, "Face size vector: ");
     for (i = 1; i <= maxSize; i++) {
-        fprintf(stdout, "%d ", faceSizeFrequency[i - 1]);
+        fprintf(reportFile, "%d ", faceSizeFrequency[i - 1]);
     }
-    fprintf(stdout, "\n");
+    fprintf(reportFile, "\n");
 }
 
 void writeFace(FILE *f, int i) {
-    EDGE *e, *eStart;
-    e = eStart = facestart[i];
+    PG_EDGE *e, *eStart;
+    e = eStart = pg->facestart[i];
     fprintf(f, "%d", e->start + 1);
     e = e->inverse->prev;
     while (e!=eStart){
@@ -669,18 +691,18 @@ void writeFace(FILE *f, int i) {
 
 void writeFaces() {
     int i;
-    EDGE *e, *eStart;
+    PG_EDGE *e, *eStart;
 
-    fprintf(stdout, "Faces:\n");
-    for (i = 0; i < nf; i++) {
-        e = eStart = facestart[i];
-        fprintf(stdout, "   F%d) %d", i+1, e->start + 1);
+    fprintf(reportFile, "Faces:\n");
+    for (i = 0; i < pg->nf; i++) {
+        e = eStart = pg->facestart[i];
+        fprintf(reportFile, "   F%d) %d", i+1, e->start + 1);
         e = e->inverse->prev;
         while (e!=eStart){
-            fprintf(stdout, ", %d", e->start + 1);
+            fprintf(reportFile, ", %d", e->start + 1);
             e = e->inverse->prev;
         }
-        fprintf(stdout, "\n");
+        fprintf(reportFile, "\n");
     }
 }
 
@@ -688,23 +710,23 @@ void writeVertexOrbits() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each vertex corresponds to an orbit.\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each vertex corresponds to an orbit.\n");
         return;
     }
 
-    fprintf(stdout, "Vertex orbits:\n");
+    fprintf(reportFile, "Vertex orbits:\n");
     
     count = 0;
-    for (i = 0; i < nv; i++) {
+    for (i = 0; i < pg->nv; i++) {
         if(vertexOrbits[i] == i){
             count++;
-            fprintf(stdout, "   Orbit %d: %d", count, i+1);
-            for(j = i + 1; j < nv; j++){
+            fprintf(reportFile, "   Orbit %d: %d", count, i+1);
+            for(j = i + 1; j < pg->nv; j++){
                 if(vertexOrbits[j] == i){
-                    fprintf(stdout, ", %d", j + 1);
+                    fprintf(reportFile, ", %d", j + 1);
                 }
             }
-            fprintf(stdout, "\n");
+            fprintf(reportFile, "\n");
         }
     }
 }
@@ -713,23 +735,23 @@ void writeEdgeOrbits() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each edge corresponds to an orbit.\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each edge corresponds to an orbit.\n");
         return;
     }
 
-    fprintf(stdout, "Edge orbits:\n");
+    fprintf(reportFile, "Edge orbits:\n");
     
     count = 0;
-    for (i = 0; i < ne/2; i++) {
+    for (i = 0; i < pg->ne/2; i++) {
         if(edgeOrbits[i] == i){
             count++;
-            fprintf(stdout, "   Orbit %d: %d-%d", count, undirectedEdges[i][0]+1, undirectedEdges[i][1]+1);
-            for(j = i + 1; j < ne/2; j++){
+            fprintf(reportFile, "   Orbit %d: %d-%d", count, undirectedEdges[i][0]+1, undirectedEdges[i][1]+1);
+            for(j = i + 1; j < pg->ne/2; j++){
                 if(edgeOrbits[j] == i){
-                    fprintf(stdout, ", %d-%d", undirectedEdges[j][0]+1, undirectedEdges[j][1]+1);
+                    fprintf(reportFile, ", %d-%d", undirectedEdges[j][0]+1, undirectedEdges[j][1]+1);
                 }
             }
-            fprintf(stdout, "\n");
+            fprintf(reportFile, "\n");
         }
     }
 }
@@ -738,23 +760,23 @@ void writeFaceOrbits() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each face corresponds to an orbit.\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each face corresponds to an orbit.\n");
         return;
     }
 
-    fprintf(stdout, "Face orbits:\n");
+    fprintf(reportFile, "Face orbits:\n");
     
     count = 0;
-    for (i = 0; i < nf; i++) {
+    for (i = 0; i < pg->nf; i++) {
         if(faceOrbits[i] == i){
             count++;
-            fprintf(stdout, "   Orbit %d: F%d", count, i+1);
-            for(j = i + 1; j < nf; j++){
+            fprintf(reportFile, "   Orbit %d: F%d", count, i+1);
+            for(j = i + 1; j < pg->nf; j++){
                 if(faceOrbits[j] == i){
-                    fprintf(stdout, ", F%d", j + 1);
+                    fprintf(reportFile, ", F%d", j + 1);
                 }
             }
-            fprintf(stdout, "\n");
+            fprintf(reportFile, "\n");
         }
     }
 }
@@ -762,127 +784,127 @@ void writeFaceOrbits() {
 void writeFaceOrbits_grouped() {
     int i, j, count;
 
-    fprintf(stdout, "Face orbits:\n");
+    fprintf(reportFile, "Face orbits:\n");
     
     count = 0;
-    for (i = 0; i < nf; i++) {
+    for (i = 0; i < pg->nf; i++) {
         if(faceOrbits[i] == i){
             count++;
-            fprintf(stdout, "   Orbit %d:\n      F%d) ", count, i + 1);
-            writeFace(stdout, i);
-            for(j = i + 1; j < nf; j++){
+            fprintf(reportFile, "   Orbit %d:\n      F%d) ", count, i + 1);
+            writeFace(reportFile, i);
+            for(j = i + 1; j < pg->nf; j++){
                 if(faceOrbits[j] == i){
-                    fprintf(stdout, "      F%d) ", j + 1);
-                    writeFace(stdout, j);
+                    fprintf(reportFile, "      F%d) ", j + 1);
+                    writeFace(reportFile, j);
                 }
             }
-            fprintf(stdout, "\n");
+            fprintf(reportFile, "\n");
         }
     }
 }
 
 void writeNumberingLatex() {
-    fprintf(stdout, "\\section*{Graph %d}\n", numberOfGraphs);
+    fprintf(reportFile, "\\section*{Graph %d}\n", graphNumber);
 }
 
 void writeDataLatex() {
-    fprintf(stdout, "Number of vertices: %d\\\\\n", nv);
-    fprintf(stdout, "Number of edges: %d\\\\\n", ne/2);
-    fprintf(stdout, "Number of faces: %d\\\\\n", nf);
+    fprintf(reportFile, "Number of vertices: %d\\\\\n", pg->nv);
+    fprintf(reportFile, "Number of edges: %d\\\\\n", pg->ne/2);
+    fprintf(reportFile, "Number of faces: %d\\\\\n", pg->nf);
     if(automorphismInfo){
-        fprintf(stdout, "Number of automorphisms: %d\\\\\n", automorphismsCount);
-        fprintf(stdout, "Number of orientation preserving automorphisms: %d\\\\\n", automorphismsCount - orientationReversingAutomorphismsCount);
-        fprintf(stdout, "Number of orientation reversing automorphisms: %d\\\\\n", orientationReversingAutomorphismsCount);
+        fprintf(reportFile, "Number of automorphisms: %d\\\\\n", automorphismsCount);
+        fprintf(reportFile, "Number of orientation preserving automorphisms: %d\\\\\n", automorphismsCount - orientationReversingAutomorphismsCount);
+        fprintf(reportFile, "Number of orientation reversing automorphisms: %d\\\\\n", orientationReversingAutomorphismsCount);
     }
 }
 
 void writeDegreeSequenceLatex() {
     int i, j;
-    int degreeFrequency[MAXVAL];
+    int *degreeFrequency = valueFrequency;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         degreeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nv; i++) {
-        degreeFrequency[degree[i] - 1]++;
+    for (i = 0; i < pg->nv; i++) {
+        degreeFrequency[pg->degree[i] - 1]++;
     }
 
-    fprintf(stdout, "Degree sequence: ");
-    for (i = MAXVAL; i > 0; i--) {
+    fprintf(reportFile, "Degree sequence: ");
+    for (i = pg->ne; i > 0; i--) {
         for (j = 0; j < degreeFrequency[i - 1]; j++) {
-            fprintf(stdout, "%d ", i);
+            fprintf(reportFile, "%d ", i);
         }
     }
-    fprintf(stdout, "\\\\\n");
+    fprintf(reportFile, "\\\\\n");
 }
 
 void writeFaceSizeSequenceLatex() {
     int i, j;
-    int faceSizeFrequency[MAXVAL];
+    int *faceSizeFrequency = valueFrequency;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         faceSizeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nf; i++) {
-        faceSizeFrequency[faceSize[i] - 1]++;
+    for (i = 0; i < pg->nf; i++) {
+        faceSizeFrequency[pg->faceSize[i] - 1]++;
     }
 
-    fprintf(stdout, "Face size sequence: ");
-    for (i = MAXVAL; i > 0; i--) {
+    fprintf(reportFile, "Face size sequence: ");
+    for (i = pg->ne; i > 0; i--) {
         for (j = 0; j < faceSizeFrequency[i - 1]; j++) {
-            fprintf(stdout, "%d ", i);
+            fprintf(reportFile, "%d ", i);
         }
     }
-    fprintf(stdout, "\\\\\n");
+    fprintf(reportFile, "\\\\\n");
 }
 
 void writeDegreeVectorLatex() {
     int i;
-    int degreeFrequency[MAXVAL];
+    int *degreeFrequency = valueFrequency;
     int maxDegree = 0;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         degreeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nv; i++) {
-        degreeFrequency[degree[i] - 1]++;
-        if(degree[i]>maxDegree) maxDegree = degree[i];
+    for (i = 0; i < pg->nv; i++) {
+        degreeFrequency[pg->degree[i] - 1]++;
+        if(pg->degree[i]>maxDegree) maxDegree = pg->degree[i];
     }
 
-    fprintf(stdout, "Degree vector:    ");
+    fprintf(reportFile, "Degree vector:    ");
     for (i = 1; i <= maxDegree; i++) {
-        fprintf(stdout, "%d ", degreeFrequency[i - 1]);
+        fprintf(reportFile, "%d ", degreeFrequency[i - 1]);
     }
-    fprintf(stdout, "\\\\\n");
+    fprintf(reportFile, "\\\\\n");
 }
 
 void writeFaceSizeVectorLatex() {
     int i;
-    int faceSizeFrequency[MAXVAL];
+    int *faceSizeFrequency = valueFrequency;
     int maxSize = 0;
 
-    for (i = 0; i < MAXVAL; i++) {
+    for (i = 0; i < pg->ne; i++) {
         faceSizeFrequency[i] = 0;
     }
 
-    for (i = 0; i < nf; i++) {
-        faceSizeFrequency[faceSize[i] - 1]++;
-        if(faceSize[i]>maxSize) maxSize=faceSize[i];
+    for (i = 0; i < pg->nf; i++) {
+        faceSizeFrequency[pg->faceSize[i] - 1]++;
+        if(pg->faceSize[i]>maxSize) maxSize=pg->faceSize[i];
     }
 
-    fprintf(stdout, "Face size vector: ");
+    fprintf(reportFile, "Face size vector: ");
     for (i = 1; i <= maxSize; i++) {
-        fprintf(stdout, "%d ", faceSizeFrequency[i - 1]);
+        fprintf(reportFile, "%d ", faceSizeFrequency[i - 1]);
     }
-    fprintf(stdout, "\\\\\n");
+    fprintf(reportFile, "\\\\\n");
 }
 
 void writeFaceLatex(FILE* f, int i) {
-    EDGE *e, *eStart;
-    e = eStart = facestart[i];
+    PG_EDGE *e, *eStart;
+    e = eStart = pg->facestart[i];
     fprintf(f, "%d", e->start + 1);
     e = e->inverse->prev;
     while (e!=eStart){
@@ -894,18 +916,18 @@ void writeFaceLatex(FILE* f, int i) {
 
 void writeFacesLatex() {
     int i;
-    EDGE *e, *eStart;
+    PG_EDGE *e, *eStart;
 
-    fprintf(stdout, "Faces:\\\\\n");
-    for (i = 0; i < nf; i++) {
-        e = eStart = facestart[i];
-        fprintf(stdout, "\\ \\  F%d) %d", i+1, e->start + 1);
+    fprintf(reportFile, "Faces:\\\\\n");
+    for (i = 0; i < pg->nf; i++) {
+        e = eStart = pg->facestart[i];
+        fprintf(reportFile, "\\ \\  F%d) %d", i+1, e->start + 1);
         e = e->inverse->prev;
         while (e!=eStart){
-            fprintf(stdout, ", %d", e->start + 1);
+            fprintf(reportFile, ", %d", e->start + 1);
             e = e->inverse->prev;
         }
-        fprintf(stdout, "\\\\\n");
+        fprintf(reportFile, "\\\\\n");
     }
 }
 
@@ -913,23 +935,23 @@ void writeVertexOrbitsLatex() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each vertex corresponds to an orbit.\\\\\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each vertex corresponds to an orbit.\\\\\n");
         return;
     }
 
-    fprintf(stdout, "Vertex orbits:\\\\\n");
+    fprintf(reportFile, "Vertex orbits:\\\\\n");
     
     count = 0;
-    for (i = 0; i < nv; i++) {
+    for (i = 0; i < pg->nv; i++) {
         if(vertexOrbits[i] == i){
             count++;
-            fprintf(stdout, "\\ \\  Orbit %d: %d", count, i+1);
-            for(j = i + 1; j < nv; j++){
+            fprintf(reportFile, "\\ \\  Orbit %d: %d", count, i+1);
+            for(j = i + 1; j < pg->nv; j++){
                 if(vertexOrbits[j] == i){
-                    fprintf(stdout, ", %d", j + 1);
+                    fprintf(reportFile, ", %d", j + 1);
                 }
             }
-            fprintf(stdout, "\\\\\n");
+            fprintf(reportFile, "\\\\\n");
         }
     }
 }
@@ -938,23 +960,23 @@ void writeEdgeOrbitsLatex() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each edge corresponds to an orbit.\\\\\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each edge corresponds to an orbit.\\\\\n");
         return;
     }
 
-    fprintf(stdout, "Edge orbits:\\\\\n");
+    fprintf(reportFile, "Edge orbits:\\\\\n");
     
     count = 0;
-    for (i = 0; i < ne/2; i++) {
+    for (i = 0; i < pg->ne/2; i++) {
         if(edgeOrbits[i] == i){
             count++;
-            fprintf(stdout, "\\ \\  Orbit %d: %d-%d", count, undirectedEdges[i][0]+1, undirectedEdges[i][1]+1);
-            for(j = i + 1; j < ne/2; j++){
+            fprintf(reportFile, "\\ \\  Orbit %d: %d-%d", count, undirectedEdges[i][0]+1, undirectedEdges[i][1]+1);
+            for(j = i + 1; j < pg->ne/2; j++){
                 if(edgeOrbits[j] == i){
-                    fprintf(stdout, ", %d-%d", undirectedEdges[j][0]+1, undirectedEdges[j][1]+1);
+                    fprintf(reportFile, ", %d-%d", undirectedEdges[j][0]+1, undirectedEdges[j][1]+1);
                 }
             }
-            fprintf(stdout, "\\\\\n");
+            fprintf(reportFile, "\\\\\n");
         }
     }
 }
@@ -963,23 +985,23 @@ void writeFaceOrbitsLatex() {
     int i, j, count;
     
     if(automorphismsCount == 1){
-        fprintf(stdout, "Graph has trivial symmetry, so each face corresponds to an orbit.\\\\\n");
+        fprintf(reportFile, "Graph has trivial symmetry, so each face corresponds to an orbit.\\\\\n");
         return;
     }
 
-    fprintf(stdout, "Face orbits:\\\\\n");
+    fprintf(reportFile, "Face orbits:\\\\\n");
     
     count = 0;
-    for (i = 0; i < nf; i++) {
+    for (i = 0; i < pg->nf; i++) {
         if(faceOrbits[i] == i){
             count++;
-            fprintf(stdout, "\\ \\  Orbit %d: F%d", count, i+1);
-            for(j = i + 1; j < nf; j++){
+            fprintf(reportFile, "\\ \\  Orbit %d: F%d", count, i+1);
+            for(j = i + 1; j < pg->nf; j++){
                 if(faceOrbits[j] == i){
-                    fprintf(stdout, ", F%d", j + 1);
+                    fprintf(reportFile, ", F%d", j + 1);
                 }
             }
-            fprintf(stdout, "\\\\\n");
+            fprintf(reportFile, "\\\\\n");
         }
     }
 }
@@ -987,26 +1009,27 @@ void writeFaceOrbitsLatex() {
 void writeFaceOrbits_groupedLatex() {
     int i, j, count;
 
-    fprintf(stdout, "Face orbits:\\\\\n");
+    fprintf(reportFile, "Face orbits:\\\\\n");
     
     count = 0;
-    for (i = 0; i < nf; i++) {
+    for (i = 0; i < pg->nf; i++) {
         if(faceOrbits[i] == i){
             count++;
-            fprintf(stdout, "\\ \\  Orbit %d:\\\\\\ \\ \\ \\ F%d) ", count, i+1);
-            writeFaceLatex(stdout, i);
-            for(j = i + 1; j < nf; j++){
+            fprintf(reportFile, "\\ \\  Orbit %d:\\\\\\ \\ \\ \\ F%d) ", count, i+1);
+            writeFaceLatex(reportFile, i);
+            for(j = i + 1; j < pg->nf; j++){
                 if(faceOrbits[j] == i){
-                    fprintf(stdout, "\\ \\ \\ \\ F%d) ", j + 1);
-                    writeFaceLatex(stdout, j);
+                    fprintf(reportFile, "\\ \\ \\ \\ F%d) ", j + 1);
+                    writeFaceLatex(reportFile, j);
                 }
             }
-            fprintf(stdout, "\\\\\n");
+            fprintf(reportFile, "\\\\\n");
         }
     }
 }
 
 void writeStatistics() {
+    growStatisticsBuffers();
     if(automorphismInfo || needAutomorphisms){
         calculateAutomorphismGroup();
         if(vertexOrbitInfo){
@@ -1045,7 +1068,7 @@ void writeStatistics() {
             }
         }
 
-        fprintf(stdout, "\\\\\n");
+        fprintf(reportFile, "\\\\\n");
     } else {
         if(includeNumbering) writeNumbering();
         writeData();
@@ -1072,9 +1095,8 @@ void writeStatistics() {
             }
         }
 
-        fprintf(stdout, "\n");
+        fprintf(reportFile, "\n");
     }
-    reportsWritten++;
 }
 
 void writeSummary() {
@@ -1087,249 +1109,231 @@ void writeSummary() {
     fprintf(stdout, "\n");
 }
 
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *findEdge(int from, int to) {
-    EDGE *e, *elast;
-
-    e = elast = firstedge[from];
-    do {
-        if (e->end == to) {
-            return e;
-        }
-        e = e->next;
-    } while (e != elast);
-    fprintf(stderr, "error while looking for edge from %d to %d.\n", from, to);
-    exit(0);
-}
+//====================== USAGE =======================
 
-/* Store in the rightface field of each edge the number of the face on
-   the right hand side of that edge.  Faces are numbered 0,1,....  Also
-   store in facestart[i] an example of an edge in the clockwise orientation
-   of the face boundary, and the size of the face in facesize[i], for each i.
-   Returns the number of faces. */
-void makeDual() {
-    register int i, sz;
-    register EDGE *e, *ex, *ef, *efx;
+//////////////////////////////////////////////////////////////////////////////
 
-    RESETMARKS;
+/* With option -j the statistics are computed by worker threads. The graphs
+ * are read in batches, and while the workers handle one batch, the next one
+ * is read. Each report is written to a buffer of its graph, and the buffers
+ * are written in the order in which the graphs were read, so the output is
+ * the same as without threads.
+ */
 
-    nf = 0;
-    for (i = 0; i < nv; ++i) {
+#define GRAPHS_PER_WORKER 64
 
-        e = ex = firstedge[i];
-        do {
-            if (!ISMARKEDLO(e)) {
-                facestart[nf] = ef = efx = e;
-                sz = 0;
-                do {
-                    ef->rightface = nf;
-                    MARKLO(ef);
-                    ef = ef->inverse->prev;
-                    ++sz;
-                } while (ef != efx);
-                faceSize[nf] = sz;
-                ++nf;
-            }
-            e = e->next;
-        } while (e != ex);
-    }
+typedef struct {
+    //a copy of the code of the graph and a view on this copy
+    unsigned char *code;
+    size_t codeCapacity;
+    CODE_VIEW view;
+    int number;
+    
+    char *report;
+    size_t reportSize;
+} BATCH_GRAPH;
+
+typedef struct {
+    BATCH_GRAPH *graphs;
+    int count;
+} BATCH;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t available, finished;
+    BATCH *batch;
+    unsigned long long generation; //the number of the current batch
+    boolean stop;
+    atomic_int next; //the next graph of the batch that is not yet taken
+    int busy; //the number of workers still working on the batch
+    int workers;
+} POOL;
+
+void handleBatchGraph(BATCH_GRAPH *graph){
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    
+    reportFile = open_memstream(&(graph->report), &(graph->reportSize));
+    if(reportFile == NULL){
+        fprintf(stderr, "Insufficient memory for the reports -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    pg = decodePlanarCodeView(&(graph->view), pg, &options);
+    graphNumber = graph->number;
+    writeStatistics();
+    fclose(reportFile);
 }
 
-void decodePlanarCode(unsigned short* code) {
-    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
-     */
-    int i, j, codePosition;
-    int edgeCounter = 0;
-    EDGE *inverse;
-
-    nv = code[0];
-    codePosition = 1;
-
-    for (i = 0; i < nv; i++) {
-        degree[i] = 0;
-        firstedge[i] = edges + edgeCounter;
-        edges[edgeCounter].start = i;
-        edges[edgeCounter].end = code[codePosition] - 1;
-        edges[edgeCounter].next = edges + edgeCounter + 1;
-        if (code[codePosition] - 1 < i) {
-            inverse = findEdge(code[codePosition] - 1, i);
-            edges[edgeCounter].inverse = inverse;
-            inverse->inverse = edges + edgeCounter;
-        } else {
-            edges[edgeCounter].inverse = NULL;
+void *worker(void *arg){
+    POOL *pool = arg;
+    unsigned long long seen = 0;
+    BATCH *batch;
+    int i;
+    
+    while(TRUE){
+        pthread_mutex_lock(&(pool->lock));
+        while(pool->generation == seen && !pool->stop){
+            pthread_cond_wait(&(pool->available), &(pool->lock));
         }
-        edgeCounter++;
-        codePosition++;
-        for (j = 1; code[codePosition]; j++, codePosition++) {
-            if (j == MAXVAL) {
-                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
-                exit(0);
-            }
-            edges[edgeCounter].start = i;
-            edges[edgeCounter].end = code[codePosition] - 1;
-            edges[edgeCounter].prev = edges + edgeCounter - 1;
-            edges[edgeCounter].next = edges + edgeCounter + 1;
-            if (code[codePosition] - 1 < i) {
-                inverse = findEdge(code[codePosition] - 1, i);
-                edges[edgeCounter].inverse = inverse;
-                inverse->inverse = edges + edgeCounter;
-            } else {
-                edges[edgeCounter].inverse = NULL;
-            }
-            edgeCounter++;
+        if(pool->stop){
+            pthread_mutex_unlock(&(pool->lock));
+            return NULL;
         }
-        firstedge[i]->prev = edges + edgeCounter - 1;
-        edges[edgeCounter - 1].next = firstedge[i];
-        degree[i] = j;
-
-        codePosition++; /* read the closing 0 */
+        seen = pool->generation;
+        batch = pool->batch;
+        pthread_mutex_unlock(&(pool->lock));
+        
+        while((i = atomic_fetch_add(&(pool->next), 1)) < batch->count){
+            handleBatchGraph(batch->graphs + i);
+        }
+        
+        pthread_mutex_lock(&(pool->lock));
+        pool->busy--;
+        if(pool->busy == 0){
+            pthread_cond_signal(&(pool->finished));
+        }
+        pthread_mutex_unlock(&(pool->lock));
     }
-
-    ne = edgeCounter;
-
-    makeDual();
-
-    // nv - ne/2 + nf = 2
 }
 
-/**
- * 
- * @param code
- * @param laenge
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
+/* Reads the graphs for which a report has to be written into the batch.
  */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
-    unsigned char c;
-    char testheader[20];
-    int bufferSize, zeroCounter;
+void readBatch(CODE_READER *reader, BATCH *batch, int capacity){
+    CODE_VIEW view;
+    BATCH_GRAPH *graph;
     
-    int readCount;
-
-
-    if (first) {
-        first = 0;
-
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
-            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
-            exit(1);
-        }
-        testheader[13] = 0;
-        if (strcmp(testheader, ">>planar_code") == 0) {
-
-        } else {
-            fprintf(stderr, "No planarcode header detected -- exiting!\n");
-            exit(1);
-        }
-        //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
+    batch->count = 0;
+    while(batch->count < capacity && nextCode(reader, &view)){
+        numberOfGraphs++;
+        if (filterEnabled && numberOfGraphs != filterOnly) {
+            continue;
         }
-        while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-                return FALSE;
+        graph = batch->graphs + batch->count;
+        if(view.length > graph->codeCapacity){
+            graph->codeCapacity = view.length;
+            graph->code = realloc(graph->code, graph->codeCapacity);
+            if(graph->code == NULL){
+                fprintf(stderr, "Insufficient memory for the batches -- exiting!\n");
+                exit(EXIT_FAILURE);
             }
         }
-        //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-            return FALSE;
-        }
+        memcpy(graph->code, view.data, view.length);
+        graph->view = view;
+        graph->view.data = graph->code;
+        graph->view.body = graph->code + (view.body - view.data);
+        graph->number = numberOfGraphs;
+        batch->count++;
     }
+}
 
-    /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c == '>') {
-        // could be a header, or maybe just a 62 (which is also possible for unsigned char
-        code[0] = c;
-        bufferSize = 1;
-        zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
-        if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
-        if (code[2] == 0) zeroCounter++;
-        bufferSize = 3;
-        // 3 characters were read and stored in buffer
-        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
-            /* read 2 more characters: */
-            c = getc(file);
-            if (c != '<') {
-                fprintf(stderr, "Problems with header -- single '<'\n");
-                exit(1);
-            }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
-                //nothing left in file
-                return (0);
-            }
-            bufferSize = 1;
-            zeroCounter = 0;
+void runThreads(CODE_READER *reader, int threads){
+    POOL pool;
+    BATCH batches[2], *current = batches, *next = batches + 1, *swap;
+    pthread_t *workers;
+    int i, capacity = GRAPHS_PER_WORKER*threads;
+    
+    for(i = 0; i < 2; i++){
+        batches[i].graphs = calloc(capacity, sizeof(BATCH_GRAPH));
+        if(batches[i].graphs == NULL){
+            fprintf(stderr, "Insufficient memory for the batches -- exiting!\n");
+            exit(EXIT_FAILURE);
         }
-    } else {
-        //no header present
-        bufferSize = 1;
-        zeroCounter = 0;
     }
-
-    if (c != 0) /* unsigned chars would be sufficient */ {
-        code[0] = c;
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
-        }
-        while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
-        }
-    } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
-        if(!readCount){
-            fprintf(stderr, "Unexpected EOF.\n");
-            exit(1);
+    
+    pool.batch = NULL;
+    pool.generation = 0;
+    pool.stop = FALSE;
+    pool.busy = 0;
+    pool.workers = threads;
+    atomic_init(&(pool.next), 0);
+    pthread_mutex_init(&(pool.lock), NULL);
+    pthread_cond_init(&(pool.available), NULL);
+    pthread_cond_init(&(pool.finished), NULL);
+    
+    workers = malloc(threads*sizeof(pthread_t));
+    if(workers == NULL){
+        fprintf(stderr, "Insufficient memory for the threads -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    for(i = 0; i < threads; i++){
+        if(pthread_create(workers + i, NULL, worker, &pool)){
+            fprintf(stderr, "Could not start thread -- exiting!\n");
+            exit(EXIT_FAILURE);
         }
-        if (code[0] > MAXN) {
-            fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-            exit(1);
+    }
+    
+    readBatch(reader, current, capacity);
+    while(current->count){
+        pthread_mutex_lock(&(pool.lock));
+        pool.batch = current;
+        atomic_store(&(pool.next), 0);
+        pool.busy = pool.workers;
+        pool.generation++;
+        pthread_cond_broadcast(&(pool.available));
+        pthread_mutex_unlock(&(pool.lock));
+        
+        //read the next batch while the workers are busy
+        readBatch(reader, next, capacity);
+        
+        pthread_mutex_lock(&(pool.lock));
+        while(pool.busy){
+            pthread_cond_wait(&(pool.finished), &(pool.lock));
         }
-        bufferSize = 1;
-        zeroCounter = 0;
-        while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
-            if(!readCount){
-                fprintf(stderr, "Unexpected EOF.\n");
-                exit(1);
+        pthread_mutex_unlock(&(pool.lock));
+        
+        for(i = 0; i < current->count; i++){
+            if(fwrite(current->graphs[i].report, 1, current->graphs[i].reportSize, stdout)
+                    != current->graphs[i].reportSize){
+                fprintf(stderr, "fwrite() failed -- exiting!\n");
+                exit(EXIT_FAILURE);
             }
-            if (code[bufferSize] == 0) zeroCounter++;
-            bufferSize++;
+            free(current->graphs[i].report);
+            reportsWritten++;
         }
+        
+        swap = current;
+        current = next;
+        next = swap;
     }
-
-    *length = bufferSize;
-    return (1);
-
-
+    
+    pthread_mutex_lock(&(pool.lock));
+    pool.stop = TRUE;
+    pthread_cond_broadcast(&(pool.available));
+    pthread_mutex_unlock(&(pool.lock));
+    for(i = 0; i < threads; i++){
+        pthread_join(workers[i], NULL);
+    }
+    
+    free(workers);
+    for(i = 0; i < capacity; i++){
+        free(batches[0].graphs[i].code);
+        free(batches[1].graphs[i].code);
+    }
+    free(batches[0].graphs);
+    free(batches[1].graphs);
+    pthread_mutex_destroy(&(pool.lock));
+    pthread_cond_destroy(&(pool.available));
+    pthread_cond_destroy(&(pool.finished));
 }
 
-//====================== USAGE =======================
+//////////////////////////////////////////////////////////////////////////////
 
 void help(char *name) {
     fprintf(stderr, "The program %s generates an overview of some statistics for the plane\n", name);
     fprintf(stderr, "graphs read from standard in.\n\n");
     fprintf(stderr, "Usage\n=====\n");
     fprintf(stderr, " %s [options]\n\n", name);
-    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a greater\n", MAXN);
-    fprintf(stderr, "value for MAXN if you need larger graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
     fprintf(stderr, "    -s, --summary\n");
     fprintf(stderr, "       Include a summary at the end.\n");
+    fprintf(stderr, "    -S, --summary-only\n");
+    fprintf(stderr, "       Only print the summary. The graphs are counted without computing\n");
+    fprintf(stderr, "       any statistics.\n");
+    fprintf(stderr, "    -j, --threads number\n");
+    fprintf(stderr, "       Compute the statistics in the given number of worker threads. The\n");
+    fprintf(stderr, "       reports are written in the same order as without this option.\n");
     fprintf(stderr, "    -f, --filter number\n");
     fprintf(stderr, "       Only print information for the graph with the given number.\n");
     fprintf(stderr, "    -a, --automorphisms\n");
@@ -1355,11 +1359,14 @@ int main(int argc, char *argv[]) {
 
     int c;
     char *name = argv[0];
+    int threads = 0;
     static struct option long_options[] = {
         {"latex", no_argument, &latex, TRUE},
         {"numbering", no_argument, &includeNumbering, TRUE},
         {"help", no_argument, NULL, 'h'},
         {"summary", no_argument, NULL, 's'},
+        {"summary-only", no_argument, NULL, 'S'},
+        {"threads", required_argument, NULL, 'j'},
         {"filter", required_argument, NULL, 'f'},
         {"automorphisms", no_argument, NULL, 'a'},
         {"vertex-orbits", no_argument, NULL, 'V'},
@@ -1369,7 +1376,7 @@ int main(int argc, char *argv[]) {
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hsf:aVEFg", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hsSj:f:aVEFg", long_options, &option_index)) != -1) {
         switch (c) {
             case 0:
                 break;
@@ -1379,6 +1386,13 @@ int main(int argc, char *argv[]) {
             case 's':
                 includeSummary = TRUE;
                 break;
+            case 'S':
+                includeSummary = TRUE;
+                summaryOnly = TRUE;
+                break;
+            case 'j':
+                threads = atoi(optarg);
+                break;
             case 'f':
                 filterOnly = atoi(optarg);
                 filterEnabled = TRUE;
@@ -1414,13 +1428,31 @@ int main(int argc, char *argv[]) {
 
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
-        numberOfGraphs++;
-        if (!filterEnabled || numberOfGraphs == filterOnly) {
-            writeStatistics();
+    CODE_READER *reader = newPlanarCodeReader(stdin);
+    CODE_VIEW view;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.computeDual = TRUE;
+    if (summaryOnly) {
+        //the summary only contains the numbers of graphs, so the graphs are
+        //not even decoded
+        while (nextCode(reader, &view)) {
+            numberOfGraphs++;
+            if (!filterEnabled || numberOfGraphs == filterOnly) {
+                reportsWritten++;
+            }
+        }
+    } else if (threads > 0) {
+        runThreads(reader, threads);
+    } else {
+        reportFile = stdout;
+        while (nextCode(reader, &view)) {
+            numberOfGraphs++;
+            if (!filterEnabled || numberOfGraphs == filterOnly) {
+                pg = decodePlanarCodeView(&view, pg, &options);
+                graphNumber = numberOfGraphs;
+                writeStatistics();
+                reportsWritten++;
+            }
         }
     }
     if (includeSummary) {
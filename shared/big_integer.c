@@ -0,0 +1,180 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "big_integer.h"
+#include <stdlib.h>
+
+void _ensureBigIntegerCapacity(BIG_INTEGER *n, int capacity){
+    unsigned int *limbs;
+
+    if(capacity <= n->capacity){
+        return;
+    }
+    if(capacity < 2*n->capacity){
+        capacity = 2*n->capacity;
+    }
+    limbs = (unsigned int *)realloc(n->limbs, sizeof(unsigned int)*capacity);
+    if(limbs == NULL){
+        fprintf(stderr, "Insufficient memory for big integer -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    n->limbs = limbs;
+    n->capacity = capacity;
+}
+
+void _normaliseBigInteger(BIG_INTEGER *n){
+    while(n->length > 0 && n->limbs[n->length - 1] == 0){
+        n->length--;
+    }
+}
+
+BIG_INTEGER *newBigInteger(unsigned long long value){
+    BIG_INTEGER *n = (BIG_INTEGER *)malloc(sizeof(BIG_INTEGER));
+    if(n == NULL){
+        fprintf(stderr, "Insufficient memory for big integer -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    n->limbs = NULL;
+    n->capacity = 0;
+    _ensureBigIntegerCapacity(n, 4);
+    n->limbs[0] = (unsigned int)value;
+    n->limbs[1] = (unsigned int)(value >> 32);
+    n->length = 2;
+    _normaliseBigInteger(n);
+    return n;
+}
+
+void freeBigInteger(BIG_INTEGER *n){
+    free(n->limbs);
+    free(n);
+}
+
+void copyBigInteger(BIG_INTEGER *target, BIG_INTEGER *source){
+    int i;
+
+    _ensureBigIntegerCapacity(target, source->length);
+    for(i = 0; i < source->length; i++){
+        target->limbs[i] = source->limbs[i];
+    }
+    target->length = source->length;
+}
+
+int compareBigIntegers(BIG_INTEGER *a, BIG_INTEGER *b){
+    int i;
+
+    if(a->length != b->length){
+        return a->length - b->length;
+    }
+    for(i = a->length - 1; i >= 0; i--){
+        if(a->limbs[i] != b->limbs[i]){
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+void addBigInteger(BIG_INTEGER *a, BIG_INTEGER *b){
+    int i;
+    int length = a->length > b->length ? a->length : b->length;
+    unsigned long long carry = 0;
+
+    _ensureBigIntegerCapacity(a, length + 1);
+    for(i = a->length; i <= length; i++){
+        a->limbs[i] = 0;
+    }
+    for(i = 0; i < length; i++){
+        carry += (unsigned long long)a->limbs[i] + (i < b->length ? b->limbs[i] : 0);
+        a->limbs[i] = (unsigned int)carry;
+        carry >>= 32;
+    }
+    a->limbs[length] = (unsigned int)carry;
+    a->length = length + 1;
+    _normaliseBigInteger(a);
+}
+
+void subtractBigInteger(BIG_INTEGER *a, BIG_INTEGER *b){
+    int i;
+    long long borrow = 0;
+
+    for(i = 0; i < a->length; i++){
+        long long difference = (long long)a->limbs[i] - (i < b->length ? b->limbs[i] : 0) - borrow;
+        if(difference < 0){
+            difference += 1LL << 32;
+            borrow = 1;
+        } else {
+            borrow = 0;
+        }
+        a->limbs[i] = (unsigned int)difference;
+    }
+    _normaliseBigInteger(a);
+}
+
+void multiplyBigInteger(BIG_INTEGER *n, unsigned int factor){
+    int i;
+    unsigned long long carry = 0;
+
+    _ensureBigIntegerCapacity(n, n->length + 1);
+    for(i = 0; i < n->length; i++){
+        carry += (unsigned long long)n->limbs[i] * factor;
+        n->limbs[i] = (unsigned int)carry;
+        carry >>= 32;
+    }
+    n->limbs[n->length++] = (unsigned int)carry;
+    _normaliseBigInteger(n);
+}
+
+unsigned int divideBigInteger(BIG_INTEGER *n, unsigned int divisor){
+    int i;
+    unsigned long long remainder = 0;
+
+    for(i = n->length - 1; i >= 0; i--){
+        unsigned long long current = (remainder << 32) | n->limbs[i];
+        n->limbs[i] = (unsigned int)(current / divisor);
+        remainder = current % divisor;
+    }
+    _normaliseBigInteger(n);
+    return (unsigned int)remainder;
+}
+
+unsigned int bigIntegerModulo(BIG_INTEGER *n, unsigned int modulus){
+    int i;
+    unsigned long long remainder = 0;
+
+    for(i = n->length - 1; i >= 0; i--){
+        remainder = ((remainder << 32) | n->limbs[i]) % modulus;
+    }
+    return (unsigned int)remainder;
+}
+
+void writeBigInteger(BIG_INTEGER *n, FILE *f){
+    int i, count = 0;
+    unsigned int *groups;
+    BIG_INTEGER *copy;
+
+    if(n->length == 0){
+        fprintf(f, "0");
+        return;
+    }
+
+    //each 32-bit limb gives at most 10 digits, so at most 2 groups of 9 digits
+    groups = (unsigned int *)malloc(sizeof(unsigned int)*(2*n->length + 1));
+    if(groups == NULL){
+        fprintf(stderr, "Insufficient memory for big integer -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    copy = newBigInteger(0);
+    copyBigInteger(copy, n);
+    do {
+        groups[count++] = divideBigInteger(copy, 1000000000);
+    } while(copy->length > 0);
+    fprintf(f, "%u", groups[count - 1]);
+    for(i = count - 2; i >= 0; i--){
+        fprintf(f, "%09u", groups[i]);
+    }
+    freeBigInteger(copy);
+    free(groups);
+}
@@ -0,0 +1,82 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef BIG_INTEGER_H
+#define	BIG_INTEGER_H
+
+#include <stdio.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* Non-negative integers of arbitrary size. Only the operations that are needed
+ * to combine residues with the Chinese remainder theorem are supported, so
+ * apart from addition and subtraction all operations take a small (32-bit)
+ * second operand.
+ *
+ * The functions exit the program if there is not enough memory.
+ */
+
+typedef struct __big_integer BIG_INTEGER;
+
+struct __big_integer {
+    //32-bit limbs, least significant first
+    unsigned int *limbs;
+    //the number of limbs in use: the most significant one is not zero
+    int length;
+    int capacity;
+};
+
+BIG_INTEGER *newBigInteger(unsigned long long value);
+
+void freeBigInteger(BIG_INTEGER *n);
+
+void copyBigInteger(BIG_INTEGER *target, BIG_INTEGER *source);
+
+/**
+ * Returns a negative number, zero or a positive number if a is respectively
+ * smaller than, equal to or larger than b.
+ */
+int compareBigIntegers(BIG_INTEGER *a, BIG_INTEGER *b);
+
+/**
+ * Replaces a by a + b.
+ */
+void addBigInteger(BIG_INTEGER *a, BIG_INTEGER *b);
+
+/**
+ * Replaces a by a - b. The result is undefined if b is larger than a.
+ */
+void subtractBigInteger(BIG_INTEGER *a, BIG_INTEGER *b);
+
+/**
+ * Replaces n by n * factor.
+ */
+void multiplyBigInteger(BIG_INTEGER *n, unsigned int factor);
+
+/**
+ * Replaces n by n / divisor and returns the remainder.
+ */
+unsigned int divideBigInteger(BIG_INTEGER *n, unsigned int divisor);
+
+/**
+ * Returns n modulo the given modulus without changing n.
+ */
+unsigned int bigIntegerModulo(BIG_INTEGER *n, unsigned int modulus);
+
+/**
+ * Writes the decimal representation of n to the file.
+ */
+void writeBigInteger(BIG_INTEGER *n, FILE *f);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* BIG_INTEGER_H */
+
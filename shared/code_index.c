@@ -0,0 +1,245 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "code_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define CODE_INDEX_MAGIC "GTINDEX1"
+
+typedef struct __code_index_header {
+    char magic[8];
+    //the header of the data file, e.g., MULTICODE_HEADER
+    char format[16];
+    int listOffset;
+    int entriesPerEdge;
+    unsigned long long count;
+    //the size of the data file when the index was built
+    unsigned long long dataSize;
+} CODE_INDEX_HEADER;
+
+struct __code_index {
+    const unsigned char *data;
+    size_t dataSize;
+
+    void *indexMap;
+    size_t indexSize;
+
+    const CODE_INDEX_HEADER *header;
+    const CODE_INDEX_ENTRY *entries;
+};
+
+void _writeCodeIndexData(const void *data, size_t size, FILE *indexFile){
+    if(fwrite(data, size, 1, indexFile) != 1){
+        fprintf(stderr, "Error while writing index -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+unsigned long long writeCodeIndex(FILE *data, const char *header, int listOffset,
+        int entriesPerEdge, FILE *indexFile){
+    CODE_INDEX_HEADER indexHeader;
+    CODE_INDEX_ENTRY entry;
+    CODE_VIEW view;
+    CODE_READER *reader;
+    struct stat dataStat;
+
+    if(strlen(header) >= sizeof(indexHeader.format)){
+        fprintf(stderr, "Header %s too long for index -- exiting!\n", header);
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&indexHeader, 0, sizeof(CODE_INDEX_HEADER));
+    memcpy(indexHeader.magic, CODE_INDEX_MAGIC, sizeof(indexHeader.magic));
+    strcpy(indexHeader.format, header);
+    indexHeader.listOffset = listOffset;
+    indexHeader.entriesPerEdge = entriesPerEdge;
+
+    //the header is written again when the number of graphs is known
+    _writeCodeIndexData(&indexHeader, sizeof(CODE_INDEX_HEADER), indexFile);
+
+    memset(&entry, 0, sizeof(CODE_INDEX_ENTRY));
+    reader = newCodeReader(data, header, listOffset);
+    while(nextCode(reader, &view)){
+        entry.offset = view.offset;
+        entry.order = view.order;
+        entry.edgeCount = (view.entryCount - (view.order + listOffset))/entriesPerEdge;
+        _writeCodeIndexData(&entry, sizeof(CODE_INDEX_ENTRY), indexFile);
+        indexHeader.count++;
+    }
+    freeCodeReader(reader);
+
+    if(fstat(fileno(data), &dataStat) || !S_ISREG(dataStat.st_mode)){
+        fprintf(stderr, "Only regular files can be indexed -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    indexHeader.dataSize = dataStat.st_size;
+
+    if(fseeko(indexFile, 0, SEEK_SET)){
+        fprintf(stderr, "Error while writing index -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    _writeCodeIndexData(&indexHeader, sizeof(CODE_INDEX_HEADER), indexFile);
+    fflush(indexFile);
+
+    return indexHeader.count;
+}
+
+char *codeIndexFileName(const char *dataFileName){
+    char *indexFileName = malloc(strlen(dataFileName) + strlen(CODE_INDEX_EXTENSION) + 1);
+    if(indexFileName == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(indexFileName, dataFileName);
+    strcat(indexFileName, CODE_INDEX_EXTENSION);
+    return indexFileName;
+}
+
+/* Maps the complete file into memory. Returns NULL if the file cannot be
+ * opened. An empty file is mapped to a non-NULL pointer that should not be
+ * dereferenced.
+ */
+void *_mapIndexedFile(const char *fileName, size_t *size, struct stat *fileStat){
+    static char empty;
+    void *map;
+    int fd = open(fileName, O_RDONLY);
+
+    if(fd < 0){
+        return NULL;
+    }
+    if(fstat(fd, fileStat) || !S_ISREG(fileStat->st_mode)){
+        fprintf(stderr, "%s is not a regular file -- exiting!\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    *size = fileStat->st_size;
+    if(*size == 0){
+        close(fd);
+        return &empty;
+    }
+    map = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED){
+        fprintf(stderr, "Could not map %s into memory -- exiting!\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    return map;
+}
+
+CODE_INDEX *openCodeIndex(const char *dataFileName, const char *indexFileName,
+        const char *header){
+    CODE_INDEX *index;
+    struct stat dataStat, indexStat;
+    char *defaultName = NULL;
+    const CODE_INDEX_HEADER *indexHeader;
+
+    if(indexFileName == NULL){
+        indexFileName = defaultName = codeIndexFileName(dataFileName);
+    }
+
+    index = (CODE_INDEX *)malloc(sizeof(CODE_INDEX));
+    if(index == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    index->indexMap = _mapIndexedFile(indexFileName, &(index->indexSize), &indexStat);
+    if(index->indexMap == NULL){
+        free(index);
+        free(defaultName);
+        return NULL;
+    }
+
+    indexHeader = index->indexMap;
+    if(index->indexSize < sizeof(CODE_INDEX_HEADER) ||
+            memcmp(indexHeader->magic, CODE_INDEX_MAGIC, sizeof(indexHeader->magic)) ||
+            index->indexSize != sizeof(CODE_INDEX_HEADER) +
+                                indexHeader->count*sizeof(CODE_INDEX_ENTRY)){
+        fprintf(stderr, "%s is not a valid index -- exiting!\n", indexFileName);
+        exit(EXIT_FAILURE);
+    }
+    if(strncmp(indexHeader->format, header, sizeof(indexHeader->format))){
+        fprintf(stderr, "%s is an index for %s<< files instead of %s<< files -- exiting!\n",
+                indexFileName, indexHeader->format, header);
+        exit(EXIT_FAILURE);
+    }
+
+    index->data = _mapIndexedFile(dataFileName, &(index->dataSize), &dataStat);
+    if(index->data == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", dataFileName);
+        exit(EXIT_FAILURE);
+    }
+    if(index->dataSize != indexHeader->dataSize ||
+            dataStat.st_mtime > indexStat.st_mtime){
+        fprintf(stderr, "%s is out of date for %s: rebuild the index -- exiting!\n",
+                indexFileName, dataFileName);
+        exit(EXIT_FAILURE);
+    }
+
+    index->header = indexHeader;
+    index->entries = (const CODE_INDEX_ENTRY *)(indexHeader + 1);
+
+    free(defaultName);
+    return index;
+}
+
+void closeCodeIndex(CODE_INDEX *index){
+    if(index->dataSize){
+        munmap((void *)index->data, index->dataSize);
+    }
+    if(index->indexSize){
+        munmap(index->indexMap, index->indexSize);
+    }
+    free(index);
+}
+
+unsigned long long codeIndexSize(CODE_INDEX *index){
+    return index->header->count;
+}
+
+const CODE_INDEX_ENTRY *codeIndexEntry(CODE_INDEX *index, unsigned long long i){
+    if(i >= index->header->count){
+        fprintf(stderr, "Graph %llu is not in the index -- exiting!\n", i + 1);
+        exit(EXIT_FAILURE);
+    }
+    return index->entries + i;
+}
+
+void codeIndexView(CODE_INDEX *index, unsigned long long i, CODE_VIEW *view){
+    const CODE_INDEX_ENTRY *entry = codeIndexEntry(index, i);
+    int entrySize;
+
+    view->offset = entry->offset;
+    view->data = index->data + entry->offset;
+    view->order = entry->order;
+    view->shortCode = (view->data[0] == 0);
+    view->entryCount = entry->order + index->header->listOffset +
+                       entry->edgeCount*index->header->entriesPerEdge;
+    entrySize = view->shortCode ? 2 : 1;
+    view->body = view->data + (view->shortCode ? 3 : 1);
+    view->length = (view->body - view->data) + (size_t)view->entryCount*entrySize;
+
+    if(entry->offset + view->length > index->dataSize){
+        fprintf(stderr, "Index entry for graph %llu points outside the data file -- exiting!\n", i + 1);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void codeIndexShard(CODE_INDEX *index, int part, int parts,
+        unsigned long long *first, unsigned long long *end){
+    unsigned long long count = index->header->count;
+
+    *first = count / parts * part + (part < count % parts ? part : count % parts);
+    *end = *first + count / parts + (part < count % parts ? 1 : 0);
+}
@@ -0,0 +1,106 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef CODE_INDEX_H
+#define	CODE_INDEX_H
+
+#include "code_reader.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* An index for a file with graphs in multicode or planarcode format. The index
+ * is stored in a separate file (by default the name of the data file followed
+ * by .idx) and contains for each graph the position of its code in the data
+ * file, its order and its number of edges. The index is built in one pass
+ * over the data file. When it is opened, both the index and the data file are
+ * mapped into memory, so any graph can be reached without reading the graphs
+ * before it.
+ *
+ * The numbers in the index are stored in the native byte order, just like the
+ * two-byte entries in the codes themselves.
+ */
+
+typedef struct __code_index CODE_INDEX;
+typedef struct __code_index_entry CODE_INDEX_ENTRY;
+
+struct __code_index_entry {
+    //the position of the first byte of the code in the data file
+    unsigned long long offset;
+    unsigned int order;
+    unsigned int edgeCount;
+};
+
+#define CODE_INDEX_EXTENSION ".idx"
+
+/**
+ * Reads all graphs in data and writes an index for them to indexFile. The
+ * header, listOffset and entriesPerEdge (i.e., the number of times each edge
+ * appears in the code) describe the format. Returns the number of graphs that
+ * were indexed. Exits in case of error.
+ */
+unsigned long long writeCodeIndex(FILE *data, const char *header, int listOffset,
+        int entriesPerEdge, FILE *indexFile);
+
+#define writeMultiCodeIndex(data, indexFile) \
+        writeCodeIndex((data), MULTICODE_HEADER, -1, 1, (indexFile))
+#define writePlanarCodeIndex(data, indexFile) \
+        writeCodeIndex((data), PLANARCODE_HEADER, 0, 2, (indexFile))
+
+/**
+ * Returns the default name of the index for the given data file. The returned
+ * string should be freed by the caller.
+ */
+char *codeIndexFileName(const char *dataFileName);
+
+/**
+ * Opens the index for the given data file. If indexFileName is NULL, the
+ * default name is used. Returns NULL if the index file does not exist. Exits
+ * if the index is invalid, does not belong to this format or is older than the
+ * data file.
+ */
+CODE_INDEX *openCodeIndex(const char *dataFileName, const char *indexFileName,
+        const char *header);
+
+#define openMultiCodeIndex(dataFileName, indexFileName) \
+        openCodeIndex((dataFileName), (indexFileName), MULTICODE_HEADER)
+#define openPlanarCodeIndex(dataFileName, indexFileName) \
+        openCodeIndex((dataFileName), (indexFileName), PLANARCODE_HEADER)
+
+void closeCodeIndex(CODE_INDEX *index);
+
+/**
+ * Returns the number of graphs in the index.
+ */
+unsigned long long codeIndexSize(CODE_INDEX *index);
+
+/**
+ * Returns the entry for graph i (0 <= i < codeIndexSize(index)).
+ */
+const CODE_INDEX_ENTRY *codeIndexEntry(CODE_INDEX *index, unsigned long long i);
+
+/**
+ * Stores a view on the code of graph i (0 <= i < codeIndexSize(index)) in
+ * view. The view remains valid until the index is closed.
+ */
+void codeIndexView(CODE_INDEX *index, unsigned long long i, CODE_VIEW *view);
+
+/**
+ * Divides the graphs in the index in parts consecutive ranges of nearly equal
+ * size and stores the range of part part (0 <= part < parts) in first (the
+ * first graph in the range) and end (the first graph after the range).
+ */
+void codeIndexShard(CODE_INDEX *index, int part, int parts,
+        unsigned long long *first, unsigned long long *end);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CODE_INDEX_H */
+
@@ -0,0 +1,387 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "code_reader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define FALSE 0
+#define TRUE 1
+
+//the size of the blocks that are read from files that cannot be mapped
+#define CODE_READER_BLOCK_SIZE (1 << 20)
+
+struct __code_reader {
+    FILE *file;
+
+    const char *header;
+    int listOffset;
+    int headerRead;
+
+    //the bytes in buffer[start] up to buffer[end - 1] have not yet been used
+    unsigned char *buffer;
+    size_t capacity;
+    size_t start;
+    size_t end;
+
+    //the position of buffer[0] in the file
+    unsigned long long bufferOffset;
+
+    //TRUE if buffer is a memory map of the complete file
+    int mapped;
+    size_t mapLength;
+
+    //TRUE if nothing more can be read from the file
+    int eof;
+};
+
+/* Tries to map the file into memory. This is only possible for regular files.
+ */
+void _mapCodeFile(CODE_READER *reader){
+    struct stat fileStat;
+    int fd = fileno(reader->file);
+    off_t position;
+    void *map;
+
+    if(fd < 0 || fstat(fd, &fileStat) || !S_ISREG(fileStat.st_mode) ||
+            fileStat.st_size <= 0){
+        return;
+    }
+
+    position = ftello(reader->file);
+    if(position < 0 || position > fileStat.st_size){
+        return;
+    }
+
+    map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map == MAP_FAILED){
+        return;
+    }
+    madvise(map, fileStat.st_size, MADV_SEQUENTIAL);
+
+    reader->mapped = TRUE;
+    reader->mapLength = fileStat.st_size;
+    reader->buffer = map;
+    reader->capacity = fileStat.st_size;
+    reader->start = position;
+    reader->end = fileStat.st_size;
+    reader->bufferOffset = 0;
+    reader->eof = TRUE;
+}
+
+CODE_READER *newCodeReader(FILE *file, const char *header, int listOffset){
+    CODE_READER *reader = (CODE_READER *)malloc(sizeof(CODE_READER));
+    if(reader == NULL){
+        fprintf(stderr, "Insufficient memory for code reader -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    reader->file = file;
+    reader->header = header;
+    reader->listOffset = listOffset;
+    reader->headerRead = FALSE;
+    reader->buffer = NULL;
+    reader->capacity = reader->start = reader->end = 0;
+    reader->bufferOffset = 0;
+    reader->mapped = FALSE;
+    reader->mapLength = 0;
+    reader->eof = FALSE;
+
+    _mapCodeFile(reader);
+
+    if(!reader->mapped){
+        reader->capacity = CODE_READER_BLOCK_SIZE;
+        reader->buffer = (unsigned char *)malloc(reader->capacity);
+        if(reader->buffer == NULL){
+            fprintf(stderr, "Insufficient memory for code reader -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return reader;
+}
+
+void skipCodeHeader(CODE_READER *reader){
+    reader->headerRead = TRUE;
+}
+
+void freeCodeReader(CODE_READER *reader){
+    if(reader->mapped){
+        munmap(reader->buffer, reader->mapLength);
+    } else {
+        free(reader->buffer);
+    }
+    free(reader);
+}
+
+/* Makes sure that at least needed unused bytes are available in the buffer,
+ * unless the end of the file is reached. Returns the number of unused bytes.
+ */
+size_t _fillCodeBuffer(CODE_READER *reader, size_t needed){
+    if(reader->end - reader->start >= needed || reader->eof){
+        return reader->end - reader->start;
+    }
+
+    if(reader->capacity - reader->start < needed){
+        //move the unused bytes to the front of the buffer
+        memmove(reader->buffer, reader->buffer + reader->start,
+                reader->end - reader->start);
+        reader->bufferOffset += reader->start;
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    if(reader->capacity < needed){
+        size_t newCapacity = reader->capacity;
+        unsigned char *newBuffer;
+        while(newCapacity < needed){
+            newCapacity *= 2;
+        }
+        newBuffer = (unsigned char *)realloc(reader->buffer, newCapacity);
+        if(newBuffer == NULL){
+            fprintf(stderr, "Insufficient memory to store code -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        reader->buffer = newBuffer;
+        reader->capacity = newCapacity;
+    }
+
+    while(reader->end - reader->start < needed && !reader->eof){
+        ssize_t readCount = read(fileno(reader->file), reader->buffer + reader->end,
+                reader->capacity - reader->end);
+        if(readCount > 0){
+            reader->end += readCount;
+        } else if(readCount == 0){
+            reader->eof = TRUE;
+        } else if(errno != EINTR){
+            fprintf(stderr, "Error while reading input -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return reader->end - reader->start;
+}
+
+/* Reads the header at the start of the file. Returns FALSE if the file ends
+ * within the header.
+ */
+int _readCodeHeader(CODE_READER *reader){
+    size_t headerLength = strlen(reader->header);
+    size_t position;
+
+    if(_fillCodeBuffer(reader, headerLength) < headerLength){
+        fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
+        exit(1);
+    }
+    if(memcmp(reader->buffer + reader->start, reader->header, headerLength)){
+        fprintf(stderr, "No header %s<< detected -- exiting!\n", reader->header);
+        exit(1);
+    }
+
+    //skip remainder of header (either empty or le/be specification)
+    position = headerLength;
+    while(TRUE){
+        if(_fillCodeBuffer(reader, position + 1) < position + 1){
+            return FALSE;
+        }
+        if(reader->buffer[reader->start + position] == '<'){
+            break;
+        }
+        position++;
+    }
+    //skip one more character
+    position += 2;
+    if(_fillCodeBuffer(reader, position) < position){
+        return FALSE;
+    }
+    reader->start += position;
+
+    return TRUE;
+}
+
+/* Skips a header in the middle of the file. The start of the buffer is at the
+ * start of this header.
+ */
+void _skipInternalCodeHeader(CODE_READER *reader){
+    size_t position = 3;
+
+    while(TRUE){
+        if(_fillCodeBuffer(reader, position + 1) < position + 1){
+            fprintf(stderr, "Problems with header -- no closing '<'\n");
+            exit(1);
+        }
+        if(reader->buffer[reader->start + position] == '<'){
+            break;
+        }
+        position++;
+    }
+    //check the second '<'
+    position++;
+    if(_fillCodeBuffer(reader, position + 1) < position + 1 ||
+            reader->buffer[reader->start + position] != '<'){
+        fprintf(stderr, "Problems with header -- single '<'\n");
+        exit(1);
+    }
+    reader->start += position + 1;
+}
+
+/* Returns the length of the code that starts at the start of the buffer and
+ * has the given number of lists with one-byte entries.
+ */
+size_t _scanByteCode(CODE_READER *reader, int lists){
+    size_t position = 1;
+    int zeroCounter = 0;
+
+    while(zeroCounter < lists){
+        size_t available = _fillCodeBuffer(reader, position + 1);
+        const unsigned char *base = reader->buffer + reader->start;
+        const unsigned char *zero;
+        if(available <= position){
+            fprintf(stderr, "Unexpected EOF.\n");
+            exit(1);
+        }
+        zero = memchr(base + position, 0, available - position);
+        if(zero == NULL){
+            position = available;
+        } else {
+            zeroCounter++;
+            position = zero - base + 1;
+        }
+    }
+
+    return position;
+}
+
+/* Returns the length of the code that starts at the start of the buffer and
+ * has the given number of lists with two-byte entries. The code starts with a
+ * zero byte and the order.
+ */
+size_t _scanShortCode(CODE_READER *reader, int lists){
+    size_t position = 3;
+    int zeroCounter = 0;
+
+    while(zeroCounter < lists){
+        size_t available = _fillCodeBuffer(reader, position + 2);
+        const unsigned char *base = reader->buffer + reader->start;
+        const unsigned char *zero;
+        size_t zeroPosition;
+        if(available < position + 2){
+            fprintf(stderr, "Unexpected EOF.\n");
+            exit(1);
+        }
+        //only look at complete entries
+        available -= (available - position) % 2;
+        zero = memchr(base + position, 0, available - position);
+        if(zero == NULL){
+            position = available;
+            continue;
+        }
+        zeroPosition = zero - base;
+        if((zeroPosition - position) % 2){
+            //high byte of an entry: the low byte is not zero
+            position = zeroPosition + 1;
+        } else if(base[zeroPosition + 1] == 0){
+            zeroCounter++;
+            position = zeroPosition + 2;
+        } else {
+            position = zeroPosition + 2;
+        }
+    }
+
+    return position;
+}
+
+int nextCode(CODE_READER *reader, CODE_VIEW *view){
+    const unsigned char *code;
+    size_t length;
+
+    if(!reader->headerRead){
+        reader->headerRead = TRUE;
+        if(!_readCodeHeader(reader)){
+            reader->start = reader->end;
+            reader->eof = TRUE;
+            return 0;
+        }
+    }
+
+    if(_fillCodeBuffer(reader, 1) == 0){
+        //nothing left in file
+        return 0;
+    }
+
+    /* possibly removing interior headers */
+    code = reader->buffer + reader->start;
+    if(code[0] == '>' && _fillCodeBuffer(reader, 3) >= 3){
+        code = reader->buffer + reader->start;
+        if(code[1] == '>' && code[2] == reader->header[2]){
+            _skipInternalCodeHeader(reader);
+            if(_fillCodeBuffer(reader, 1) == 0){
+                //nothing left in file
+                return 0;
+            }
+        }
+    }
+
+    code = reader->buffer + reader->start;
+    if(code[0] != 0){
+        view->order = code[0];
+        view->shortCode = FALSE;
+        length = _scanByteCode(reader, view->order + reader->listOffset);
+        view->entryCount = length - 1;
+    } else {
+        if(_fillCodeBuffer(reader, 3) < 3){
+            fprintf(stderr, "Unexpected EOF.\n");
+            exit(1);
+        }
+        view->order = codeEntryShort(reader->buffer + reader->start + 1, 0);
+        view->shortCode = TRUE;
+        length = _scanShortCode(reader, view->order + reader->listOffset);
+        view->entryCount = (length - 3)/2;
+    }
+
+    //the buffer might have moved while scanning
+    view->data = reader->buffer + reader->start;
+    view->body = view->data + (view->shortCode ? 3 : 1);
+    view->length = length;
+    view->offset = reader->bufferOffset + reader->start;
+
+    reader->start += length;
+
+    return 1;
+}
+
+int codeViewToArray(CODE_VIEW *view, unsigned short *code){
+    int i;
+
+    code[0] = view->order;
+    if(view->shortCode){
+        memcpy(code + 1, view->body, 2*view->entryCount);
+    } else {
+        for(i = 0; i < view->entryCount; i++){
+            code[i + 1] = view->body[i];
+        }
+    }
+
+    return view->entryCount + 1;
+}
+
+void writeCodeView(CODE_VIEW *view, const char *header, FILE *file){
+    if(header != NULL){
+        fprintf(file, "%s<<", header);
+    }
+    if(fwrite(view->data, 1, view->length, file) != view->length){
+        fprintf(stderr, "fwrite() failed -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef CODE_READER_H
+#define	CODE_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A reader for the binary graph codes in this repository (multicode and
+ * planarcode). Both formats consist of a header, followed by the codes of the
+ * graphs. Each code starts with the order (or a zero followed by the order
+ * as a two-byte number) and consists of a number of lists that are closed by
+ * a zero. The reader reads large blocks from the file (or maps the file into
+ * memory if it is a regular file), locates the zeros with memchr and hands
+ * out views on the codes that point directly into this memory.
+ *
+ * All state is contained in the reader, so different readers can be used at
+ * the same time (e.g., in different threads).
+ */
+
+typedef struct __code_reader CODE_READER;
+typedef struct __code_view CODE_VIEW;
+
+struct __code_view {
+    //the first byte of the code of this graph
+    const unsigned char *data;
+    //the total number of bytes in the code of this graph
+    size_t length;
+
+    //the position of the first byte of this code in the file
+    unsigned long long offset;
+
+    int order;
+    //TRUE if the entries are two-byte numbers
+    int shortCode;
+
+    //the first entry after the order and the number of entries
+    const unsigned char *body;
+    int entryCount;
+};
+
+/* Returns the i-th entry in the body of the code. */
+#define CODE_ENTRY(view, i) ((view)->shortCode ? \
+        codeEntryShort((view)->body, (i)) : (unsigned short)(view)->body[i])
+
+static inline unsigned short codeEntryShort(const unsigned char *body, int i){
+    unsigned short entry;
+    const unsigned char *p = body + 2*i;
+    ((unsigned char *)&entry)[0] = p[0];
+    ((unsigned char *)&entry)[1] = p[1];
+    return entry;
+}
+
+#define MULTICODE_HEADER ">>multi_code"
+#define PLANARCODE_HEADER ">>planar_code"
+
+/**
+ * Creates a new reader for the given file. The header is the start of the
+ * header of the file (e.g., MULTICODE_HEADER). The number of lists in a code is
+ * the order of the graph plus listOffset (i.e., -1 for multicode and 0 for
+ * planarcode). Exits if there is insufficient memory.
+ */
+CODE_READER *newCodeReader(FILE *file, const char *header, int listOffset);
+
+#define newMultiCodeReader(file) newCodeReader((file), MULTICODE_HEADER, -1)
+#define newPlanarCodeReader(file) newCodeReader((file), PLANARCODE_HEADER, 0)
+
+/**
+ * Tells the reader that the file does not start with a header. This should be
+ * called before the first call to nextCode.
+ */
+void skipCodeHeader(CODE_READER *reader);
+
+/**
+ * Frees the reader. This does not close the file.
+ */
+void freeCodeReader(CODE_READER *reader);
+
+/**
+ * Reads the next code and stores a view on it in view. The memory the view
+ * points to remains valid until the next call to this function for this
+ * reader.
+ *
+ * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
+ */
+int nextCode(CODE_READER *reader, CODE_VIEW *view);
+
+/**
+ * Copies the code in the view to code in the format used by readMultiCode and
+ * readPlanarCode: the first entry is the order, and the remaining entries are
+ * the entries of the code. Returns the number of entries stored in code.
+ */
+int codeViewToArray(CODE_VIEW *view, unsigned short *code);
+
+/**
+ * Writes the code in the view to file exactly as it was read, without decoding
+ * and encoding the graph again. If header is not NULL, the header of the format
+ * (e.g., PLANARCODE_HEADER) is written before the code. Exits in case of error.
+ */
+void writeCodeView(CODE_VIEW *view, const char *header, FILE *file);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CODE_READER_H */
+
@@ -0,0 +1,552 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "external_dedup.h"
+#include "hash_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+//a checkpoint is written after this many records or bytes
+#define CHECKPOINT_RECORDS (1 << 16)
+#define CHECKPOINT_BYTES (64ULL << 20)
+//a partition is not split more often than this
+#define MAX_SPLIT_LEVEL 3
+
+#define CHECKPOINT_TITLE "external dedup checkpoint"
+
+typedef struct __key_record KEY_RECORD;
+typedef struct __result_record RESULT_RECORD;
+typedef struct __result_head RESULT_HEAD;
+
+//in a partition file each record is followed by the key and the payload
+struct __key_record {
+    unsigned long long number;
+    HASH_128 hash;
+    unsigned int keyLength;
+    unsigned int payloadLength;
+};
+
+//in a result file each record is followed by the payload
+struct __result_record {
+    unsigned long long number;
+    unsigned long long copy;
+    unsigned int payloadLength;
+};
+
+struct __external_dedup {
+    char *directory;
+    int partitionCount;
+    size_t memoryBudget;
+
+    FILE **partitions;
+    unsigned long long resumePoint;
+    unsigned long long lastNumber;
+    unsigned long long recordsSinceCheckpoint;
+    unsigned long long bytesSinceCheckpoint;
+    int addingComplete;
+    int finished;
+};
+
+//================= Files =================
+
+static void *_allocateDedupMemory(void *memory, size_t size){
+    memory = realloc(memory, size);
+    if(memory == NULL){
+        fprintf(stderr, "Insufficient memory for external deduplication -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+static char *_dedupPath(EXTERNAL_DEDUP *dedup, const char *name, int index){
+    size_t size = strlen(dedup->directory) + strlen(name) + 32;
+    char *path = _allocateDedupMemory(NULL, size);
+
+    if(index < 0){
+        snprintf(path, size, "%s/%s", dedup->directory, name);
+    } else {
+        snprintf(path, size, "%s/%s-%d", dedup->directory, name, index);
+    }
+    return path;
+}
+
+//returns path followed by suffix and, if index is not negative, by index
+static char *_extendPath(const char *path, const char *suffix, int index){
+    size_t size = strlen(path) + strlen(suffix) + 16;
+    char *extendedPath = _allocateDedupMemory(NULL, size);
+
+    if(index < 0){
+        snprintf(extendedPath, size, "%s%s", path, suffix);
+    } else {
+        snprintf(extendedPath, size, "%s%s%d", path, suffix, index);
+    }
+    return extendedPath;
+}
+
+static FILE *_openDedupFile(const char *path, const char *mode){
+    FILE *f = fopen(path, mode);
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s (%s) -- exiting!\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    return f;
+}
+
+static void _writeDedupData(const void *data, size_t size, FILE *f){
+    if(size && fwrite(data, size, 1, f) != 1){
+        fprintf(stderr, "Could not write to deduplication file (%s) -- exiting!\n",
+                strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void _readDedupData(void *data, size_t size, FILE *f){
+    if(size && fread(data, size, 1, f) != 1){
+        fprintf(stderr, "Deduplication file is truncated -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static int _fileExists(const char *path){
+    struct stat info;
+    return stat(path, &info) == 0;
+}
+
+static unsigned long long _fileSize(const char *path){
+    struct stat info;
+    if(stat(path, &info)){
+        fprintf(stderr, "Could not inspect %s (%s) -- exiting!\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    return info.st_size;
+}
+
+/* Reads the next key record from f and stores its key and payload in
+ * buffer, which is grown if needed. Returns 0 at the end of the file.
+ */
+static int _readKeyRecord(FILE *f, KEY_RECORD *record, unsigned char **buffer, size_t *capacity){
+    size_t size;
+
+    if(fread(record, sizeof(KEY_RECORD), 1, f) != 1){
+        return 0;
+    }
+    size = (size_t)record->keyLength + record->payloadLength;
+    if(size > *capacity){
+        *capacity = 2*size;
+        *buffer = _allocateDedupMemory(*buffer, *capacity);
+    }
+    _readDedupData(*buffer, size, f);
+    return 1;
+}
+
+//================= Checkpoints =================
+
+static void _writeCheckpoint(EXTERNAL_DEDUP *dedup){
+    int i;
+    char *path = _dedupPath(dedup, "checkpoint", -1);
+    char *temporaryPath = _dedupPath(dedup, "checkpoint.tmp", -1);
+    FILE *f = _openDedupFile(temporaryPath, "w");
+
+    fprintf(f, "%s\n", CHECKPOINT_TITLE);
+    fprintf(f, "partitions %d\n", dedup->partitionCount);
+    fprintf(f, "number %llu\n", dedup->lastNumber);
+    fprintf(f, "complete %d\n", dedup->addingComplete);
+    for(i = 0; i < dedup->partitionCount; i++){
+        //all partitions are flushed, so this is the length on disk
+        fflush(dedup->partitions[i]);
+        fprintf(f, "%ld\n", ftell(dedup->partitions[i]));
+    }
+    if(fclose(f)){
+        fprintf(stderr, "Could not write checkpoint (%s) -- exiting!\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    //the old checkpoint stays valid until the new one is complete
+    if(rename(temporaryPath, path)){
+        fprintf(stderr, "Could not write checkpoint (%s) -- exiting!\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    dedup->recordsSinceCheckpoint = 0;
+    dedup->bytesSinceCheckpoint = 0;
+    free(path);
+    free(temporaryPath);
+}
+
+/* Restores the partitions to the state of the checkpoint. Returns 0 if there
+ * is no checkpoint.
+ */
+static int _resumeFromCheckpoint(EXTERNAL_DEDUP *dedup){
+    int i, partitionCount;
+    long length;
+    char title[64];
+    char *path = _dedupPath(dedup, "checkpoint", -1);
+    FILE *f = fopen(path, "r");
+
+    free(path);
+    if(f == NULL){
+        return 0;
+    }
+
+    if(fgets(title, sizeof(title), f) == NULL || strncmp(title, CHECKPOINT_TITLE, strlen(CHECKPOINT_TITLE)) ||
+            fscanf(f, " partitions %d number %llu complete %d", &partitionCount,
+                &dedup->lastNumber, &dedup->addingComplete) != 3){
+        fprintf(stderr, "Invalid checkpoint in %s -- exiting!\n", dedup->directory);
+        exit(EXIT_FAILURE);
+    }
+    if(partitionCount != dedup->partitionCount){
+        fprintf(stderr, "The run in %s used %d partitions -- exiting!\n",
+                dedup->directory, partitionCount);
+        exit(EXIT_FAILURE);
+    }
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        char *partitionPath = _dedupPath(dedup, "partition", i);
+        if(fscanf(f, " %ld", &length) != 1){
+            fprintf(stderr, "Invalid checkpoint in %s -- exiting!\n", dedup->directory);
+            exit(EXIT_FAILURE);
+        }
+        //drop the records that were written after the checkpoint
+        if(truncate(partitionPath, length)){
+            fprintf(stderr, "Could not restore %s (%s) -- exiting!\n", partitionPath, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        dedup->partitions[i] = _openDedupFile(partitionPath, "ab");
+        //make sure ftell gives the length before the first write
+        fseek(dedup->partitions[i], 0, SEEK_END);
+        free(partitionPath);
+    }
+    fclose(f);
+
+    dedup->resumePoint = dedup->lastNumber;
+    return 1;
+}
+
+//================= Adding keys =================
+
+EXTERNAL_DEDUP *openExternalDedup(const char *directory, int partitionCount,
+        size_t memoryBudget){
+    int i;
+    EXTERNAL_DEDUP *dedup = _allocateDedupMemory(NULL, sizeof(EXTERNAL_DEDUP));
+
+    if(partitionCount < 1){
+        fprintf(stderr, "The number of partitions should be positive -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if(mkdir(directory, 0777) && errno != EEXIST){
+        fprintf(stderr, "Could not create %s (%s) -- exiting!\n", directory, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    dedup->directory = _allocateDedupMemory(NULL, strlen(directory) + 1);
+    strcpy(dedup->directory, directory);
+    dedup->partitionCount = partitionCount;
+    dedup->memoryBudget = memoryBudget;
+    dedup->partitions = _allocateDedupMemory(NULL, sizeof(FILE *)*partitionCount);
+    dedup->resumePoint = 0;
+    dedup->lastNumber = 0;
+    dedup->recordsSinceCheckpoint = 0;
+    dedup->bytesSinceCheckpoint = 0;
+    dedup->addingComplete = 0;
+    dedup->finished = 0;
+
+    if(!_resumeFromCheckpoint(dedup)){
+        for(i = 0; i < partitionCount; i++){
+            char *partitionPath = _dedupPath(dedup, "partition", i);
+            dedup->partitions[i] = _openDedupFile(partitionPath, "wb");
+            free(partitionPath);
+        }
+        _writeCheckpoint(dedup);
+    }
+
+    return dedup;
+}
+
+unsigned long long externalDedupResumePoint(EXTERNAL_DEDUP *dedup){
+    return dedup->resumePoint;
+}
+
+void addToExternalDedup(EXTERNAL_DEDUP *dedup, unsigned long long number,
+        const void *key, size_t keyLength, const void *payload, size_t payloadLength){
+    KEY_RECORD record;
+    FILE *partition;
+
+    if(number <= dedup->resumePoint){
+        return;
+    }
+    if(dedup->addingComplete){
+        fprintf(stderr, "The run in %s was already complete, but the input is longer -- exiting!\n",
+                dedup->directory);
+        exit(EXIT_FAILURE);
+    }
+
+    record.number = number;
+    record.hash = computeHash128(key, keyLength);
+    record.keyLength = keyLength;
+    record.payloadLength = payloadLength;
+
+    partition = dedup->partitions[record.hash.high % dedup->partitionCount];
+    _writeDedupData(&record, sizeof(KEY_RECORD), partition);
+    _writeDedupData(key, keyLength, partition);
+    _writeDedupData(payload, payloadLength, partition);
+
+    dedup->lastNumber = number;
+    dedup->recordsSinceCheckpoint++;
+    dedup->bytesSinceCheckpoint += sizeof(KEY_RECORD) + keyLength + payloadLength;
+    if(dedup->recordsSinceCheckpoint >= CHECKPOINT_RECORDS ||
+            dedup->bytesSinceCheckpoint >= CHECKPOINT_BYTES){
+        _writeCheckpoint(dedup);
+    }
+}
+
+//================= Merging results =================
+
+struct __result_head {
+    FILE *file;
+    RESULT_RECORD record;
+    unsigned char *payload;
+    size_t capacity;
+};
+
+static int _readResultHead(RESULT_HEAD *head){
+    if(fread(&head->record, sizeof(RESULT_RECORD), 1, head->file) != 1){
+        return 0;
+    }
+    if(head->record.payloadLength > head->capacity){
+        head->capacity = 2*head->record.payloadLength;
+        head->payload = _allocateDedupMemory(head->payload, head->capacity);
+    }
+    _readDedupData(head->payload, head->record.payloadLength, head->file);
+    return 1;
+}
+
+static void _siftDown(RESULT_HEAD **heap, int size, int i){
+    while(2*i + 1 < size){
+        int child = 2*i + 1;
+        RESULT_HEAD *swap;
+        if(child + 1 < size && heap[child + 1]->record.number < heap[child]->record.number){
+            child++;
+        }
+        if(heap[i]->record.number <= heap[child]->record.number){
+            return;
+        }
+        swap = heap[i];
+        heap[i] = heap[child];
+        heap[child] = swap;
+        i = child;
+    }
+}
+
+/* Merges the result files, which are each sorted by number, and reports the
+ * results in the order of the numbers.
+ */
+static void _mergeResults(char **paths, int count, EXTERNAL_DEDUP_REPORT report, void *data){
+    int i, size = 0;
+    RESULT_HEAD *heads = _allocateDedupMemory(NULL, sizeof(RESULT_HEAD)*count);
+    RESULT_HEAD **heap = _allocateDedupMemory(NULL, sizeof(RESULT_HEAD *)*count);
+
+    for(i = 0; i < count; i++){
+        heads[i].file = _openDedupFile(paths[i], "rb");
+        heads[i].payload = NULL;
+        heads[i].capacity = 0;
+        if(_readResultHead(heads + i)){
+            heap[size++] = heads + i;
+        }
+    }
+    for(i = size/2 - 1; i >= 0; i--){
+        _siftDown(heap, size, i);
+    }
+
+    while(size){
+        RESULT_HEAD *head = heap[0];
+        report(head->record.number, head->record.copy, head->payload,
+                head->record.payloadLength, data);
+        if(!_readResultHead(head)){
+            heap[0] = heap[--size];
+        }
+        _siftDown(heap, size, 0);
+    }
+
+    for(i = 0; i < count; i++){
+        fclose(heads[i].file);
+        free(heads[i].payload);
+    }
+    free(heads);
+    free(heap);
+}
+
+static void _writeResult(unsigned long long number, unsigned long long copy,
+        const void *payload, size_t payloadLength, void *data){
+    FILE *f = (FILE *)data;
+    RESULT_RECORD record;
+
+    record.number = number;
+    record.copy = copy;
+    record.payloadLength = payloadLength;
+    _writeDedupData(&record, sizeof(RESULT_RECORD), f);
+    _writeDedupData(payload, payloadLength, f);
+}
+
+//================= Deduplicating partitions =================
+
+static void _dedupPartitionInMemory(const char *path, FILE *result){
+    KEY_RECORD record;
+    unsigned char *buffer = NULL;
+    size_t capacity = 0;
+    unsigned long long copy;
+    HASH_STORE *store = newHashStore();
+    FILE *partition = _openDedupFile(path, "rb");
+
+    while(_readKeyRecord(partition, &record, &buffer, &capacity)){
+        //the records are in the order of the numbers, so the first one is stored
+        if(addHashedToHashStore(store, record.hash, buffer, record.keyLength,
+                record.number, &copy)){
+            _writeResult(record.number, 0, buffer + record.keyLength,
+                    record.payloadLength, result);
+        } else {
+            _writeResult(record.number, copy, NULL, 0, result);
+        }
+    }
+
+    fclose(partition);
+    free(buffer);
+    freeHashStore(store);
+}
+
+/* Deduplicates the partition at path and writes the results to result. If the
+ * partition is larger than the memory budget, it is first split into smaller
+ * partitions based on the next digits of the hash in base partitionCount.
+ */
+static void _dedupPartition(EXTERNAL_DEDUP *dedup, const char *path, FILE *result, int level){
+    int i;
+    unsigned long long divisor = 1;
+    KEY_RECORD record;
+    unsigned char *buffer = NULL;
+    size_t capacity = 0;
+    FILE *partition, **parts;
+    char **partPaths, **resultPaths;
+
+    for(i = 0; i < level && divisor <= ~0ULL / dedup->partitionCount; i++){
+        divisor *= dedup->partitionCount;
+    }
+    if(_fileSize(path) <= dedup->memoryBudget || dedup->partitionCount == 1 ||
+            level > MAX_SPLIT_LEVEL || i < level){
+        _dedupPartitionInMemory(path, result);
+        return;
+    }
+
+    partPaths = _allocateDedupMemory(NULL, sizeof(char *)*dedup->partitionCount);
+    resultPaths = _allocateDedupMemory(NULL, sizeof(char *)*dedup->partitionCount);
+    parts = _allocateDedupMemory(NULL, sizeof(FILE *)*dedup->partitionCount);
+    for(i = 0; i < dedup->partitionCount; i++){
+        partPaths[i] = _extendPath(path, ".", i);
+        parts[i] = _openDedupFile(partPaths[i], "wb");
+    }
+
+    partition = _openDedupFile(path, "rb");
+    while(_readKeyRecord(partition, &record, &buffer, &capacity)){
+        FILE *part = parts[(record.hash.high / divisor) % dedup->partitionCount];
+        _writeDedupData(&record, sizeof(KEY_RECORD), part);
+        _writeDedupData(buffer, (size_t)record.keyLength + record.payloadLength, part);
+    }
+    fclose(partition);
+    free(buffer);
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        FILE *partResult;
+        fclose(parts[i]);
+        resultPaths[i] = _extendPath(partPaths[i], ".result", -1);
+        partResult = _openDedupFile(resultPaths[i], "wb");
+        _dedupPartition(dedup, partPaths[i], partResult, level + 1);
+        fclose(partResult);
+        remove(partPaths[i]);
+    }
+
+    _mergeResults(resultPaths, dedup->partitionCount, _writeResult, result);
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        remove(resultPaths[i]);
+        free(partPaths[i]);
+        free(resultPaths[i]);
+    }
+    free(partPaths);
+    free(resultPaths);
+    free(parts);
+}
+
+void finishExternalDedup(EXTERNAL_DEDUP *dedup, EXTERNAL_DEDUP_REPORT report, void *data){
+    int i;
+    char **resultPaths = _allocateDedupMemory(NULL, sizeof(char *)*dedup->partitionCount);
+
+    dedup->addingComplete = 1;
+    _writeCheckpoint(dedup);
+    for(i = 0; i < dedup->partitionCount; i++){
+        fclose(dedup->partitions[i]);
+        dedup->partitions[i] = NULL;
+    }
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        resultPaths[i] = _dedupPath(dedup, "result", i);
+        //a result only gets its final name once it is complete
+        if(!_fileExists(resultPaths[i])){
+            char *partitionPath = _dedupPath(dedup, "partition", i);
+            char *temporaryPath = _extendPath(resultPaths[i], ".tmp", -1);
+            FILE *result = _openDedupFile(temporaryPath, "wb");
+            _dedupPartition(dedup, partitionPath, result, 1);
+            if(fclose(result) || rename(temporaryPath, resultPaths[i])){
+                fprintf(stderr, "Could not write %s (%s) -- exiting!\n", resultPaths[i], strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            free(partitionPath);
+            free(temporaryPath);
+        }
+    }
+
+    _mergeResults(resultPaths, dedup->partitionCount, report, data);
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        free(resultPaths[i]);
+    }
+    free(resultPaths);
+    dedup->finished = 1;
+}
+
+void closeExternalDedup(EXTERNAL_DEDUP *dedup){
+    int i;
+    char *path;
+
+    for(i = 0; i < dedup->partitionCount; i++){
+        if(dedup->partitions[i] != NULL){
+            fclose(dedup->partitions[i]);
+        }
+    }
+
+    if(dedup->finished){
+        for(i = 0; i < dedup->partitionCount; i++){
+            path = _dedupPath(dedup, "partition", i);
+            remove(path);
+            free(path);
+            path = _dedupPath(dedup, "result", i);
+            remove(path);
+            free(path);
+        }
+        path = _dedupPath(dedup, "checkpoint", -1);
+        remove(path);
+        free(path);
+        //fails if the directory contains other files
+        rmdir(dedup->directory);
+    }
+
+    free(dedup->directory);
+    free(dedup->partitions);
+    free(dedup);
+}
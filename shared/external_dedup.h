@@ -0,0 +1,85 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef EXTERNAL_DEDUP_H
+#define	EXTERNAL_DEDUP_H
+
+#include <stddef.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* Removes duplicates from a sequence of numbered keys (e.g., canonical forms
+ * of graphs) that does not fit into memory. The keys are first written to a
+ * number of partition files in a directory, where the partition of a key is
+ * determined by its hash, so equal keys always end up in the same partition.
+ * Once all keys are added, each partition is deduplicated in memory with a
+ * hash store. A partition which is larger than the memory budget is split
+ * again into smaller partitions first. Finally the results of the partitions
+ * are merged, so that they are reported in the order of the numbers.
+ *
+ * Each key can have a payload (e.g., the code of the graph) which is reported
+ * together with the first occurrence of that key.
+ *
+ * A checkpoint is written regularly while keys are added. If the program is
+ * interrupted, a new run with the same directory and the same input continues
+ * from the last checkpoint: keys with a number up to the resume point are
+ * already stored and should not be added again. Partitions which were
+ * completely deduplicated are not processed again.
+ */
+
+typedef struct __external_dedup EXTERNAL_DEDUP;
+
+/**
+ * Is called for each number in increasing order. The copy is 0 if the key
+ * with this number did not occur before, and otherwise the number of the
+ * first occurrence of the key. The payload is only given for a new key.
+ */
+typedef void (*EXTERNAL_DEDUP_REPORT)(unsigned long long number,
+        unsigned long long copy, const void *payload, size_t payloadLength,
+        void *data);
+
+/**
+ * Opens an external deduplication in the given directory, which is created if
+ * it does not exist. If the directory contains a checkpoint, the previous run
+ * is resumed. The memory budget is given in bytes. Exits in case of error.
+ */
+EXTERNAL_DEDUP *openExternalDedup(const char *directory, int partitionCount,
+        size_t memoryBudget);
+
+/**
+ * Returns the largest number that was already added in a previous run, or 0
+ * if this run did not resume a previous one.
+ */
+unsigned long long externalDedupResumePoint(EXTERNAL_DEDUP *dedup);
+
+/**
+ * Adds a key with the given number. The numbers should be increasing. Keys
+ * with a number that is not larger than the resume point are ignored.
+ */
+void addToExternalDedup(EXTERNAL_DEDUP *dedup, unsigned long long number,
+        const void *key, size_t keyLength, const void *payload, size_t payloadLength);
+
+/**
+ * Deduplicates all keys and calls report for each number that was added.
+ */
+void finishExternalDedup(EXTERNAL_DEDUP *dedup, EXTERNAL_DEDUP_REPORT report, void *data);
+
+/**
+ * Frees the deduplication. If the deduplication was finished, all files in the
+ * directory which belong to it are removed, and so is the directory if it is
+ * empty.
+ */
+void closeExternalDedup(EXTERNAL_DEDUP *dedup);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* EXTERNAL_DEDUP_H */
+
@@ -0,0 +1,157 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "frequency_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 64
+//the clock is read after this many calls to isFrequencyTableSnapshotDue
+#define ADDITIONS_PER_CLOCK_CHECK 4096
+
+static void *_allocateFrequencyTableMemory(void *memory, size_t size){
+    memory = realloc(memory, size);
+    if(memory == NULL){
+        fprintf(stderr, "Insufficient memory for frequency table -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+static unsigned int _hashKey(int key){
+    //Fibonacci hashing: the high bits are well mixed even for consecutive keys
+    return ((unsigned int)key) * 2654435769U;
+}
+
+static int _findSlot(FREQUENCY_TABLE *table, int key){
+    int mask = table->slotCount - 1;
+    int slot = (int)(_hashKey(key) >> 8) & mask;
+
+    while(table->slots[slot] && table->entries[table->slots[slot] - 1].key != key){
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static void _rebuildSlots(FREQUENCY_TABLE *table){
+    int i;
+
+    memset(table->slots, 0, sizeof(int)*table->slotCount);
+    for(i = 0; i < table->size; i++){
+        table->slots[_findSlot(table, table->entries[i].key)] = i + 1;
+    }
+}
+
+FREQUENCY_TABLE *newFrequencyTable(){
+    FREQUENCY_TABLE *table = _allocateFrequencyTableMemory(NULL, sizeof(FREQUENCY_TABLE));
+
+    table->size = 0;
+    //the load factor is kept at most 1/2
+    table->capacity = INITIAL_SLOT_COUNT/2;
+    table->entries = _allocateFrequencyTableMemory(NULL, sizeof(FREQUENCY_ENTRY)*table->capacity);
+    table->slotCount = INITIAL_SLOT_COUNT;
+    table->slots = _allocateFrequencyTableMemory(NULL, sizeof(int)*table->slotCount);
+    memset(table->slots, 0, sizeof(int)*table->slotCount);
+
+    table->snapshotInterval = 0;
+
+    return table;
+}
+
+void freeFrequencyTable(FREQUENCY_TABLE *table){
+    free(table->entries);
+    free(table->slots);
+    free(table);
+}
+
+void clearFrequencyTable(FREQUENCY_TABLE *table){
+    int i;
+
+    //the slots are always filled in the order of the entries, so emptying them
+    //in reverse order never breaks the probe sequence of a remaining entry
+    for(i = table->size - 1; i >= 0; i--){
+        table->slots[_findSlot(table, table->entries[i].key)] = 0;
+    }
+    table->size = 0;
+}
+
+static void _growFrequencyTable(FREQUENCY_TABLE *table){
+    table->capacity *= 2;
+    table->entries = _allocateFrequencyTableMemory(table->entries,
+            sizeof(FREQUENCY_ENTRY)*table->capacity);
+    table->slotCount *= 2;
+    table->slots = _allocateFrequencyTableMemory(table->slots, sizeof(int)*table->slotCount);
+    _rebuildSlots(table);
+}
+
+void addToFrequencyTable(FREQUENCY_TABLE *table, int key, unsigned long long count){
+    int slot = _findSlot(table, key);
+
+    if(table->slots[slot]){
+        table->entries[table->slots[slot] - 1].frequency += count;
+        return;
+    }
+
+    if(table->size == table->capacity){
+        _growFrequencyTable(table);
+        slot = _findSlot(table, key);
+    }
+    table->entries[table->size].key = key;
+    table->entries[table->size].frequency = count;
+    table->size++;
+    table->slots[slot] = table->size;
+}
+
+unsigned long long getFrequency(FREQUENCY_TABLE *table, int key){
+    int slot = _findSlot(table, key);
+
+    return table->slots[slot] ? table->entries[table->slots[slot] - 1].frequency : 0;
+}
+
+void mergeFrequencyTables(FREQUENCY_TABLE *target, FREQUENCY_TABLE *source){
+    int i;
+
+    for(i = 0; i < source->size; i++){
+        addToFrequencyTable(target, source->entries[i].key, source->entries[i].frequency);
+    }
+}
+
+static int _compareFrequencyEntries(const void *a, const void *b){
+    int keyA = ((const FREQUENCY_ENTRY *)a)->key;
+    int keyB = ((const FREQUENCY_ENTRY *)b)->key;
+
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+void sortFrequencyTable(FREQUENCY_TABLE *table){
+    qsort(table->entries, table->size, sizeof(FREQUENCY_ENTRY), _compareFrequencyEntries);
+    _rebuildSlots(table);
+}
+
+void setFrequencyTableSnapshotInterval(FREQUENCY_TABLE *table, unsigned int interval){
+    table->snapshotInterval = interval;
+    table->nextSnapshot = time(NULL) + interval;
+    table->additionsUntilClockCheck = ADDITIONS_PER_CLOCK_CHECK;
+}
+
+int isFrequencyTableSnapshotDue(FREQUENCY_TABLE *table){
+    time_t now;
+
+    if(!table->snapshotInterval || --table->additionsUntilClockCheck){
+        return 0;
+    }
+    table->additionsUntilClockCheck = ADDITIONS_PER_CLOCK_CHECK;
+
+    now = time(NULL);
+    if(now < table->nextSnapshot){
+        return 0;
+    }
+    table->nextSnapshot = now + table->snapshotInterval;
+    return 1;
+}
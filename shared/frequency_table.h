@@ -0,0 +1,99 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef FREQUENCY_TABLE_H
+#define	FREQUENCY_TABLE_H
+
+#include <time.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A frequency table counts how often each integer key occurs. The entries are
+ * stored consecutively in one growing array and are found through an
+ * open-addressing hash table with linear probing that stores the position of
+ * each entry in that array. Clearing a table keeps all its memory, so the
+ * same table can be reused for each graph.
+ *
+ * A table does no locking: each thread should count in its own table, and the
+ * tables can be merged afterwards.
+ */
+
+typedef struct __frequency_entry FREQUENCY_ENTRY;
+typedef struct __frequency_table FREQUENCY_TABLE;
+
+struct __frequency_entry {
+    int key;
+    unsigned long long frequency;
+};
+
+struct __frequency_table {
+    FREQUENCY_ENTRY *entries;
+    int size;
+    int capacity;
+
+    //position + 1 of the entry in entries, or 0 for an empty slot
+    int *slots;
+    //always a power of 2
+    int slotCount;
+
+    //0 if no snapshots are requested
+    unsigned int snapshotInterval;
+    time_t nextSnapshot;
+    unsigned int additionsUntilClockCheck;
+};
+
+FREQUENCY_TABLE *newFrequencyTable();
+
+void freeFrequencyTable(FREQUENCY_TABLE *table);
+
+/**
+ * Removes all entries from the table.
+ */
+void clearFrequencyTable(FREQUENCY_TABLE *table);
+
+/**
+ * Increases the frequency of key by count.
+ */
+void addToFrequencyTable(FREQUENCY_TABLE *table, int key, unsigned long long count);
+
+/**
+ * Returns the frequency of key, i.e., 0 if key is not in the table.
+ */
+unsigned long long getFrequency(FREQUENCY_TABLE *table, int key);
+
+/**
+ * Adds all frequencies in source to target. The source is not changed.
+ */
+void mergeFrequencyTables(FREQUENCY_TABLE *target, FREQUENCY_TABLE *source);
+
+/**
+ * Sorts the entries of the table by increasing key, so that they can be
+ * listed by looping over table->entries.
+ */
+void sortFrequencyTable(FREQUENCY_TABLE *table);
+
+/**
+ * Requests a snapshot every interval seconds. An interval of 0 disables the
+ * snapshots.
+ */
+void setFrequencyTableSnapshotInterval(FREQUENCY_TABLE *table, unsigned int interval);
+
+/**
+ * Returns TRUE if a snapshot was requested and the interval has passed since
+ * the previous time this function returned TRUE. The clock is only read once
+ * every few calls, so this can be called after each addition.
+ */
+int isFrequencyTableSnapshotDue(FREQUENCY_TABLE *table);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FREQUENCY_TABLE_H */
+
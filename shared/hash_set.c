@@ -0,0 +1,174 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "hash_set.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define INITIAL_SLOT_COUNT (1 << 16)
+
+//the number of slots of the old table that are moved with each addition
+#define MIGRATION_STEP 16
+
+struct __hash_set {
+    //an empty slot contains the hash 0
+    HASH_128 *slots;
+    //always a power of 2
+    unsigned long long slotCount;
+
+    //while the table is being doubled, the hashes in the old table which are
+    //not yet moved are still found there
+    HASH_128 *oldSlots;
+    unsigned long long oldSlotCount;
+    unsigned long long migrated;
+
+    unsigned long long size;
+
+    unsigned long long additions;
+    unsigned long long probes;
+    unsigned long long maximumProbeLength;
+    int resizes;
+};
+
+static HASH_128 *_allocateSlots(unsigned long long slotCount){
+    HASH_128 *slots = calloc(slotCount, sizeof(HASH_128));
+    if(slots == NULL){
+        fprintf(stderr, "Insufficient memory for hash set -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return slots;
+}
+
+static inline int _isEmpty(HASH_128 *slot){
+    return slot->low == 0 && slot->high == 0;
+}
+
+/* Returns the slot that contains the hash, or the empty slot where the probe
+ * sequence of the hash ends. The number of inspected slots is added to probes.
+ */
+static inline HASH_128 *_findSlot(HASH_128 *slots, unsigned long long slotCount,
+        HASH_128 hash, unsigned long long *probes){
+    unsigned long long mask = slotCount - 1;
+    unsigned long long i = hash.low & mask;
+
+    (*probes)++;
+    while(!_isEmpty(slots + i) &&
+            (slots[i].low != hash.low || slots[i].high != hash.high)){
+        i = (i + 1) & mask;
+        (*probes)++;
+    }
+    return slots + i;
+}
+
+HASH_SET *newHashSet(){
+    HASH_SET *set = malloc(sizeof(HASH_SET));
+    if(set == NULL){
+        fprintf(stderr, "Insufficient memory for hash set -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    set->slotCount = INITIAL_SLOT_COUNT;
+    set->slots = _allocateSlots(set->slotCount);
+    set->oldSlots = NULL;
+    set->oldSlotCount = 0;
+    set->migrated = 0;
+    set->size = 0;
+    set->additions = 0;
+    set->probes = 0;
+    set->maximumProbeLength = 0;
+    set->resizes = 0;
+
+    return set;
+}
+
+void freeHashSet(HASH_SET *set){
+    free(set->oldSlots);
+    free(set->slots);
+    free(set);
+}
+
+static void _migrate(HASH_SET *set){
+    unsigned long long end = set->migrated + MIGRATION_STEP;
+    unsigned long long probes = 0;
+
+    if(end > set->oldSlotCount){
+        end = set->oldSlotCount;
+    }
+    //the old table is never changed, so its probe sequences stay intact
+    for(; set->migrated < end; set->migrated++){
+        HASH_128 *old = set->oldSlots + set->migrated;
+        if(!_isEmpty(old)){
+            *_findSlot(set->slots, set->slotCount, *old, &probes) = *old;
+        }
+    }
+
+    if(set->migrated == set->oldSlotCount){
+        free(set->oldSlots);
+        set->oldSlots = NULL;
+        set->oldSlotCount = 0;
+    }
+}
+
+int addToHashSet(HASH_SET *set, HASH_128 hash){
+    unsigned long long probes = 0;
+    HASH_128 *slot;
+
+    //0 marks an empty slot
+    if(hash.low == 0 && hash.high == 0){
+        hash.low = 1;
+    }
+
+    set->additions++;
+    slot = _findSlot(set->slots, set->slotCount, hash, &probes);
+    if(_isEmpty(slot) && set->oldSlots != NULL &&
+            !_isEmpty(_findSlot(set->oldSlots, set->oldSlotCount, hash, &probes))){
+        slot = NULL;
+    }
+
+    set->probes += probes;
+    if(probes > set->maximumProbeLength){
+        set->maximumProbeLength = probes;
+    }
+
+    if(slot == NULL || !_isEmpty(slot)){
+        return 0;
+    }
+
+    *slot = hash;
+    set->size++;
+
+    if(set->oldSlots != NULL){
+        _migrate(set);
+    } else if(4*set->size > 3*set->slotCount){
+        //the old table is moved while the new one is filled: it contains at
+        //most 3/4 of its size in hashes and is moved after at most
+        //1/MIGRATION_STEP of its size in additions
+        set->oldSlots = set->slots;
+        set->oldSlotCount = set->slotCount;
+        set->migrated = 0;
+        set->slotCount *= 2;
+        set->slots = _allocateSlots(set->slotCount);
+        set->resizes++;
+    }
+
+    return 1;
+}
+
+unsigned long long hashSetSize(HASH_SET *set){
+    return set->size;
+}
+
+void getHashSetStatistics(HASH_SET *set, HASH_SET_STATISTICS *statistics){
+    statistics->size = set->size;
+    statistics->slotCount = set->slotCount;
+    statistics->loadFactor = ((double)set->size)/set->slotCount;
+    statistics->additions = set->additions;
+    statistics->averageProbeLength =
+            set->additions ? ((double)set->probes)/set->additions : 0;
+    statistics->maximumProbeLength = set->maximumProbeLength;
+    statistics->resizes = set->resizes;
+}
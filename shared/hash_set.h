@@ -0,0 +1,65 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef HASH_SET_H
+#define	HASH_SET_H
+
+#include "hash_store.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A hash set only stores 128-bit hashes (e.g., of canonical forms of graphs)
+ * and not the strings themselves, so two strings with the same hash are
+ * considered equal. The table uses open addressing with linear probing. When
+ * the table gets too full, a table of twice the size is allocated, and the
+ * entries are moved to it a few at a time with each following addition, so a
+ * single addition never has to rehash the complete table.
+ */
+
+typedef struct __hash_set HASH_SET;
+typedef struct __hash_set_statistics HASH_SET_STATISTICS;
+
+struct __hash_set_statistics {
+    unsigned long long size;
+    //the number of slots of the table to which new hashes are added
+    unsigned long long slotCount;
+    double loadFactor;
+
+    unsigned long long additions;
+    //the number of slots that were inspected per addition
+    double averageProbeLength;
+    unsigned long long maximumProbeLength;
+
+    //the number of times the table was doubled
+    int resizes;
+};
+
+HASH_SET *newHashSet();
+
+void freeHashSet(HASH_SET *set);
+
+/**
+ * Adds the hash to the set and returns 1, unless the set already contains the
+ * hash. In that case 0 is returned.
+ */
+int addToHashSet(HASH_SET *set, HASH_128 hash);
+
+/**
+ * Returns the number of hashes in the set.
+ */
+unsigned long long hashSetSize(HASH_SET *set);
+
+void getHashSetStatistics(HASH_SET *set, HASH_SET_STATISTICS *statistics);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* HASH_SET_H */
+
@@ -0,0 +1,237 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "hash_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 1024
+#define BLOCK_SIZE (1 << 20)
+
+typedef struct __stored_string STORED_STRING;
+typedef struct __hash_store_slot HASH_STORE_SLOT;
+typedef struct __memory_block MEMORY_BLOCK;
+
+struct __stored_string {
+    unsigned long long hashHigh;
+    unsigned long long value;
+    size_t length;
+    //followed by the bytes of the string
+};
+
+struct __hash_store_slot {
+    unsigned long long hashLow;
+    //NULL for an empty slot
+    STORED_STRING *string;
+};
+
+struct __memory_block {
+    MEMORY_BLOCK *previous;
+    size_t size;
+    size_t used;
+    //followed by the memory of the block
+};
+
+struct __hash_store {
+    HASH_STORE_SLOT *slots;
+    //always a power of 2
+    unsigned long long slotCount;
+    unsigned long long size;
+
+    MEMORY_BLOCK *currentBlock;
+};
+
+static void *_allocateHashStoreMemory(void *memory, size_t size){
+    memory = realloc(memory, size);
+    if(memory == NULL){
+        fprintf(stderr, "Insufficient memory for hash store -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+//================= MurmurHash3 (x64, 128 bits) =================
+
+static inline unsigned long long _rotateLeft(unsigned long long x, int r){
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline unsigned long long _finalMix(unsigned long long k){
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+HASH_128 computeHash128(const void *data, size_t length){
+    const unsigned char *bytes = (const unsigned char *)data;
+    const unsigned long long c1 = 0x87c37b91114253d5ULL;
+    const unsigned long long c2 = 0x4cf5ad432745937fULL;
+    unsigned long long h1 = 0, h2 = 0, k1, k2;
+    size_t i, blockCount = length / 16;
+    const unsigned char *tail = bytes + 16*blockCount;
+    HASH_128 hash;
+
+    for(i = 0; i < blockCount; i++){
+        memcpy(&k1, bytes + 16*i, 8);
+        memcpy(&k2, bytes + 16*i + 8, 8);
+
+        k1 *= c1; k1 = _rotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = _rotateLeft(h1, 27); h1 += h2; h1 = h1*5 + 0x52dce729;
+
+        k2 *= c2; k2 = _rotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = _rotateLeft(h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+    }
+
+    k1 = k2 = 0;
+    for(i = length & 15; i > 8; i--){
+        k2 ^= ((unsigned long long)tail[i - 1]) << (8*(i - 9));
+    }
+    for(; i > 0; i--){
+        k1 ^= ((unsigned long long)tail[i - 1]) << (8*(i - 1));
+    }
+    //mixing a zero word has no effect, so this also covers a shorter tail
+    k2 *= c2; k2 = _rotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+    k1 *= c1; k1 = _rotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+
+    h1 ^= length; h2 ^= length;
+    h1 += h2; h2 += h1;
+    h1 = _finalMix(h1); h2 = _finalMix(h2);
+    h1 += h2; h2 += h1;
+
+    hash.low = h1;
+    hash.high = h2;
+    return hash;
+}
+
+//================= Memory blocks =================
+
+static STORED_STRING *_allocateStoredString(HASH_STORE *store, size_t length){
+    //keep the headers aligned
+    size_t size = (sizeof(STORED_STRING) + length + 7) & ~((size_t)7);
+    MEMORY_BLOCK *block = store->currentBlock;
+    STORED_STRING *string;
+
+    if(block == NULL || block->size - block->used < size){
+        size_t blockSize = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+        block = _allocateHashStoreMemory(NULL, sizeof(MEMORY_BLOCK) + blockSize);
+        block->previous = store->currentBlock;
+        block->size = blockSize;
+        block->used = 0;
+        store->currentBlock = block;
+    }
+
+    string = (STORED_STRING *)((unsigned char *)(block + 1) + block->used);
+    block->used += size;
+    return string;
+}
+
+//================= Hash table =================
+
+HASH_STORE *newHashStore(){
+    HASH_STORE *store = _allocateHashStoreMemory(NULL, sizeof(HASH_STORE));
+
+    store->slotCount = INITIAL_SLOT_COUNT;
+    store->slots = _allocateHashStoreMemory(NULL, sizeof(HASH_STORE_SLOT)*store->slotCount);
+    memset(store->slots, 0, sizeof(HASH_STORE_SLOT)*store->slotCount);
+    store->size = 0;
+    store->currentBlock = NULL;
+
+    return store;
+}
+
+void freeHashStore(HASH_STORE *store){
+    while(store->currentBlock != NULL){
+        MEMORY_BLOCK *previous = store->currentBlock->previous;
+        free(store->currentBlock);
+        store->currentBlock = previous;
+    }
+    free(store->slots);
+    free(store);
+}
+
+static void _growHashStore(HASH_STORE *store){
+    unsigned long long i, j;
+    unsigned long long oldSlotCount = store->slotCount;
+    HASH_STORE_SLOT *oldSlots = store->slots;
+
+    store->slotCount *= 2;
+    store->slots = _allocateHashStoreMemory(NULL, sizeof(HASH_STORE_SLOT)*store->slotCount);
+    memset(store->slots, 0, sizeof(HASH_STORE_SLOT)*store->slotCount);
+
+    for(i = 0; i < oldSlotCount; i++){
+        if(oldSlots[i].string != NULL){
+            j = oldSlots[i].hashLow & (store->slotCount - 1);
+            while(store->slots[j].string != NULL){
+                j = (j + 1) & (store->slotCount - 1);
+            }
+            store->slots[j] = oldSlots[i];
+        }
+    }
+
+    free(oldSlots);
+}
+
+unsigned long long *findOrAddToHashStore(HASH_STORE *store, HASH_128 hash,
+        const void *string, size_t length, unsigned long long value, int *added){
+    unsigned long long mask = store->slotCount - 1;
+    unsigned long long i = hash.low & mask;
+    STORED_STRING *stored;
+
+    while(store->slots[i].string != NULL){
+        stored = store->slots[i].string;
+        if(store->slots[i].hashLow == hash.low && stored->hashHigh == hash.high &&
+                stored->length == length && memcmp(stored + 1, string, length) == 0){
+            *added = 0;
+            return &(stored->value);
+        }
+        i = (i + 1) & mask;
+    }
+
+    stored = _allocateStoredString(store, length);
+    stored->hashHigh = hash.high;
+    stored->value = value;
+    stored->length = length;
+    memcpy(stored + 1, string, length);
+
+    store->slots[i].hashLow = hash.low;
+    store->slots[i].string = stored;
+    store->size++;
+
+    //keep the load factor at most 3/4 (the strings themselves are not moved)
+    if(4*store->size > 3*store->slotCount){
+        _growHashStore(store);
+    }
+
+    *added = 1;
+    return &(stored->value);
+}
+
+int addHashedToHashStore(HASH_STORE *store, HASH_128 hash, const void *string,
+        size_t length, unsigned long long value, unsigned long long *storedValue){
+    int added;
+    unsigned long long *stored = findOrAddToHashStore(store, hash, string,
+            length, value, &added);
+
+    if(!added && storedValue != NULL){
+        *storedValue = *stored;
+    }
+    return added;
+}
+
+int addToHashStore(HASH_STORE *store, const void *string, size_t length,
+        unsigned long long value, unsigned long long *storedValue){
+    return addHashedToHashStore(store, computeHash128(string, length), string,
+            length, value, storedValue);
+}
+
+unsigned long long hashStoreSize(HASH_STORE *store){
+    return store->size;
+}
@@ -0,0 +1,77 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2016 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef HASH_STORE_H
+#define	HASH_STORE_H
+
+#include <stddef.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* A hash store is a set of byte strings (e.g., canonical forms of graphs)
+ * which each have a value attached. The strings are copied into large blocks
+ * of memory, so storing a string costs no separate allocation. The table of
+ * entries uses open addressing with linear probing and is indexed by a 128-bit
+ * hash of the string. Two strings are only compared byte by byte if their
+ * hashes are equal.
+ */
+
+typedef struct __hash_128 HASH_128;
+typedef struct __hash_store HASH_STORE;
+
+struct __hash_128 {
+    unsigned long long low;
+    unsigned long long high;
+};
+
+/**
+ * Returns the 128-bit MurmurHash3 of the given bytes.
+ */
+HASH_128 computeHash128(const void *data, size_t length);
+
+HASH_STORE *newHashStore();
+
+void freeHashStore(HASH_STORE *store);
+
+/**
+ * Adds a copy of the given string with the given value to the store and
+ * returns 1, unless the store already contains this string. In that case the
+ * store is not changed, 0 is returned and the value of the stored string is
+ * written to storedValue (if storedValue is not NULL).
+ */
+int addToHashStore(HASH_STORE *store, const void *string, size_t length,
+        unsigned long long value, unsigned long long *storedValue);
+
+/**
+ * The same as addToHashStore, but with the hash of the string already
+ * computed by computeHash128.
+ */
+int addHashedToHashStore(HASH_STORE *store, HASH_128 hash, const void *string,
+        size_t length, unsigned long long value, unsigned long long *storedValue);
+
+/**
+ * Adds a copy of the given string with the given value to the store if the
+ * store does not contain this string yet, and sets added to 1 in that case and
+ * to 0 otherwise. Returns a pointer to the value of the stored string, which
+ * may be changed. The value stays at this address until the store is freed.
+ */
+unsigned long long *findOrAddToHashStore(HASH_STORE *store, HASH_128 hash,
+        const void *string, size_t length, unsigned long long value, int *added);
+
+/**
+ * Returns the number of strings in the store.
+ */
+unsigned long long hashStoreSize(HASH_STORE *store);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* HASH_STORE_H */
+